@@ -125,6 +125,11 @@ final class AppDelegate: UIResponder, UIApplicationDelegate {
     func applicationDidEnterBackground(_ application: UIApplication) {
         Logger.info("")
 
+        if DebugFlags.internalLogging, appReadiness.isAppReady {
+            SSKEnvironment.shared.modelReadCachesRef.logStatistics()
+        }
+        ContentionProfiler.shared.logWorstOffenders()
+
         if shouldKillAppWhenBackgrounded {
             Logger.flush()
             exit(0)
@@ -549,6 +554,10 @@ final class AppDelegate: UIResponder, UIApplicationDelegate {
             OWSOrphanDataCleaner.auditOnLaunchIfNecessary()
         }
 
+        appReadiness.runNowOrWhenAppDidBecomeReadyAsync {
+            FullTextSearchIndexer.indexPendingMessagesOnLaunch()
+        }
+
         appReadiness.runNowOrWhenAppDidBecomeReadyAsync {
             Task.detached(priority: .low) {
                 await FullTextSearchOptimizer(
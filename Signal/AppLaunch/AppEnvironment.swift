@@ -5,6 +5,7 @@
 
 public import Foundation
 import SignalServiceKit
+import SignalUI
 
 public class AppEnvironment: NSObject {
 
@@ -75,6 +76,8 @@ public class AppEnvironment: NSObject {
         appReadiness.runNowOrWhenAppWillBecomeReady {
             self.badgeManager.startObservingChanges(in: SSKEnvironment.shared.databaseStorageRef)
             self.appIconBadgeUpdater.startObserving()
+            // Start observing installs, so that new packs are prefetched.
+            _ = StickerImageCache.shared
         }
 
         appReadiness.runNowOrWhenAppDidBecomeReadyAsync {
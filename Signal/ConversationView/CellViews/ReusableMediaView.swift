@@ -553,7 +553,8 @@ public class MediaViewAdapterSticker: NSObject, MediaViewAdapterSwift {
             }
             return Promise.value(animatedImage)
         } else {
-            guard let image = try? attachmentStream.decryptedImage() else {
+            // Cells are never larger than the screen.
+            guard let image = try? attachmentStream.decryptedImage(maxDimensionPoints: UIScreen.main.bounds.size.largerAxis) else {
                 return Promise(error: OWSAssertionError("Invalid image."))
             }
             return Promise.value(image)
@@ -9,6 +9,18 @@ public import SignalServiceKit
 public import SignalUI
 import UniformTypeIdentifiers
 
+/// A draft waiting to be saved.
+private struct PendingDraft {
+    let messageBody: MessageBody?
+    let quotedReply: DraftQuotedReplyModel?
+    let editTarget: TSOutgoingMessage?
+}
+
+/// Drafts whose save is waiting for the write queue, by thread unique ID.
+/// Later saves for the same thread replace the draft rather than queueing
+/// another write.
+private let pendingDrafts = AtomicValue<[String: PendingDraft]>([:], lock: .init())
+
 extension ConversationViewController: ConversationInputToolbarDelegate {
 
     public func isBlockedConversation() -> Bool {
@@ -271,35 +283,60 @@ extension ConversationViewController: ConversationInputToolbarDelegate {
         }
 
         if !inputToolbar.isHidden {
-            let thread = self.thread
-            let currentDraft = inputToolbar.messageBodyForSending
-            let quotedReply = inputToolbar.quotedReplyDraft
-            let editTarget = inputToolbar.editTarget
+            let threadUniqueId = self.thread.uniqueId
+            let draft = PendingDraft(
+                messageBody: inputToolbar.messageBodyForSending,
+                quotedReply: inputToolbar.quotedReplyDraft,
+                editTarget: inputToolbar.editTarget
+            )
+
+            // If a save for this thread is already waiting for the write
+            // queue, it saves this draft instead.
+            let didReplaceQueuedDraft = pendingDrafts.update { pendingDrafts in
+                guard pendingDrafts[threadUniqueId] != nil else {
+                    return false
+                }
+                pendingDrafts[threadUniqueId] = draft
+                return true
+            }
+            if didReplaceQueuedDraft {
+                return
+            }
+
+            // Most saves don't change the draft; don't make them wait behind
+            // message processing for the write queue.
+            let didChange = SSKEnvironment.shared.databaseStorageRef.read { transaction in
+                guard let thread = TSThread.anyFetch(uniqueId: threadUniqueId, transaction: transaction) else {
+                    return false
+                }
+                return Self.draftHasChanged(draft, thread: thread, transaction: transaction)
+            }
+            guard didChange else {
+                return
+            }
+
+            pendingDrafts.update { $0[threadUniqueId] = draft }
             SSKEnvironment.shared.databaseStorageRef.asyncWrite { transaction in
+                guard let draft = pendingDrafts.update(block: { $0.removeValue(forKey: threadUniqueId) }) else {
+                    return
+                }
+
                 // Reload a fresh instance of the thread model; our models are not
                 // thread-safe, so it wouldn't be safe to update the model in an
                 // async write.
-                guard let thread = TSThread.anyFetch(uniqueId: thread.uniqueId, transaction: transaction) else {
+                guard let thread = TSThread.anyFetch(uniqueId: threadUniqueId, transaction: transaction) else {
                     owsFailDebug("Missing thread.")
                     return
                 }
 
-                let didChange = Self.draftHasChanged(
-                    currentDraft: currentDraft,
-                    quotedReply: quotedReply,
-                    editTarget: editTarget,
-                    thread: thread,
-                    transaction: transaction
-                )
-
                 // Persist the draft only if its changed. This avoids unnecessary model changes.
-                guard didChange else {
+                guard Self.draftHasChanged(draft, thread: thread, transaction: transaction) else {
                     return
                 }
 
                 let replyInfo: ThreadReplyInfoObjC?
                 if
-                    let quotedReply,
+                    let quotedReply = draft.quotedReply,
                     let originalMessageTimestamp = quotedReply.originalMessageTimestamp,
                     let aci = quotedReply.originalMessageAuthorAddress.aci
                 {
@@ -311,11 +348,11 @@ extension ConversationViewController: ConversationInputToolbarDelegate {
                     replyInfo = nil
                 }
                 var editTargetTimestamp: NSNumber?
-                if let timestamp = inputToolbar.editTarget?.timestamp {
+                if let timestamp = draft.editTarget?.timestamp {
                     editTargetTimestamp = NSNumber(value: timestamp)
                 }
                 thread.update(
-                    withDraft: currentDraft,
+                    withDraft: draft.messageBody,
                     replyInfo: replyInfo,
                     editTargetTimestamp: editTargetTimestamp,
                     transaction: transaction
@@ -325,12 +362,13 @@ extension ConversationViewController: ConversationInputToolbarDelegate {
     }
 
     private static func draftHasChanged(
-        currentDraft: MessageBody?,
-        quotedReply: DraftQuotedReplyModel?,
-        editTarget: TSOutgoingMessage?,
+        _ draft: PendingDraft,
         thread: TSThread,
         transaction: SDSAnyReadTransaction
     ) -> Bool {
+        let currentDraft = draft.messageBody
+        let quotedReply = draft.quotedReply
+        let editTarget = draft.editTarget
         let currentText = currentDraft?.text ?? ""
         let persistedText = thread.messageDraft ?? ""
         if currentText != persistedText {
@@ -452,7 +452,7 @@ enum OWSOrphanDataCleaner {
             let threadIds: Set<String> = Set(TSThread.anyAllUniqueIds(transaction: transaction))
 
             var allInteractionIds: Set<String> = []
-            TSInteraction.anyEnumerate(transaction: transaction, batched: true) { interaction, stop in
+            TSInteraction.anyEnumerateDecodingInParallel(transaction: transaction) { interaction, stop in
                 guard isMainAppAndActive else {
                     shouldAbort = true
                     stop.pointee = true
@@ -540,6 +540,8 @@ enum OWSOrphanDataCleaner {
         orphanFilePaths.subtract(profileAvatarFilePaths)
         orphanFilePaths.subtract(groupAvatarFilePaths)
         orphanFilePaths.subtract(activeStickerFilePaths)
+        // Content store entries are referenced via hard links and swept by the store itself.
+        orphanFilePaths = orphanFilePaths.filter { !TSAttachmentContentStore.isStorePath($0) }
         var missingAttachmentFilePaths = allAttachmentFilePaths
         missingAttachmentFilePaths.subtract(allOnDiskFilePaths)
 
@@ -821,6 +823,8 @@ enum OWSOrphanDataCleaner {
             guard removeOrphanedFileAndDirectoryPaths(orphanData.fileAndDirectoryPaths) else {
                 return false
             }
+            // Orphaned attachment files may have been the last links to content store entries.
+            TSAttachmentContentStore.shared.sweepUnreferencedEntries()
         }
 
         return true
@@ -72,23 +72,18 @@ class PaymentsHistoryDataSource {
     private func loadAllPaymentsHistoryItems(delegate: PaymentsHistoryDataSourceDelegate) -> [PaymentsHistoryItem] {
         SSKEnvironment.shared.databaseStorageRef.read { transaction in
             // PAYMENTS TODO: Should we using paging, etc?
-            // PAYMENTS TODO: Sort in query?
-            var paymentModels: [TSPaymentModel] = TSPaymentModel.anyFetchAll(transaction: transaction)
-            paymentModels.sortBySortDate(descending: true)
-            paymentModels = paymentModels.filter { paymentModel in
-                switch delegate.recordType {
-                case .all:
-                    return true
-                case .incoming:
-                    return paymentModel.isIncoming
-                case .outgoing:
-                    return paymentModel.isOutgoing
-                }
-            }
-            if let maxRecordCount = delegate.maxRecordCount,
-               maxRecordCount < paymentModels.count {
-                paymentModels = Array(paymentModels.prefix(maxRecordCount))
+            let isIncoming: Bool?
+            switch delegate.recordType {
+            case .all:
+                isIncoming = nil
+            case .incoming:
+                isIncoming = true
+            case .outgoing:
+                isIncoming = false
             }
+            let paymentModels = PaymentFinder.mostRecentPaymentModels(isIncoming: isIncoming,
+                                                                      limit: delegate.maxRecordCount ?? Int.max,
+                                                                      transaction: transaction)
 
             return paymentModels.map { paymentModel in
                 var displayName: String
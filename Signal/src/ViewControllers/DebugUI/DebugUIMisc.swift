@@ -61,6 +61,9 @@ class DebugUIMisc: NSObject, DebugUIPage {
         }
 
         items += [
+            OWSTableItem(title: "Show performance counters", actionBlock: {
+                OWSActionSheets.showActionSheet(title: "Performance counters", message: PerformanceCounters.shared.report())
+            }),
             OWSTableItem(title: "Show 2FA Reminder", actionBlock: {
                 DebugUIMisc.showPinReminder()
             }),
@@ -946,7 +946,7 @@ class StoryItemMediaView: UIView {
     }
 
     private func buildImageView(attachment: TSResourceStream) -> UIView {
-        guard let image = try? attachment.decryptedImage() else {
+        guard let image = try? attachment.decryptedImage(maxDimensionPoints: UIScreen.main.bounds.size.largerAxis) else {
             owsFailDebug("Could not load attachment.")
             return buildContentUnavailableView()
         }
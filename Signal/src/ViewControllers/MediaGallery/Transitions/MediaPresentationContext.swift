@@ -15,7 +15,7 @@ enum Media {
     var image: UIImage? {
         switch self {
         case let .gallery(item):
-            return try? item.attachmentStream.attachmentStream.decryptedImage()
+            return try? item.attachmentStream.attachmentStream.decryptedImage(maxDimensionPoints: UIScreen.main.bounds.size.largerAxis)
         case let .image(image):
             return image
         }
@@ -185,6 +185,7 @@ class DebugLogs: NSObject {
             }
             OWSFileSystem.protectFileOrFolder(atPath: copyFilePath)
         }
+        DebugLogger.shared.writeInMemoryLogs(toDirectory: zipDirPath)
 
         return .success(zipDirPath)
     }
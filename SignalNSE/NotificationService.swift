@@ -77,6 +77,10 @@ class NotificationService: UNNotificationServiceExtension {
 
         Self.nseDidComplete()
 
+        if let memoryStatus = LocalDevice.currentMemoryStatus(forceUpdate: true) {
+            logger.info("Delivering notification, footprint: \(memoryStatus.footprint), peak: \(memoryStatus.peakFootprint), remaining: \(memoryStatus.bytesRemaining)")
+        }
+
         let content = UNMutableNotificationContent()
         content.badge = badgeCount.map { NSNumber(value: $0.unreadTotalCount) }
 
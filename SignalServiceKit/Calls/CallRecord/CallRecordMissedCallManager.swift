@@ -64,26 +64,9 @@ class CallRecordMissedCallManagerImpl: CallRecordMissedCallManager {
     // MARK: -
 
     func countUnreadMissedCalls(tx: DBReadTransaction) -> UInt {
-        var unreadMissedCallCount: UInt = 0
-
-        for missedCallStatus in CallRecord.CallStatus.missedCalls {
-            guard let unreadMissedCallCursor = callRecordQuerier.fetchCursorForUnread(
-                callStatus: missedCallStatus,
-                ordering: .descending,
-                tx: tx
-            ) else { continue }
-
-            do {
-                while let _ = try unreadMissedCallCursor.next() {
-                    unreadMissedCallCount += 1
-                }
-            } catch {
-                owsFailDebug("Unexpectedly failed to iterate CallRecord cursor!")
-                continue
-            }
+        return CallRecord.CallStatus.missedCalls.reduce(0) { partialCount, missedCallStatus in
+            return partialCount + callRecordQuerier.countUnread(callStatus: missedCallStatus, tx: tx)
         }
-
-        return unreadMissedCallCount
     }
 
     func markUnreadCallsAsRead(
@@ -132,6 +132,18 @@ public protocol CallRecordQuerier {
         ordering: FetchOrdering,
         tx: DBReadTransaction
     ) -> CallRecordCursor?
+
+    /// Returns the number of ``CallRecord``s with the given call status whose
+    /// ``CallRecord/unreadStatus`` is `.unread`.
+    ///
+    /// - Note
+    /// The implementation of this method in ``CallRecordQuerierImpl`` counts
+    /// entries in the index `CallRecord_callStatus_unreadStatus_callBeganTimestamp`,
+    /// without reading (or decoding) the records themselves.
+    func countUnread(
+        callStatus: CallRecord.CallStatus,
+        tx: DBReadTransaction
+    ) -> UInt
 }
 
 // MARK: -
@@ -252,6 +264,40 @@ class CallRecordQuerierImpl: CallRecordQuerier {
 
     // MARK: -
 
+    func countUnread(
+        callStatus: CallRecord.CallStatus,
+        tx: DBReadTransaction
+    ) -> UInt {
+        return fetchCount(
+            columnArgs: [
+                ColumnArg(.callStatus, callStatus.intValue),
+                ColumnArg(.unreadStatus, CallRecord.CallUnreadStatus.unread.rawValue)
+            ],
+            tx: tx
+        )
+    }
+
+    // MARK: -
+
+    fileprivate func fetchCount(
+        columnArgs: [ColumnArg],
+        tx: DBReadTransaction
+    ) -> UInt {
+        let (sqlString, sqlArgs) = compileCountQuery(columnArgs: columnArgs)
+
+        do {
+            return try UInt.fetchOne(
+                tx.databaseConnection,
+                sql: sqlString,
+                arguments: StatementArguments(sqlArgs)
+            ) ?? 0
+        } catch let error {
+            let columns = columnArgs.map { $0.column }
+            owsFailBeta("Error counting CallRecord by \(columns): \(error.grdbErrorForLogging)")
+            return 0
+        }
+    }
+
     fileprivate func fetchCursor(
         columnArgs: [ColumnArg],
         ordering: FetchOrdering,
@@ -303,27 +349,39 @@ class CallRecordQuerierImpl: CallRecordQuerier {
             columnArgs.append(timestampColumnArg)
         }
 
-        let whereClause: String = {
-            let columnClauses: [String] = columnArgs.map { columnArg -> String in
-                return "\(columnArg.column.rawValue) \(columnArg.relationship) ?"
-            }
-
-            if columnClauses.isEmpty {
-                return ""
-            } else {
-                return "WHERE \(columnClauses.joined(separator: " AND "))"
-            }
-        }()
-
         return (
             sqlString: """
                 SELECT * FROM \(CallRecord.databaseTableName)
-                \(whereClause)
+                \(compileWhereClause(columnArgs: columnArgs))
                 ORDER BY \(CallRecord.CodingKeys.callBeganTimestamp.rawValue) \(orderByKeyword)
             """,
             sqlArgs: columnArgs.map { $0.arg }
         )
     }
+
+    fileprivate func compileCountQuery(
+        columnArgs: [ColumnArg]
+    ) -> (sqlString: String, sqlArgs: [DatabaseValueConvertible]) {
+        return (
+            sqlString: """
+                SELECT COUNT(*) FROM \(CallRecord.databaseTableName)
+                \(compileWhereClause(columnArgs: columnArgs))
+            """,
+            sqlArgs: columnArgs.map { $0.arg }
+        )
+    }
+
+    private func compileWhereClause(columnArgs: [ColumnArg]) -> String {
+        let columnClauses: [String] = columnArgs.map { columnArg -> String in
+            return "\(columnArg.column.rawValue) \(columnArg.relationship) ?"
+        }
+
+        if columnClauses.isEmpty {
+            return ""
+        } else {
+            return "WHERE \(columnClauses.joined(separator: " AND "))"
+        }
+    }
 }
 
 #if TESTABLE_BUILD
@@ -358,6 +416,27 @@ final class ExplainingCallRecordQuerierImpl: CallRecordQuerierImpl {
             tx: tx
         )
     }
+
+    override fileprivate func fetchCount(
+        columnArgs: [ColumnArg],
+        tx: DBReadTransaction
+    ) -> UInt {
+        let (sqlString, sqlArgs) = compileCountQuery(columnArgs: columnArgs)
+
+        guard
+            let explanationRow = try? Row.fetchOne(tx.databaseConnection, SQLRequest(
+                sql: "EXPLAIN QUERY PLAN \(sqlString)",
+                arguments: StatementArguments(sqlArgs)
+            )),
+            let explanation = explanationRow[3] as? String
+        else {
+            owsFail("Failed to get explanation for query!")
+        }
+
+        lastExplanation = explanation
+
+        return super.fetchCount(columnArgs: columnArgs, tx: tx)
+    }
 }
 
 #endif
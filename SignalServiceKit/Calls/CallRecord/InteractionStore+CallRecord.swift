@@ -66,6 +66,10 @@ public extension InteractionStore {
     /// Update the joined members and creator of a group call on the associated
     /// group-call interaction.
     ///
+    /// Peeks report the whole membership, which is usually unchanged from the
+    /// previous peek; in that case the interaction isn't rewritten and no
+    /// notification is posted.
+    ///
     /// - Parameter notificationScheduler
     /// A scheduler on which to post a ``GroupCallInteractionUpdatedNotification``
     /// about the update.
@@ -78,10 +82,20 @@ public extension InteractionStore {
         notificationScheduler: Scheduler,
         tx: DBWriteTransaction
     ) {
+        let creatorUuid = creatorAci.serviceIdUppercaseString
+        let joinedMemberUuids = joinedMemberAcis.map { $0.serviceIdUppercaseString }
+        guard
+            groupCallInteraction.hasEnded != joinedMemberAcis.isEmpty
+            || groupCallInteraction.creatorUuid != creatorUuid
+            || (groupCallInteraction.joinedMemberUuids ?? []) != joinedMemberUuids
+        else {
+            return
+        }
+
         updateInteraction(groupCallInteraction, tx: tx) { groupCallInteraction in
             groupCallInteraction.hasEnded = joinedMemberAcis.isEmpty
-            groupCallInteraction.creatorUuid = creatorAci.serviceIdUppercaseString
-            groupCallInteraction.joinedMemberUuids = joinedMemberAcis.map { $0.serviceIdUppercaseString }
+            groupCallInteraction.creatorUuid = creatorUuid
+            groupCallInteraction.joinedMemberUuids = joinedMemberUuids
         }
 
         postUpdatedNotification(
@@ -12,7 +12,13 @@ NS_ASSUME_NONNULL_BEGIN
 
 #pragma mark -
 
-@implementation OWSGroupCallMessage
+@implementation OWSGroupCallMessage {
+    // Parsed lazily from joinedMemberUuids and creatorUuid, and cleared when
+    // they're set. They aren't properties so that Mantle doesn't archive or
+    // compare them.
+    NSArray<AciObjC *> *_Nullable _cachedJoinedMemberAcis;
+    AciObjC *_Nullable _cachedCreatorAci;
+}
 
 - (instancetype)initWithJoinedMemberAcis:(NSArray<AciObjC *> *)joinedMemberAcis
                               creatorAci:(nullable AciObjC *)creatorAci
@@ -86,22 +92,44 @@ NS_ASSUME_NONNULL_BEGIN
     return [super initWithCoder:coder];
 }
 
+- (void)setJoinedMemberUuids:(nullable NSArray<NSString *> *)joinedMemberUuids
+{
+    @synchronized(self) {
+        _joinedMemberUuids = [joinedMemberUuids copy];
+        _cachedJoinedMemberAcis = nil;
+    }
+}
+
+- (void)setCreatorUuid:(nullable NSString *)creatorUuid
+{
+    @synchronized(self) {
+        _creatorUuid = [creatorUuid copy];
+        _cachedCreatorAci = nil;
+    }
+}
+
 - (NSArray<AciObjC *> *)joinedMemberAcis
 {
-    NSArray<NSString *> *_Nullable uuids = self.joinedMemberUuids;
-    NSMutableArray<AciObjC *> *result = [[NSMutableArray alloc] initWithCapacity:uuids.count];
-    for (NSString *aciString in uuids) {
-        [result addObject:[[AciObjC alloc] initWithAciString:aciString]];
+    @synchronized(self) {
+        if (_cachedJoinedMemberAcis == nil) {
+            NSArray<NSString *> *_Nullable uuids = _joinedMemberUuids;
+            NSMutableArray<AciObjC *> *result = [[NSMutableArray alloc] initWithCapacity:uuids.count];
+            for (NSString *aciString in uuids) {
+                [result addObject:[[AciObjC alloc] initWithAciString:aciString]];
+            }
+            _cachedJoinedMemberAcis = [result copy];
+        }
+        return _cachedJoinedMemberAcis;
     }
-    return result;
 }
 
 - (nullable AciObjC *)creatorAci
 {
-    if (self.creatorUuid) {
-        return [[AciObjC alloc] initWithAciString:self.creatorUuid];
-    } else {
-        return nil;
+    @synchronized(self) {
+        if (_cachedCreatorAci == nil && _creatorUuid != nil) {
+            _cachedCreatorAci = [[AciObjC alloc] initWithAciString:_creatorUuid];
+        }
+        return _cachedCreatorAci;
     }
 }
 
@@ -323,7 +323,9 @@ public class OWSDisappearingMessagesConfigurationCursor: NSObject, SDSCursor {
         guard let record = try cursor.next() else {
             return nil
         }
-        return try OWSDisappearingMessagesConfiguration.fromRecord(record)
+        let value = try OWSDisappearingMessagesConfiguration.fromRecord(record)
+        SSKEnvironment.shared.modelReadCachesRef.disappearingMessagesConfigurationReadCache.didReadConfiguration(value, transaction: transaction.asAnyRead)
+        return value
     }
 
     public func all() throws -> [OWSDisappearingMessagesConfiguration] {
@@ -362,6 +364,20 @@ public extension OWSDisappearingMessagesConfiguration {
                         transaction: SDSAnyReadTransaction) -> OWSDisappearingMessagesConfiguration? {
         assert(!uniqueId.isEmpty)
 
+        return anyFetch(uniqueId: uniqueId, transaction: transaction, ignoreCache: false)
+    }
+
+    // Fetches a single model by "unique id".
+    class func anyFetch(uniqueId: String,
+                        transaction: SDSAnyReadTransaction,
+                        ignoreCache: Bool) -> OWSDisappearingMessagesConfiguration? {
+        assert(!uniqueId.isEmpty)
+
+        if !ignoreCache,
+            let cachedCopy = SSKEnvironment.shared.modelReadCachesRef.disappearingMessagesConfigurationReadCache.getConfiguration(uniqueId: uniqueId, transaction: transaction) {
+            return cachedCopy
+        }
+
         switch transaction.readTransaction {
         case .grdbRead(let grdbTransaction):
             let sql = "SELECT * FROM \(DisappearingMessagesConfigurationRecord.databaseTableName) WHERE \(disappearingMessagesConfigurationColumn: .uniqueId) = ?"
@@ -552,7 +568,9 @@ public extension OWSDisappearingMessagesConfiguration {
                 return nil
             }
 
-            return try OWSDisappearingMessagesConfiguration.fromRecord(record)
+            let value = try OWSDisappearingMessagesConfiguration.fromRecord(record)
+            SSKEnvironment.shared.modelReadCachesRef.disappearingMessagesConfigurationReadCache.didReadConfiguration(value, transaction: transaction.asAnyRead)
+            return value
         } catch {
             owsFailDebug("error: \(error)")
             return nil
@@ -148,6 +148,33 @@ NS_ASSUME_NONNULL_BEGIN
         && otherConfiguration.timerVersion == self.timerVersion;
 }
 
+- (void)anyDidInsertWithTransaction:(SDSAnyWriteTransaction *)transaction
+{
+    [super anyDidInsertWithTransaction:transaction];
+
+    [SSKEnvironment.shared.modelReadCachesRef.disappearingMessagesConfigurationReadCache
+        didInsertOrUpdateConfiguration:self
+                           transaction:transaction];
+}
+
+- (void)anyDidUpdateWithTransaction:(SDSAnyWriteTransaction *)transaction
+{
+    [super anyDidUpdateWithTransaction:transaction];
+
+    [SSKEnvironment.shared.modelReadCachesRef.disappearingMessagesConfigurationReadCache
+        didInsertOrUpdateConfiguration:self
+                           transaction:transaction];
+}
+
+- (void)anyDidRemoveWithTransaction:(SDSAnyWriteTransaction *)transaction
+{
+    [super anyDidRemoveWithTransaction:transaction];
+
+    [SSKEnvironment.shared.modelReadCachesRef.disappearingMessagesConfigurationReadCache
+        didRemoveConfiguration:self
+                   transaction:transaction];
+}
+
 @end
 
 NS_ASSUME_NONNULL_END
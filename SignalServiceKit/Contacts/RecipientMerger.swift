@@ -941,10 +941,13 @@ extension SignalServiceAddressCache: RecipientMergeObserver {
     func didLearnAssociation(mergedRecipient: MergedRecipient, tx: DBWriteTransaction) {
         updateRecipient(mergedRecipient.newRecipient, tx: tx)
 
-        // If there are any threads with addresses that have been merged, we should
-        // reload them from disk. This allows us to rebuild the addresses with the
-        // proper hash values.
-        SSKEnvironment.shared.modelReadCachesRef.evacuateAllCaches()
+        // If there are any threads or interactions with addresses that have been
+        // merged, we should reload them from disk. This allows us to rebuild the
+        // addresses with the proper hash values. The other model caches don't
+        // hold addresses.
+        let modelReadCaches = SSKEnvironment.shared.modelReadCachesRef
+        modelReadCaches.threadReadCache.evacuate()
+        modelReadCaches.interactionReadCache.evacuate()
     }
 }
 
@@ -132,6 +132,9 @@ public class SignalServiceAddress: NSObject, NSCopying, NSSecureCoding, Codable
     }
 
     public static func legacyAddress(serviceId: ServiceId?, phoneNumber: String?) -> SignalServiceAddress {
+        if let serviceId, phoneNumber == nil {
+            return SSKEnvironment.shared.signalServiceAddressCacheRef.internedAddress(for: serviceId)
+        }
         return SignalServiceAddress(
             serviceId: serviceId,
             legacyPhoneNumber: phoneNumber,
@@ -149,13 +152,26 @@ public class SignalServiceAddress: NSObject, NSCopying, NSSecureCoding, Codable
 
     @objc
     public static func legacyAddress(serviceIdString: String?, phoneNumber: String?) -> SignalServiceAddress {
-        return SignalServiceAddress(
+        return legacyAddress(
             serviceId: serviceIdString.flatMap { try? ServiceId.parseFrom(serviceIdString: $0) },
-            legacyPhoneNumber: phoneNumber,
-            cache: SSKEnvironment.shared.signalServiceAddressCacheRef
+            phoneNumber: phoneNumber
         )
     }
 
+    /// Returns a shared address for `serviceId`.
+    ///
+    /// Prefer this when creating many addresses for the same accounts (e.g.,
+    /// message authors and group members); equal interned addresses are
+    /// identical, so they cost no extra memory and compare by pointer.
+    public static func interned(_ serviceId: ServiceId) -> SignalServiceAddress {
+        return SSKEnvironment.shared.signalServiceAddressCacheRef.internedAddress(for: serviceId)
+    }
+
+    @objc
+    public static func interned(serviceIdObjC: ServiceIdObjC) -> SignalServiceAddress {
+        return interned(serviceIdObjC.wrappedValue)
+    }
+
     public convenience init(_ e164: E164) {
         self.init(phoneNumber: e164.stringValue)
     }
@@ -375,6 +391,11 @@ public class SignalServiceAddress: NSObject, NSCopying, NSSecureCoding, Codable
             return false
         }
 
+        // Addresses for the same identifiers usually share a CachedAddress.
+        if cachedAddress === otherAddress.cachedAddress {
+            return cachedAddress.identifiers.get().isValid
+        }
+
         let this = cachedAddress.identifiers.get()
         let other = otherAddress.cachedAddress.identifiers.get()
 
@@ -498,6 +519,9 @@ private class CachedAddress {
     struct Identifiers: Equatable {
         var serviceId: ServiceId?
         var phoneNumber: String?
+
+        /// Addresses without identifiers are never equal to anything.
+        var isValid: Bool { serviceId != nil || phoneNumber != nil }
     }
 
     let hashValue: Int
@@ -513,6 +537,10 @@ private class CachedAddress {
 public class SignalServiceAddressCache: NSObject {
     private let state = AtomicValue(CacheState(), lock: .init())
 
+    /// Canonical addresses created by `internedAddress(for:)`. Like the
+    /// CachedAddresses in `state`, these are never removed.
+    private let internedAddresses = AtomicValue([ServiceId: SignalServiceAddress](), lock: .init())
+
     private let _phoneNumberVisibilityFetcher: PhoneNumberVisibilityFetcher?
     private var phoneNumberVisibilityFetcher: PhoneNumberVisibilityFetcher {
         return _phoneNumberVisibilityFetcher ?? DependenciesBridge.shared.phoneNumberVisibilityFetcher
@@ -711,6 +739,20 @@ public class SignalServiceAddressCache: NSObject {
         }
     }
 
+    /// An address's identifiers live in its CachedAddress, which is updated
+    /// in place as recipients change, so one address can be shared by
+    /// everyone who needs an address for `serviceId`.
+    func internedAddress(for serviceId: ServiceId) -> SignalServiceAddress {
+        return internedAddresses.update { internedAddresses in
+            if let address = internedAddresses[serviceId] {
+                return address
+            }
+            let address = SignalServiceAddress(serviceId: serviceId, phoneNumber: nil, cache: self)
+            internedAddresses[serviceId] = address
+            return address
+        }
+    }
+
     fileprivate func registerAddress(proposedIdentifiers: CachedAddress.Identifiers, isLegacyPhoneNumber: Bool) -> CachedAddress {
         state.update { cacheState in
             let resolvedIdentifiers = resolveIdentifiers(
@@ -185,10 +185,19 @@ lastVisibleSortIdOnScreenPercentageObsolete:(double)lastVisibleSortIdOnScreenPer
 
 - (NSArray<SignalServiceAddress *> *)recipientAddressesWithSneakyTransaction
 {
+    ThreadReadCache *threadReadCache = SSKEnvironment.shared.modelReadCachesRef.threadReadCache;
+    NSArray<SignalServiceAddress *> *_Nullable snapshot =
+        [threadReadCache recipientAddressesSnapshotForThreadUniqueId:self.uniqueId];
+    if (snapshot != nil) {
+        return snapshot;
+    }
+
+    NSInteger generation = [threadReadCache recipientSnapshotGeneration];
     __block NSArray<SignalServiceAddress *> *recipientAddresses;
     [SSKEnvironment.shared.databaseStorageRef readWithBlock:^(SDSAnyReadTransaction *transaction) {
         recipientAddresses = [self recipientAddressesWithTransaction:transaction];
     }];
+    [threadReadCache didReadRecipients:recipientAddresses forThreadUniqueId:self.uniqueId generation:generation];
     return recipientAddresses;
 }
 
@@ -230,23 +239,19 @@ lastVisibleSortIdOnScreenPercentageObsolete:(double)lastVisibleSortIdOnScreenPer
                                                                                      tx:(SDSAnyReadTransaction *)tx
 {
     NSMutableArray *errorMessages = [NSMutableArray new];
-    [self enumerateRecentInteractionsWithTransaction:tx
-                                          usingBlock:^(TSInteraction *interaction) {
-                                              if ([interaction isKindOfClass:[TSInvalidIdentityKeyReceivingErrorMessage
-                                                                                 class]]) {
-                                                  TSInvalidIdentityKeyReceivingErrorMessage *errorMessage
-                                                      = (TSInvalidIdentityKeyReceivingErrorMessage *)interaction;
-                                                  NSError *error;
-                                                  NSData *newIdentityKey = [errorMessage newIdentityKey:&error];
-                                                  if (newIdentityKey != nil) {
-                                                      if ([newIdentityKey isEqualToData:key]) {
-                                                          [errorMessages addObject:errorMessage];
-                                                      }
-                                                  } else {
-                                                      OWSFailDebug(@"error: %@", error);
-                                                  }
-                                              }
-                                          }];
+    InteractionFinder *interactionFinder = [[InteractionFinder alloc] initWithThreadUniqueId:self.uniqueId];
+    for (TSInvalidIdentityKeyReceivingErrorMessage *errorMessage in
+        [interactionFinder fetchInvalidIdentityKeyReceivingErrorMessagesWithTransaction:tx]) {
+        NSError *error;
+        NSData *newIdentityKey = [errorMessage newIdentityKey:&error];
+        if (newIdentityKey != nil) {
+            if ([newIdentityKey isEqualToData:key]) {
+                [errorMessages addObject:errorMessage];
+            }
+        } else {
+            OWSFailDebug(@"error: %@", error);
+        }
+    }
 
     return errorMessages;
 }
@@ -323,8 +328,16 @@ lastVisibleSortIdOnScreenPercentageObsolete:(double)lastVisibleSortIdOnScreenPer
 
     BOOL needsToClearIsMarkedUnread = associatedData.isMarkedUnread && wasMessageInserted;
 
-    if (needsToMarkAsVisible || needsToClearArchived || needsToUpdateLastInteractionRowId
-        || needsToClearLastVisibleSortId || needsToClearIsMarkedUnread) {
+    if (!needsToMarkAsVisible && !needsToClearArchived && !needsToClearLastVisibleSortId
+        && !needsToClearIsMarkedUnread) {
+        // Only lastInteractionRowId needs to change, so do that once for all
+        // the messages inserted into this thread in this transaction.
+        if (needsToUpdateLastInteractionRowId) {
+            [self scheduleLastInteractionRowIdUpdate:messageSortId transaction:transaction];
+        } else {
+            [self scheduleTouchFinalizationWithTransaction:transaction];
+        }
+    } else {
         [self anyUpdateWithTransaction:transaction
                                  block:^(TSThread *thread) {
                                      thread.shouldThreadBeVisible = YES;
@@ -341,8 +354,6 @@ lastVisibleSortIdOnScreenPercentageObsolete:(double)lastVisibleSortIdOnScreenPer
         if (needsToClearLastVisibleSortId) {
             [self clearLastVisibleInteractionWithTransaction:transaction];
         }
-    } else {
-        [self scheduleTouchFinalizationWithTransaction:transaction];
     }
 }
 
@@ -416,6 +427,8 @@ lastVisibleSortIdOnScreenPercentageObsolete:(double)lastVisibleSortIdOnScreenPer
     OWSAssertDebug(message != nil);
     OWSAssertDebug(transaction != nil);
 
+    [self applyPendingLastInteractionRowIdWithTransaction:transaction];
+
     uint64_t messageSortId = [self messageSortIdForMessage:message];
     BOOL needsToUpdateLastInteractionRowId = messageSortId == self.lastInteractionRowId;
 
@@ -425,48 +438,17 @@ lastVisibleSortIdOnScreenPercentageObsolete:(double)lastVisibleSortIdOnScreenPer
 
     [self updateOnInteractionsRemovedWithNeedsToUpdateLastInteractionRowId:needsToUpdateLastInteractionRowId
                                             needsToUpdateLastVisibleSortId:needsToUpdateLastVisibleSortId
-                                                         lastVisibleSortId:lastVisibleSortId
-                                                               transaction:transaction];
-}
-
-- (void)updateOnInteractionsRemovedWithNeedsToUpdateLastInteractionRowId:(BOOL)needsToUpdateLastInteractionRowId
-                                          needsToUpdateLastVisibleSortId:(BOOL)needsToUpdateLastVisibleSortId
-                                                             transaction:(SDSAnyWriteTransaction *)transaction
-{
-    NSNumber *_Nullable lastVisibleSortId = [self lastVisibleSortIdWithTransaction:transaction];
-
-    [self updateOnInteractionsRemovedWithNeedsToUpdateLastInteractionRowId:needsToUpdateLastInteractionRowId
-                                            needsToUpdateLastVisibleSortId:needsToUpdateLastVisibleSortId
-                                                         lastVisibleSortId:lastVisibleSortId
                                                                transaction:transaction];
 }
 
 - (void)updateOnInteractionsRemovedWithNeedsToUpdateLastInteractionRowId:(BOOL)needsToUpdateLastInteractionRowId
                                           needsToUpdateLastVisibleSortId:(BOOL)needsToUpdateLastVisibleSortId
-                                                       lastVisibleSortId:(nullable NSNumber *)lastVisibleSortId
                                                              transaction:(SDSAnyWriteTransaction *)transaction
 {
     if (needsToUpdateLastInteractionRowId || needsToUpdateLastVisibleSortId) {
-        [self anyUpdateWithTransaction:transaction
-                                 block:^(TSThread *thread) {
-                                     if (needsToUpdateLastInteractionRowId) {
-                                         TSInteraction *_Nullable latestInteraction =
-                                             [thread lastInteractionForInboxWithTransaction:transaction];
-                                         thread.lastInteractionRowId = latestInteraction ? latestInteraction.sortId : 0;
-                                     }
-                                 }];
-
-        if (needsToUpdateLastVisibleSortId) {
-            TSInteraction *_Nullable messageBeforeDeletedMessage =
-                [self firstInteractionAtOrAroundSortId:lastVisibleSortId.unsignedLongLongValue transaction:transaction];
-            if (messageBeforeDeletedMessage != nil) {
-                [self setLastVisibleInteractionWithSortId:messageBeforeDeletedMessage.sortId
-                                       onScreenPercentage:1
-                                              transaction:transaction];
-            } else {
-                [self clearLastVisibleInteractionWithTransaction:transaction];
-            }
-        }
+        [self scheduleUpdateAfterInteractionsRemovedWithNeedsToUpdateLastInteractionRowId:needsToUpdateLastInteractionRowId
+                                                           needsToUpdateLastVisibleSortId:needsToUpdateLastVisibleSortId
+                                                                              transaction:transaction];
     } else {
         [self scheduleTouchFinalizationWithTransaction:transaction];
     }
@@ -478,13 +460,13 @@ lastVisibleSortIdOnScreenPercentageObsolete:(double)lastVisibleSortIdOnScreenPer
 
     // If we insert, update or remove N interactions in a given
     // transactions, we don't need to touch the same thread more
-    // than once.
+    // than once. Touches in successive transactions are coalesced
+    // by ThreadTouchCoalescer.
     [transactionForMethod addTransactionFinalizationBlockForKey:self.transactionFinalizationKey
                                                           block:^(SDSAnyWriteTransaction *transactionForBlock) {
-                                                              [SSKEnvironment.shared.databaseStorageRef
-                                                                    touchThread:self
-                                                                  shouldReindex:NO
-                                                                    transaction:transactionForBlock];
+                                                              [ThreadTouchCoalescer.shared
+                                                                  touchWithThread:self
+                                                                      transaction:transactionForBlock];
                                                           }];
 }
 
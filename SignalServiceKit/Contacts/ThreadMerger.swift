@@ -321,15 +321,21 @@ final class ThreadMerger {
 class _ThreadMerger_SDSThreadMergerWrapper: _ThreadMerger_SDSThreadMergerShim {
     func mergeThread(_ thread: TSContactThread, into targetThread: TSContactThread, tx: DBWriteTransaction) {
         let threadPair = MergePair<TSContactThread>(fromValue: thread, intoValue: targetThread)
-        mergeInteractions(threadPair, tx: SDSDB.shimOnlyBridge(tx))
+        let didMoveInteractions = mergeInteractions(threadPair, tx: SDSDB.shimOnlyBridge(tx))
         mergeMediaGalleryItems(threadPair, tx: SDSDB.shimOnlyBridge(tx))
         mergeReceiptsPendingMessageRequest(threadPair, tx: SDSDB.shimOnlyBridge(tx))
         mergeMessageSendLogPayloads(threadPair, tx: SDSDB.shimOnlyBridge(tx))
-        // We might have changed something in the cache -- evacuate it.
-        SSKEnvironment.shared.modelReadCachesRef.evacuateAllCaches()
+        // Cached interactions might still point at the old thread -- evacuate
+        // them. The threads themselves are updated through their models, and
+        // nothing else moved here is cached, so mass merges (e.g., after a PNI
+        // migration) needn't empty every model cache for each pair.
+        if didMoveInteractions {
+            SSKEnvironment.shared.modelReadCachesRef.interactionReadCache.evacuate()
+        }
     }
 
-    private func mergeInteractions(_ threadPair: MergePair<TSContactThread>, tx: SDSAnyWriteTransaction) {
+    /// - Returns: Whether any interactions were moved.
+    private func mergeInteractions(_ threadPair: MergePair<TSContactThread>, tx: SDSAnyWriteTransaction) -> Bool {
         let uniqueIds = threadPair.map { $0.uniqueId }
         tx.unwrapGrdbWrite.execute(
             sql: """
@@ -339,6 +345,7 @@ class _ThreadMerger_SDSThreadMergerWrapper: _ThreadMerger_SDSThreadMergerShim {
             """,
             arguments: [uniqueIds.intoValue, uniqueIds.fromValue]
         )
+        return tx.unwrapGrdbWrite.database.changesCount > 0
     }
 
     private func mergeMediaGalleryItems(_ threadPair: MergePair<TSContactThread>, tx: SDSAnyWriteTransaction) {
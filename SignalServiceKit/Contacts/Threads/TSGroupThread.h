@@ -84,6 +84,12 @@ NS_DESIGNATED_INITIALIZER NS_SWIFT_NAME(init(grdbId:uniqueId:conversationColorNa
                               transaction:(SDSAnyReadTransaction *)transaction
     NS_SWIFT_NAME(fetch(groupId:transaction:));
 
+/// The same recipients as `recipientAddressesWithTransaction:`, for membership tests.
+- (NSSet<SignalServiceAddress *> *)recipientAddressSetWithTransaction:(SDSAnyReadTransaction *)transaction
+    NS_SWIFT_NAME(recipientAddressSet(with:));
+- (BOOL)isRecipientAddress:(SignalServiceAddress *)address
+               transaction:(SDSAnyReadTransaction *)transaction NS_SWIFT_NAME(isRecipientAddress(_:tx:));
+
 @property (nonatomic, readonly) NSString *groupNameOrDefault;
 @property (nonatomic, readonly, class) NSString *defaultGroupName;
 
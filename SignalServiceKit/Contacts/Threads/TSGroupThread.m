@@ -12,7 +12,13 @@ NS_ASSUME_NONNULL_BEGIN
 NSString *const TSGroupThreadAvatarChangedNotification = @"TSGroupThreadAvatarChangedNotification";
 NSString *const TSGroupThread_NotificationKey_UniqueId = @"TSGroupThread_NotificationKey_UniqueId";
 
-@interface TSGroupThread ()
+@interface TSGroupThread () {
+    // Derived from groupModel, so not persisted; guarded by @synchronized(self).
+    TSGroupModel *_Nullable _cachedRecipientsGroupModel;
+    SignalServiceAddress *_Nullable _cachedRecipientsLocalAddress;
+    NSArray<SignalServiceAddress *> *_Nullable _cachedRecipientAddresses;
+    NSSet<SignalServiceAddress *> *_Nullable _cachedRecipientAddressSet;
+}
 
 @property (nonatomic) TSGroupModel *groupModel;
 
@@ -113,16 +119,58 @@ lastVisibleSortIdOnScreenPercentageObsolete:lastVisibleSortIdOnScreenPercentageO
     return [TSGroupThread anyFetchGroupThreadWithUniqueId:uniqueId transaction:transaction];
 }
 
+- (void)setGroupModel:(TSGroupModel *)groupModel
+{
+    @synchronized(self) {
+        _groupModel = groupModel;
+        _cachedRecipientsGroupModel = nil;
+        _cachedRecipientsLocalAddress = nil;
+        _cachedRecipientAddresses = nil;
+        _cachedRecipientAddressSet = nil;
+    }
+}
+
+// Sends, receipts and typing indicators ask for the recipients repeatedly, so
+// they're computed once per group model rather than on every call.
+- (void)ensureCachedRecipientsWithTransaction:(SDSAnyReadTransaction *)transaction
+{
+    SignalServiceAddress *_Nullable localAddress = [TSAccountManagerObjcBridge localAciAddressWith:transaction];
+    TSGroupModel *groupModel = self.groupModel;
+    if (_cachedRecipientAddresses != nil && _cachedRecipientsGroupModel == groupModel
+        && [NSObject isNullableObject:_cachedRecipientsLocalAddress equalTo:localAddress]) {
+        return;
+    }
+
+    NSMutableArray<SignalServiceAddress *> *groupMembers = [groupModel.groupMembers mutableCopy] ?: [NSMutableArray new];
+    if (localAddress != nil) {
+        [groupMembers removeObject:localAddress];
+    }
+
+    _cachedRecipientsGroupModel = groupModel;
+    _cachedRecipientsLocalAddress = localAddress;
+    _cachedRecipientAddresses = [groupMembers copy];
+    _cachedRecipientAddressSet = [NSSet setWithArray:groupMembers];
+}
+
 - (NSArray<SignalServiceAddress *> *)recipientAddressesWithTransaction:(SDSAnyReadTransaction *)transaction
 {
-    NSMutableArray<SignalServiceAddress *> *groupMembers = [self.groupModel.groupMembers mutableCopy];
-    if (groupMembers == nil) {
-        return @[];
+    @synchronized(self) {
+        [self ensureCachedRecipientsWithTransaction:transaction];
+        return _cachedRecipientAddresses;
     }
+}
 
-    [groupMembers removeObject:[TSAccountManagerObjcBridge localAciAddressWith:transaction]];
+- (NSSet<SignalServiceAddress *> *)recipientAddressSetWithTransaction:(SDSAnyReadTransaction *)transaction
+{
+    @synchronized(self) {
+        [self ensureCachedRecipientsWithTransaction:transaction];
+        return _cachedRecipientAddressSet;
+    }
+}
 
-    return [groupMembers copy];
+- (BOOL)isRecipientAddress:(SignalServiceAddress *)address transaction:(SDSAnyReadTransaction *)transaction
+{
+    return [[self recipientAddressSetWithTransaction:transaction] containsObject:address];
 }
 
 - (NSString *)groupNameOrDefault
@@ -137,6 +137,10 @@ public extension TSThread {
 
     private static let lastVisibleInteractionStore = SDSKeyValueStore(collection: "lastVisibleInteractionStore")
 
+    /// Every inserted message checks (and usually clears) this state, so
+    /// keep it in memory rather than reading the store each time.
+    private static let lastVisibleInteractionCache = LastVisibleInteractionCache()
+
     @objc
     func hasLastVisibleInteraction(transaction: SDSAnyReadTransaction) -> Bool {
         nil != Self.lastVisibleInteraction(forThread: self, transaction: transaction)
@@ -156,14 +160,16 @@ public extension TSThread {
 
     static func lastVisibleInteraction(forThread thread: TSThread,
                                        transaction: SDSAnyReadTransaction) -> LastVisibleInteraction? {
-        guard let data = lastVisibleInteractionStore.getData(thread.uniqueId, transaction: transaction) else {
-            return nil
-        }
-        do {
-            return try JSONDecoder().decode(LastVisibleInteraction.self, from: data)
-        } catch {
-            owsFailDebug("Error: \(error)")
-            return nil
+        return lastVisibleInteractionCache.value(forThreadUniqueId: thread.uniqueId, transaction: transaction) {
+            guard let data = lastVisibleInteractionStore.getData(thread.uniqueId, transaction: transaction) else {
+                return nil
+            }
+            do {
+                return try JSONDecoder().decode(LastVisibleInteraction.self, from: data)
+            } catch {
+                owsFailDebug("Error: \(error)")
+                return nil
+            }
         }
     }
 
@@ -189,7 +195,12 @@ public extension TSThread {
                                           forThread thread: TSThread,
                                           transaction: SDSAnyWriteTransaction) {
         guard let lastVisibleInteraction = lastVisibleInteraction else {
+            guard self.lastVisibleInteraction(forThread: thread, transaction: transaction) != nil else {
+                // Nothing to clear.
+                return
+            }
             lastVisibleInteractionStore.removeValue(forKey: thread.uniqueId, transaction: transaction)
+            lastVisibleInteractionCache.didSet(nil, forThreadUniqueId: thread.uniqueId, transaction: transaction)
             return
         }
         let data: Data
@@ -198,9 +209,245 @@ public extension TSThread {
         } catch {
             owsFailDebug("Error: \(error)")
             lastVisibleInteractionStore.removeValue(forKey: thread.uniqueId, transaction: transaction)
+            lastVisibleInteractionCache.didSet(nil, forThreadUniqueId: thread.uniqueId, transaction: transaction)
             return
         }
         lastVisibleInteractionStore.setData(data, key: thread.uniqueId, transaction: transaction)
+        lastVisibleInteractionCache.didSet(lastVisibleInteraction, forThreadUniqueId: thread.uniqueId, transaction: transaction)
+    }
+}
+
+// MARK: -
+
+/// Caches `TSThread.LastVisibleInteraction` by thread.
+///
+/// Committed values are shared by all transactions. Values written by the
+/// open write transaction are only visible to that transaction until it
+/// commits; other transactions read them from the database in the meantime.
+private final class LastVisibleInteractionCache {
+
+    private typealias Value = TSThread.LastVisibleInteraction
+
+    private let lock = UnfairLock()
+
+    // These properties should only be accessed with lock acquired.
+
+    /// A nil value means the thread is known to have no last visible
+    /// interaction; a missing entry means it isn't cached.
+    private var committedValues = [String: Value?]()
+    /// Writes are serialized, so only one transaction has uncommitted values.
+    private weak var uncommittedTransaction: GRDBWriteTransaction?
+    private var uncommittedValues = [String: Value?]()
+    /// Incremented on every write so that loads which raced with a write
+    /// aren't cached.
+    private var generation = 0
+    /// Transactions older than this may have read what another process
+    /// has since changed, so their loads aren't cached.
+    private var evacuationDate: Date?
+
+    init() {
+        for name in [
+            SDSDatabaseStorage.didReceiveCrossProcessNotificationAlwaysSync,
+            ModelReadCaches.evacuateAllModelCaches,
+        ] {
+            NotificationCenter.default.addObserver(forName: name, object: nil, queue: nil) { [weak self] _ in
+                self?.evacuate()
+            }
+        }
+    }
+
+    func value(
+        forThreadUniqueId threadUniqueId: String,
+        transaction: SDSAnyReadTransaction,
+        load: () -> Value?
+    ) -> Value? {
+        let writeTransaction = Self.writeTransaction(for: transaction)
+        let cachedValue: Value?? = lock.withLock {
+            if uncommittedTransaction == nil {
+                uncommittedValues.removeAll()
+            }
+            if let uncommittedValue = uncommittedValues[threadUniqueId] {
+                if let writeTransaction, writeTransaction === uncommittedTransaction {
+                    return .some(uncommittedValue)
+                }
+                // This value hasn't committed yet; read what's in the database.
+                return nil
+            }
+            return committedValues[threadUniqueId]
+        }
+        if let cachedValue {
+            return cachedValue
+        }
+        let loadGeneration = lock.withLock { generation }
+        let value = load()
+        lock.withLock {
+            guard generation == loadGeneration, uncommittedValues[threadUniqueId] == nil else {
+                return
+            }
+            if let evacuationDate, evacuationDate > transaction.startDate {
+                return
+            }
+            committedValues[threadUniqueId] = .some(value)
+        }
+        return value
+    }
+
+    func didSet(_ value: Value?, forThreadUniqueId threadUniqueId: String, transaction: SDSAnyWriteTransaction) {
+        let writeTransaction = transaction.unwrapGrdbWrite
+        lock.withLock {
+            if uncommittedTransaction !== writeTransaction {
+                // Any values left by an earlier transaction never committed.
+                uncommittedTransaction = writeTransaction
+                for threadUniqueId in uncommittedValues.keys {
+                    committedValues.removeValue(forKey: threadUniqueId)
+                }
+                uncommittedValues.removeAll()
+            }
+            uncommittedValues[threadUniqueId] = .some(value)
+            committedValues.removeValue(forKey: threadUniqueId)
+            generation += 1
+        }
+        transaction.addSyncCompletion { [weak self] in
+            self?.didCommit(threadUniqueId: threadUniqueId)
+        }
+    }
+
+    private func evacuate() {
+        lock.withLock {
+            committedValues.removeAll()
+            evacuationDate = Date()
+            generation += 1
+        }
+    }
+
+    private func didCommit(threadUniqueId: String) {
+        lock.withLock {
+            if let committedValue = uncommittedValues.removeValue(forKey: threadUniqueId) {
+                committedValues[threadUniqueId] = .some(committedValue)
+            }
+            if uncommittedValues.isEmpty {
+                uncommittedTransaction = nil
+            }
+            generation += 1
+        }
+    }
+
+    private static func writeTransaction(for transaction: SDSAnyReadTransaction) -> GRDBWriteTransaction? {
+        switch transaction.readTransaction {
+        case .grdbRead(let grdbRead):
+            return grdbRead as? GRDBWriteTransaction
+        }
+    }
+}
+
+// MARK: - Last Interaction
+
+public extension TSThread {
+
+    /// The highest `lastInteractionRowId` each thread needs once the open
+    /// write transaction finalizes. Writes are serialized, so these all
+    /// belong to the same transaction.
+    private static let pendingLastInteractionRowIds = AtomicValue<[String: UInt64]>([:], lock: .init())
+
+    private var lastInteractionRowIdFinalizationKey: String {
+        return transactionFinalizationKey + ".lastInteractionRowId"
+    }
+
+    /// Advances `lastInteractionRowId` when the transaction finalizes, so
+    /// that inserting many messages into a thread updates it only once.
+    @objc
+    func scheduleLastInteractionRowIdUpdate(_ lastInteractionRowId: UInt64, transaction: SDSAnyWriteTransaction) {
+        let threadUniqueId = self.uniqueId
+        Self.pendingLastInteractionRowIds.update {
+            $0[threadUniqueId] = max($0[threadUniqueId] ?? 0, lastInteractionRowId)
+        }
+        transaction.addTransactionFinalizationBlock(forKey: lastInteractionRowIdFinalizationKey) { transaction in
+            guard
+                let thread = TSThread.anyFetch(uniqueId: threadUniqueId, transaction: transaction)
+            else {
+                // The thread was removed.
+                _ = Self.pendingLastInteractionRowIds.update { $0.removeValue(forKey: threadUniqueId) }
+                return
+            }
+            thread.applyPendingLastInteractionRowId(transaction: transaction)
+        }
+    }
+
+    /// Applies any update scheduled with `scheduleLastInteractionRowIdUpdate`
+    /// now; call this before reading or resetting `lastInteractionRowId`
+    /// when messages may have been inserted earlier in the transaction.
+    @objc
+    func applyPendingLastInteractionRowId(transaction: SDSAnyWriteTransaction) {
+        let threadUniqueId = self.uniqueId
+        guard
+            let lastInteractionRowId = Self.pendingLastInteractionRowIds.update({ $0.removeValue(forKey: threadUniqueId) }),
+            lastInteractionRowId > self.lastInteractionRowId
+        else {
+            return
+        }
+        anyUpdate(transaction: transaction) { thread in
+            thread.lastInteractionRowId = max(thread.lastInteractionRowId, lastInteractionRowId)
+        }
+    }
+
+    private struct PendingRemovalUpdate {
+        var needsToUpdateLastInteractionRowId = false
+        var needsToUpdateLastVisibleSortId = false
+    }
+
+    /// Pointers that need to be recomputed once the open write transaction
+    /// finalizes because the interactions they referred to were removed.
+    private static let pendingRemovalUpdates = AtomicValue<[String: PendingRemovalUpdate]>([:], lock: .init())
+
+    private var removalUpdateFinalizationKey: String {
+        return transactionFinalizationKey + ".removedInteractions"
+    }
+
+    /// Recomputes `lastInteractionRowId` and/or the last visible interaction
+    /// when the transaction finalizes, so that removing many interactions from
+    /// a thread (e.g. when they expire) queries for the new values only once.
+    @objc
+    func scheduleUpdateAfterInteractionsRemoved(
+        needsToUpdateLastInteractionRowId: Bool,
+        needsToUpdateLastVisibleSortId: Bool,
+        transaction: SDSAnyWriteTransaction
+    ) {
+        let threadUniqueId = self.uniqueId
+        Self.pendingRemovalUpdates.update {
+            var pendingUpdate = $0[threadUniqueId] ?? PendingRemovalUpdate()
+            pendingUpdate.needsToUpdateLastInteractionRowId = pendingUpdate.needsToUpdateLastInteractionRowId || needsToUpdateLastInteractionRowId
+            pendingUpdate.needsToUpdateLastVisibleSortId = pendingUpdate.needsToUpdateLastVisibleSortId || needsToUpdateLastVisibleSortId
+            $0[threadUniqueId] = pendingUpdate
+        }
+        transaction.addTransactionFinalizationBlock(forKey: removalUpdateFinalizationKey) { transaction in
+            guard
+                let pendingUpdate = Self.pendingRemovalUpdates.update({ $0.removeValue(forKey: threadUniqueId) }),
+                let thread = TSThread.anyFetch(uniqueId: threadUniqueId, transaction: transaction)
+            else {
+                // The thread was removed.
+                return
+            }
+            thread.updateAfterInteractionsRemoved(pendingUpdate, transaction: transaction)
+        }
+    }
+
+    private func updateAfterInteractionsRemoved(_ pendingUpdate: PendingRemovalUpdate, transaction: SDSAnyWriteTransaction) {
+        // Messages inserted in this transaction may not be reflected yet.
+        applyPendingLastInteractionRowId(transaction: transaction)
+
+        anyUpdate(transaction: transaction) { thread in
+            if pendingUpdate.needsToUpdateLastInteractionRowId {
+                thread.lastInteractionRowId = thread.lastInteractionForInbox(transaction: transaction)?.sortId ?? 0
+            }
+        }
+
+        if pendingUpdate.needsToUpdateLastVisibleSortId, let lastVisibleInteraction = lastVisibleInteraction(transaction: transaction) {
+            if let messageBeforeDeletedMessage = firstInteraction(atOrAroundSortId: lastVisibleInteraction.sortId, transaction: transaction) {
+                setLastVisibleInteraction(sortId: messageBeforeDeletedMessage.sortId, onScreenPercentage: 1, transaction: transaction)
+            } else {
+                clearLastVisibleInteraction(transaction: transaction)
+            }
+        }
     }
 }
 
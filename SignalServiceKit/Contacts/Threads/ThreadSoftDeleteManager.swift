@@ -236,6 +236,7 @@ final class ThreadSoftDeleteManagerImpl: ThreadSoftDeleteManager {
         /// Because we skipped updating the thread for each deleted interaction,
         /// now that we're done deleting we'll do a one-time update of
         /// properties on the thread.
+        thread.applyPendingLastInteractionRowId(transaction: sdsTx)
         thread.anyUpdate(transaction: sdsTx) { thread in
             thread.lastInteractionRowId = 0
         }
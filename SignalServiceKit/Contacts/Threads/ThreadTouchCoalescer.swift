@@ -0,0 +1,108 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import Foundation
+
+/// Coalesces thread touches across write transactions.
+///
+/// A touch is already deduplicated within a transaction, but each message
+/// from a busy group usually arrives in its own transaction, and every
+/// touch re-renders the thread's row in the chat list. After a thread is
+/// touched, later touches within `coalescingInterval` are deferred and
+/// replaced by a single touch at the end of the interval.
+@objc
+final class ThreadTouchCoalescer: NSObject {
+
+    @objc
+    static let shared: ThreadTouchCoalescer = {
+        // Tests expect touches to be observed immediately.
+        let coalescingInterval: TimeInterval = CurrentAppContext().isRunningTests ? 0 : 0.5
+        return ThreadTouchCoalescer(coalescingInterval: coalescingInterval)
+    }()
+
+    private let coalescingInterval: TimeInterval
+
+    private let lock = UnfairLock()
+
+    // These properties should only be accessed with lock acquired.
+    private var lastTouchDates = [String: Date]()
+    private var deferredThreadUniqueIds = Set<String>()
+    private var isFlushScheduled = false
+
+    init(coalescingInterval: TimeInterval) {
+        self.coalescingInterval = coalescingInterval
+        super.init()
+    }
+
+    @objc
+    func touch(thread: TSThread, transaction: SDSAnyWriteTransaction) {
+        guard shouldTouchNow(threadUniqueId: thread.uniqueId, now: Date()) else {
+            scheduleFlushIfNecessary()
+            return
+        }
+        SSKEnvironment.shared.databaseStorageRef.touch(thread: thread, shouldReindex: false, transaction: transaction)
+    }
+
+    /// Returns true if the thread should be touched now. Otherwise, the
+    /// touch is deferred until the next flush.
+    func shouldTouchNow(threadUniqueId: String, now: Date) -> Bool {
+        return lock.withLock {
+            if deferredThreadUniqueIds.contains(threadUniqueId) {
+                return false
+            }
+            if let lastTouchDate = lastTouchDates[threadUniqueId], now.timeIntervalSince(lastTouchDate) < coalescingInterval {
+                deferredThreadUniqueIds.insert(threadUniqueId)
+                return false
+            }
+            lastTouchDates[threadUniqueId] = now
+            // Entries older than the interval no longer defer anything.
+            lastTouchDates = lastTouchDates.filter { now.timeIntervalSince($0.value) < coalescingInterval }
+            return true
+        }
+    }
+
+    /// Returns the deferred touches and marks them as touched at `now`.
+    func takeDeferredThreadUniqueIds(now: Date) -> Set<String> {
+        return lock.withLock {
+            let threadUniqueIds = deferredThreadUniqueIds
+            deferredThreadUniqueIds.removeAll()
+            isFlushScheduled = false
+            for threadUniqueId in threadUniqueIds {
+                lastTouchDates[threadUniqueId] = now
+            }
+            return threadUniqueIds
+        }
+    }
+
+    private func scheduleFlushIfNecessary() {
+        let shouldSchedule: Bool = lock.withLock {
+            guard !deferredThreadUniqueIds.isEmpty, !isFlushScheduled else {
+                return false
+            }
+            isFlushScheduled = true
+            return true
+        }
+        guard shouldSchedule else {
+            return
+        }
+        DispatchQueue.global().asyncAfter(deadline: .now() + coalescingInterval) { [weak self] in
+            self?.flush()
+        }
+    }
+
+    private func flush() {
+        SSKEnvironment.shared.databaseStorageRef.asyncCoalescedWrite { tx in
+            let threadUniqueIds = self.takeDeferredThreadUniqueIds(now: Date())
+            Signpost.event("FlushDeferredThreadTouches")
+            for threadUniqueId in threadUniqueIds {
+                guard let thread = TSThread.anyFetch(uniqueId: threadUniqueId, transaction: tx) else {
+                    // The thread was removed.
+                    continue
+                }
+                SSKEnvironment.shared.databaseStorageRef.touch(thread: thread, shouldReindex: false, transaction: tx)
+            }
+        }
+    }
+}
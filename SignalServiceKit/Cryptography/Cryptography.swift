@@ -401,6 +401,26 @@ public extension Cryptography {
         try decryptFile(at: encryptedUrl, metadata: metadata, output: unencryptedUrl)
     }
 
+    /// Like `decryptAttachment(at:metadata:output:)`, but also hashes the
+    /// plaintext as it is written.
+    ///
+    /// - returns: The SHA-256 digest of the plaintext.
+    static func decryptAttachmentComputingPlaintextSha256(
+        at encryptedUrl: URL,
+        metadata: EncryptionMetadata,
+        output unencryptedUrl: URL
+    ) throws -> Data {
+        // We require digests for all attachments.
+        guard let digest = metadata.digest, !digest.isEmpty else {
+            throw OWSAssertionError("Missing digest")
+        }
+        var sha256 = SHA256()
+        try decryptFile(at: encryptedUrl, metadata: metadata, output: unencryptedUrl) { plaintextDataBlock in
+            sha256.update(data: plaintextDataBlock)
+        }
+        return Data(sha256.finalize())
+    }
+
     static func decryptAttachment(
         at encryptedUrl: URL,
         metadata: EncryptionMetadata
@@ -450,7 +470,8 @@ public extension Cryptography {
     static func decryptFile(
         at encryptedUrl: URL,
         metadata: EncryptionMetadata,
-        output unencryptedUrl: URL
+        output unencryptedUrl: URL,
+        didWritePlaintext: ((_ plaintextDataBlock: Data) -> Void)? = nil
     ) throws {
         guard FileManager.default.createFile(
             atPath: unencryptedUrl.path,
@@ -469,6 +490,7 @@ public extension Cryptography {
                 outputBlockSize: UInt32(diskPageSize)
             ) { plaintextDataBlock in
                 outputFile.write(plaintextDataBlock)
+                didWritePlaintext?(plaintextDataBlock)
             }
         } catch let error {
             // In the event of any failure, we both throw *and*
@@ -171,12 +171,35 @@ public final class DebugLogger {
 
         self.fileLogger = fileLogger
         DDLog.add(fileLogger)
+        HotPathLog.setIsEnabled(true)
     }
 
     public func disableFileLogging() {
         guard let fileLogger else { return }
         DDLog.remove(fileLogger)
         self.fileLogger = nil
+        HotPathLog.setIsEnabled(false)
+    }
+
+    /// Writes this process's in-memory diagnostics (`HotPathLog` records,
+    /// release-build assertion failure counts and `PerformanceCounters`)
+    /// into text files in `dirPath`.
+    public func writeInMemoryLogs(toDirectory dirPath: String) {
+        write(HotPathLog.decodedText(), toFile: dirPath.appendingPathComponent("HotPath.log"))
+        write(OWSAssertionFailureReport(), toFile: dirPath.appendingPathComponent("AssertionFailures.log"))
+        write(PerformanceCounters.shared.report(), toFile: dirPath.appendingPathComponent("PerformanceCounters.log"))
+    }
+
+    private func write(_ text: String, toFile filePath: String) {
+        guard !text.isEmpty else {
+            return
+        }
+        do {
+            try text.write(toFile: filePath, atomically: true, encoding: .utf8)
+            OWSFileSystem.protectFileOrFolder(atPath: filePath)
+        } catch {
+            owsFailDebug("Couldn't write \((filePath as NSString).lastPathComponent): \(error)")
+        }
     }
 
     public func enableTTYLoggingIfNeeded() {
@@ -0,0 +1,203 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import Foundation
+
+/// An in-memory, binary log for high-frequency events.
+///
+/// Each thread appends fixed-size records to its own ring buffer, without
+/// allocating. A record is a timestamp, a static event string and two
+/// integers; it's only formatted as text when debug logs are collected. Use
+/// it for events that are too frequent to log with `Logger` (per-envelope,
+/// per-thumbnail, per-recipient, etc.).
+///
+/// Appending takes two locks: the one behind `isEnabled`, and the buffer's
+/// own. Only the owning thread takes a buffer's lock, except while logs are
+/// being collected, so neither is contended in practice.
+///
+/// The buffers aren't persisted, so they only cover this process's recent
+/// activity.
+public enum HotPathLog {
+
+    public enum Category: UInt8 {
+        case messageProcessing = 1
+        case thumbnails = 2
+        case sends = 3
+
+        fileprivate var name: String {
+            switch self {
+            case .messageProcessing: return "MessageProcessing"
+            case .thumbnails: return "Thumbnails"
+            case .sends: return "Sends"
+            }
+        }
+    }
+
+    /// Records are only kept while file logging is enabled.
+    private static let isEnabled = AtomicBool(false, lock: .init())
+
+    static func setIsEnabled(_ isEnabled: Bool) {
+        self.isEnabled.set(isEnabled)
+    }
+
+    public static func record(_ category: Category, _ event: StaticString, _ value0: Int64 = 0, _ value1: Int64 = 0) {
+        guard isEnabled.get() else {
+            return
+        }
+        guard event.hasPointerRepresentation else {
+            owsFailDebug("Events must be string literals.")
+            return
+        }
+        HotPathLogBuffers.shared.currentThreadBuffer().append(HotPathLogRecord(
+            sequenceNumber: 0,
+            timestamp: clock_gettime_nsec_np(CLOCK_REALTIME),
+            event: UnsafeRawPointer(event.utf8Start),
+            eventLength: UInt32(event.utf8CodeUnitCount),
+            threadId: pthread_mach_thread_np(pthread_self()),
+            category: category.rawValue,
+            value0: value0,
+            value1: value1
+        ))
+    }
+
+    /// Decodes the records from every thread, in chronological order.
+    public static func decodedText() -> String {
+        let records = HotPathLogBuffers.shared.allRecords().sorted { $0.timestamp < $1.timestamp }
+        let dateFormatter = DateFormatter()
+        dateFormatter.locale = Locale(identifier: "en_US_POSIX")
+        dateFormatter.dateFormat = "yyyy/MM/dd HH:mm:ss:SSS"
+        var lines = [String]()
+        lines.reserveCapacity(records.count)
+        for record in records {
+            guard let event = record.event, let category = Category(rawValue: record.category) else {
+                continue
+            }
+            let date = Date(timeIntervalSince1970: TimeInterval(record.timestamp) / TimeInterval(NSEC_PER_SEC))
+            let eventString = String(decoding: UnsafeRawBufferPointer(start: event, count: Int(record.eventLength)), as: UTF8.self)
+            let threadId = String(record.threadId, radix: 16)
+            lines.append("\(dateFormatter.string(from: date)) [\(category.name)] \(threadId) \(eventString): \(record.value0), \(record.value1)")
+        }
+        return lines.joined(separator: "\n")
+    }
+}
+
+// MARK: -
+
+private struct HotPathLogRecord {
+    /// Zero if the slot is empty.
+    var sequenceNumber: UInt64
+    var timestamp: UInt64
+    var event: UnsafeRawPointer?
+    var eventLength: UInt32
+    var threadId: mach_port_t
+    var category: UInt8
+    var value0: Int64
+    var value1: Int64
+}
+
+// MARK: -
+
+/// One thread's records. Only the owning thread appends to a buffer.
+private final class HotPathLogBuffer {
+    private static let capacity = 512
+
+    private let lock = UnfairLock()
+
+    // These properties should only be accessed with lock acquired.
+    private let records: UnsafeMutablePointer<HotPathLogRecord>
+    private var nextSequenceNumber: UInt64 = 1
+
+    init() {
+        records = .allocate(capacity: Self.capacity)
+        records.initialize(
+            repeating: HotPathLogRecord(
+                sequenceNumber: 0,
+                timestamp: 0,
+                event: nil,
+                eventLength: 0,
+                threadId: 0,
+                category: 0,
+                value0: 0,
+                value1: 0
+            ),
+            count: Self.capacity
+        )
+    }
+
+    deinit {
+        records.deinitialize(count: Self.capacity)
+        records.deallocate()
+    }
+
+    func append(_ record: HotPathLogRecord) {
+        lock.withLock {
+            let sequenceNumber = nextSequenceNumber
+            nextSequenceNumber += 1
+            let slot = records + Int(sequenceNumber % UInt64(Self.capacity))
+            slot.pointee = record
+            slot.pointee.sequenceNumber = sequenceNumber
+        }
+    }
+
+    func copyRecords() -> [HotPathLogRecord] {
+        return lock.withLock {
+            UnsafeBufferPointer(start: records, count: Self.capacity).filter { $0.sequenceNumber != 0 }
+        }
+    }
+}
+
+// MARK: -
+
+private final class HotPathLogBuffers {
+    static let shared = HotPathLogBuffers()
+
+    private let key: pthread_key_t
+
+    private let lock = UnfairLock()
+
+    // These properties should only be accessed with lock acquired.
+    private var allBuffers = [HotPathLogBuffer]()
+    /// Buffers of threads that have exited; they're reused (and keep their
+    /// records) so that the number of buffers is bounded by the number of
+    /// concurrent threads.
+    private var idleBuffers = [HotPathLogBuffer]()
+
+    private init() {
+        var key = pthread_key_t()
+        let result = pthread_key_create(&key) { pointer in
+            let buffer = Unmanaged<HotPathLogBuffer>.fromOpaque(pointer).takeRetainedValue()
+            HotPathLogBuffers.shared.didExitThread(buffer: buffer)
+        }
+        owsPrecondition(result == 0)
+        self.key = key
+    }
+
+    func currentThreadBuffer() -> HotPathLogBuffer {
+        if let pointer = pthread_getspecific(key) {
+            return Unmanaged<HotPathLogBuffer>.fromOpaque(pointer).takeUnretainedValue()
+        }
+        let buffer: HotPathLogBuffer = lock.withLock {
+            if let buffer = idleBuffers.popLast() {
+                return buffer
+            }
+            let buffer = HotPathLogBuffer()
+            allBuffers.append(buffer)
+            return buffer
+        }
+        pthread_setspecific(key, Unmanaged.passRetained(buffer).toOpaque())
+        return buffer
+    }
+
+    private func didExitThread(buffer: HotPathLogBuffer) {
+        lock.withLock {
+            idleBuffers.append(buffer)
+        }
+    }
+
+    func allRecords() -> [HotPathLogRecord] {
+        let buffers = lock.withLock { allBuffers }
+        return buffers.flatMap { $0.copyRecords() }
+    }
+}
@@ -0,0 +1,234 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import Foundation
+import QuartzCore
+
+/// Always-on counters for the hot paths that usually explain "the app is
+/// slow": decryption throughput, sends in flight, write transactions,
+/// thumbnail loading and the main thread's backlog.
+///
+/// Recording is a lock and a few integer operations; nothing is logged or
+/// formatted until `report()` is called (from the debug UI, or when debug
+/// logs are collected). Counters are per-process and aren't persisted.
+public final class PerformanceCounters {
+
+    public static let shared = PerformanceCounters(now: { CACurrentMediaTime() })
+
+    /// Upper bounds of the write transaction duration buckets, in
+    /// milliseconds. Longer transactions fall into a final, unbounded bucket.
+    static let writeDurationBucketLimits: [Double] = [1, 4, 16, 64, 256, 1024]
+
+    /// A count per second over the most recent `windowSeconds`.
+    private struct RateWindow {
+        static let windowSeconds = 60
+
+        private var counts = [Int](repeating: 0, count: windowSeconds)
+        private var seconds = [Int](repeating: -1, count: windowSeconds)
+
+        mutating func record(second: Int) {
+            let index = second % Self.windowSeconds
+            if seconds[index] != second {
+                seconds[index] = second
+                counts[index] = 0
+            }
+            counts[index] += 1
+        }
+
+        /// Returns the counts of the seconds in the window before (and
+        /// including) `second`.
+        func counts(endingAt second: Int) -> [Int] {
+            return zip(seconds, counts).compactMap { bucketSecond, count in
+                guard bucketSecond > second - Self.windowSeconds, bucketSecond <= second else {
+                    return nil
+                }
+                return count
+            }
+        }
+    }
+
+    private struct Gauge {
+        var current = 0
+        var peak = 0
+
+        mutating func set(_ value: Int) {
+            current = value
+            peak = max(peak, value)
+        }
+    }
+
+    private struct State {
+        var decryptionCount = 0
+        var decryptionRate = RateWindow()
+        var sendsInFlight = Gauge()
+        var writeTransactionCount = 0
+        var writeTransactionTotalDuration: TimeInterval = 0
+        var writeTransactionMaxDuration: TimeInterval = 0
+        var writeDurationBuckets = [Int](repeating: 0, count: PerformanceCounters.writeDurationBucketLimits.count + 1)
+        var thumbnailCacheHitCount = 0
+        var thumbnailCacheMissCount = 0
+        var thumbnailQueueDepth = Gauge()
+        var mainThreadBacklog = Gauge()
+    }
+
+    private let now: () -> TimeInterval
+    private let startTime: TimeInterval
+
+    private let lock = UnfairLock()
+
+    // This property should only be accessed with lock acquired.
+    private var state = State()
+
+    init(now: @escaping () -> TimeInterval) {
+        self.now = now
+        self.startTime = now()
+    }
+
+    // MARK: - Recording
+
+    public func recordDecryption() {
+        let second = Int(now() - startTime)
+        lock.withLock {
+            state.decryptionCount += 1
+            state.decryptionRate.record(second: second)
+        }
+    }
+
+    public func sendDidStart() {
+        lock.withLock {
+            state.sendsInFlight.set(state.sendsInFlight.current + 1)
+        }
+    }
+
+    public func sendDidFinish() {
+        lock.withLock {
+            owsAssertDebug(state.sendsInFlight.current > 0)
+            state.sendsInFlight.set(max(0, state.sendsInFlight.current - 1))
+        }
+    }
+
+    public func recordWriteTransaction(duration: TimeInterval) {
+        let milliseconds = duration * 1000
+        let bucket = Self.writeDurationBucketLimits.firstIndex(where: { milliseconds < $0 }) ?? Self.writeDurationBucketLimits.count
+        lock.withLock {
+            state.writeTransactionCount += 1
+            state.writeTransactionTotalDuration += duration
+            state.writeTransactionMaxDuration = max(state.writeTransactionMaxDuration, duration)
+            state.writeDurationBuckets[bucket] += 1
+        }
+    }
+
+    public func recordThumbnailCacheLookup(isHit: Bool) {
+        lock.withLock {
+            if isHit {
+                state.thumbnailCacheHitCount += 1
+            } else {
+                state.thumbnailCacheMissCount += 1
+            }
+        }
+    }
+
+    public func setThumbnailQueueDepth(_ depth: Int) {
+        lock.withLock {
+            state.thumbnailQueueDepth.set(depth)
+        }
+    }
+
+    public func setMainThreadBacklog(_ blockCount: Int) {
+        lock.withLock {
+            state.mainThreadBacklog.set(blockCount)
+        }
+    }
+
+    // MARK: - Reporting
+
+    public struct Snapshot {
+        public let decryptionCount: Int
+        /// The mean over the last minute.
+        public let decryptionsPerSecond: Double
+        /// The busiest second in the last minute.
+        public let peakDecryptionsPerSecond: Int
+        public let sendsInFlight: Int
+        public let peakSendsInFlight: Int
+        public let writeTransactionCount: Int
+        public let writeTransactionMeanDuration: TimeInterval
+        public let writeTransactionMaxDuration: TimeInterval
+        /// The counts for each of `writeDurationBucketLimits`, then the count
+        /// of longer transactions.
+        public let writeDurationBuckets: [Int]
+        public let thumbnailCacheHitCount: Int
+        public let thumbnailCacheMissCount: Int
+        public let thumbnailQueueDepth: Int
+        public let peakThumbnailQueueDepth: Int
+        public let mainThreadBacklog: Int
+        public let peakMainThreadBacklog: Int
+
+        public var thumbnailCacheHitRate: Double? {
+            let lookupCount = thumbnailCacheHitCount + thumbnailCacheMissCount
+            guard lookupCount > 0 else {
+                return nil
+            }
+            return Double(thumbnailCacheHitCount) / Double(lookupCount)
+        }
+    }
+
+    public func snapshot() -> Snapshot {
+        let second = Int(now() - startTime)
+        let state = lock.withLock { self.state }
+        let recentDecryptionCounts = state.decryptionRate.counts(endingAt: second)
+        return Snapshot(
+            decryptionCount: state.decryptionCount,
+            decryptionsPerSecond: Double(recentDecryptionCounts.reduce(0, +)) / Double(RateWindow.windowSeconds),
+            peakDecryptionsPerSecond: recentDecryptionCounts.max() ?? 0,
+            sendsInFlight: state.sendsInFlight.current,
+            peakSendsInFlight: state.sendsInFlight.peak,
+            writeTransactionCount: state.writeTransactionCount,
+            writeTransactionMeanDuration: (
+                state.writeTransactionCount > 0
+                ? state.writeTransactionTotalDuration / Double(state.writeTransactionCount)
+                : 0
+            ),
+            writeTransactionMaxDuration: state.writeTransactionMaxDuration,
+            writeDurationBuckets: state.writeDurationBuckets,
+            thumbnailCacheHitCount: state.thumbnailCacheHitCount,
+            thumbnailCacheMissCount: state.thumbnailCacheMissCount,
+            thumbnailQueueDepth: state.thumbnailQueueDepth.current,
+            peakThumbnailQueueDepth: state.thumbnailQueueDepth.peak,
+            mainThreadBacklog: state.mainThreadBacklog.current,
+            peakMainThreadBacklog: state.mainThreadBacklog.peak
+        )
+    }
+
+    public func report() -> String {
+        let snapshot = self.snapshot()
+
+        var bucketNames = Self.writeDurationBucketLimits.map { "<\(Int($0))ms" }
+        bucketNames.append(">=\(Int(Self.writeDurationBucketLimits.last!))ms")
+        let histogram = zip(bucketNames, snapshot.writeDurationBuckets).map { "\($0): \($1)" }.joined(separator: ", ")
+
+        let hitRate = snapshot.thumbnailCacheHitRate.map { String(format: "%.1f%%", $0 * 100) } ?? "n/a"
+
+        return [
+            "Counting for: \(Int(now() - startTime))s",
+            String(
+                format: "Decryptions: %d total, %.1f/s over the last minute, peak %d/s",
+                snapshot.decryptionCount,
+                snapshot.decryptionsPerSecond,
+                snapshot.peakDecryptionsPerSecond
+            ),
+            "Sends in flight: \(snapshot.sendsInFlight), peak \(snapshot.peakSendsInFlight)",
+            String(
+                format: "Write transactions: %d, mean %.2fms, max %.2fms",
+                snapshot.writeTransactionCount,
+                snapshot.writeTransactionMeanDuration * 1000,
+                snapshot.writeTransactionMaxDuration * 1000
+            ),
+            "Write transaction durations: \(histogram)",
+            "Thumbnail cache: \(snapshot.thumbnailCacheHitCount) hits, \(snapshot.thumbnailCacheMissCount) misses, hit rate \(hitRate)",
+            "Thumbnail queue depth: \(snapshot.thumbnailQueueDepth), peak \(snapshot.peakThumbnailQueueDepth)",
+            "Main thread backlog: \(snapshot.mainThreadBacklog) blocks, peak \(snapshot.peakMainThreadBacklog)",
+        ].joined(separator: "\n")
+    }
+}
@@ -0,0 +1,120 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import Foundation
+
+@objc
+public enum PipelineWatermarkStage: Int, CaseIterable {
+    case messageDecode
+    case groupModelDecode
+    case protoBuild
+
+    fileprivate var name: String {
+        switch self {
+        case .messageDecode: return "MessageDecode"
+        case .groupModelDecode: return "GroupModelDecode"
+        case .protoBuild: return "ProtoBuild"
+        }
+    }
+}
+
+/// Records the high-water marks of stack usage and memory footprint,
+/// sampled as work passes through each pipeline stage.
+///
+/// A sample is cheap: stack usage is computed from the stack pointer, and
+/// `LocalDevice` caches the memory status for a second. The marks are
+/// written to a file in this process's debug logs directory (so that they're
+/// included when debug logs are collected) shortly after they change. This
+/// shows how close each stage came to the NSE's stack and memory limits.
+@objc
+public final class PipelineWatermarks: NSObject {
+
+    @objc
+    public static let shared = PipelineWatermarks(
+        reportFilePath: { CurrentAppContext().debugLogsDirPath.appendingPathComponent("Watermarks.txt") },
+        writeDelay: 2
+    )
+
+    public struct Watermark: Equatable {
+        public fileprivate(set) var sampleCount: Int = 0
+        public fileprivate(set) var peakStackUsage: Double = 0
+        public fileprivate(set) var peakFootprint: UInt64 = 0
+    }
+
+    private let reportFilePath: () -> String
+    private let writeDelay: TimeInterval
+
+    private let lock = UnfairLock()
+
+    // These properties should only be accessed with lock acquired.
+    private var watermarks = [PipelineWatermarkStage: Watermark]()
+    private var isWriteScheduled = false
+
+    init(reportFilePath: @escaping () -> String, writeDelay: TimeInterval) {
+        self.reportFilePath = reportFilePath
+        self.writeDelay = writeDelay
+        super.init()
+    }
+
+    @objc(sampleStage:)
+    public func sample(_ stage: PipelineWatermarkStage) {
+        let stackUsage = _CurrentStackUsage()
+        let footprint = LocalDevice.currentMemoryStatus()?.footprint ?? 0
+        let shouldScheduleWrite: Bool = lock.withLock {
+            var watermark = watermarks[stage] ?? Watermark()
+            watermark.sampleCount += 1
+            var didRaiseWatermark = false
+            if stackUsage.isFinite, stackUsage > watermark.peakStackUsage {
+                watermark.peakStackUsage = stackUsage
+                didRaiseWatermark = true
+            }
+            if footprint > watermark.peakFootprint {
+                watermark.peakFootprint = footprint
+                didRaiseWatermark = true
+            }
+            watermarks[stage] = watermark
+            guard didRaiseWatermark, !isWriteScheduled else {
+                return false
+            }
+            isWriteScheduled = true
+            return true
+        }
+        if shouldScheduleWrite {
+            DispatchQueue.global(qos: .utility).asyncAfter(deadline: .now() + writeDelay) { [weak self] in
+                self?.writeReport()
+            }
+        }
+    }
+
+    public func watermark(for stage: PipelineWatermarkStage) -> Watermark? {
+        return lock.withLock { watermarks[stage] }
+    }
+
+    public func report() -> String {
+        let watermarks = lock.withLock { self.watermarks }
+        return PipelineWatermarkStage.allCases.compactMap { stage -> String? in
+            guard let watermark = watermarks[stage] else {
+                return nil
+            }
+            let stackPercent = String(format: "%.1f", watermark.peakStackUsage * 100)
+            return "\(stage.name): \(watermark.sampleCount) samples, peak stack \(stackPercent)%, peak footprint \(watermark.peakFootprint)"
+        }.joined(separator: "\n")
+    }
+
+    private func writeReport() {
+        lock.withLock {
+            isWriteScheduled = false
+        }
+        guard Preferences.isLoggingEnabled else {
+            return
+        }
+        let filePath = reportFilePath()
+        do {
+            try report().write(toFile: filePath, atomically: true, encoding: .utf8)
+        } catch {
+            owsFailDebug("Couldn't write watermarks: \(error)")
+        }
+    }
+}
@@ -144,7 +144,37 @@ public class GroupMembership: MTLModel {
 
     // MARK: Init
 
-    fileprivate var memberStates: MemberStateMap
+    /// Decoding every member of a large group is expensive, and most uses of
+    /// a fetched group (e.g. listing it in the chat list) don't look at the
+    /// members. Archived member states are therefore decoded on first use,
+    /// and full member checks use `fullMemberAciIndex` until then.
+    private let memberStatesLock = UnfairLock()
+    private var _memberStates: MemberStateMap?
+    private var encodedMemberStates: Data?
+    private let fullMemberAciIndex: GroupMemberAciIndex?
+    private var _fullMembers: Set<SignalServiceAddress>?
+
+    fileprivate var memberStates: MemberStateMap {
+        return memberStatesLock.withLock { loadMemberStates() }
+    }
+
+    /// Must be called with `memberStatesLock` acquired.
+    private func loadMemberStates() -> MemberStateMap {
+        if let memberStates = _memberStates {
+            return memberStates
+        }
+        let memberStates: MemberStateMap
+        do {
+            memberStates = try JSONDecoder().decode(MemberStateMap.self, from: encodedMemberStates ?? Data())
+        } catch {
+            owsFailDebug("Could not decode member states: \(error)")
+            memberStates = [:]
+        }
+        _memberStates = memberStates
+        encodedMemberStates = nil
+        return memberStates
+    }
+
     public fileprivate(set) var bannedMembers: BannedMembersMap
     private var invalidInviteMap: InvalidInviteMap
 
@@ -154,7 +184,8 @@ public class GroupMembership: MTLModel {
 
     @objc
     public override init() {
-        self.memberStates = [:]
+        self._memberStates = [:]
+        self.fullMemberAciIndex = nil
         self.bannedMembers = [:]
         self.invalidInviteMap = [:]
 
@@ -170,16 +201,26 @@ public class GroupMembership: MTLModel {
             self.invalidInviteMap = [:]
         }
 
-        if let memberStatesData = aDecoder.decodeObject(forKey: Self.memberStatesKey) as? Data {
+        if
+            let memberStatesData = aDecoder.decodeObject(forKey: Self.memberStatesKey) as? Data,
+            let fullMemberAciIndexData = aDecoder.decodeObject(forKey: Self.fullMemberAciIndexKey) as? Data,
+            let fullMemberAciIndex = GroupMemberAciIndex(serializedData: fullMemberAciIndexData)
+        {
+            self.encodedMemberStates = memberStatesData
+            self.fullMemberAciIndex = fullMemberAciIndex
+        } else if let memberStatesData = aDecoder.decodeObject(forKey: Self.memberStatesKey) as? Data {
+            // Archived before the index existed; decode now so it can be built.
             let decoder = JSONDecoder()
             do {
-                self.memberStates = try decoder.decode(MemberStateMap.self, from: memberStatesData)
+                self._memberStates = try decoder.decode(MemberStateMap.self, from: memberStatesData)
             } catch {
                 owsFailDebug("Could not decode member states: \(error)")
                 return nil
             }
+            self.fullMemberAciIndex = nil
         } else if let legacyMemberStateMap = aDecoder.decodeObject(forKey: Self.legacyMemberStatesKey) as? LegacyMemberStateMap {
-            self.memberStates = Self.convertLegacyMemberStateMap(legacyMemberStateMap)
+            self._memberStates = Self.convertLegacyMemberStateMap(legacyMemberStateMap)
+            self.fullMemberAciIndex = nil
         } else {
             owsFailDebug("Could not decode legacy member states.")
             return nil
@@ -201,14 +242,26 @@ public class GroupMembership: MTLModel {
     private static var legacyMemberStatesKey: String { "memberStateMap" }
     private static var bannedMembersKey: String { "bannedMembers" }
     private static var invalidInviteMapKey: String { "invalidInviteMap" }
+    private static var fullMemberAciIndexKey: String { "fullMemberAciIndex" }
 
     public override func encode(with aCoder: NSCoder) {
-        let encoder = JSONEncoder()
-        do {
-            let memberStatesData = try encoder.encode(self.memberStates)
-            aCoder.encode(memberStatesData, forKey: Self.memberStatesKey)
-        } catch {
-            owsFailDebug("Error: \(error)")
+        let (memberStates, encodedMemberStates) = memberStatesLock.withLock { (_memberStates, encodedMemberStates) }
+        if let encodedMemberStates, let fullMemberAciIndex {
+            // Still undecoded; write it back as-is.
+            aCoder.encode(encodedMemberStates, forKey: Self.memberStatesKey)
+            aCoder.encode(fullMemberAciIndex.serializedData, forKey: Self.fullMemberAciIndexKey)
+        } else {
+            let memberStates = memberStates ?? self.memberStates
+            let encoder = JSONEncoder()
+            do {
+                let memberStatesData = try encoder.encode(memberStates)
+                aCoder.encode(memberStatesData, forKey: Self.memberStatesKey)
+            } catch {
+                owsFailDebug("Error: \(error)")
+            }
+            if let fullMemberAciIndex = GroupMemberAciIndex(fullMemberAddresses: Self.fullMembers(of: memberStates)) {
+                aCoder.encode(fullMemberAciIndex.serializedData, forKey: Self.fullMemberAciIndexKey)
+            }
         }
 
         aCoder.encode(bannedMembers.mapKeys(injectiveTransform: { $0.rawUUID }), forKey: Self.bannedMembersKey)
@@ -225,7 +278,8 @@ public class GroupMembership: MTLModel {
         bannedMembers: BannedMembersMap,
         invalidInviteMap: InvalidInviteMap
     ) {
-        self.memberStates = memberStates
+        self._memberStates = memberStates
+        self.fullMemberAciIndex = nil
         self.bannedMembers = bannedMembers
         self.invalidInviteMap = invalidInviteMap
 
@@ -236,7 +290,8 @@ public class GroupMembership: MTLModel {
     init(v1Members: [SignalServiceAddress]) {
         var builder = Builder()
         builder.addFullMembers(Set(v1Members), role: .normal)
-        self.memberStates = builder.memberStates
+        self._memberStates = builder.memberStates
+        self.fullMemberAciIndex = nil
         self.bannedMembers = [:]
         self.invalidInviteMap = [:]
 
@@ -355,6 +410,15 @@ public class GroupMembership: MTLModel {
         )
     }
 
+    fileprivate static func fullMembers(of memberStates: MemberStateMap) -> Set<SignalServiceAddress> {
+        return Set(memberStates.lazy.filter { $0.value.isFullMember }.map { $0.key })
+    }
+
+    /// The index, if the member states haven't been decoded yet.
+    fileprivate var undecodedFullMemberAciIndex: GroupMemberAciIndex? {
+        return memberStatesLock.withLock { _memberStates == nil ? fullMemberAciIndex : nil }
+    }
+
     public override var debugDescription: String {
         var result = "[\n"
         for address in GroupMembership.normalize(Array(allMembersOfAnyKind)) {
@@ -372,6 +436,78 @@ public class GroupMembership: MTLModel {
     }
 }
 
+// MARK: - GroupMemberAciIndex
+
+/// The ACIs of a group's full members as sorted 16-byte UUIDs, so that they
+/// can be archived compactly and looked up with a binary search.
+struct GroupMemberAciIndex {
+    private static let uuidLength = 16
+
+    let serializedData: Data
+
+    init?(serializedData: Data) {
+        guard serializedData.count % Self.uuidLength == 0 else {
+            owsFailDebug("Invalid index length.")
+            return nil
+        }
+        self.serializedData = serializedData
+    }
+
+    /// Returns nil unless every full member has an ACI, since otherwise the
+    /// index couldn't answer every lookup.
+    init?(fullMemberAddresses: Set<SignalServiceAddress>) {
+        var uuids = [UUID]()
+        uuids.reserveCapacity(fullMemberAddresses.count)
+        for address in fullMemberAddresses {
+            guard let aci = address.serviceId as? Aci else {
+                return nil
+            }
+            uuids.append(aci.rawUUID)
+        }
+        var serializedData = Data(capacity: uuids.count * Self.uuidLength)
+        for uuid in uuids.sorted(by: { Self.compare($0.data, $1.data) < 0 }) {
+            serializedData.append(uuid.data)
+        }
+        self.serializedData = serializedData
+    }
+
+    var count: Int { serializedData.count / Self.uuidLength }
+
+    var acis: [Aci] {
+        return (0..<count).compactMap { UUID(data: uuidData(at: $0)).map { Aci(fromUUID: $0) } }
+    }
+
+    func contains(_ aci: Aci) -> Bool {
+        let needle = aci.rawUUID.data
+        var lowerBound = 0
+        var upperBound = count
+        while lowerBound < upperBound {
+            let middle = (lowerBound + upperBound) / 2
+            let comparison = Self.compare(uuidData(at: middle), needle)
+            if comparison == 0 {
+                return true
+            } else if comparison < 0 {
+                lowerBound = middle + 1
+            } else {
+                upperBound = middle
+            }
+        }
+        return false
+    }
+
+    private func uuidData(at index: Int) -> Data {
+        let start = serializedData.startIndex + index * Self.uuidLength
+        return serializedData[start..<(start + Self.uuidLength)]
+    }
+
+    private static func compare(_ lhs: Data, _ rhs: Data) -> Int {
+        for (l, r) in zip(lhs, rhs) where l != r {
+            return l < r ? -1 : 1
+        }
+        return 0
+    }
+}
+
 // MARK: - Accessors
 
 public extension GroupMembership {
@@ -381,7 +517,19 @@ public extension GroupMembership {
     }
 
     var fullMembers: Set<SignalServiceAddress> {
-        return Set(memberStates.lazy.filter { $0.value.isFullMember }.map { $0.key })
+        return memberStatesLock.withLock {
+            if let fullMembers = _fullMembers {
+                return fullMembers
+            }
+            let fullMembers: Set<SignalServiceAddress>
+            if _memberStates == nil, let fullMemberAciIndex {
+                fullMembers = Set(fullMemberAciIndex.acis.lazy.map { SignalServiceAddress($0) })
+            } else {
+                fullMembers = Self.fullMembers(of: loadMemberStates())
+            }
+            _fullMembers = fullMembers
+            return fullMembers
+        }
     }
 
     var invitedMembers: Set<SignalServiceAddress> {
@@ -458,6 +606,9 @@ public extension GroupMembership {
 
     @objc
     func isFullMember(_ address: SignalServiceAddress) -> Bool {
+        if let aci = address.serviceId as? Aci, let fullMemberAciIndex = undecodedFullMemberAciIndex {
+            return fullMemberAciIndex.contains(aci)
+        }
         guard let memberState = memberStates[address] else {
             return false
         }
@@ -465,6 +616,9 @@ public extension GroupMembership {
     }
 
     func isFullMember(_ serviceId: ServiceId) -> Bool {
+        if let aci = serviceId as? Aci, let fullMemberAciIndex = undecodedFullMemberAciIndex {
+            return fullMemberAciIndex.contains(aci)
+        }
         return isFullMember(SignalServiceAddress(serviceId))
     }
 
@@ -288,32 +288,35 @@ extension GroupUpdateInfoMessageInserterImpl {
         forGroupThread groupThread: TSGroupThread,
         withTransaction transaction: SDSAnyReadTransaction
     ) -> (first: TSInfoMessage, second: TSInfoMessage?)? {
-        var mostRecentVisibleInteraction: TSInteraction?
-        var secondMostRecentVisibleInteraction: TSInteraction?
+        var mostRecentVisibleInteractions = [InteractionFinder.InteractionProjection]()
         do {
+            // Only group updates can be folded into, and they're always plain
+            // `TSInfoMessage`s, so nothing else needs to be deserialized.
             try InteractionFinder(threadUniqueId: groupThread.uniqueId)
-                .enumerateInteractionsForConversationView(
+                .enumerateInteractionProjectionsForConversationView(
                     rowIdFilter: .newest,
                     tx: transaction
-                ) { interaction -> Bool in
-                    if mostRecentVisibleInteraction == nil {
-                        mostRecentVisibleInteraction = interaction
-                    } else if secondMostRecentVisibleInteraction == nil {
-                        secondMostRecentVisibleInteraction = interaction
-                        return false
-                    }
-                    return true
+                ) { projection -> Bool in
+                    mostRecentVisibleInteractions.append(projection)
+                    return mostRecentVisibleInteractions.count < 2
                 }
         } catch let error {
             Logger.warn("Failed to get most recent interactions for thread: \(error.localizedDescription)")
             return nil
         }
 
-        guard let mostRecentInfoMessage = mostRecentVisibleInteraction as? TSInfoMessage else {
+        func fetchInfoMessage(_ projection: InteractionFinder.InteractionProjection?) -> TSInfoMessage? {
+            guard let projection, projection.recordType == .infoMessage else {
+                return nil
+            }
+            return projection.fetchInteraction(tx: transaction) as? TSInfoMessage
+        }
+
+        guard let mostRecentInfoMessage = fetchInfoMessage(mostRecentVisibleInteractions.first) else {
             return nil
         }
 
-        guard let secondMostRecentInfoMessage = secondMostRecentVisibleInteraction as? TSInfoMessage else {
+        guard let secondMostRecentInfoMessage = fetchInfoMessage(mostRecentVisibleInteractions.dropFirst().first) else {
             return (mostRecentInfoMessage, nil)
         }
 
@@ -273,6 +273,7 @@ public class GroupsV2Protos {
     public class func parse(groupProto: GroupsProtoGroup,
                             downloadedAvatars: GroupV2DownloadedAvatars,
                             groupV2Params: GroupV2Params) throws -> GroupV2Snapshot {
+        defer { PipelineWatermarks.shared.sample(.groupModelDecode) }
 
         let title = groupV2Params.decryptGroupName(groupProto.title) ?? ""
         let descriptionText = groupV2Params.decryptGroupDescription(groupProto.descriptionBytes)
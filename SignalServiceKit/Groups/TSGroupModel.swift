@@ -271,8 +271,19 @@ public extension TSGroupModel {
 public extension TSGroupModel {
     private static let appSharedDataDirectory = URL(fileURLWithPath: OWSFileSystem.appSharedDataDirectoryPath())
     static let avatarsDirectory = URL(fileURLWithPath: "GroupAvatars", isDirectory: true, relativeTo: appSharedDataDirectory)
+    // Avatars are stored by hash, so neither cache ever goes stale.
     @nonobjc
-    private static let avatarsCache = LRUCache<String, Data>(maxSize: 16, nseMaxSize: 0)
+    private static let avatarsCache: LRUCache<String, Data> = {
+        let avatarsCache = LRUCache<String, Data>(maxSize: 16, nseMaxSize: 0)
+        CacheCoordinator.shared.register(name: "Group avatars", priority: .media, purge: avatarsCache.clear)
+        return avatarsCache
+    }()
+    @nonobjc
+    private static let avatarImagesCache: LRUCache<String, UIImage> = {
+        let avatarImagesCache = LRUCache<String, UIImage>(maxSize: 16, nseMaxSize: 0)
+        CacheCoordinator.shared.register(name: "Group avatar images", priority: .media, purge: avatarImagesCache.clear)
+        return avatarImagesCache
+    }()
 
     func attemptToMigrateLegacyAvatarDataToDisk() throws {
         guard let legacyAvatarData = legacyAvatarData, !legacyAvatarData.isEmpty else {
@@ -329,12 +340,12 @@ public extension TSGroupModel {
     }
 
     var avatarData: Data? {
-        if let avatarHash = avatarHash, let cachedData = Self.avatarsCache.object(forKey: avatarHash) {
+        guard let avatarHash else { return nil }
+        if let cachedData = Self.avatarsCache.object(forKey: avatarHash) {
             return cachedData
         }
 
-        guard let fileName = avatarFileName else { return nil }
-        let filePath = URL(fileURLWithPath: fileName, relativeTo: Self.avatarsDirectory)
+        let filePath = Self.avatarFilePath(forHash: avatarHash)
 
         let avatarData: Data
         do {
@@ -349,14 +360,22 @@ public extension TSGroupModel {
             return nil
         }
 
+        Self.avatarsCache.set(key: avatarHash, value: avatarData)
         return avatarData
     }
 
     var avatarImage: UIImage? {
-        guard let avatarData = avatarData else {
+        guard let avatarHash else { return nil }
+        if let cachedImage = Self.avatarImagesCache.object(forKey: avatarHash) {
+            return cachedImage
+        }
+
+        guard let avatarData, let avatarImage = UIImage(data: avatarData) else {
             return nil
         }
-        return UIImage(data: avatarData)
+
+        Self.avatarImagesCache.set(key: avatarHash, value: avatarImage)
+        return avatarImage
     }
 
     var avatarFileName: String? {
@@ -214,16 +214,14 @@ private class BulkDeleteInteractionJobRunner: JobRunner {
 
         if interactionsToDelete.isEmpty { return 0 }
 
-        for interaction in interactionsToDelete {
-            interactionDeleteManager.delete(
-                interaction,
-                sideEffects: .custom(
-                    associatedCallDelete: .localDeleteOnly,
-                    updateThreadOnInteractionDelete: .doNotUpdate
-                ),
-                tx: tx
-            )
-        }
+        interactionDeleteManager.delete(
+            interactions: interactionsToDelete,
+            sideEffects: .custom(
+                associatedCallDelete: .localDeleteOnly,
+                updateThreadOnInteractionDelete: .doNotUpdate
+            ),
+            tx: tx
+        )
 
         /// Above, we're skipping a per-interaction thread update that would
         /// otherwise set various "last visible" properties on the thread. To
@@ -251,9 +249,6 @@ private class BulkDeleteInteractionJobRunner: JobRunner {
     }
 }
 
-private extension InteractionFinder {
-}
-
 // MARK: -
 
 private class BulkDeleteInteractionJobRunnerFactory: JobRunnerFactory {
@@ -63,6 +63,11 @@ public protocol JobQueue: DurableOperationDelegate {
     func operationQueue(jobRecord: JobRecordType) -> OperationQueue
     func buildOperation(jobRecord: JobRecordType, transaction: SDSAnyReadTransaction) throws -> DurableOperationType
 
+    /// Returns the ready job to start next.
+    ///
+    /// By default, jobs start in the order they were enqueued.
+    func nextReadyJob(transaction: SDSAnyWriteTransaction) throws -> JobRecordType?
+
     /// When `requiresInternet` is true, we immediately run any jobs which are waiting for retry upon detecting Reachability.
     ///
     /// Because `Reachability` isn't 100% reliable, the jobs will be attempted regardless of what we think our current Reachability is.
@@ -142,11 +147,15 @@ public extension JobQueue {
         SSKEnvironment.shared.databaseStorageRef.write { self.workStep(transaction: $0) }
     }
 
+    func nextReadyJob(transaction: SDSAnyWriteTransaction) throws -> JobRecordType? {
+        return try JobRecordFinderImpl(db: DependenciesBridge.shared.db).getNextReady(transaction: transaction.asV2Write)
+    }
+
     func workStep(transaction: SDSAnyWriteTransaction) {
         let nextJob: JobRecordType?
 
         do {
-            nextJob = try JobRecordFinderImpl(db: DependenciesBridge.shared.db).getNextReady(transaction: transaction.asV2Write)
+            nextJob = try nextReadyJob(transaction: transaction)
         } catch let error {
             Logger.error("Couldn't start next job: \(error)")
             return
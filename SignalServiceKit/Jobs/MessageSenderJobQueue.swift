@@ -26,6 +26,8 @@ public class MessageSenderJobQueue: NSObject, JobQueue {
 
     private let appReadiness: AppReadiness
 
+    private let scheduler = MessageSenderJobScheduler()
+
     public init(appReadiness: AppReadiness) {
         self.appReadiness = appReadiness
         super.init()
@@ -91,6 +93,7 @@ public class MessageSenderJobQueue: NSObject, JobQueue {
             jobRecord.flagAsExclusiveForCurrentProcessIdentifier()
         }
         self.add(jobRecord: jobRecord, appReadiness: appReadiness, transaction: transaction)
+        scheduler.didAdd(jobRecord)
         if let future {
             jobFutures[jobRecord.uniqueId] = future
         }
@@ -132,6 +135,13 @@ public class MessageSenderJobQueue: NSObject, JobQueue {
             .updateAllUnsentRecipientsAsSending(transaction: transaction)
     }
 
+    public func nextReadyJob(transaction: SDSAnyWriteTransaction) throws -> MessageSenderJobRecord? {
+        return try scheduler.nextReadyJob(
+            finder: JobRecordFinderImpl(db: DependenciesBridge.shared.db),
+            transaction: transaction
+        )
+    }
+
     public func buildOperation(jobRecord: MessageSenderJobRecord,
                                transaction: SDSAnyReadTransaction) throws -> MessageSenderOperation {
         guard let message = PreparedOutgoingMessage.restore(from: jobRecord, tx: transaction) else {
@@ -0,0 +1,180 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import Foundation
+
+/// Chooses which ready `MessageSenderJobRecord` the job queue starts next.
+///
+/// Jobs are started one per write transaction, so after reconnecting with
+/// hundreds of receipts and sync messages queued, a message the user just
+/// typed would otherwise wait for all of them to be started first. Instead,
+/// jobs are started by urgency: user-visible messages, then receipts and
+/// syncs, then other background traffic.
+///
+/// Two rules keep this safe and fair:
+/// - A job never starts before an earlier job for the same thread, so each
+///   thread's messages are still sent in the order they were enqueued.
+/// - After `maxConsecutivePreemptions` jobs have started ahead of the oldest
+///   ready job, the oldest starts next.
+final class MessageSenderJobScheduler {
+
+    enum SendClass: Int, Comparable {
+        case userVisible
+        case receiptsAndSyncs
+        case background
+
+        static func < (lhs: Self, rhs: Self) -> Bool { lhs.rawValue < rhs.rawValue }
+    }
+
+    struct Candidate {
+        /// Jobs with the same key run in order on the same serial queue.
+        let orderingKey: String
+        let sendClass: SendClass
+    }
+
+    private struct BacklogEntry {
+        let rowId: JobRecord.RowId
+        let candidate: Candidate
+    }
+
+    /// Bounds the cost of loading the backlog.
+    private static let maxBacklogCount = 256
+
+    static let maxConsecutivePreemptions = 8
+
+    private let lock = UnfairLock()
+
+    // These properties should only be accessed with lock acquired.
+
+    /// Ready jobs in the order they were enqueued, or nil if they need to be
+    /// loaded from the database.
+    private var backlog: [BacklogEntry]?
+    /// Whether there may be ready jobs that aren't in `backlog`.
+    private var isBacklogTruncated = false
+    private var consecutivePreemptions = 0
+
+    init() {}
+
+    static func sendClass(for jobRecord: MessageSenderJobRecord) -> SendClass {
+        if jobRecord.isHighPriority {
+            return .userVisible
+        }
+        switch jobRecord.messageType {
+        case .persisted, .editMessage, .none:
+            return .userVisible
+        case .transient(let message):
+            if message is OWSOutgoingSyncMessage || message is OWSReceiptsForSenderMessage {
+                return .receiptsAndSyncs
+            }
+            return message.isUrgent ? .userVisible : .background
+        }
+    }
+
+    private static func candidate(for jobRecord: MessageSenderJobRecord) -> Candidate {
+        return Candidate(orderingKey: jobRecord.threadId ?? "", sendClass: sendClass(for: jobRecord))
+    }
+
+    /// Returns the index of the candidate to start next.
+    ///
+    /// - Parameter candidates: Ready jobs in the order they were enqueued.
+    static func nextIndex(in candidates: [Candidate], consecutivePreemptions: Int) -> Int? {
+        guard !candidates.isEmpty else {
+            return nil
+        }
+        guard consecutivePreemptions < maxConsecutivePreemptions else {
+            return 0
+        }
+        var seenOrderingKeys = Set<String>()
+        var bestIndex: Int?
+        for (index, candidate) in candidates.enumerated() {
+            // Only the first job for each thread can start.
+            guard seenOrderingKeys.insert(candidate.orderingKey).inserted else {
+                continue
+            }
+            if let bestIndex, candidates[bestIndex].sendClass <= candidate.sendClass {
+                continue
+            }
+            bestIndex = index
+            if candidate.sendClass == .userVisible {
+                break
+            }
+        }
+        return bestIndex
+    }
+
+    /// Note a newly-enqueued job.
+    func didAdd(_ jobRecord: MessageSenderJobRecord) {
+        guard let rowId = jobRecord.id else {
+            owsFailDebug("Missing rowId.")
+            return
+        }
+        let candidate = Self.candidate(for: jobRecord)
+        lock.withLock {
+            guard backlog != nil else {
+                return
+            }
+            if isBacklogTruncated {
+                // Jobs not yet loaded must stay ahead of this one; reload now
+                // only if it's worth jumping the queue for.
+                if candidate.sendClass == .userVisible {
+                    backlog = nil
+                }
+            } else {
+                backlog?.append(BacklogEntry(rowId: rowId, candidate: candidate))
+            }
+        }
+    }
+
+    func nextReadyJob(
+        finder: JobRecordFinderImpl<MessageSenderJobRecord>,
+        transaction: SDSAnyWriteTransaction
+    ) throws -> MessageSenderJobRecord? {
+        return try lock.withLock {
+            while true {
+                if backlog?.isEmpty != false {
+                    try loadBacklog(finder: finder, transaction: transaction)
+                }
+                guard
+                    let backlog,
+                    let index = Self.nextIndex(in: backlog.map(\.candidate), consecutivePreemptions: consecutivePreemptions)
+                else {
+                    return nil
+                }
+                let entry = self.backlog!.remove(at: index)
+                consecutivePreemptions = (index == 0) ? 0 : consecutivePreemptions + 1
+
+                // The backlog may be stale; only start jobs that are still ready.
+                if
+                    let jobRecord = try finder.fetchJob(rowId: entry.rowId, tx: transaction.asV2Read),
+                    jobRecord.status == .ready,
+                    jobRecord.canBeRunByCurrentProcess
+                {
+                    return jobRecord
+                }
+            }
+        }
+    }
+
+    private func loadBacklog(
+        finder: JobRecordFinderImpl<MessageSenderJobRecord>,
+        transaction: SDSAnyWriteTransaction
+    ) throws {
+        var loadedBacklog = [BacklogEntry]()
+        var isTruncated = false
+        try finder.enumerateJobRecords(status: .ready, transaction: transaction.asV2Read) { jobRecord, stop in
+            guard jobRecord.canBeRunByCurrentProcess, let rowId = jobRecord.id else {
+                return
+            }
+            guard loadedBacklog.count < Self.maxBacklogCount else {
+                isTruncated = true
+                stop = true
+                return
+            }
+            loadedBacklog.append(BacklogEntry(rowId: rowId, candidate: Self.candidate(for: jobRecord)))
+        }
+        backlog = loadedBacklog
+        isBacklogTruncated = isTruncated
+    }
+}
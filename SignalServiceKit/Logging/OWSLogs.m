@@ -4,21 +4,65 @@
 //
 
 #import "OWSLogs.h"
+#import <os/lock.h>
 
 NS_ASSUME_NONNULL_BEGIN
 
+static os_unfair_lock callSiteStringsLock = OS_UNFAIR_LOCK_INIT;
+
+/// `__FILE__` and `__PRETTY_FUNCTION__` are string literals, so each call
+/// site passes the same pointer every time. Their NSString forms are cached
+/// by pointer so that logging a line doesn't allocate (or trim) them again.
+static NSMapTable *CallSiteStrings(BOOL isTrimmedFilePath)
+{
+    static NSMapTable *trimmedFilePaths;
+    static NSMapTable *untrimmedStrings;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSPointerFunctionsOptions keyOptions
+            = NSPointerFunctionsOpaqueMemory | NSPointerFunctionsOpaquePersonality;
+        trimmedFilePaths = [[NSMapTable alloc] initWithKeyOptions:keyOptions
+                                                     valueOptions:NSPointerFunctionsStrongMemory
+                                                         capacity:256];
+        untrimmedStrings = [[NSMapTable alloc] initWithKeyOptions:keyOptions
+                                                     valueOptions:NSPointerFunctionsStrongMemory
+                                                         capacity:256];
+    });
+    return isTrimmedFilePath ? trimmedFilePaths : untrimmedStrings;
+}
+
+static NSString *CallSiteString(const char *cString, BOOL shouldTrimFilePath)
+{
+    NSMapTable *strings = CallSiteStrings(shouldTrimFilePath);
+    const void *key = (const void *)cString;
+
+    os_unfair_lock_lock(&callSiteStringsLock);
+    NSString *_Nullable result = (__bridge NSString *)NSMapGet(strings, key);
+    os_unfair_lock_unlock(&callSiteStringsLock);
+    if (result != nil) {
+        return result;
+    }
+
+    NSString *string = @(cString);
+    string = shouldTrimFilePath ? string.lastPathComponent : string;
+
+    os_unfair_lock_lock(&callSiteStringsLock);
+    NSMapInsertIfAbsent(strings, key, (__bridge void *)string);
+    result = (__bridge NSString *)NSMapGet(strings, key);
+    os_unfair_lock_unlock(&callSiteStringsLock);
+    return result;
+}
+
 static void logUnconditionally(
     DDLogFlag flag, const char *file, BOOL shouldTrimFilePath, NSUInteger line, const char *function, NSString *message)
 {
     OWSCPrecondition(ShouldLogFlag(flag));
-    NSString *fileObj = [NSString stringWithFormat:@"%s", file];
-    fileObj = shouldTrimFilePath ? fileObj.lastPathComponent : fileObj;
     DDLogMessage *logMessage = [[DDLogMessage alloc] initWithMessage:message
                                                                level:ddLogLevel
                                                                 flag:flag
                                                              context:0
-                                                                file:fileObj
-                                                            function:[NSString stringWithFormat:@"%s", function]
+                                                                file:CallSiteString(file, shouldTrimFilePath)
+                                                            function:CallSiteString(function, NO)
                                                                 line:line
                                                                  tag:nil
                                                              options:0
@@ -34,6 +78,8 @@ void OWSLogUnconditionally(DDLogFlag flag,
     NSString *format,
     ...)
 {
+    // The message is formatted here, not on the logging queue: the arguments
+    // (and any objects they point to) are only valid for the caller's frame.
     va_list args;
     va_start(args, format);
     NSString *message = [[NSString alloc] initWithFormat:format arguments:args];
@@ -0,0 +1,56 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+#import <os/signpost.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+// Signposts mark intervals and events in Instruments' "Points of Interest"
+// track. Unless Instruments is recording, each macro costs a single check.
+// Define OWS_SIGNPOSTS_ENABLED as 0 to compile them out entirely.
+#ifndef OWS_SIGNPOSTS_ENABLED
+#define OWS_SIGNPOSTS_ENABLED 1
+#endif
+
+/// The log used by `OWSSignpost` macros and `Signpost`.
+os_log_t OWSSignpostLog(void);
+
+#if OWS_SIGNPOSTS_ENABLED
+
+/// Begins an interval and returns its `os_signpost_id_t`, which must be
+/// passed to `OWSSignpostIntervalEnd` with the same (literal) name.
+#define OWSSignpostIntervalBegin(name)                                                                                 \
+    ({                                                                                                                 \
+        os_log_t _owsSignpostLog = OWSSignpostLog();                                                                   \
+        os_signpost_id_t _owsSignpostID = OS_SIGNPOST_ID_NULL;                                                         \
+        if (os_signpost_enabled(_owsSignpostLog)) {                                                                    \
+            _owsSignpostID = os_signpost_id_generate(_owsSignpostLog);                                                 \
+            os_signpost_interval_begin(_owsSignpostLog, _owsSignpostID, name);                                         \
+        }                                                                                                              \
+        _owsSignpostID;                                                                                                \
+    })
+
+#define OWSSignpostIntervalEnd(name, signpostID)                                                                       \
+    do {                                                                                                               \
+        if ((signpostID) != OS_SIGNPOST_ID_NULL)                                                                       \
+            os_signpost_interval_end(OWSSignpostLog(), (signpostID), name);                                            \
+    } while (0)
+
+#define OWSSignpostEvent(name) os_signpost_event_emit(OWSSignpostLog(), OS_SIGNPOST_ID_EXCLUSIVE, name)
+
+#else
+
+#define OWSSignpostIntervalBegin(name) OS_SIGNPOST_ID_NULL
+#define OWSSignpostIntervalEnd(name, signpostID)                                                                       \
+    do {                                                                                                               \
+        (void)(signpostID);                                                                                            \
+    } while (0)
+#define OWSSignpostEvent(name)                                                                                         \
+    do {                                                                                                               \
+    } while (0)
+
+#endif
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,18 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+#import "OWSSignpost.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+os_log_t OWSSignpostLog(void)
+{
+    static os_log_t log;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{ log = os_log_create("org.signal.SignalServiceKit", OS_LOG_CATEGORY_POINTS_OF_INTEREST); });
+    return log;
+}
+
+NS_ASSUME_NONNULL_END
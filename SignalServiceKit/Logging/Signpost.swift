@@ -0,0 +1,30 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import Foundation
+import os
+
+/// The Swift counterpart of the `OWSSignpost` macros.
+public enum Signpost {
+    /// Marks `block` as an interval named `name`.
+    public static func interval<T>(_ name: StaticString, block: () throws -> T) rethrows -> T {
+        let log = OWSSignpostLog()
+        guard log.signpostsEnabled else {
+            return try block()
+        }
+        let signpostID = OSSignpostID(log: log)
+        os_signpost(.begin, log: log, name: name, signpostID: signpostID)
+        defer { os_signpost(.end, log: log, name: name, signpostID: signpostID) }
+        return try block()
+    }
+
+    public static func event(_ name: StaticString) {
+        let log = OWSSignpostLog()
+        guard log.signpostsEnabled else {
+            return
+        }
+        os_signpost(.event, log: log, name: name)
+    }
+}
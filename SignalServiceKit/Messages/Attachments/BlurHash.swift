@@ -58,16 +58,42 @@ public class BlurHash: NSObject {
     // these thumbnails.
     private static let kDefaultSize: CGFloat = 16
 
+    // Every undownloaded attachment shows its blurHash, and cells (and
+    // story thumbnails) are rebuilt often, so decoded images are cached.
+    private static let imageCache: LRUCache<String, UIImage> = {
+        let imageCache = LRUCache<String, UIImage>(maxSize: 256, nseMaxSize: 0)
+        CacheCoordinator.shared.register(name: "BlurHash", priority: .placeholder, purge: imageCache.clear)
+        return imageCache
+    }()
+
+    private static let prewarmQueue = DispatchQueue(label: "org.signal.blurhash-prewarm", qos: .utility)
+
     @objc(imageForBlurHash:)
     public class func image(for blurHash: String) -> UIImage? {
         let thumbnailSize = imageSize(for: blurHash)
+        let cacheKey = "\(blurHash)-\(Int(thumbnailSize.width))x\(Int(thumbnailSize.height))"
+        if let image = imageCache.get(key: cacheKey) {
+            return image
+        }
         guard let image = UIImage(blurHash: blurHash, size: thumbnailSize) else {
             owsFailDebug("Couldn't generate image for blurHash.")
             return nil
         }
+        imageCache.set(key: cacheKey, value: image)
         return image
     }
 
+    /// Decodes the image for `blurHash` into the cache, off the main thread,
+    /// so that the first view to show it doesn't have to.
+    public class func prewarmImage(for blurHash: String) {
+        guard CurrentAppContext().isMainApp, isValidBlurHash(blurHash) else {
+            return
+        }
+        prewarmQueue.async {
+            _ = image(for: blurHash)
+        }
+    }
+
     private class func imageSize(for blurHash: String) -> CGSize {
         return CGSize(width: kDefaultSize, height: kDefaultSize)
     }
@@ -33,7 +33,7 @@ public class OWSMediaUtils: NSObject {
         return result
     }
 
-    private class func thumbnail(forImage image: UIImage, maxDimensionPoints: CGFloat) throws -> UIImage {
+    public class func thumbnail(forImage image: UIImage, maxDimensionPoints: CGFloat) throws -> UIImage {
         let scale = UIScreen.main.scale
         let maxDimensionPixels = maxDimensionPoints * scale
         return try thumbnail(forImage: image, maxDimensionPixels: maxDimensionPixels)
@@ -67,6 +67,32 @@ public class OWSMediaUtils: NSObject {
         return try thumbnail(forImage: originalImage, maxDimensionPoints: maxDimensionPoints)
     }
 
+    /// Decodes the image at `path` directly at (at most) `maxDimensionPixels` using ImageIO,
+    /// so the full-resolution bitmap is never materialized.
+    @objc
+    public class func downsampledImage(atPath path: String, maxDimensionPixels: CGFloat) throws -> UIImage {
+        guard FileManager.default.fileExists(atPath: path) else {
+            throw OWSMediaError.failure(description: "Media file missing.")
+        }
+        guard Data.ows_isValidImage(atPath: path) else {
+            throw OWSMediaError.failure(description: "Invalid image.")
+        }
+        let sourceOptions = [kCGImageSourceShouldCache: false] as CFDictionary
+        guard let imageSource = CGImageSourceCreateWithURL(URL(fileURLWithPath: path) as CFURL, sourceOptions) else {
+            throw OWSMediaError.failure(description: "Could not create image source.")
+        }
+        let downsampleOptions = [
+            kCGImageSourceCreateThumbnailFromImageAlways: true,
+            kCGImageSourceShouldCacheImmediately: true,
+            kCGImageSourceCreateThumbnailWithTransform: true,
+            kCGImageSourceThumbnailMaxPixelSize: max(1, maxDimensionPixels)
+        ] as [CFString: Any] as CFDictionary
+        guard let cgImage = CGImageSourceCreateThumbnailAtIndex(imageSource, 0, downsampleOptions) else {
+            throw OWSMediaError.failure(description: "Could not downsample image.")
+        }
+        return UIImage(cgImage: cgImage, scale: UIScreen.main.scale, orientation: .up)
+    }
+
     @objc
     public class func thumbnail(forImageData imageData: Data, maxDimensionPoints: CGFloat) throws -> UIImage {
         guard imageData.ows_isValidImage else {
@@ -224,6 +250,22 @@ public class OWSMediaUtils: NSObject {
         return maxTrackSize
     }
 
+    /// The size at which the video is displayed, in pixels.
+    ///
+    /// This is read from the tracks' natural size and preferred transform, so no
+    /// frame is decoded.
+    @objc
+    public class func videoDisplaySizePixels(forVideoAtPath path: String) -> CGSize {
+        var maxTrackSize = CGSize.zero
+        let asset = AVURLAsset(url: URL(fileURLWithPath: path))
+        for track: AVAssetTrack in asset.tracks(withMediaType: .video) {
+            let trackSize = track.naturalSize.applying(track.preferredTransform)
+            maxTrackSize.width = max(maxTrackSize.width, abs(trackSize.width))
+            maxTrackSize.height = max(maxTrackSize.height, abs(trackSize.height))
+        }
+        return maxTrackSize
+    }
+
     // MARK: Constants
 
     /**
@@ -148,7 +148,6 @@ NS_DESIGNATED_INITIALIZER NS_SWIFT_NAME(init(grdbId:uniqueId:albumMessageId:atta
 
 // --- CODE GENERATION MARKER
 
-- (void)upgradeAttachmentSchemaVersionIfNecessary;
 - (void)upgradeFromAttachmentSchemaVersion:(NSUInteger)attachmentSchemaVersion;
 
 - (TSAnimatedMimeType)getAnimatedMimeType;
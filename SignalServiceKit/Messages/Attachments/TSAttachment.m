@@ -266,27 +266,6 @@ NSUInteger const TSAttachmentSchemaVersion = 1;
     }
 }
 
-- (void)upgradeAttachmentSchemaVersionIfNecessary
-{
-    if (self.attachmentSchemaVersion < TSAttachmentSchemaVersion) {
-        // Apply the schema update to the local copy
-        [self upgradeFromAttachmentSchemaVersion:self.attachmentSchemaVersion];
-        self.attachmentSchemaVersion = TSAttachmentSchemaVersion;
-
-        // Async save the schema update in the database
-        DatabaseStorageAsyncWrite(SSKEnvironment.shared.databaseStorageRef, ^(SDSAnyWriteTransaction *transaction) {
-            TSAttachment *_Nullable latestInstance = [TSAttachment anyFetchWithUniqueId:self.uniqueId
-                                                                            transaction:transaction];
-            if (latestInstance == nil) {
-                return;
-            }
-            [latestInstance upgradeFromAttachmentSchemaVersion:latestInstance.attachmentSchemaVersion];
-            latestInstance.attachmentSchemaVersion = TSAttachmentSchemaVersion;
-            [latestInstance anyUpsertWithTransaction:transaction];
-        });
-    }
-}
-
 - (void)upgradeFromAttachmentSchemaVersion:(NSUInteger)attachmentSchemaVersion
 {
     // This method is overridden by the base classes TSAttachmentPointer and
@@ -498,6 +477,7 @@ NSUInteger const TSAttachmentSchemaVersion = 1;
 
     [SSKEnvironment.shared.modelReadCachesRef.attachmentReadCache didInsertOrUpdateAttachment:self
                                                                                   transaction:transaction];
+    [PreviewTextCache.shared didUpdateWithUniqueId:self.uniqueId transaction:transaction];
 }
 
 - (void)anyDidRemoveWithTransaction:(SDSAnyWriteTransaction *)transaction
@@ -505,6 +485,7 @@ NSUInteger const TSAttachmentSchemaVersion = 1;
     [super anyDidRemoveWithTransaction:transaction];
 
     [SSKEnvironment.shared.modelReadCachesRef.attachmentReadCache didRemoveAttachment:self transaction:transaction];
+    [PreviewTextCache.shared didUpdateWithUniqueId:self.uniqueId transaction:transaction];
 }
 
 - (void)setDefaultContentType:(NSString *)contentType
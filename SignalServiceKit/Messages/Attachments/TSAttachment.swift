@@ -66,19 +66,34 @@ public extension TSAttachmentStream {
     }
 
     func thumbnailImageSmall(success: @escaping OWSThumbnailSuccess, failure: @escaping OWSThumbnailFailure) {
-        thumbnailImage(quality: .small, success: success, failure: failure)
+        thumbnailImageCallingBack(quality: .small, success: success, failure: failure)
     }
 
     func thumbnailImageMedium(success: @escaping OWSThumbnailSuccess, failure: @escaping OWSThumbnailFailure) {
-        thumbnailImage(quality: .medium, success: success, failure: failure)
+        thumbnailImageCallingBack(quality: .medium, success: success, failure: failure)
     }
 
     func thumbnailImageMediumLarge(success: @escaping OWSThumbnailSuccess, failure: @escaping OWSThumbnailFailure) {
-        thumbnailImage(quality: .mediumLarge, success: success, failure: failure)
+        thumbnailImageCallingBack(quality: .mediumLarge, success: success, failure: failure)
     }
 
     func thumbnailImageLarge(success: @escaping OWSThumbnailSuccess, failure: @escaping OWSThumbnailFailure) {
-        thumbnailImage(quality: .large, success: success, failure: failure)
+        thumbnailImageCallingBack(quality: .large, success: success, failure: failure)
+    }
+
+    /// Unlike `thumbnailImage(quality:success:failure:)`, invokes `success`
+    /// on a cache hit too. Either way exactly one block is invoked, async on
+    /// main, so callers never see it run before they return.
+    private func thumbnailImageCallingBack(
+        quality: TSAttachmentThumbnailQuality,
+        success: @escaping OWSThumbnailSuccess,
+        failure: @escaping OWSThumbnailFailure
+    ) {
+        if let cachedImage = thumbnailImage(quality: quality, success: success, failure: failure) {
+            DispatchQueue.main.async {
+                success(cachedImage)
+            }
+        }
     }
 
     func thumbnailImageSmallSync() -> UIImage? {
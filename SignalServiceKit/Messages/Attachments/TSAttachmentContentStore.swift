@@ -0,0 +1,242 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import CryptoKit
+import Foundation
+
+/// Stores identical legacy attachment plaintext once on disk.
+///
+/// Each distinct plaintext has one entry in the store, named by its SHA-256.
+/// Attachment streams' files are hard links to that entry, so the file
+/// system's link count is the reference count: removing a stream's file
+/// (`removeFile`) drops one reference and never affects other streams. When
+/// a removal leaves an entry linked only by the store, that entry is deleted.
+///
+/// Attachment files are replaced (by atomic writes) or unlinked, never
+/// written in place. Shared files are made read-only so that a writer which
+/// breaks that rule fails instead of changing every stream that shares the
+/// inode, which also keeps memory-mapped reads of shared files safe.
+@objc
+public class TSAttachmentContentStore: NSObject {
+
+    @objc(shared)
+    public static let shared = TSAttachmentContentStore()
+
+    /// Small files aren't worth the inode bookkeeping.
+    private static let minimumByteCount: UInt64 = 64 * 1024
+
+    /// Each entry's inode carries its digest, so whichever link is removed
+    /// leads back to the entry without listing the store.
+    private static let sha256DigestAttributeName = "org.signal.content-store.sha256"
+
+    private static let sharedFilePermissions = 0o444
+
+    /// Linking and sweeping share this queue, so they never race each other
+    /// within a process, and stay off the download and send paths.
+    private let serialQueue = DispatchQueue(label: "org.signal.attachment-content-store", qos: .utility)
+
+    private override init() {
+        super.init()
+
+        SwiftSingletons.register(self)
+    }
+
+    public static var storeDirPath: String {
+        return TSAttachmentStream.attachmentsFolder().appendingPathComponent("ContentStore")
+    }
+
+    /// Store entries are referenced by the file system, not by any model, so
+    /// orphan data cleanup must leave them alone.
+    public static func isStorePath(_ path: String) -> Bool {
+        return path.hasPrefix(storeDirPath + "/")
+    }
+
+    private func storePath(forSha256Digest sha256Digest: Data) -> String {
+        return Self.storeDirPath.appendingPathComponent(sha256Digest.hexadecimalString)
+    }
+
+    // MARK: - Linking
+
+    /// Replaces the file at `fileUrl` with a link to the store's copy of identical
+    /// content, or adds the file to the store if there is none yet.
+    ///
+    /// `sha256Digest` is the digest of the file's plaintext, computed while the
+    /// file was written. The work is done asynchronously and is skipped if the
+    /// file has been removed or replaced by then. Failures are logged and leave
+    /// the file as-is; deduplication is best-effort.
+    @objc
+    public func deduplicateFile(at fileUrl: URL, sha256Digest: Data) {
+        guard
+            let attributes = try? FileManager.default.attributesOfItem(atPath: fileUrl.path),
+            let byteCount = (attributes[.size] as? NSNumber)?.uint64Value,
+            byteCount >= Self.minimumByteCount,
+            let fileNumber = attributes[.systemFileNumber] as? NSNumber
+        else {
+            return
+        }
+        serialQueue.async {
+            do {
+                try self.deduplicateFile(at: fileUrl, sha256Digest: sha256Digest, byteCount: byteCount, fileNumber: fileNumber)
+            } catch CocoaError.fileWriteFileExists {
+                // Another process added the same content to the store first; harmless.
+            } catch {
+                Logger.warn("Could not deduplicate attachment file: \(error)")
+            }
+        }
+    }
+
+    private func deduplicateFile(at fileUrl: URL, sha256Digest: Data, byteCount: UInt64, fileNumber: NSNumber) throws {
+        // The digest only describes the file that was written, not any
+        // file that has replaced it since.
+        guard
+            let attributes = try? FileManager.default.attributesOfItem(atPath: fileUrl.path),
+            attributes[.systemFileNumber] as? NSNumber == fileNumber
+        else {
+            return
+        }
+        guard OWSFileSystem.ensureDirectoryExists(Self.storeDirPath) else {
+            throw OWSAssertionError("Could not create content store directory.")
+        }
+        let storeUrl = URL(fileURLWithPath: storePath(forSha256Digest: sha256Digest))
+
+        if FileManager.default.fileExists(atPath: storeUrl.path) {
+            guard OWSFileSystem.fileSize(ofPath: storeUrl.path)?.uint64Value == byteCount else {
+                throw OWSAssertionError("Content store entry size mismatch.")
+            }
+            try replaceFile(at: fileUrl, withLinkTo: storeUrl)
+        } else {
+            try Self.setSha256DigestAttribute(sha256Digest, atPath: fileUrl.path)
+            try Self.makeReadOnly(fileUrl)
+            try FileManager.default.linkItem(at: fileUrl, to: storeUrl)
+        }
+    }
+
+    /// Makes `dstUrl` share `srcUrl`'s file rather than copying it.
+    ///
+    /// Falls back to copying if the file can't be linked.
+    @objc
+    public func linkOrCopyFile(at srcUrl: URL, to dstUrl: URL) throws {
+        do {
+            try Self.makeReadOnly(srcUrl)
+            try FileManager.default.linkItem(at: srcUrl, to: dstUrl)
+        } catch {
+            Logger.warn("Could not link attachment file; copying. \(error)")
+            try FileManager.default.copyItem(at: srcUrl, to: dstUrl)
+        }
+    }
+
+    private func replaceFile(at fileUrl: URL, withLinkTo storeUrl: URL) throws {
+        // Link beside the file, then rename over it, so the file is never missing.
+        let tempUrl = fileUrl.deletingLastPathComponent().appendingPathComponent(UUID().uuidString)
+        try FileManager.default.linkItem(at: storeUrl, to: tempUrl)
+        guard rename(tempUrl.path, fileUrl.path) == 0 else {
+            let error = POSIXError(POSIXErrorCode(rawValue: errno) ?? .EIO)
+            try? FileManager.default.removeItem(at: tempUrl)
+            throw error
+        }
+    }
+
+    private static func makeReadOnly(_ fileUrl: URL) throws {
+        try FileManager.default.setAttributes([.posixPermissions: sharedFilePermissions], ofItemAtPath: fileUrl.path)
+    }
+
+    private static func setSha256DigestAttribute(_ sha256Digest: Data, atPath path: String) throws {
+        let result = sha256Digest.withUnsafeBytes {
+            setxattr(path, sha256DigestAttributeName, $0.baseAddress, $0.count, 0, 0)
+        }
+        guard result == 0 else {
+            throw POSIXError(POSIXErrorCode(rawValue: errno) ?? .EIO)
+        }
+    }
+
+    private static func sha256DigestAttribute(atPath path: String) -> Data? {
+        var sha256Digest = Data(count: SHA256.byteCount)
+        let byteCount = sha256Digest.withUnsafeMutableBytes {
+            getxattr(path, sha256DigestAttributeName, $0.baseAddress, $0.count, 0, 0)
+        }
+        guard byteCount == sha256Digest.count else {
+            return nil
+        }
+        return sha256Digest
+    }
+
+    // MARK: - Removal
+
+    /// Returns the number of hard links to the file at `path`, or 0 if it doesn't exist.
+    @objc
+    public static func linkCount(atPath path: String) -> Int {
+        guard
+            let attributes = try? FileManager.default.attributesOfItem(atPath: path),
+            let linkCount = attributes[.referenceCount] as? NSNumber
+        else {
+            return 0
+        }
+        return linkCount.intValue
+    }
+
+    /// Returns the digest of the store entry that the file at `path` links
+    /// to, or nil if it isn't linked into the store.
+    ///
+    /// Call before removing an attachment file, and pass the result to
+    /// `didRemoveFile(linkedToEntryWithSha256Digest:)` once it's removed.
+    @objc
+    public static func storeSha256Digest(ofFileAtPath path: String) -> Data? {
+        guard linkCount(atPath: path) > 1 else {
+            return nil
+        }
+        return sha256DigestAttribute(atPath: path)
+    }
+
+    /// Deletes the store entry for `sha256Digest` if the file just removed
+    /// was the last attachment file linked to it.
+    @objc
+    public func didRemoveFile(linkedToEntryWithSha256Digest sha256Digest: Data) {
+        let storePath = storePath(forSha256Digest: sha256Digest)
+        serialQueue.async {
+            guard Self.linkCount(atPath: storePath) == 1 else {
+                return
+            }
+            if OWSFileSystem.deleteFileIfExists(storePath) {
+                Logger.info("Removed unreferenced content store entry.")
+            }
+        }
+    }
+
+    /// Deletes every store entry that no attachment file links to anymore.
+    ///
+    /// Files removed without going through `removeFile` (e.g. by orphan data
+    /// cleanup) don't report their entry, so maintenance calls this to catch
+    /// up. It lists the whole store; don't call it on hot paths.
+    public func sweepUnreferencedEntries() {
+        serialQueue.sync {
+            let storeDirPath = Self.storeDirPath
+            guard let entryNames = try? FileManager.default.contentsOfDirectory(atPath: storeDirPath) else {
+                return
+            }
+            var removedCount = 0
+            for entryName in entryNames {
+                let entryPath = storeDirPath.appendingPathComponent(entryName)
+                guard Self.linkCount(atPath: entryPath) == 1 else {
+                    continue
+                }
+                if OWSFileSystem.deleteFileIfExists(entryPath) {
+                    removedCount += 1
+                }
+            }
+            if removedCount > 0 {
+                Logger.info("Removed \(removedCount) unreferenced content store entries.")
+            }
+        }
+    }
+
+    #if TESTABLE_BUILD
+
+    /// Waits for queued linking and removal work to finish.
+    func flushForTests() {
+        serialQueue.sync {}
+    }
+
+    #endif
+}
@@ -184,7 +184,7 @@ static const NSUInteger kMaxAttachmentsPerDataMessage = 100;
 
 - (void)sdsFinalizeAttachmentPointer
 {
-    [self upgradeAttachmentSchemaVersionIfNecessary];
+    // Rows are upgraded to TSAttachmentSchemaVersion by a schema migration.
 }
 
 + (nullable TSAttachmentPointer *)attachmentPointerFromProto:(SSKProtoAttachmentPointer *)attachmentProto
@@ -0,0 +1,137 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import Foundation
+
+/// Deletes large directory trees (e.g. every legacy attachment) without
+/// blocking the caller.
+///
+/// A directory is first renamed into a trash location on the same volume, which
+/// is atomic and instant; from the caller's point of view the directory is gone.
+/// The trash is then deleted on a background queue with bounded parallelism.
+/// Anything still in the trash when the process dies is deleted on the next
+/// launch.
+@objc
+public class TSAttachmentPurger: NSObject {
+
+    @objc(shared)
+    public static let shared = TSAttachmentPurger()
+
+    private static let maxConcurrentDeletions = 4
+
+    /// Reports deletion of the top-level entries of every trashed directory.
+    @objc
+    public let progress = Progress(totalUnitCount: 0)
+
+    private let operationQueue: OperationQueue
+
+    private let lock = UnfairLock()
+
+    // This property should only be accessed with lock acquired.
+    private var trashDirPathsInProgress = Set<String>()
+
+    private override init() {
+        let operationQueue = OperationQueue()
+        operationQueue.name = "TSAttachmentPurger"
+        operationQueue.qualityOfService = .utility
+        operationQueue.maxConcurrentOperationCount = Self.maxConcurrentDeletions
+        self.operationQueue = operationQueue
+
+        super.init()
+
+        SwiftSingletons.register(self)
+    }
+
+    public static var trashDirPath: String {
+        return OWSFileSystem.appSharedDataDirectoryPath().appendingPathComponent("AttachmentsTrash")
+    }
+
+    /// Moves `dirPath` into the trash, recreates it empty, and deletes the old
+    /// contents in the background. Returns immediately.
+    @objc
+    public func purgeDirectory(atPath dirPath: String) {
+        guard FileManager.default.fileExists(atPath: dirPath) else {
+            return
+        }
+        guard OWSFileSystem.ensureDirectoryExists(Self.trashDirPath) else {
+            owsFailDebug("Could not create trash directory.")
+            return
+        }
+        let trashedPath = Self.trashDirPath.appendingPathComponent(UUID().uuidString)
+        do {
+            try FileManager.default.moveItem(atPath: dirPath, toPath: trashedPath)
+        } catch {
+            owsFailDebug("Could not move directory to trash; deleting in place. \(error)")
+            OWSFileSystem.deleteContents(ofDirectory: dirPath)
+            return
+        }
+        // Callers cache the directory's existence.
+        OWSFileSystem.ensureDirectoryExists(dirPath)
+
+        purgeTrashedDirectory(atPath: trashedPath)
+    }
+
+    /// Resumes deleting anything left in the trash by a previous launch.
+    @objc
+    public func resumePendingPurges() {
+        operationQueue.addOperation {
+            guard let entryNames = try? FileManager.default.contentsOfDirectory(atPath: Self.trashDirPath) else {
+                return
+            }
+            if !entryNames.isEmpty {
+                Logger.info("Resuming purge of \(entryNames.count) trashed directories.")
+            }
+            for entryName in entryNames {
+                self.purgeTrashedDirectory(atPath: Self.trashDirPath.appendingPathComponent(entryName))
+            }
+        }
+    }
+
+    private func purgeTrashedDirectory(atPath trashedPath: String) {
+        let entryNames = (try? FileManager.default.contentsOfDirectory(atPath: trashedPath)) ?? []
+        let didStart: Bool = lock.withLock {
+            guard trashDirPathsInProgress.insert(trashedPath).inserted else {
+                return false
+            }
+            progress.totalUnitCount += Int64(entryNames.count)
+            return true
+        }
+        guard didStart else {
+            return
+        }
+
+        // Each top-level entry is usually one attachment's folder or file.
+        let deletions = entryNames.map { entryName in
+            BlockOperation { [weak self] in
+                autoreleasepool {
+                    let entryPath = trashedPath.appendingPathComponent(entryName)
+                    do {
+                        try FileManager.default.removeItem(atPath: entryPath)
+                    } catch CocoaError.fileNoSuchFile {
+                        // Already deleted before a relaunch.
+                    } catch {
+                        Logger.warn("Could not delete trashed item: \(error)")
+                    }
+                    self?.lock.withLock {
+                        self?.progress.completedUnitCount += 1
+                    }
+                }
+            }
+        }
+        let completion = BlockOperation { [weak self] in
+            do {
+                try FileManager.default.removeItem(atPath: trashedPath)
+            } catch {
+                Logger.warn("Could not delete trashed directory: \(error)")
+            }
+            self?.lock.withLock {
+                _ = self?.trashDirPathsInProgress.remove(trashedPath)
+            }
+            Logger.info("Purged \(entryNames.count) trashed items.")
+        }
+        deletions.forEach { completion.addDependency($0) }
+        operationQueue.addOperations(deletions + [completion], waitUntilFinished: false)
+    }
+}
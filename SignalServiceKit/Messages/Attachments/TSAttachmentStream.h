@@ -13,6 +13,7 @@
 NS_ASSUME_NONNULL_BEGIN
 
 @class AudioWaveform;
+@class OWSThumbnailLoadingToken;
 @class SSKProtoAttachmentPointer;
 @class TSAttachmentPointer;
 
@@ -29,6 +30,13 @@ typedef NS_CLOSED_ENUM(NSUInteger, TSAttachmentThumbnailQuality) {
 };
 NSString *NSStringForAttachmentThumbnailQuality(TSAttachmentThumbnailQuality value);
 
+typedef NS_CLOSED_ENUM(NSInteger, OWSThumbnailLoadingPriority) {
+    // Prefetching and other work that nobody is waiting on.
+    OWSThumbnailLoadingPriorityBackground,
+    // Thumbnails for on-screen content; these jump ahead of background work.
+    OWSThumbnailLoadingPriorityVisible
+};
+
 @interface TSAttachmentStream : TSAttachment
 
 - (instancetype)initWithServerId:(UInt64)serverId
@@ -137,6 +145,16 @@ NS_DESIGNATED_INITIALIZER NS_SWIFT_NAME(init(grdbId:uniqueId:albumMessageId:atta
 #endif
 
 @property (nonatomic, readonly, nullable) UIImage *originalImage;
+
+// Loads the original image decoded at no more than maxPixelSize along its longest edge.
+// Unlike originalImage, peak memory is bounded by maxPixelSize rather than by the
+// resolution of the source. Images that are already small enough are returned as by
+// originalImage; larger animated images are returned as a still of their first frame.
+- (nullable UIImage *)originalImageWithMaxPixelSize:(CGFloat)maxPixelSize NS_SWIFT_NAME(originalImage(maxPixelSize:));
+
+// Convenience for callers that only need display-size pixels.
+- (nullable UIImage *)originalImageWithMaxDimensionPoints:(CGFloat)maxDimensionPoints
+    NS_SWIFT_NAME(originalImage(maxDimensionPoints:));
 @property (nonatomic, readonly, nullable) NSString *originalFilePath;
 @property (nonatomic, readonly, nullable) NSURL *originalMediaURL;
 
@@ -145,18 +163,33 @@ NS_DESIGNATED_INITIALIZER NS_SWIFT_NAME(init(grdbId:uniqueId:albumMessageId:atta
 - (NSArray<NSString *> *)allSecondaryFilePaths;
 
 - (nullable NSData *)readDataFromFileWithError:(NSError **)error;
+/// Reads the attachment file memory-mapped where safe, so that large files are paged in
+/// on demand rather than copied onto the heap. Prefer this for upload, forward and export.
+- (nullable NSData *)readMappedDataFromFileWithError:(NSError **)error;
 - (BOOL)writeData:(NSData *)data error:(NSError **)error;
 
 /// Copies the contents of the DataSource into the attachment stream's backing file.
+///
+/// File-backed sources are cloned where the file system supports it, and the copy's image
+/// header is probed to seed the media metadata.
 - (BOOL)writeCopyingDataSource:(id<DataSource>)dataSource
                          error:(NSError **)error NS_SWIFT_NAME(writeCopyingDataSource(_:));
 
+/// Makes this stream's backing file share the source stream's file on disk instead of copying it.
+- (BOOL)writeSharingFileOfAttachmentStream:(TSAttachmentStream *)sourceAttachment
+                                     error:(NSError **)error NS_SWIFT_NAME(writeSharingFile(of:));
+
 /// This method *moves* the file backing `dataSource`, rather than copying it's content. As such it's faster than
 /// `writeCopyingDataSource`, but it must not be used if the DataSource is backed by a file which must exist *after*
 /// this write.
 - (BOOL)writeConsumingDataSource:(id<DataSource>)dataSource
                            error:(NSError **)error NS_SWIFT_NAME(writeConsumingDataSource(_:));
 
+// Removes the attachment's file and all derived files (thumbnails, waveform).
+- (void)removeFile;
+
+// Empties the attachments folder immediately and deletes its former contents
+// in the background; see TSAttachmentPurger.
 + (void)deleteAttachmentsFromDisk;
 
 + (NSString *)attachmentsFolder;
@@ -168,6 +201,12 @@ NS_DESIGNATED_INITIALIZER NS_SWIFT_NAME(init(grdbId:uniqueId:albumMessageId:atta
 
 - (NSTimeInterval)audioDurationSeconds;
 
+// Computes every piece of media metadata that applies to this attachment's type
+// (validity, animation, image size, audio duration) so that the getters above are
+// cache hits. Does file I/O; call this off the main thread, before the attachment
+// is first inserted, so the values are persisted with the row.
+- (void)ensureMediaMetadata;
+
 #pragma mark - Thumbnails
 
 // On cache hit, the thumbnail will be returned synchronously and completion will never be invoked.
@@ -175,16 +214,36 @@ NS_DESIGNATED_INITIALIZER NS_SWIFT_NAME(init(grdbId:uniqueId:albumMessageId:atta
 // otherwise failure will be invoked.
 //
 // success and failure are invoked async on main.
-- (void)thumbnailImageWithSizeHint:(CGSize)sizeHint
-                           success:(OWSThumbnailSuccess)success
-                           failure:(OWSThumbnailFailure)failure;
-- (void)thumbnailImageWithQuality:(TSAttachmentThumbnailQuality)quality
-                          success:(OWSThumbnailSuccess)success
-                          failure:(OWSThumbnailFailure)failure NS_SWIFT_NAME(thumbnailImage(quality:success:failure:));
+//
+// Callers must use the returned image; dropping it loses the cache hit, since
+// neither block will run. Swift callers that only want callbacks should use
+// the thumbnailImageSmall(success:failure:) family instead.
+- (nullable UIImage *)thumbnailImageWithSizeHint:(CGSize)sizeHint
+                                         success:(OWSThumbnailSuccess)success
+                                         failure:(OWSThumbnailFailure)failure NS_WARN_UNUSED_RESULT;
+- (nullable UIImage *)thumbnailImageWithQuality:(TSAttachmentThumbnailQuality)quality
+                                        success:(OWSThumbnailSuccess)success
+                                        failure:(OWSThumbnailFailure)failure NS_WARN_UNUSED_RESULT
+    NS_SWIFT_NAME(thumbnailImage(quality:success:failure:));
+
+// As above, but visible requests are scheduled ahead of background ones. If cancellationToken
+// is cancelled before the thumbnail loads, failure is invoked and success never will be.
+- (nullable UIImage *)thumbnailImageWithQuality:(TSAttachmentThumbnailQuality)quality
+                                       priority:(OWSThumbnailLoadingPriority)priority
+                              cancellationToken:(nullable OWSThumbnailLoadingToken *)cancellationToken
+                                        success:(OWSThumbnailSuccess)success
+                                        failure:(OWSThumbnailFailure)failure NS_WARN_UNUSED_RESULT
+    NS_SWIFT_NAME(thumbnailImage(quality:priority:cancellationToken:success:failure:));
 
 - (nullable UIImage *)thumbnailImageSyncWithQuality:(TSAttachmentThumbnailQuality)quality
     NS_SWIFT_NAME(thumbnailImageSync(quality:));
 
+// Never blocks; returns nil if the small thumbnail hasn't been generated yet.
+- (nullable NSData *)thumbnailDataSmallIfAvailable;
+
+// completion is invoked async, _off_ the main thread.
+- (void)thumbnailDataSmallWithCompletion:(void (^)(NSData *_Nullable thumbnailData))completion;
+
 // This method should only be invoked by OWSThumbnailService.
 - (NSString *)pathForThumbnailDimensionPoints:(CGFloat)thumbnailDimensionPoints;
 
@@ -210,7 +269,14 @@ NS_DESIGNATED_INITIALIZER NS_SWIFT_NAME(init(grdbId:uniqueId:albumMessageId:atta
                           uploadTimestamp:(unsigned long long)uploadTimestamp
                               transaction:(SDSAnyWriteTransaction *)transaction;
 
-- (nullable TSAttachmentStream *)cloneAsThumbnail;
+// Returns nil unless the small thumbnail can be produced without generating it,
+// i.e. it's already on disk or the original is small enough. Never blocks on
+// the thumbnail queue, so it's safe to use within a write transaction.
+- (nullable TSAttachmentStream *)cloneAsThumbnailIfAvailable;
+
+// Generates the small thumbnail if necessary. The clone is not inserted.
+// completion is invoked async, _off_ the main thread.
+- (void)cloneAsThumbnailWithCompletion:(void (^)(TSAttachmentStream *_Nullable))completion;
 
 #pragma mark - Protobuf
 
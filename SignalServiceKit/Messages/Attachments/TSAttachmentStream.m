@@ -6,9 +6,11 @@
 #import "TSAttachmentStream.h"
 #import "TSAttachmentPointer.h"
 #import <AVFoundation/AVFoundation.h>
+#import <SignalServiceKit/OWSSignpost.h>
 #import <SignalServiceKit/SignalServiceKit-Swift.h>
 #import <SignalServiceKit/Threading.h>
 #import <YYImage/YYImage.h>
+#import <os/lock.h>
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -28,31 +30,120 @@ NSString *NSStringForAttachmentThumbnailQuality(TSAttachmentThumbnailQuality val
     }
 }
 
-@interface TSAttachmentStream ()
+// An immutable snapshot of an attachment stream's derived media metadata.
+//
+// Snapshots are only mutated before they are published; once published they
+// are replaced as a whole, so readers never block and never observe a
+// partially-updated set of values.
+@interface TSAttachmentStreamMediaMetadata : NSObject <NSCopying>
+
+@property (nonatomic, nullable) NSNumber *isValidImage;
+@property (nonatomic, nullable) NSNumber *isValidVideo;
+@property (nonatomic, nullable) NSNumber *isAnimated;
+// In pixels, not points.
+@property (nonatomic, nullable) NSNumber *imageWidth;
+@property (nonatomic, nullable) NSNumber *imageHeight;
+@property (nonatomic, nullable) NSNumber *audioDurationSeconds;
+
+@end
+
+#pragma mark -
+
+@implementation TSAttachmentStreamMediaMetadata
+
+- (id)copyWithZone:(nullable NSZone *)zone
+{
+    TSAttachmentStreamMediaMetadata *copy = [TSAttachmentStreamMediaMetadata new];
+    copy.isValidImage = self.isValidImage;
+    copy.isValidVideo = self.isValidVideo;
+    copy.isAnimated = self.isAnimated;
+    copy.imageWidth = self.imageWidth;
+    copy.imageHeight = self.imageHeight;
+    copy.audioDurationSeconds = self.audioDurationSeconds;
+    return copy;
+}
+
+@end
+
+#pragma mark -
+
+// A built pointer proto and the upload fields it was built from.
+@interface TSAttachmentStreamPointerProtoCacheEntry : NSObject
+
+@property (nonatomic, readonly) NSString *uploadFingerprint;
+@property (nonatomic, readonly) SSKProtoAttachmentPointer *proto;
+
+@end
+
+#pragma mark -
+
+@implementation TSAttachmentStreamPointerProtoCacheEntry
+
+- (instancetype)initWithUploadFingerprint:(NSString *)uploadFingerprint proto:(SSKProtoAttachmentPointer *)proto
+{
+    self = [super init];
+    if (self) {
+        _uploadFingerprint = uploadFingerprint;
+        _proto = proto;
+    }
+    return self;
+}
+
+@end
+
+#pragma mark -
+
+@interface TSAttachmentStream () {
+    // Serializes publication of mediaMetadata; never held by readers.
+    os_unfair_lock _mediaMetadataWriteLock;
+
+    // Set while ensureMediaMetadata runs; the row hasn't been inserted yet so
+    // there's nothing to write back to.
+    BOOL _isEnsuringMediaMetadata;
+}
 
 // We only want to generate the file path for this attachment once, so that
 // changes in the file path generation logic don't break existing attachments.
 @property (nullable, nonatomic) NSString *localRelativeFilePath;
 
-// These properties should only be accessed while synchronized on self.
+// These properties are the persisted form of mediaMetadata. Their ivars are
+// only used to seed mediaMetadata when a row is loaded; the accessors read
+// and publish through mediaMetadata.
 //
 // In pixels, not points.
 @property (nullable, nonatomic) NSNumber *cachedImageWidth;
 @property (nullable, nonatomic) NSNumber *cachedImageHeight;
 
-// This property should only be accessed on the main thread.
 @property (nullable, nonatomic) NSNumber *cachedAudioDurationSeconds;
 
 @property (atomic, nullable) NSNumber *isValidImageCached;
 @property (atomic, nullable) NSNumber *isValidVideoCached;
 @property (atomic, nullable) NSNumber *isAnimatedCached;
 
+@property (atomic, nullable) TSAttachmentStreamMediaMetadata *mediaMetadata;
+
 @end
 
 #pragma mark -
 
 @implementation TSAttachmentStream
 
+@synthesize cachedImageWidth = _cachedImageWidth;
+@synthesize cachedImageHeight = _cachedImageHeight;
+@synthesize cachedAudioDurationSeconds = _cachedAudioDurationSeconds;
+@synthesize isValidImageCached = _isValidImageCached;
+@synthesize isValidVideoCached = _isValidVideoCached;
+@synthesize isAnimatedCached = _isAnimatedCached;
+
++ (MTLPropertyStorage)storageBehaviorForPropertyWithKey:(NSString *)propertyKey
+{
+    if ([propertyKey isEqualToString:@"mediaMetadata"]) {
+        // Persisted via the cached* properties.
+        return MTLPropertyStorageNone;
+    }
+    return [super storageBehaviorForPropertyWithKey:propertyKey];
+}
+
 - (instancetype)initWithContentType:(NSString *)contentType
                           byteCount:(UInt32)byteCount
                      sourceFilename:(nullable NSString *)sourceFilename
@@ -200,7 +291,123 @@ NSString *NSStringForAttachmentThumbnailQuality(TSAttachmentThumbnailQuality val
 
 - (void)sdsFinalizeAttachmentStream
 {
-    [self upgradeAttachmentSchemaVersionIfNecessary];
+    TSAttachmentStreamMediaMetadata *mediaMetadata = [TSAttachmentStreamMediaMetadata new];
+    mediaMetadata.isValidImage = _isValidImageCached;
+    mediaMetadata.isValidVideo = _isValidVideoCached;
+    mediaMetadata.isAnimated = _isAnimatedCached;
+    mediaMetadata.imageWidth = _cachedImageWidth;
+    mediaMetadata.imageHeight = _cachedImageHeight;
+    mediaMetadata.audioDurationSeconds = _cachedAudioDurationSeconds;
+    self.mediaMetadata = mediaMetadata;
+}
+
+#pragma mark - Media Metadata
+
+- (void)updateMediaMetadataWithBlock:(void (^)(TSAttachmentStreamMediaMetadata *mediaMetadata))block
+{
+    os_unfair_lock_lock(&_mediaMetadataWriteLock);
+    TSAttachmentStreamMediaMetadata *mediaMetadata = [self.mediaMetadata copy] ?: [TSAttachmentStreamMediaMetadata new];
+    block(mediaMetadata);
+    self.mediaMetadata = mediaMetadata;
+    os_unfair_lock_unlock(&_mediaMetadataWriteLock);
+}
+
+- (nullable NSNumber *)cachedImageWidth
+{
+    return self.mediaMetadata.imageWidth;
+}
+
+- (void)setCachedImageWidth:(nullable NSNumber *)cachedImageWidth
+{
+    [self updateMediaMetadataWithBlock:^(TSAttachmentStreamMediaMetadata *mediaMetadata) {
+        mediaMetadata.imageWidth = cachedImageWidth;
+    }];
+}
+
+- (nullable NSNumber *)cachedImageHeight
+{
+    return self.mediaMetadata.imageHeight;
+}
+
+- (void)setCachedImageHeight:(nullable NSNumber *)cachedImageHeight
+{
+    [self updateMediaMetadataWithBlock:^(TSAttachmentStreamMediaMetadata *mediaMetadata) {
+        mediaMetadata.imageHeight = cachedImageHeight;
+    }];
+}
+
+- (nullable NSNumber *)cachedAudioDurationSeconds
+{
+    return self.mediaMetadata.audioDurationSeconds;
+}
+
+- (void)setCachedAudioDurationSeconds:(nullable NSNumber *)cachedAudioDurationSeconds
+{
+    [self updateMediaMetadataWithBlock:^(TSAttachmentStreamMediaMetadata *mediaMetadata) {
+        mediaMetadata.audioDurationSeconds = cachedAudioDurationSeconds;
+    }];
+}
+
+- (nullable NSNumber *)isValidImageCached
+{
+    return self.mediaMetadata.isValidImage;
+}
+
+- (void)setIsValidImageCached:(nullable NSNumber *)isValidImageCached
+{
+    [self updateMediaMetadataWithBlock:^(TSAttachmentStreamMediaMetadata *mediaMetadata) {
+        mediaMetadata.isValidImage = isValidImageCached;
+    }];
+}
+
+- (nullable NSNumber *)isValidVideoCached
+{
+    return self.mediaMetadata.isValidVideo;
+}
+
+- (void)setIsValidVideoCached:(nullable NSNumber *)isValidVideoCached
+{
+    [self updateMediaMetadataWithBlock:^(TSAttachmentStreamMediaMetadata *mediaMetadata) {
+        mediaMetadata.isValidVideo = isValidVideoCached;
+    }];
+}
+
+- (nullable NSNumber *)isAnimatedCached
+{
+    return self.mediaMetadata.isAnimated;
+}
+
+- (void)setIsAnimatedCached:(nullable NSNumber *)isAnimatedCached
+{
+    [self updateMediaMetadataWithBlock:^(TSAttachmentStreamMediaMetadata *mediaMetadata) {
+        mediaMetadata.isAnimated = isAnimatedCached;
+    }];
+}
+
+- (void)ensureMediaMetadata
+{
+    _isEnsuringMediaMetadata = YES;
+    // Each getter publishes its result before the next runs, so e.g. the image
+    // size calculation reuses the validity result.
+    if (self.isImageMimeType || [self getAnimatedMimeType] != TSAnimatedMimeTypeNotAnimated) {
+        [self isValidImage];
+        [self isAnimatedContent];
+    }
+    if (self.isVideoMimeType) {
+        [self isValidVideo];
+    }
+    if (self.shouldHaveImageSize) {
+        [self imageSizePixels];
+    }
+    if (self.isAudioMimeType) {
+        if (self.cachedAudioDurationSeconds == nil) {
+            // One decode yields both the waveform and a more accurate duration
+            // than AVAudioPlayer's estimate.
+            self.cachedAudioDurationSeconds = [self analyzeIngestedAudio];
+        }
+        [self audioDurationSeconds];
+    }
+    _isEnsuringMediaMetadata = NO;
 }
 
 - (void)upgradeFromAttachmentSchemaVersion:(NSUInteger)attachmentSchemaVersion
@@ -258,6 +465,17 @@ NSString *NSStringForAttachmentThumbnailQuality(TSAttachmentThumbnailQuality val
     return [NSData dataWithContentsOfFile:filePath options:0 error:error];
 }
 
+- (nullable NSData *)readMappedDataFromFileWithError:(NSError **)error
+{
+    *error = nil;
+    NSString *_Nullable filePath = self.originalFilePath;
+    if (!filePath) {
+        OWSFailDebug(@"Missing path for attachment.");
+        return nil;
+    }
+    return [NSData dataWithContentsOfFile:filePath options:NSDataReadingMappedIfSafe error:error];
+}
+
 - (BOOL)writeData:(NSData *)data error:(NSError **)error
 {
     OWSAssertDebug(data);
@@ -268,7 +486,21 @@ NSString *NSStringForAttachmentThumbnailQuality(TSAttachmentThumbnailQuality val
         *error = [OWSError makeAssertionError:@"Missing path for attachment."];
         return NO;
     }
-    return [data writeToFile:filePath options:0 error:error];
+    // Write atomically: the file may be a content store link shared with other streams.
+    return [data writeToFile:filePath options:NSDataWritingAtomic error:error];
+}
+
+- (BOOL)writeSharingFileOfAttachmentStream:(TSAttachmentStream *)sourceAttachment error:(NSError **)error
+{
+    OWSAssertDebug(sourceAttachment);
+
+    NSURL *_Nullable originalMediaURL = self.originalMediaURL;
+    NSURL *_Nullable sourceMediaURL = sourceAttachment.originalMediaURL;
+    if (originalMediaURL == nil || sourceMediaURL == nil) {
+        *error = [OWSError makeAssertionError:@"Missing URL for attachment."];
+        return NO;
+    }
+    return [TSAttachmentContentStore.shared linkOrCopyFileAt:sourceMediaURL to:originalMediaURL error:error];
 }
 
 - (BOOL)writeCopyingDataSource:(id<DataSource>)dataSource error:(NSError **)error
@@ -280,7 +512,32 @@ NSString *NSStringForAttachmentThumbnailQuality(TSAttachmentThumbnailQuality val
         *error = [OWSError makeAssertionError:@"Missing URL for attachment."];
         return NO;
     }
-    return [dataSource writeTo:originalMediaURL error:error];
+    TSAttachmentStreamingWriteResult *_Nullable result = [TSAttachmentStreamingWriter writeCopying:dataSource
+                                                                                                to:originalMediaURL
+                                                                                             error:error];
+    if (result == nil) {
+        return NO;
+    }
+    [self applyStreamingWriteResult:result];
+    [TSAttachmentContentStore.shared deduplicateFileAt:originalMediaURL sha256Digest:result.plaintextSha256Digest];
+    return YES;
+}
+
+- (void)applyStreamingWriteResult:(TSAttachmentStreamingWriteResult *)result
+{
+    // Seed the image size from the header probe, but only if the header agrees
+    // with our content type; otherwise leave it to the full validation path.
+    if (result.sniffedMimeType == nil || ![result.sniffedMimeType isEqualToString:self.contentType]) {
+        return;
+    }
+    CGSize imageSizePixels = result.imageSizePixels;
+    if (imageSizePixels.width <= 0 || imageSizePixels.height <= 0) {
+        return;
+    }
+    [self updateMediaMetadataWithBlock:^(TSAttachmentStreamMediaMetadata *mediaMetadata) {
+        mediaMetadata.imageWidth = @(imageSizePixels.width);
+        mediaMetadata.imageHeight = @(imageSizePixels.height);
+    }];
 }
 
 - (BOOL)writeConsumingDataSource:(id<DataSource>)dataSource error:(NSError **)error
@@ -400,6 +657,8 @@ NSString *NSStringForAttachmentThumbnailQuality(TSAttachmentThumbnailQuality val
 
 - (void)removeFile
 {
+    [OWSThumbnailCache.shared removeImagesForUniqueId:self.uniqueId];
+
     NSString *_Nullable thumbnailsDirPath = self.thumbnailsDirPath;
     if (thumbnailsDirPath && ![OWSFileSystem deleteFileIfExists:thumbnailsDirPath]) {
         OWSLogError(@"remove thumbnails dir failed.");
@@ -412,6 +671,9 @@ NSString *NSStringForAttachmentThumbnailQuality(TSAttachmentThumbnailQuality val
 
     NSString *_Nullable filePath = self.originalFilePath;
     OWSAssertDebug(filePath);
+    // The file may be shared with other streams; removing it only drops this
+    // stream's reference.
+    NSData *_Nullable storeSha256Digest = filePath ? [TSAttachmentContentStore storeSha256DigestOfFileAtPath:filePath] : nil;
     if (filePath && ![OWSFileSystem deleteFileIfExists:filePath]) {
         OWSLogError(@"remove file failed");
     }
@@ -421,6 +683,10 @@ NSString *NSStringForAttachmentThumbnailQuality(TSAttachmentThumbnailQuality val
     if (attachmentFolder && ![OWSFileSystem deleteFileIfExists:attachmentFolder]) {
         OWSFailDebug(@"remove unique attachment folder failed.");
     }
+
+    if (storeSha256Digest != nil) {
+        [TSAttachmentContentStore.shared didRemoveFileLinkedToEntryWithSha256Digest:storeSha256Digest];
+    }
 }
 
 - (void)anyDidInsertWithTransaction:(SDSAnyWriteTransaction *)transaction
@@ -433,7 +699,7 @@ NSString *NSStringForAttachmentThumbnailQuality(TSAttachmentThumbnailQuality val
 {
     [super anyDidRemoveWithTransaction:transaction];
 
-    [self removeFile];
+    [self scheduleFileRemovalWithTx:transaction];
     [self anyDidRemoveSwiftWithTx:transaction];
 }
 
@@ -470,23 +736,21 @@ NSString *NSStringForAttachmentThumbnailQuality(TSAttachmentThumbnailQuality val
 {
     OWSAssertDebug(self.isImageMimeType || [self getAnimatedMimeType] != TSAnimatedMimeTypeNotAnimated);
 
-    BOOL result;
-    BOOL didUpdateCache = NO;
-    @synchronized(self) {
-        if (!self.isValidImageCached) {
-            self.isValidImageCached = @([NSData imageMetadataWithPath:self.originalFilePath
-                                                             mimeType:self.contentType
-                                                       ignoreFileSize:ignoreSize]
-                    .isValid);
-            if (!self.isValidImageCached.boolValue) {
-                OWSLogWarn(@"Invalid image.");
-            }
-            didUpdateCache = YES;
-        }
-        result = self.isValidImageCached.boolValue;
+    NSNumber *_Nullable cachedValue = self.isValidImageCached;
+    if (cachedValue != nil) {
+        return cachedValue.boolValue;
+    }
+
+    BOOL result = [NSData imageMetadataWithPath:self.originalFilePath
+                                       mimeType:self.contentType
+                                 ignoreFileSize:ignoreSize]
+                      .isValid;
+    if (!result) {
+        OWSLogWarn(@"Invalid image.");
     }
+    self.isValidImageCached = @(result);
 
-    if (didUpdateCache && self.canAsyncUpdate) {
+    if (self.canAsyncUpdate) {
         [self applyChangeAsyncToLatestCopyWithChangeBlock:^(
             TSAttachmentStream *latestInstance) { latestInstance.isValidImageCached = @(result); }];
     }
@@ -496,7 +760,7 @@ NSString *NSStringForAttachmentThumbnailQuality(TSAttachmentThumbnailQuality val
 
 - (BOOL)canAsyncUpdate
 {
-    return !AppContextObjCBridge.shared.isRunningTests;
+    return !_isEnsuringMediaMetadata && !AppContextObjCBridge.shared.isRunningTests;
 }
 
 - (BOOL)isValidVideo
@@ -508,21 +772,18 @@ NSString *NSStringForAttachmentThumbnailQuality(TSAttachmentThumbnailQuality val
 {
     OWSAssertDebug(self.isVideoMimeType);
 
-    BOOL result;
-    BOOL didUpdateCache = NO;
-    @synchronized(self) {
-        if (!self.isValidVideoCached) {
-            self.isValidVideoCached = @([OWSMediaUtils isValidVideoWithPath:self.originalFilePath
-                                                                 ignoreSize:ignoreSize]);
-            if (!self.isValidVideoCached) {
-                OWSLogWarn(@"Invalid video.");
-            }
-            didUpdateCache = YES;
-        }
-        result = self.isValidVideoCached.boolValue;
+    NSNumber *_Nullable cachedValue = self.isValidVideoCached;
+    if (cachedValue != nil) {
+        return cachedValue.boolValue;
     }
 
-    if (didUpdateCache && self.canAsyncUpdate) {
+    BOOL result = [OWSMediaUtils isValidVideoWithPath:self.originalFilePath ignoreSize:ignoreSize];
+    if (!result) {
+        OWSLogWarn(@"Invalid video.");
+    }
+    self.isValidVideoCached = @(result);
+
+    if (self.canAsyncUpdate) {
         [self applyChangeAsyncToLatestCopyWithChangeBlock:^(
             TSAttachmentStream *latestInstance) { latestInstance.isValidVideoCached = @(result); }];
     }
@@ -532,17 +793,15 @@ NSString *NSStringForAttachmentThumbnailQuality(TSAttachmentThumbnailQuality val
 
 - (BOOL)isAnimatedContent
 {
-    BOOL result;
-    BOOL didUpdateCache = NO;
-    @synchronized(self) {
-        if (!self.isAnimatedCached) {
-            self.isAnimatedCached = @([self hasAnimatedImageContent]);
-            didUpdateCache = YES;
-        }
-        result = self.isAnimatedCached.boolValue;
+    NSNumber *_Nullable cachedValue = self.isAnimatedCached;
+    if (cachedValue != nil) {
+        return cachedValue.boolValue;
     }
 
-    if (didUpdateCache && self.canAsyncUpdate) {
+    BOOL result = [self hasAnimatedImageContent];
+    self.isAnimatedCached = @(result);
+
+    if (self.canAsyncUpdate) {
         [self applyChangeAsyncToLatestCopyWithChangeBlock:^(
             TSAttachmentStream *latestInstance) { latestInstance.isAnimatedCached = @(result); }];
     }
@@ -593,6 +852,44 @@ NSString *NSStringForAttachmentThumbnailQuality(TSAttachmentThumbnailQuality val
     }
 }
 
+- (nullable UIImage *)originalImageWithMaxPixelSize:(CGFloat)maxPixelSize
+{
+    if ([self isVideoMimeType]) {
+        // Video stills are already decoded at a bounded size.
+        return [self videoStillImage];
+    }
+    if (![self isImageMimeType] && [self getAnimatedMimeType] == TSAnimatedMimeTypeNotAnimated) {
+        return nil;
+    }
+    CGSize imageSizePixels = self.imageSizePixels;
+    if (imageSizePixels.width > 0 && imageSizePixels.height > 0
+        && MAX(imageSizePixels.width, imageSizePixels.height) <= maxPixelSize) {
+        // No need to downsample; this also preserves animation.
+        return self.originalImage;
+    }
+    NSString *_Nullable originalFilePath = self.originalFilePath;
+    if (!originalFilePath) {
+        return nil;
+    }
+    if (![self isValidImage]) {
+        return nil;
+    }
+    NSError *error;
+    UIImage *_Nullable image = [OWSMediaUtils downsampledImageAtPath:originalFilePath
+                                                  maxDimensionPixels:maxPixelSize
+                                                               error:&error];
+    if (error || !image) {
+        OWSLogError(@"Could not downsample original image: %@.", error);
+        return nil;
+    }
+    return image;
+}
+
+- (nullable UIImage *)originalImageWithMaxDimensionPoints:(CGFloat)maxDimensionPoints
+{
+    return [self originalImageWithMaxPixelSize:maxDimensionPoints * UIScreen.mainScreen.scale];
+}
+
 - (nullable NSData *)validStillImageData
 {
     if ([self isVideoMimeType]) {
@@ -609,11 +906,27 @@ NSString *NSStringForAttachmentThumbnailQuality(TSAttachmentThumbnailQuality val
         return nil;
     }
 
-    return [NSData dataWithContentsOfFile:self.originalFilePath];
+    NSError *error;
+    NSData *_Nullable data = [self readMappedDataFromFileWithError:&error];
+    if (error != nil) {
+        OWSLogError(@"Could not read image data: %@", error);
+    }
+    return data;
 }
 
+// The poster frame is persisted as the large thumbnail, so it is only
+// decoded from the video once.
 - (nullable UIImage *)videoStillImage
 {
+    NSString *posterFramePath = [self pathForThumbnailDimensionPoints:[TSAttachmentStream thumbnailDimensionPointsLarge]];
+    if ([[NSFileManager defaultManager] fileExistsAtPath:posterFramePath]) {
+        UIImage *_Nullable image = [UIImage imageWithContentsOfFile:posterFramePath];
+        if (image != nil) {
+            return image;
+        }
+        OWSLogWarn(@"Could not load persisted video still.");
+    }
+
     NSError *error;
     UIImage *_Nullable image = [OWSMediaUtils thumbnailForVideoAtPath:self.originalFilePath
                                                    maxDimensionPoints:[TSAttachmentStream thumbnailDimensionPointsLarge]
@@ -622,31 +935,14 @@ NSString *NSStringForAttachmentThumbnailQuality(TSAttachmentThumbnailQuality val
         OWSLogError(@"Could not create video still: %@.", error);
         return nil;
     }
+    [OWSThumbnailService.shared persistVideoStillImage:image forAttachment:self];
     return image;
 }
 
 + (void)deleteAttachmentsFromDisk
 {
-    NSError *error;
-    NSFileManager *fileManager = [NSFileManager defaultManager];
-
-    NSURL *fileURL = [NSURL fileURLWithPath:self.attachmentsFolder];
-    NSArray<NSURL *> *contents = [fileManager contentsOfDirectoryAtURL:fileURL
-                                            includingPropertiesForKeys:nil
-                                                               options:0
-                                                                 error:&error];
-
-    if (error) {
-        OWSFailDebug(@"failed to get contents of attachments folder: %@ with error: %@", self.attachmentsFolder, error);
-        return;
-    }
-
-    for (NSURL *url in contents) {
-        [fileManager removeItemAtURL:url error:&error];
-        if (error) {
-            OWSFailDebug(@"failed to remove item at path: %@ with error: %@", url, error);
-        }
-    }
+    // Returns immediately; the old files are deleted in the background.
+    [TSAttachmentPurger.shared purgeDirectoryAtPath:self.attachmentsFolder];
 }
 
 - (CGSize)calculateImageSizePixels
@@ -655,7 +951,8 @@ NSString *NSStringForAttachmentThumbnailQuality(TSAttachmentThumbnailQuality val
         if (![self isValidVideo]) {
             return CGSizeZero;
         }
-        return [[self videoStillImage] pixelSize];
+        // Read the dimensions from the track metadata rather than decoding a frame.
+        return [OWSMediaUtils videoDisplaySizePixelsForVideoAtPath:self.originalFilePath];
     } else if ([self isImageMimeType] || [self getAnimatedMimeType] != TSAnimatedMimeTypeNotAnimated) {
         // imageSizeForFilePath checks validity.
         return [NSData imageSizeForFilePath:self.originalFilePath mimeType:self.contentType];
@@ -677,39 +974,40 @@ NSString *NSStringForAttachmentThumbnailQuality(TSAttachmentThumbnailQuality val
         return CGSizeZero;
     }
 
-    @synchronized(self) {
-        if (self.cachedImageWidth && self.cachedImageHeight) {
-            return CGSizeMake(self.cachedImageWidth.floatValue, self.cachedImageHeight.floatValue);
-        }
+    // Read both dimensions from the same snapshot.
+    TSAttachmentStreamMediaMetadata *_Nullable mediaMetadata = self.mediaMetadata;
+    if (mediaMetadata.imageWidth && mediaMetadata.imageHeight) {
+        return CGSizeMake(mediaMetadata.imageWidth.floatValue, mediaMetadata.imageHeight.floatValue);
+    }
 
-        CGSize imageSizePixels = [self calculateImageSizePixels];
-        if (imageSizePixels.width <= 0 || imageSizePixels.height <= 0) {
-            return CGSizeZero;
-        }
-        self.cachedImageWidth = @(imageSizePixels.width);
-        self.cachedImageHeight = @(imageSizePixels.height);
-
-        if (self.canAsyncUpdate) {
-            [self applyChangeAsyncToLatestCopyWithChangeBlock:^(TSAttachmentStream *latestInstance) {
-                latestInstance.cachedImageWidth = @(imageSizePixels.width);
-                latestInstance.cachedImageHeight = @(imageSizePixels.height);
-            }];
-        }
+    CGSize imageSizePixels = [self calculateImageSizePixels];
+    if (imageSizePixels.width <= 0 || imageSizePixels.height <= 0) {
+        return CGSizeZero;
+    }
+    [self updateMediaMetadataWithBlock:^(TSAttachmentStreamMediaMetadata *latestMediaMetadata) {
+        latestMediaMetadata.imageWidth = @(imageSizePixels.width);
+        latestMediaMetadata.imageHeight = @(imageSizePixels.height);
+    }];
 
-        return imageSizePixels;
+    if (self.canAsyncUpdate) {
+        [self applyChangeAsyncToLatestCopyWithChangeBlock:^(TSAttachmentStream *latestInstance) {
+            latestInstance.cachedImageWidth = @(imageSizePixels.width);
+            latestInstance.cachedImageHeight = @(imageSizePixels.height);
+        }];
     }
+
+    return imageSizePixels;
 }
 
 - (CGSize)cachedMediaSize
 {
     OWSAssertDebug(self.shouldHaveImageSize);
 
-    @synchronized(self) {
-        if (self.cachedImageWidth && self.cachedImageHeight) {
-            return CGSizeMake(self.cachedImageWidth.floatValue, self.cachedImageHeight.floatValue);
-        } else {
-            return CGSizeZero;
-        }
+    TSAttachmentStreamMediaMetadata *_Nullable mediaMetadata = self.mediaMetadata;
+    if (mediaMetadata.imageWidth && mediaMetadata.imageHeight) {
+        return CGSizeMake(mediaMetadata.imageWidth.floatValue, mediaMetadata.imageHeight.floatValue);
+    } else {
+        return CGSizeZero;
     }
 }
 
@@ -720,7 +1018,8 @@ NSString *NSStringForAttachmentThumbnailQuality(TSAttachmentThumbnailQuality val
     OWSAssertDebug(changeBlock);
 
     NSString *uniqueId = self.uniqueId;
-    DatabaseStorageAsyncWrite(SSKEnvironment.shared.databaseStorageRef, ^(SDSAnyWriteTransaction *tx) {
+    // These are cache updates, so they can share a transaction with others.
+    [SSKEnvironment.shared.databaseStorageRef asyncCoalescedWriteWithBlock:^(SDSAnyWriteTransaction *tx) {
         // We load a new instance before using anyUpdateWithTransaction() since it
         // isn't thread-safe to mutate the current instance async.
         TSAttachmentStream *_Nullable latestInstance = [TSAttachmentStream anyFetchAttachmentStreamWithUniqueId:uniqueId
@@ -736,7 +1035,7 @@ NSString *NSStringForAttachmentThumbnailQuality(TSAttachmentThumbnailQuality val
         }
         changeBlock(latestInstance);
         [latestInstance anyOverwritingUpdateWithTransaction:tx];
-    });
+    }];
 }
 
 #pragma mark -
@@ -769,29 +1068,28 @@ NSString *NSStringForAttachmentThumbnailQuality(TSAttachmentThumbnailQuality val
 
 - (NSTimeInterval)audioDurationSeconds
 {
-    @synchronized(self) {
-        if (self.cachedAudioDurationSeconds) {
-            return self.cachedAudioDurationSeconds.doubleValue;
-        }
-
-        NSTimeInterval audioDurationSeconds = [self calculateAudioDurationSeconds];
-        self.cachedAudioDurationSeconds = @(audioDurationSeconds);
+    NSNumber *_Nullable cachedValue = self.cachedAudioDurationSeconds;
+    if (cachedValue != nil) {
+        return cachedValue.doubleValue;
+    }
 
-        if (self.canAsyncUpdate) {
-            [self applyChangeAsyncToLatestCopyWithChangeBlock:^(TSAttachmentStream *latestInstance) {
-                latestInstance.cachedAudioDurationSeconds = @(audioDurationSeconds);
-            }];
-        }
+    NSTimeInterval audioDurationSeconds = [self calculateAudioDurationSeconds];
+    self.cachedAudioDurationSeconds = @(audioDurationSeconds);
 
-        return audioDurationSeconds;
+    if (self.canAsyncUpdate) {
+        [self applyChangeAsyncToLatestCopyWithChangeBlock:^(TSAttachmentStream *latestInstance) {
+            latestInstance.cachedAudioDurationSeconds = @(audioDurationSeconds);
+        }];
     }
+
+    return audioDurationSeconds;
 }
 
 #pragma mark - Thumbnails
 
-- (void)thumbnailImageWithSizeHint:(CGSize)sizeHint
-                           success:(OWSThumbnailSuccess)success
-                           failure:(OWSThumbnailFailure)failure
+- (nullable UIImage *)thumbnailImageWithSizeHint:(CGSize)sizeHint
+                                         success:(OWSThumbnailSuccess)success
+                                         failure:(OWSThumbnailFailure)failure
 {
     CGFloat maxDimensionHint = MAX(sizeHint.width, sizeHint.height);
     CGFloat thumbnailDimensionPoints;
@@ -803,95 +1101,176 @@ NSString *NSStringForAttachmentThumbnailQuality(TSAttachmentThumbnailQuality val
         thumbnailDimensionPoints = [TSAttachmentStream thumbnailDimensionPointsLarge];
     }
 
-    [self thumbnailImageWithThumbnailDimensionPoints:thumbnailDimensionPoints success:success failure:failure];
+    return [self thumbnailImageWithThumbnailDimensionPoints:thumbnailDimensionPoints success:success failure:failure];
 }
 
-- (void)thumbnailImageWithQuality:(TSAttachmentThumbnailQuality)quality
-                          success:(OWSThumbnailSuccess)success
-                          failure:(OWSThumbnailFailure)failure
+- (nullable UIImage *)thumbnailImageWithQuality:(TSAttachmentThumbnailQuality)quality
+                                        success:(OWSThumbnailSuccess)success
+                                        failure:(OWSThumbnailFailure)failure
+{
+    return [self thumbnailImageWithQuality:quality
+                                  priority:OWSThumbnailLoadingPriorityVisible
+                         cancellationToken:nil
+                                   success:success
+                                   failure:failure];
+}
+
+- (nullable UIImage *)thumbnailImageWithQuality:(TSAttachmentThumbnailQuality)quality
+                                       priority:(OWSThumbnailLoadingPriority)priority
+                              cancellationToken:(nullable OWSThumbnailLoadingToken *)cancellationToken
+                                        success:(OWSThumbnailSuccess)success
+                                        failure:(OWSThumbnailFailure)failure
 {
     CGFloat thumbnailDimensionPoints = [TSAttachmentStream thumbnailDimensionPointsForThumbnailQuality:quality];
-    [self thumbnailImageWithThumbnailDimensionPoints:thumbnailDimensionPoints success:success failure:failure];
+    return [self thumbnailImageWithThumbnailDimensionPoints:thumbnailDimensionPoints
+                                                   priority:priority
+                                          cancellationToken:cancellationToken
+                                                    success:success
+                                                    failure:failure];
 }
 
-- (void)thumbnailImageWithThumbnailDimensionPoints:(CGFloat)thumbnailDimensionPoints
-                                           success:(OWSThumbnailSuccess)success
-                                           failure:(OWSThumbnailFailure)failure
+- (nullable UIImage *)thumbnailImageWithThumbnailDimensionPoints:(CGFloat)thumbnailDimensionPoints
+                                                         success:(OWSThumbnailSuccess)success
+                                                         failure:(OWSThumbnailFailure)failure
 {
+    return [self thumbnailImageWithThumbnailDimensionPoints:thumbnailDimensionPoints
+                                                   priority:OWSThumbnailLoadingPriorityVisible
+                                          cancellationToken:nil
+                                                    success:success
+                                                    failure:failure];
+}
+
+- (nullable UIImage *)thumbnailImageWithThumbnailDimensionPoints:(CGFloat)thumbnailDimensionPoints
+                                                        priority:(OWSThumbnailLoadingPriority)priority
+                                               cancellationToken:(nullable OWSThumbnailLoadingToken *)cancellationToken
+                                                         success:(OWSThumbnailSuccess)success
+                                                         failure:(OWSThumbnailFailure)failure
+{
+    UIImage *_Nullable cachedImage = [OWSThumbnailCache.shared imageForUniqueId:self.uniqueId
+                                                       thumbnailDimensionPoints:thumbnailDimensionPoints];
+    if (cachedImage != nil) {
+        return cachedImage;
+    }
+
+    NSString *uniqueId = self.uniqueId;
+    MainThreadWorkPriority mainThreadPriority = (priority == OWSThumbnailLoadingPriorityVisible
+            ? MainThreadWorkPriorityUserVisible
+            : MainThreadWorkPriorityBackground);
     [self loadedThumbnailWithThumbnailDimensionPoints:thumbnailDimensionPoints
-        success:^(OWSLoadedThumbnail *thumbnail) { DispatchMainThreadSafeObjc(^{ success(thumbnail.image); }); }
-        failure:^{ DispatchMainThreadSafeObjc(^{ failure(); }); }];
+        priority:priority
+        cancellationToken:cancellationToken
+        success:^(OWSLoadedThumbnail *thumbnail) {
+            [OWSThumbnailCache.shared setImage:thumbnail.image
+                                   forUniqueId:uniqueId
+                      thumbnailDimensionPoints:thumbnailDimensionPoints];
+            DispatchMainThreadSafeBatchedObjc(mainThreadPriority, ^{ success(thumbnail.image); });
+        }
+        failure:^{ DispatchMainThreadSafeBatchedObjc(mainThreadPriority, ^{ failure(); }); }];
+    return nil;
 }
 
 - (void)loadedThumbnailWithThumbnailDimensionPoints:(CGFloat)thumbnailDimensionPoints
+                                           priority:(OWSThumbnailLoadingPriority)priority
+                                  cancellationToken:(nullable OWSThumbnailLoadingToken *)cancellationToken
                                             success:(OWSLoadedThumbnailSuccess)success
                                             failure:(OWSThumbnailFailure)failure
 {
-    [self.thumbnailLoadingOperationQueue addOperationWithBlock:^{
-        @autoreleasepool {
-            if (!self.isValidVisualMedia) {
-                // Never thumbnail (or try to use the original of) invalid media.
-                OWSFailDebug(@"Invalid image.");
-                failure();
-                return;
-            }
+    NSString *loadKey =
+        [NSString stringWithFormat:@"%@-%lu", self.uniqueId, (unsigned long)thumbnailDimensionPoints];
+    [OWSThumbnailLoadingQueue.shared
+        enqueueLoadWithKey:loadKey
+                  priority:priority
+                     token:cancellationToken
+                      work:^(OWSLoadedThumbnailSuccess workSuccess, OWSThumbnailFailure workFailure) {
+                          os_signpost_id_t signpostID = OWSSignpostIntervalBegin("LoadThumbnail");
+                          [self loadThumbnailWithThumbnailDimensionPoints:thumbnailDimensionPoints
+                              success:^(OWSLoadedThumbnail *loadedThumbnail) {
+                                  OWSSignpostIntervalEnd("LoadThumbnail", signpostID);
+                                  workSuccess(loadedThumbnail);
+                              }
+                              failure:^{
+                                  OWSSignpostIntervalEnd("LoadThumbnail", signpostID);
+                                  workFailure();
+                              }];
+                      }
+                   success:success
+                   failure:failure];
+}
 
-            CGSize originalSizePoints = self.imageSizePoints;
-            if (self.imageSizePixels.width < 1 || self.imageSizePixels.height < 1) {
-                failure();
-                return;
-            }
+// This should only be called on the thumbnail loading queue.
+- (void)loadThumbnailWithThumbnailDimensionPoints:(CGFloat)thumbnailDimensionPoints
+                                          success:(OWSLoadedThumbnailSuccess)success
+                                          failure:(OWSThumbnailFailure)failure
+{
+    if (!self.isValidVisualMedia) {
+        // Never thumbnail (or try to use the original of) invalid media.
+        OWSFailDebug(@"Invalid image.");
+        failure();
+        return;
+    }
 
-            if (originalSizePoints.width <= thumbnailDimensionPoints
-                && originalSizePoints.height <= thumbnailDimensionPoints && self.isImageMimeType) {
-                // There's no point in generating a thumbnail if the original is smaller than the
-                // thumbnail size. Only do this for images. We still need to generate thumbnails
-                // for videos.
-                NSString *originalFilePath = self.originalFilePath;
-                UIImage *_Nullable originalImage = self.originalImage;
-                if (originalImage == nil) {
-                    OWSFailDebug(@"originalImage was unexpectedly nil");
-                    failure();
-                } else {
-                    success([[OWSLoadedThumbnail alloc] initWithImage:originalImage filePath:originalFilePath]);
-                }
-                return;
-            }
+    if (self.imageSizePixels.width < 1 || self.imageSizePixels.height < 1) {
+        failure();
+        return;
+    }
 
-            NSString *thumbnailPath = [self pathForThumbnailDimensionPoints:thumbnailDimensionPoints];
-            if ([[NSFileManager defaultManager] fileExistsAtPath:thumbnailPath]) {
-                UIImage *_Nullable image = [UIImage imageWithContentsOfFile:thumbnailPath];
-                if (!image) {
-                    OWSFailDebug(@"couldn't load image.");
-                    failure();
-                } else {
-                    success([[OWSLoadedThumbnail alloc] initWithImage:image filePath:thumbnailPath]);
-                }
-                return;
-            }
+    OWSLoadedThumbnail *_Nullable existingThumbnail =
+        [self existingLoadedThumbnailWithDimensionPoints:thumbnailDimensionPoints];
+    if (existingThumbnail != nil) {
+        success(existingThumbnail);
+        return;
+    }
+
+    [OWSThumbnailService.shared ensureThumbnailForAttachment:self
+                                    thumbnailDimensionPoints:thumbnailDimensionPoints
+                                                     success:success
+                                                     failure:^(NSError *error) {
+                                                         OWSLogError(@"Failed to create thumbnail: %@", error);
+                                                         failure();
+                                                     }];
+}
 
-            [OWSThumbnailService.shared ensureThumbnailForAttachment:self
-                                            thumbnailDimensionPoints:thumbnailDimensionPoints
-                                                             success:success
-                                                             failure:^(NSError *error) {
-                                                                 OWSLogError(@"Failed to create thumbnail: %@", error);
-                                                                 failure();
-                                                             }];
+// Loads a thumbnail that doesn't need to be generated: either the original is
+// already small enough, or the thumbnail has previously been written to disk.
+- (nullable OWSLoadedThumbnail *)existingLoadedThumbnailWithDimensionPoints:(CGFloat)thumbnailDimensionPoints
+{
+    CGSize originalSizePoints = self.imageSizePoints;
+    if (originalSizePoints.width <= thumbnailDimensionPoints && originalSizePoints.height <= thumbnailDimensionPoints
+        && self.isImageMimeType) {
+        // There's no point in generating a thumbnail if the original is smaller than the
+        // thumbnail size. Only do this for images. We still need to generate thumbnails
+        // for videos.
+        NSString *originalFilePath = self.originalFilePath;
+        UIImage *_Nullable originalImage = self.originalImage;
+        if (originalImage == nil) {
+            OWSFailDebug(@"originalImage was unexpectedly nil");
+            return nil;
         }
-    }];
-    return;
+        return [[OWSLoadedThumbnail alloc] initWithImage:originalImage filePath:originalFilePath];
+    }
+
+    NSString *thumbnailPath = [self pathForThumbnailDimensionPoints:thumbnailDimensionPoints];
+    if ([[NSFileManager defaultManager] fileExistsAtPath:thumbnailPath]) {
+        UIImage *_Nullable image = [UIImage imageWithContentsOfFile:thumbnailPath];
+        if (!image) {
+            OWSFailDebug(@"couldn't load image.");
+            return nil;
+        }
+        return [[OWSLoadedThumbnail alloc] initWithImage:image filePath:thumbnailPath];
+    }
+
+    return nil;
 }
 
-- (NSOperationQueue *)thumbnailLoadingOperationQueue
+- (nullable OWSLoadedThumbnail *)loadedThumbnailIfAvailableWithDimensionPoints:(CGFloat)thumbnailDimensionPoints
 {
-    static dispatch_once_t onceToken;
-    static NSOperationQueue *operationQueue;
-    dispatch_once(&onceToken, ^{
-        operationQueue = [NSOperationQueue new];
-        operationQueue.name = @"ThumbnailLoading";
-        operationQueue.maxConcurrentOperationCount = 4;
-    });
-    return operationQueue;
+    if (!self.isValidVisualMedia) {
+        return nil;
+    }
+    if (self.imageSizePixels.width < 1 || self.imageSizePixels.height < 1) {
+        return nil;
+    }
+    return [self existingLoadedThumbnailWithDimensionPoints:thumbnailDimensionPoints];
 }
 
 - (nullable OWSLoadedThumbnail *)loadedThumbnailSyncWithDimensionPoints:(CGFloat)thumbnailDimensionPoints
@@ -900,16 +1279,24 @@ NSString *NSStringForAttachmentThumbnailQuality(TSAttachmentThumbnailQuality val
 
     __block OWSLoadedThumbnail *_Nullable asyncLoadedThumbnail = nil;
     [self loadedThumbnailWithThumbnailDimensionPoints:thumbnailDimensionPoints
+        priority:OWSThumbnailLoadingPriorityVisible
+        cancellationToken:nil
         success:^(OWSLoadedThumbnail *thumbnail) {
+            CFTimeInterval lockStartTime = [ContentionProfiler currentTime];
             @synchronized(self) {
+                [ContentionProfiler.shared recordWaitWithSite:@"TSAttachmentStream.synchronized" startTime:lockStartTime];
                 asyncLoadedThumbnail = thumbnail;
             }
             dispatch_semaphore_signal(semaphore);
         }
         failure:^{ dispatch_semaphore_signal(semaphore); }];
     // Wait up to N seconds.
+    CFTimeInterval waitStartTime = [ContentionProfiler currentTime];
     dispatch_semaphore_wait(semaphore, dispatch_time(DISPATCH_TIME_NOW, (int64_t)(5 * NSEC_PER_SEC)));
+    [ContentionProfiler.shared recordWaitWithSite:@"TSAttachmentStream.loadedThumbnailSync" startTime:waitStartTime];
+    CFTimeInterval lockStartTime = [ContentionProfiler currentTime];
     @synchronized(self) {
+        [ContentionProfiler.shared recordWaitWithSite:@"TSAttachmentStream.synchronized" startTime:lockStartTime];
         return asyncLoadedThumbnail;
     }
 }
@@ -917,21 +1304,26 @@ NSString *NSStringForAttachmentThumbnailQuality(TSAttachmentThumbnailQuality val
 - (nullable UIImage *)thumbnailImageSyncWithQuality:(TSAttachmentThumbnailQuality)quality
 {
     CGFloat thumbnailDimensionPoints = [TSAttachmentStream thumbnailDimensionPointsForThumbnailQuality:quality];
+    UIImage *_Nullable cachedImage = [OWSThumbnailCache.shared imageForUniqueId:self.uniqueId
+                                                       thumbnailDimensionPoints:thumbnailDimensionPoints];
+    if (cachedImage != nil) {
+        return cachedImage;
+    }
     OWSLoadedThumbnail *_Nullable loadedThumbnail =
         [self loadedThumbnailSyncWithDimensionPoints:thumbnailDimensionPoints];
     if (!loadedThumbnail) {
         OWSLogInfo(@"Couldn't load %@ thumbnail sync.", NSStringForAttachmentThumbnailQuality(quality));
         return nil;
     }
+    [OWSThumbnailCache.shared setImage:loadedThumbnail.image
+                           forUniqueId:self.uniqueId
+              thumbnailDimensionPoints:thumbnailDimensionPoints];
     return loadedThumbnail.image;
 }
 
-- (nullable NSData *)thumbnailDataSmallSync
+- (nullable NSData *)thumbnailDataFromLoadedThumbnail:(nullable OWSLoadedThumbnail *)loadedThumbnail
 {
-    OWSLoadedThumbnail *_Nullable loadedThumbnail =
-        [self loadedThumbnailSyncWithDimensionPoints:TSAttachmentStream.thumbnailDimensionPointsSmall];
     if (!loadedThumbnail) {
-        OWSLogInfo(@"Couldn't load small thumbnail sync.");
         return nil;
     }
     NSError *error;
@@ -943,6 +1335,25 @@ NSString *NSStringForAttachmentThumbnailQuality(TSAttachmentThumbnailQuality val
     return data;
 }
 
+- (nullable NSData *)thumbnailDataSmallIfAvailable
+{
+    OWSLoadedThumbnail *_Nullable loadedThumbnail =
+        [self loadedThumbnailIfAvailableWithDimensionPoints:TSAttachmentStream.thumbnailDimensionPointsSmall];
+    return [self thumbnailDataFromLoadedThumbnail:loadedThumbnail];
+}
+
+- (void)thumbnailDataSmallWithCompletion:(void (^)(NSData *_Nullable))completion
+{
+    [self loadedThumbnailWithThumbnailDimensionPoints:TSAttachmentStream.thumbnailDimensionPointsSmall
+        priority:OWSThumbnailLoadingPriorityVisible
+        cancellationToken:nil
+        success:^(OWSLoadedThumbnail *thumbnail) { completion([self thumbnailDataFromLoadedThumbnail:thumbnail]); }
+        failure:^{
+            OWSLogInfo(@"Couldn't load small thumbnail.");
+            completion(nil);
+        }];
+}
+
 - (NSArray<NSString *> *)allSecondaryFilePaths
 {
     NSMutableArray<NSString *> *result = [NSMutableArray new];
@@ -985,6 +1396,8 @@ NSString *NSStringForAttachmentThumbnailQuality(TSAttachmentThumbnailQuality val
     OWSAssertDebug(serverId > 0 || cdnKey.length > 0);
     OWSAssertDebug(uploadTimestamp > 0);
 
+    [TSAttachmentStream.pointerProtoCache removeObjectForKey:self.uniqueId];
+
     [self anyUpdateAttachmentStreamWithTransaction:transaction
                                              block:^(TSAttachmentStream *attachment) {
                                                  [attachment setEncryptionKey:encryptionKey];
@@ -997,20 +1410,39 @@ NSString *NSStringForAttachmentThumbnailQuality(TSAttachmentThumbnailQuality val
                                              }];
 }
 
-- (nullable TSAttachmentStream *)cloneAsThumbnail
+- (nullable TSAttachmentStream *)cloneAsThumbnailIfAvailable
 {
     if (!self.isValidVisualMedia) {
         return nil;
     }
-
-    NSString *thumbnailMimeType = [OWSThumbnailService thumbnailMimetypeForContentType:self.contentType];
-    NSString *thumbnailFileExtension = [OWSThumbnailService thumbnailFileExtensionForContentType:self.contentType];
-
-    NSData *_Nullable thumbnailData = self.thumbnailDataSmallSync;
+    NSData *_Nullable thumbnailData = self.thumbnailDataSmallIfAvailable;
     //  Only some media types have thumbnails
     if (!thumbnailData) {
         return nil;
     }
+    return [self cloneAsThumbnailWithThumbnailData:thumbnailData];
+}
+
+- (void)cloneAsThumbnailWithCompletion:(void (^)(TSAttachmentStream *_Nullable))completion
+{
+    if (!self.isValidVisualMedia) {
+        completion(nil);
+        return;
+    }
+    [self thumbnailDataSmallWithCompletion:^(NSData *_Nullable thumbnailData) {
+        //  Only some media types have thumbnails
+        if (!thumbnailData) {
+            completion(nil);
+            return;
+        }
+        completion([self cloneAsThumbnailWithThumbnailData:thumbnailData]);
+    }];
+}
+
+- (nullable TSAttachmentStream *)cloneAsThumbnailWithThumbnailData:(NSData *)thumbnailData
+{
+    NSString *thumbnailMimeType = [OWSThumbnailService thumbnailMimetypeForContentType:self.contentType];
+    NSString *thumbnailFileExtension = [OWSThumbnailService thumbnailFileExtensionForContentType:self.contentType];
 
     // Copy the thumbnail to a new attachment.
     NSString *thumbnailName =
@@ -1035,7 +1467,74 @@ NSString *NSStringForAttachmentThumbnailQuality(TSAttachmentThumbnailQuality val
 
 // MARK: Protobuf serialization
 
+// Sends fetch a fresh stream for every recipient, so a fan-out would otherwise
+// build the same pointer proto once per recipient. Protos are immutable, so
+// one instance per attachment is shared until its upload fields change.
++ (NSCache<NSString *, TSAttachmentStreamPointerProtoCacheEntry *> *)pointerProtoCache
+{
+    static NSCache *cache;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        cache = [NSCache new];
+        cache.countLimit = 256;
+    });
+    return cache;
+}
+
+// Every field buildProto serializes.
+- (NSString *)pointerProtoUploadFingerprint
+{
+    CGSize imageSizePixels = self.shouldHaveImageSize ? self.imageSizePixels : CGSizeZero;
+    return [NSString stringWithFormat:@"%llu|%@|%u|%@|%@|%llu|%@|%@|%@|%@|%u|%@|%u|%@",
+                     self.serverId,
+                     self.cdnKey,
+                     self.cdnNumber,
+                     [self.encryptionKey base64EncodedStringWithOptions:0],
+                     [self.digest base64EncodedStringWithOptions:0],
+                     self.uploadTimestamp,
+                     self.contentType,
+                     self.caption,
+                     self.blurHash,
+                     self.sourceFilename,
+                     self.byteCount,
+                     self.clientUuid,
+                     self.pointerProtoFlags,
+                     NSStringFromCGSize(imageSizePixels)];
+}
+
+- (UInt32)pointerProtoFlags
+{
+    if (self.attachmentType == TSAttachmentTypeVoiceMessage) {
+        return SSKProtoAttachmentPointerFlagsVoiceMessage;
+    } else if (self.attachmentType == TSAttachmentTypeBorderless) {
+        return SSKProtoAttachmentPointerFlagsBorderless;
+    } else if (self.attachmentType == TSAttachmentTypeGIF || self.isAnimatedContent) {
+        return SSKProtoAttachmentPointerFlagsGif;
+    } else {
+        return 0;
+    }
+}
+
 - (nullable SSKProtoAttachmentPointer *)buildProto
+{
+    NSString *uploadFingerprint = [self pointerProtoUploadFingerprint];
+    TSAttachmentStreamPointerProtoCacheEntry *_Nullable cacheEntry =
+        [TSAttachmentStream.pointerProtoCache objectForKey:self.uniqueId];
+    if (cacheEntry != nil && [cacheEntry.uploadFingerprint isEqualToString:uploadFingerprint]) {
+        return cacheEntry.proto;
+    }
+
+    SSKProtoAttachmentPointer *_Nullable proto = [self buildProtoUncached];
+    if (proto != nil) {
+        [TSAttachmentStream.pointerProtoCache
+            setObject:[[TSAttachmentStreamPointerProtoCacheEntry alloc] initWithUploadFingerprint:uploadFingerprint
+                                                                                           proto:proto]
+               forKey:self.uniqueId];
+    }
+    return proto;
+}
+
+- (nullable SSKProtoAttachmentPointer *)buildProtoUncached
 {
     BOOL isValidV1orV2 = self.serverId > 0;
     BOOL isValidV3 = (self.cdnKey.length > 0 && self.cdnNumber > 0);
@@ -1073,15 +1572,7 @@ NSString *NSStringForAttachmentThumbnailQuality(TSAttachmentThumbnailQuality val
         }
     }
 
-    if (self.attachmentType == TSAttachmentTypeVoiceMessage) {
-        builder.flags = SSKProtoAttachmentPointerFlagsVoiceMessage;
-    } else if (self.attachmentType == TSAttachmentTypeBorderless) {
-        builder.flags = SSKProtoAttachmentPointerFlagsBorderless;
-    } else if (self.attachmentType == TSAttachmentTypeGIF || self.isAnimatedContent) {
-        builder.flags = SSKProtoAttachmentPointerFlagsGif;
-    } else {
-        builder.flags = 0;
-    }
+    builder.flags = self.pointerProtoFlags;
 
     if (self.blurHash.length > 0) {
         builder.blurHash = self.blurHash;
@@ -28,4 +28,47 @@ extension TSAttachmentStream {
             tx: tx.asV2Write
         )
     }
+
+    private static let fileRemovalQueue = DispatchQueue(label: "org.signal.attachment-file-removal", qos: .utility)
+
+    /// Removes the attachment's files once the transaction that removed it
+    /// has committed.
+    ///
+    /// Deleting a large thread removes thousands of attachments, and deleting
+    /// their files inline would hold the write lock for most of that time.
+    /// If the app exits before the files are removed, orphan data cleanup
+    /// removes them later.
+    @objc
+    internal func scheduleFileRemoval(tx: SDSAnyWriteTransaction) {
+        tx.addAsyncCompletion(queue: Self.fileRemovalQueue) {
+            self.removeFile()
+        }
+    }
+
+    /// Decodes an audio attachment once at ingest, writing its waveform and
+    /// returning its decoded duration, so neither is computed on first display.
+    /// Returns nil if the caller should fall back to the on-demand paths.
+    @objc
+    internal func analyzeIngestedAudio() -> NSNumber? {
+        // Decoding the whole file is too memory-hungry for the NSE.
+        guard !CurrentAppContext().isNSE else {
+            return nil
+        }
+        guard let audioPath = originalFilePath, let waveformPath = audioWaveformPath else {
+            return nil
+        }
+        do {
+            let decodedDuration = try DependenciesBridge.shared.audioWaveformManager.analyzeAudioSync(
+                forAudioPath: audioPath,
+                waveformPath: waveformPath
+            )
+            guard let decodedDuration, decodedDuration > 0 else {
+                return nil
+            }
+            return NSNumber(value: decodedDuration)
+        } catch {
+            Logger.warn("Could not analyze ingested audio: \(error)")
+            return nil
+        }
+    }
 }
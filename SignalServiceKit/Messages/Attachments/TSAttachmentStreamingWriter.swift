@@ -0,0 +1,169 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import CryptoKit
+import Foundation
+import ImageIO
+import UniformTypeIdentifiers
+
+/// What was learned about an attachment's plaintext while it was being written.
+@objc
+public class TSAttachmentStreamingWriteResult: NSObject {
+    /// The SHA-256 digest of the plaintext.
+    @objc
+    public let plaintextSha256Digest: Data
+
+    /// The MIME type implied by the file's header, if it was recognized as an image.
+    @objc
+    public let sniffedMimeType: String?
+
+    /// The image's size in pixels, read from its header; zero if unknown.
+    @objc
+    public let imageSizePixels: CGSize
+
+    init(plaintextSha256Digest: Data, sniffedMimeType: String?, imageSizePixels: CGSize) {
+        self.plaintextSha256Digest = plaintextSha256Digest
+        self.sniffedMimeType = sniffedMimeType
+        self.imageSizePixels = imageSizePixels
+    }
+}
+
+// MARK: -
+
+/// Copies a DataSource into an attachment file in fixed-size chunks.
+///
+/// In the same pass, each chunk is hashed, and the leading chunks are fed to
+/// an incremental ImageIO source until it can report the image's type and
+/// dimensions, so neither needs another read of the file.
+@objc
+public class TSAttachmentStreamingWriter: NSObject {
+
+    private static let chunkSize = 1024 * 1024
+
+    /// Image headers (including EXIF, which can embed a thumbnail) are
+    /// expected within this many leading bytes.
+    private static let maxHeaderByteCount = 512 * 1024
+
+    private override init() {}
+
+    @objc
+    public static func write(copying dataSource: DataSource, to dstUrl: URL) throws -> TSAttachmentStreamingWriteResult {
+        // Asking an in-memory source for its URL would write it to disk first.
+        guard dataSource is DataSourcePath, let srcUrl = dataSource.dataUrl else {
+            let data = dataSource.data
+            try data.write(to: dstUrl, options: .atomic)
+            let (sniffedMimeType, imageSizePixels) = probeHeader(of: CGImageSourceCreateWithData(data as CFData, nil))
+            return TSAttachmentStreamingWriteResult(
+                plaintextSha256Digest: Data(SHA256.hash(data: data)),
+                sniffedMimeType: sniffedMimeType,
+                imageSizePixels: imageSizePixels
+            )
+        }
+        return try write(copyingFileAt: srcUrl, to: dstUrl)
+    }
+
+    public static func write(copyingFileAt srcUrl: URL, to dstUrl: URL) throws -> TSAttachmentStreamingWriteResult {
+        let inputFile = try FileHandle(forReadingFrom: srcUrl)
+        defer { try? inputFile.close() }
+
+        guard FileManager.default.createFile(
+            atPath: dstUrl.path,
+            contents: nil,
+            attributes: [.protectionKey: FileProtectionType.completeUntilFirstUserAuthentication]
+        ) else {
+            throw OWSAssertionError("Cannot create output file.")
+        }
+        do {
+            let outputFile = try FileHandle(forWritingTo: dstUrl)
+            defer { try? outputFile.close() }
+
+            var sha256 = SHA256()
+            var headerProbe = IncrementalHeaderProbe(maxByteCount: maxHeaderByteCount)
+            while true {
+                let didCopy: Bool = try autoreleasepool {
+                    guard let chunk = try inputFile.read(upToCount: chunkSize), !chunk.isEmpty else {
+                        return false
+                    }
+                    try outputFile.write(contentsOf: chunk)
+                    sha256.update(data: chunk)
+                    headerProbe.append(chunk)
+                    return true
+                }
+                guard didCopy else {
+                    break
+                }
+            }
+            let (sniffedMimeType, imageSizePixels) = headerProbe.finish()
+            return TSAttachmentStreamingWriteResult(
+                plaintextSha256Digest: Data(sha256.finalize()),
+                sniffedMimeType: sniffedMimeType,
+                imageSizePixels: imageSizePixels
+            )
+        } catch {
+            // Don't leave a partial attachment file behind.
+            try? FileManager.default.removeItem(at: dstUrl)
+            throw error
+        }
+    }
+
+    /// Feeds the leading bytes of a file to ImageIO until it knows the
+    /// image's type and size, or until `maxByteCount` bytes have been seen.
+    private struct IncrementalHeaderProbe {
+        private let maxByteCount: Int
+        private let imageSource = CGImageSourceCreateIncremental(nil)
+        // ImageIO wants all of the data so far on every update.
+        private var headerBytes = Data()
+        private var result: (sniffedMimeType: String?, imageSizePixels: CGSize)?
+
+        init(maxByteCount: Int) {
+            self.maxByteCount = maxByteCount
+        }
+
+        mutating func append(_ chunk: Data) {
+            guard result == nil, headerBytes.count < maxByteCount else {
+                return
+            }
+            headerBytes.append(chunk.prefix(maxByteCount - headerBytes.count))
+            CGImageSourceUpdateData(imageSource, headerBytes as CFData, false)
+            let probed = TSAttachmentStreamingWriter.probeHeader(of: imageSource)
+            if probed.imageSizePixels != .zero {
+                result = probed
+                headerBytes = Data()
+            }
+        }
+
+        mutating func finish() -> (sniffedMimeType: String?, imageSizePixels: CGSize) {
+            if let result {
+                return result
+            }
+            // The whole file fit within the limit; let ImageIO know it's complete.
+            CGImageSourceUpdateData(imageSource, headerBytes as CFData, headerBytes.count < maxByteCount)
+            return TSAttachmentStreamingWriter.probeHeader(of: imageSource)
+        }
+    }
+
+    /// Asks ImageIO for the image's type and dimensions without decoding it.
+    private static func probeHeader(of imageSource: CGImageSource?) -> (sniffedMimeType: String?, imageSizePixels: CGSize) {
+        guard
+            let imageSource,
+            let typeIdentifier = CGImageSourceGetType(imageSource) as String?,
+            let properties = CGImageSourceCopyPropertiesAtIndex(imageSource, 0, nil) as? [CFString: Any],
+            let width = properties[kCGImagePropertyPixelWidth] as? NSNumber,
+            let height = properties[kCGImagePropertyPixelHeight] as? NSNumber
+        else {
+            return (nil, .zero)
+        }
+        return (UTType(typeIdentifier)?.preferredMIMEType, imageSize(width: width, height: height, properties: properties))
+    }
+
+    private static func imageSize(width: NSNumber, height: NSNumber, properties: [CFString: Any]) -> CGSize {
+        // EXIF orientations 5-8 rotate the image by 90 degrees.
+        let orientation = (properties[kCGImagePropertyOrientation] as? NSNumber)?.intValue ?? 1
+        if orientation >= 5 {
+            return CGSize(width: height.doubleValue, height: width.doubleValue)
+        }
+        return CGSize(width: width.doubleValue, height: height.doubleValue)
+    }
+}
@@ -82,6 +82,12 @@ extension AttachmentStream: TSResourceStream {
     public func computeIsValidVisualMedia() -> Bool {
         return contentType.isVisualMedia
     }
+
+    public func decryptedImage(maxDimensionPoints: CGFloat) throws -> UIImage {
+        // The file is encrypted on disk, so there is nothing for ImageIO
+        // to downsample from; decode it as usual.
+        return try decryptedImage()
+    }
 }
 
 extension AttachmentStream: TSResource {
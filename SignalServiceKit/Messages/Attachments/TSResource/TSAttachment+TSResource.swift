@@ -109,10 +109,7 @@ extension TSAttachment: TSResource {
 extension TSAttachmentStream: TSResourceStream {
 
     public func decryptedRawData() throws -> Data {
-        guard let originalFilePath else {
-            throw OWSAssertionError("Missing file path!")
-        }
-        return try NSData(contentsOfFile: originalFilePath) as Data
+        return try readMappedDataFromFile()
     }
 
     public func decryptedLongText() throws -> String {
@@ -136,6 +133,13 @@ extension TSAttachmentStream: TSResourceStream {
         return originalImage
     }
 
+    public func decryptedImage(maxDimensionPoints: CGFloat) throws -> UIImage {
+        guard let image = self.originalImage(maxDimensionPoints: maxDimensionPoints) else {
+            throw OWSAssertionError("Not a valid image!")
+        }
+        return image
+    }
+
     public func decryptedYYImage() throws -> YYImage {
         guard let filePath = self.originalFilePath else {
             throw OWSAssertionError("Missing file")
@@ -280,16 +284,27 @@ extension TSAttachmentStream: TSResourceStream {
     // MARK: - Thumbnails
 
     public func thumbnailImage(quality: AttachmentThumbnailQuality) async -> UIImage? {
-        return await withCheckedContinuation { continuation in
-            self.thumbnailImage(
-                quality: quality.tsQuality,
-                success: { image in
-                    continuation.resume(returning: image)
-                },
-                failure: {
-                    continuation.resume(returning: nil)
+        let cancellationToken = OWSThumbnailLoadingToken()
+        return await withTaskCancellationHandler {
+            return await withCheckedContinuation { continuation in
+                let cachedImage = self.thumbnailImage(
+                    quality: quality.tsQuality,
+                    priority: .visible,
+                    cancellationToken: cancellationToken,
+                    success: { image in
+                        continuation.resume(returning: image)
+                    },
+                    failure: {
+                        continuation.resume(returning: nil)
+                    }
+                )
+                // On cache hit, neither completion block is invoked.
+                if let cachedImage {
+                    continuation.resume(returning: cachedImage)
                 }
-            )
+            }
+        } onCancel: {
+            cancellationToken.cancel()
         }
     }
 
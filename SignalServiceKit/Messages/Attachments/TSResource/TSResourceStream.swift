@@ -22,6 +22,11 @@ public protocol TSResourceStream: TSResource {
     /// Throws an error if reading/decrypting the file fails or the data is incompatible with UIImage.
     func decryptedImage() throws -> UIImage
 
+    /// Like `decryptedImage()`, but for display: where the file can be downsampled
+    /// as it's decoded, the image is at most `maxDimensionPoints` (at screen scale)
+    /// along its longest edge, so peak memory doesn't grow with the original's resolution.
+    func decryptedImage(maxDimensionPoints: CGFloat) throws -> UIImage
+
     /// Interprets the data on disk as a YYImage.
     /// Throws an error if reading/decrypting the file fails or the data is incompatible with YYImage.
     /// YYImage is typically used for animated images, but is a subclass of UIImage and supports stills too.
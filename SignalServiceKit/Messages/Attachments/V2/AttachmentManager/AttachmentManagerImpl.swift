@@ -39,11 +39,16 @@ public class AttachmentManagerImpl: AttachmentManager {
         guard protos.count < UInt32.max else {
             throw OWSAssertionError("Input array too large")
         }
+        // Prepare every pointer before inserting any of them, so that the
+        // inserts only write rows that have already been built.
+        let preparedPointers = try protos.map { ownedProto in
+            return try PreparedAttachmentPointer(proto: ownedProto.proto)
+        }
         try createAttachments(
-            protos,
-            mimeType: \.proto.contentType,
-            owner: \.owner,
-            output: \.proto,
+            Array(zip(protos, preparedPointers)),
+            mimeType: { $0.0.proto.contentType },
+            owner: { $0.0.owner },
+            output: { $0.1 },
             createFn: self._createAttachmentPointer(from:owner:sourceOrder:tx:),
             tx: tx
         )
@@ -214,63 +219,25 @@ public class AttachmentManagerImpl: AttachmentManager {
     }
 
     private func _createAttachmentPointer(
-        from proto: SSKProtoAttachmentPointer,
+        from preparedPointer: PreparedAttachmentPointer,
         owner: OwnerBuilder,
         // Nil if no order is to be applied.
         sourceOrder: UInt32?,
         tx: DBWriteTransaction
     ) throws {
-        let transitTierInfo = try self.transitTierInfo(from: proto)
-
-        let knownIdFromProto: OwnerBuilder.KnownIdInOwner = {
-            if
-                let uuidData = proto.clientUuid,
-                let uuid = UUID(data: uuidData)
-            {
-                return .known(uuid)
-            } else {
-                return .knownNil
-            }
-        }()
-
-        let sourceFilename = proto.fileName
-        let mimeType = self.mimeType(
-            fromProtoContentType: proto.contentType,
-            sourceFilename: sourceFilename
-        )
-
-        let attachmentParams = Attachment.ConstructionParams.fromPointer(
-            blurHash: proto.blurHash,
-            mimeType: mimeType,
-            encryptionKey: transitTierInfo.encryptionKey,
-            transitTierInfo: transitTierInfo
-        )
-        let sourceMediaSizePixels: CGSize?
-        if
-            proto.width > 0,
-            let width = CGFloat(exactly: proto.width),
-            proto.height > 0,
-            let height = CGFloat(exactly: proto.height)
-        {
-            sourceMediaSizePixels = CGSize(width: width, height: height)
-        } else {
-            sourceMediaSizePixels = nil
-        }
-
+        let attachmentParams = preparedPointer.attachmentParams
         let referenceParams = AttachmentReference.ConstructionParams(
             owner: try owner.build(
                 orderInOwner: sourceOrder,
-                knownIdInOwner: knownIdFromProto,
-                renderingFlag: .fromProto(proto),
+                knownIdInOwner: preparedPointer.knownIdInOwner,
+                renderingFlag: preparedPointer.renderingFlag,
                 // Not downloaded so we don't know the content type.
                 contentType: nil,
-                // This should be unset for newly-incoming attachments, but it's
-                // still technically in the proto definition.
-                caption: proto.hasCaption ? proto.caption : nil
+                caption: preparedPointer.caption
             ),
-            sourceFilename: sourceFilename,
-            sourceUnencryptedByteCount: proto.size,
-            sourceMediaSizePixels: sourceMediaSizePixels
+            sourceFilename: preparedPointer.sourceFilename,
+            sourceUnencryptedByteCount: preparedPointer.sourceUnencryptedByteCount,
+            sourceMediaSizePixels: preparedPointer.sourceMediaSizePixels
         )
 
         try attachmentStore.insert(
@@ -279,6 +246,11 @@ public class AttachmentManagerImpl: AttachmentManager {
             tx: tx
         )
 
+        if let blurHash = attachmentParams.blurHash {
+            // The pointer will be shown with its blurHash until it's downloaded.
+            BlurHash.prewarmImage(for: blurHash)
+        }
+
         if let mediaName = attachmentParams.mediaName {
             try orphanedBackupAttachmentManager.didCreateOrUpdateAttachment(
                 withMediaName: mediaName,
@@ -314,7 +286,7 @@ public class AttachmentManagerImpl: AttachmentManager {
         }
     }
 
-    private func transitTierInfo(
+    static func transitTierInfo(
         from proto: SSKProtoAttachmentPointer
     ) throws -> Attachment.TransitTierInfo {
         let cdnNumber = proto.cdnNumber
@@ -356,7 +328,7 @@ public class AttachmentManagerImpl: AttachmentManager {
         } ?? .knownNil
 
         let sourceFilename = proto.fileName.nilIfEmpty
-        let mimeType = self.mimeType(
+        let mimeType = Self.mimeType(
             fromProtoContentType: proto.contentType,
             sourceFilename: sourceFilename
         )
@@ -567,7 +539,7 @@ public class AttachmentManagerImpl: AttachmentManager {
         ))
     }
 
-    private func mimeType(
+    static func mimeType(
         fromProtoContentType contentType: String?,
         sourceFilename: String?
     ) -> String {
@@ -788,7 +760,7 @@ public class AttachmentManagerImpl: AttachmentManager {
         switch dataSource.source.source {
         case .pointer(let proto):
             try self._createAttachmentPointer(
-                from: proto,
+                from: PreparedAttachmentPointer(proto: proto),
                 owner: referenceOwner,
                 sourceOrder: nil,
                 tx: tx
@@ -814,7 +786,7 @@ public class AttachmentManagerImpl: AttachmentManager {
                 originalAttachment.asStream() == nil,
                 let thumbnailProtoFromSender = originalAttachmentSource.thumbnailPointerFromSender,
                 let mimeType = thumbnailProtoFromSender.contentType,
-                let transitTierInfo = try? self.transitTierInfo(from: thumbnailProtoFromSender)
+                let transitTierInfo = try? Self.transitTierInfo(from: thumbnailProtoFromSender)
             {
                 // If the original is undownloaded, prefer to use the thumbnail
                 // pointer from the sender.
@@ -15,6 +15,69 @@ public struct OwnedAttachmentPointerProto {
     }
 }
 
+/// An attachment pointer proto from its sender, validated and converted into
+/// everything about the attachment and its reference except the owner.
+///
+/// Preparing a pointer doesn't need a transaction, so every pointer in a
+/// message is validated before the first attachment is inserted.
+struct PreparedAttachmentPointer {
+    let proto: SSKProtoAttachmentPointer
+
+    let attachmentParams: Attachment.ConstructionParams
+    let knownIdInOwner: AttachmentReference.OwnerBuilder.KnownIdInOwner
+    let renderingFlag: AttachmentReference.RenderingFlag
+    let caption: String?
+    let sourceFilename: String?
+    let sourceUnencryptedByteCount: UInt32
+    let sourceMediaSizePixels: CGSize?
+
+    init(proto: SSKProtoAttachmentPointer) throws {
+        let transitTierInfo = try AttachmentManagerImpl.transitTierInfo(from: proto)
+
+        self.proto = proto
+
+        if
+            let uuidData = proto.clientUuid,
+            let uuid = UUID(data: uuidData)
+        {
+            self.knownIdInOwner = .known(uuid)
+        } else {
+            self.knownIdInOwner = .knownNil
+        }
+
+        let sourceFilename = proto.fileName
+        let mimeType = AttachmentManagerImpl.mimeType(
+            fromProtoContentType: proto.contentType,
+            sourceFilename: sourceFilename
+        )
+
+        self.attachmentParams = .fromPointer(
+            blurHash: proto.blurHash,
+            mimeType: mimeType,
+            encryptionKey: transitTierInfo.encryptionKey,
+            transitTierInfo: transitTierInfo
+        )
+
+        if
+            proto.width > 0,
+            let width = CGFloat(exactly: proto.width),
+            proto.height > 0,
+            let height = CGFloat(exactly: proto.height)
+        {
+            self.sourceMediaSizePixels = CGSize(width: width, height: height)
+        } else {
+            self.sourceMediaSizePixels = nil
+        }
+
+        self.renderingFlag = .fromProto(proto)
+        // This should be unset for newly-incoming attachments, but it's
+        // still technically in the proto definition.
+        self.caption = proto.hasCaption ? proto.caption : nil
+        self.sourceFilename = sourceFilename
+        self.sourceUnencryptedByteCount = proto.size
+    }
+}
+
 public struct OwnedAttachmentBackupPointerProto {
     public let proto: BackupProto_FilePointer
     public let renderingFlag: AttachmentReference.RenderingFlag
@@ -228,27 +228,53 @@ public class TSAttachmentManager {
         }
 
         // OH GOD THIS IS HORRIBLE keeping this now because this code will be deprecated/deleted soon.
-        // If we happen to be handed a write transaction, we can perform the clone synchronously
-        // Otherwise, just hand the caller what we have. We'll clone it async.
-        if let writeTx = tx as? SDSAnyWriteTransaction {
-            return Self.refetchMessageAndCreateThumbnailIfNeeded(
+        // If we happen to be handed a write transaction and the thumbnail already exists, we can
+        // perform the clone synchronously. Otherwise, just hand the caller what we have; we'll
+        // generate the thumbnail off the transaction and clone it async.
+        if
+            let writeTx = tx as? SDSAnyWriteTransaction,
+            let attachmentStream = attachment as? TSAttachmentStream,
+            let thumbnailClone = attachmentStream.cloneAsThumbnailIfAvailable()
+        {
+            return Self.refetchMessageAndSetThumbnailIfNeeded(
+                thumbnailClone,
                 originalParentMessageInstance: parentMessage,
                 tx: writeTx
-            )
-        } else {
-            SSKEnvironment.shared.databaseStorageRef.asyncWrite { writeTx in
-                _ = Self.refetchMessageAndCreateThumbnailIfNeeded(
-                    originalParentMessageInstance: parentMessage,
+            ) ?? attachment
+        }
+        if let attachmentStream = attachment as? TSAttachmentStream {
+            Self.cloneThumbnailAsync(attachmentStream, originalParentMessageInstance: parentMessage)
+        }
+        return attachment
+    }
+
+    private static func cloneThumbnailAsync(
+        _ attachmentStream: TSAttachmentStream,
+        originalParentMessageInstance: TSMessage
+    ) {
+        Task {
+            Logger.info("Cloning attachment to thumbnail")
+            guard let thumbnailClone = await attachmentStream.cloneAsThumbnail() else {
+                Logger.error("Unable to clone")
+                return
+            }
+            await SSKEnvironment.shared.databaseStorageRef.awaitableWrite { writeTx in
+                _ = Self.refetchMessageAndSetThumbnailIfNeeded(
+                    thumbnailClone,
+                    originalParentMessageInstance: originalParentMessageInstance,
                     tx: writeTx
                 )
             }
-            return attachment
         }
     }
 
     /// Very important that this method is static; we call it from an async write so we need to reload everything,
     /// including the OWSAttachmentInfo, and not used the same instance with the same cached value.
-    private static func refetchMessageAndCreateThumbnailIfNeeded(
+    ///
+    /// `thumbnailClone` is an unsaved clone of the quoted attachment stream; it's inserted only if the
+    /// quoted message still needs it, and its file is removed otherwise.
+    private static func refetchMessageAndSetThumbnailIfNeeded(
+        _ thumbnailClone: TSAttachmentStream,
         originalParentMessageInstance: TSMessage,
         tx: SDSAnyWriteTransaction
     ) -> TSAttachmentStream? {
@@ -259,14 +285,13 @@ public class TSAttachmentManager {
             let quotedMessage = refetchedMessage.quotedMessage,
             let info = quotedMessage.attachmentInfo()
         else {
+            thumbnailClone.removeFile()
             return nil
         }
 
-        // We want to clone the existing attachment to a new attachment if necessary. This means:
-        // - Fetching the attachment and making sure it's an attachment stream
-        // - If we already own the attachment, we've already cloned it!
-        // - Otherwise, we should copy the attachment stream to a new attachment
-        // - Updating the message's state to now point to the new attachment
+        // We want to use the clone only if:
+        // - The quoted attachment is still an attachment stream
+        // - We don't already own a thumbnail (e.g. a concurrent clone won the race)
         guard
             let attachmentId = info.attachmentId,
             let attachmentStream = TSAttachment.anyFetch(
@@ -275,20 +300,16 @@ public class TSAttachmentManager {
             ) as? TSAttachmentStream
         else {
             // No stream, nothing to clone. exit early.
+            thumbnailClone.removeFile()
             return nil
         }
 
         if info.attachmentType.isThumbnailOwned {
             // We already own it, nothing to do!
+            thumbnailClone.removeFile()
             return attachmentStream
         }
 
-        // Do this outside the anyUpdateMessage block because that can get executed more than once.
-        Logger.info("Cloning attachment to thumbnail")
-        guard let thumbnailClone = attachmentStream.cloneAsThumbnail() else {
-            Logger.error("Unable to clone")
-            return nil
-        }
         thumbnailClone.anyInsert(transaction: tx)
 
         originalParentMessageInstance.anyUpdateMessage(transaction: tx) { message in
@@ -323,7 +344,7 @@ public class TSAttachmentManager {
             MimeTypeUtil.isSupportedVisualMediaMimeType(stream.mimeType)
         {
             // We found an attachment stream on the original message! Use it as our quoted attachment
-            if let thumbnail = stream.cloneAsThumbnail() {
+            if let thumbnail = stream.cloneAsThumbnailIfAvailable() {
                 thumbnail.anyInsert(transaction: tx)
                 return .init(
                     info: OWSAttachmentInfo(
@@ -333,8 +354,23 @@ public class TSAttachmentManager {
                     renderingFlag: thumbnail.attachmentType.asRenderingFlag
                 )
             } else {
-                owsFailDebug("Unable to clone!")
-                return nil
+                // The thumbnail hasn't been generated yet, and we mustn't block this transaction
+                // waiting on it. Reference the original for now; it'll be cloned to a thumbnail
+                // the first time the quote loads its thumbnail.
+                _ = stream.thumbnailImage(
+                    quality: .small,
+                    priority: .background,
+                    cancellationToken: nil,
+                    success: { _ in },
+                    failure: {}
+                )
+                return .init(
+                    info: OWSAttachmentInfo(
+                        legacyAttachmentId: stream.uniqueId,
+                        ofType: .original
+                    ),
+                    renderingFlag: stream.attachmentType.asRenderingFlag
+                )
             }
 
         } else if
@@ -421,7 +457,6 @@ public class TSAttachmentManager {
             ) else {
                 throw OWSAssertionError("Missing source attachment!")
             }
-            let data = try existingAttachment.readDataFromFile()
             attachment = TSAttachmentStream(
                 contentType: dataSource.mimeType,
                 byteCount: existingAttachment.byteCount,
@@ -430,7 +465,8 @@ public class TSAttachmentManager {
                 attachmentType: dataSource.renderingFlag.tsAttachmentType,
                 albumMessageId: albumMessageId
             )
-            try attachment.write(data)
+            // Forwarding links to the existing file rather than copying it.
+            try attachment.writeSharingFile(of: existingAttachment)
         }
         return attachment
     }
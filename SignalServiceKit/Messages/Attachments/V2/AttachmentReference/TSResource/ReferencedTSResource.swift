@@ -42,7 +42,7 @@ public class ReferencedTSResource {
         case (.v2(let reference), .v2(let attachment)):
             return ReferencedAttachment(reference: reference, attachment: attachment).previewText()
         case (.legacy(_), .legacy(let attachment)):
-            return attachment.previewText()
+            return PreviewTextCache.shared.attachmentPreviewText(attachment)
         case (.v2, .legacy), (.legacy, .v2):
             owsFailDebug("Invalid combination!")
             return ""
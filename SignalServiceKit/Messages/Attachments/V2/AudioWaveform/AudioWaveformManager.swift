@@ -37,6 +37,15 @@ public protocol AudioWaveformManager {
         forAudioPath audioPath: String
     ) throws -> AudioWaveform
 
+    /// No caching, no enqueueing.
+    /// Decodes the audio once, writing its waveform to `waveformPath` and returning
+    /// the decoded duration in seconds, or nil if the waveform already existed.
+    /// Meant for ingest, so that neither is computed when the audio is first shown.
+    func analyzeAudioSync(
+        forAudioPath audioPath: String,
+        waveformPath: String
+    ) throws -> TimeInterval?
+
     /// No caching, no enqueueing.
     /// Generates an audio waveform synchronously, blocking on file I/O operations.
     func audioWaveformSync(
@@ -151,6 +151,16 @@ public class AudioWaveformManagerImpl: AudioWaveformManager {
         )
     }
 
+    public func analyzeAudioSync(
+        forAudioPath audioPath: String,
+        waveformPath: String
+    ) throws -> TimeInterval? {
+        return try _analyzeAudio(
+            source: .unencryptedFile(path: audioPath),
+            waveformPath: waveformPath
+        ).decodedDuration
+    }
+
     private enum AVAssetSource {
         case unencryptedFile(path: String)
         case encryptedFile(
@@ -214,11 +224,20 @@ public class AudioWaveformManagerImpl: AudioWaveformManager {
         // If non-nil, writes the waveform to this output file.
         waveformPath: String?
     ) throws -> AudioWaveform {
+        return try _analyzeAudio(source: source, waveformPath: waveformPath).waveform
+    }
+
+    /// `decodedDuration` is nil if the waveform was read from disk rather than decoded.
+    private func _analyzeAudio(
+        source: AVAssetSource,
+        // If non-nil, writes the waveform to this output file.
+        waveformPath: String?
+    ) throws -> (waveform: AudioWaveform, decodedDuration: TimeInterval?) {
         if let waveformPath {
             if FileManager.default.fileExists(atPath: waveformPath) {
                 // We have a cached waveform on disk, read it into memory.
                 do {
-                    return try AudioWaveform(contentsOfFile: waveformPath)
+                    return (try AudioWaveform(contentsOfFile: waveformPath), nil)
                 } catch {
                     owsFailDebug("Error: \(error)")
 
@@ -250,7 +269,7 @@ public class AudioWaveformManagerImpl: AudioWaveformManager {
             throw AudioWaveformError.audioTooLong
         }
 
-        let waveform = try sampleWaveform(asset: asset)
+        let (waveform, decodedDuration) = try sampleWaveform(asset: asset)
 
         if let waveformPath {
             do {
@@ -273,7 +292,7 @@ public class AudioWaveformManagerImpl: AudioWaveformManager {
             }
         }
 
-        return waveform
+        return (waveform, decodedDuration)
     }
 
     private func assetFromUnencryptedAudioFile(
@@ -324,7 +343,7 @@ public class AudioWaveformManagerImpl: AudioWaveformManager {
     /// It's too intensive to sample a waveform for really long audio files.
     fileprivate static let maximumDuration: TimeInterval = 15 * kMinuteInterval
 
-    private func sampleWaveform(asset: AVAsset) throws -> AudioWaveform {
+    private func sampleWaveform(asset: AVAsset) throws -> (AudioWaveform, TimeInterval) {
         try Task.checkCancellation()
 
         guard let assetReader = try? AVAssetReader(asset: asset) else {
@@ -350,19 +369,22 @@ public class AudioWaveformManagerImpl: AudioWaveformManager {
         )
         assetReader.add(trackOutput)
 
-        let decibelSamples = try readDecibels(from: assetReader)
+        let (decibelSamples, decodedDuration) = try readDecibels(from: assetReader)
 
         try Task.checkCancellation()
 
-        return AudioWaveform(decibelSamples: decibelSamples)
+        return (AudioWaveform(decibelSamples: decibelSamples), CMTimeGetSeconds(decodedDuration))
     }
 
-    private func readDecibels(from assetReader: AVAssetReader) throws -> [Float] {
+    /// Also returns the total duration of the decoded sample buffers, which is
+    /// the audio's true duration regardless of container metadata.
+    private func readDecibels(from assetReader: AVAssetReader) throws -> ([Float], CMTime) {
         let sampler = AudioWaveformSampler(
             inputCount: sampleCount(from: assetReader),
             outputCount: AudioWaveform.sampleCount
         )
 
+        var decodedDuration = CMTime.zero
         assetReader.startReading()
         while assetReader.status == .reading {
             // Stop reading if the operation is cancelled.
@@ -397,10 +419,14 @@ public class AudioWaveformManagerImpl: AudioWaveformManager {
             }
             let bufferPointer = UnsafeBufferPointer(start: dataPointer, count: lengthAtOffset)
             bufferPointer.withMemoryRebound(to: Int16.self) { sampler.update($0) }
+            let bufferDuration = CMSampleBufferGetDuration(nextSampleBuffer)
+            if bufferDuration.isNumeric {
+                decodedDuration = CMTimeAdd(decodedDuration, bufferDuration)
+            }
             CMSampleBufferInvalidate(nextSampleBuffer)
         }
 
-        return sampler.finalize()
+        return (sampler.finalize(), decodedDuration)
     }
 
     private func sampleCount(from assetReader: AVAssetReader) -> Int {
@@ -39,6 +39,13 @@ public class AudioWaveformManagerMock: AudioWaveformManager {
         return AudioWaveform(decibelSamples: [])
     }
 
+    public func analyzeAudioSync(
+        forAudioPath audioPath: String,
+        waveformPath: String
+    ) throws -> TimeInterval? {
+        return nil
+    }
+
     public func audioWaveformSync(
         forEncryptedAudioFileAtPath filePath: String,
         encryptionKey: Data,
@@ -22,6 +22,7 @@ public class TSAttachmentDownloadManager: NSObject {
     private var completeAttachmentMap = LRUCache<AttachmentId, Bool>(maxSize: 256)
 
     private let appReadiness: AppReadiness
+    private let pointerStateUpdater = TSAttachmentPointerStateUpdater()
     private static let schedulers: Schedulers = DispatchQueueSchedulers()
     private var schedulers: Schedulers { Self.schedulers }
 
@@ -181,60 +182,68 @@ public class TSAttachmentDownloadManager: NSObject {
         return Self.unfairLock.withLock {
             let kMaxSimultaneousDownloads: Int = CurrentAppContext().isNSE ? 1 : 4
             let maxNumJobsToRun = kMaxSimultaneousDownloads - activeJobMap.count
-            guard maxNumJobsToRun > 0 else {
+            guard maxNumJobsToRun > 0, !jobQueue.isEmpty else {
                 return []
             }
             var indexesToRemove = [Int]()
             var jobsToRun = [(Job, TSAttachmentPointer)]()
+            var cancelledJobs = [Job]()
+
+            // Every job we prepare shares one write transaction, rather than
+            // one transaction per job.
+            SSKEnvironment.shared.databaseStorageRef.write { transaction in
+                // Go through each job in the queue, until we find jobs we can run,
+                // up to the count we can run at a time.
+                // Either:
+                // 1. The job can be run: assign it to jobToRun and break
+                // 2. The job can't be run yet, but might be later: leave it in the queue
+                // 3. The job is running already: join its promise to the running instance & remove
+                // 4. The already finished: remove it (we don't assign the promise as we assume
+                //    downstream actions already happened)
+                // 5. The job has been cancelled or attachment deleted: reject it and remove it
+                jobLoop: for (index, job) in jobQueue.enumerated() {
+                    if _shouldCancelJobWithinLock(job, asOfDate: Date()) {
+                        // Job is cancelled! Fail it (once the transaction is done) and drop it.
+                        cancelledJobs.append(job)
+                        indexesToRemove.append(index)
+
+                        continue
+                    }
 
-            // Go through each job in the queue, until we find jobs we can run,
-            // up to the count we can run at a time.
-            // Either:
-            // 1. The job can be run: assign it to jobToRun and break
-            // 2. The job can't be run yet, but might be later: leave it in the queue
-            // 3. The job is running already: join its promise to the running instance & remove
-            // 4. The already finished: remove it (we don't assign the promise as we assume
-            //    downstream actions already happened)
-            // 5. The job has been cancelled or attachment deleted: reject it and remove it
-            jobLoop: for (index, job) in jobQueue.enumerated() {
-                if _shouldCancelJobWithinLock(job, asOfDate: Date()) {
-                    // Job is cancelled! Fail it and drop it.
-                    job.future.reject(AttachmentDownloadError.cancelled)
-                    indexesToRemove.append(index)
-
-                    continue
-                }
-
-                if let existingJob = activeJobMap[job.attachmentId] {
-                    // Ensure we only have one download in flight at a time for a given attachment.
-                    Logger.warn("Ignoring duplicate download.")
+                    if let existingJob = activeJobMap[job.attachmentId] {
+                        // Ensure we only have one download in flight at a time for a given attachment.
+                        Logger.warn("Ignoring duplicate download.")
 
-                    // Link up this job's promise to the other job, then remove it.
-                    job.future.resolve(on: schedulers.sync, with: existingJob.promise)
-                    indexesToRemove.append(index)
+                        // Link up this job's promise to the other job, then remove it.
+                        job.future.resolve(on: schedulers.sync, with: existingJob.promise)
+                        indexesToRemove.append(index)
 
-                    continue
-                }
-                switch self.prepareDownload(job: job) {
-                case .alreadyDownloaded:
-                    self._markJobCompleteWithinLock(job, isAttachmentDownloaded: true)
-                    indexesToRemove.append(index)
-                    continue
-                case .attachmentDeleted:
-                    self._markJobCompleteWithinLock(job, isAttachmentDownloaded: true)
-                    indexesToRemove.append(index)
-                    continue
-                case .cannotDownload:
-                    // Just leave it in the queue. Maybe we can download it later.
-                    continue
-                case .downloadable(let tSAttachmentPointer):
-                    indexesToRemove.append(index)
-                    jobsToRun.append((job, tSAttachmentPointer))
-                    if jobsToRun.count == maxNumJobsToRun {
-                        break jobLoop
+                        continue
+                    }
+                    switch self.prepareDownload(job: job, transaction: transaction) {
+                    case .alreadyDownloaded:
+                        self._markJobCompleteWithinLock(job, isAttachmentDownloaded: true)
+                        indexesToRemove.append(index)
+                        continue
+                    case .attachmentDeleted:
+                        self._markJobCompleteWithinLock(job, isAttachmentDownloaded: true)
+                        indexesToRemove.append(index)
+                        continue
+                    case .cannotDownload:
+                        // Just leave it in the queue. Maybe we can download it later.
+                        continue
+                    case .downloadable(let tSAttachmentPointer):
+                        indexesToRemove.append(index)
+                        jobsToRun.append((job, tSAttachmentPointer))
+                        if jobsToRun.count == maxNumJobsToRun {
+                            break jobLoop
+                        }
                     }
                 }
             }
+            for job in cancelledJobs {
+                job.future.reject(AttachmentDownloadError.cancelled)
+            }
             for indexToRemove in indexesToRemove.reversed() {
                 jobQueue.remove(at: indexToRemove)
             }
@@ -291,116 +300,114 @@ public class TSAttachmentDownloadManager: NSObject {
         case downloadable(TSAttachmentPointer)
     }
 
-    private func prepareDownload(job: Job) -> PrepareDownloadResult {
-        return SSKEnvironment.shared.databaseStorageRef.write { (transaction) -> PrepareDownloadResult in
-            // Fetch latest to ensure we don't overwrite an attachment stream, resurrect an attachment, etc.
-            guard let attachment = job.loadLatestAttachment(transaction: transaction) else {
-                // This isn't necessarily a bug.  For example:
-                //
-                // * Receive an incoming message with an attachment.
-                // * Kick off download of that attachment.
-                // * Receive read receipt for that message, causing it to be disappeared immediately.
-                // * Try to download that attachment - but it's missing.
-                Logger.warn("Missing attachment: \(job.category).")
-                return .attachmentDeleted
+    private func prepareDownload(job: Job, transaction: SDSAnyWriteTransaction) -> PrepareDownloadResult {
+        // Fetch latest to ensure we don't overwrite an attachment stream, resurrect an attachment, etc.
+        guard let attachment = job.loadLatestAttachment(transaction: transaction) else {
+            // This isn't necessarily a bug.  For example:
+            //
+            // * Receive an incoming message with an attachment.
+            // * Kick off download of that attachment.
+            // * Receive read receipt for that message, causing it to be disappeared immediately.
+            // * Try to download that attachment - but it's missing.
+            Logger.warn("Missing attachment: \(job.category).")
+            return .attachmentDeleted
+        }
+        guard let attachmentPointer = attachment as? TSAttachmentPointer else {
+            // This isn't necessarily a bug.
+            //
+            // * An attachment may have been re-enqueued for download while it was already being downloaded.
+            Logger.info("Attachment already downloaded: \(job.category).")
+
+            return .alreadyDownloaded
+        }
+
+        switch job.jobType {
+        case .messageAttachment(_, let messageUniqueId):
+            if DebugFlags.forceAttachmentDownloadFailures.get() {
+                Logger.info("Skipping media download for thread due to debug settings: \(job.category).")
+                attachmentPointer.updateAttachmentPointerState(from: .enqueued,
+                                                               to: .failed,
+                                                               transaction: transaction)
+                return .cannotDownload
             }
-            guard let attachmentPointer = attachment as? TSAttachmentPointer else {
-                // This isn't necessarily a bug.
-                //
-                // * An attachment may have been re-enqueued for download while it was already being downloaded.
-                Logger.info("Attachment already downloaded: \(job.category).")
 
-                return .alreadyDownloaded
+            if self.isDownloadBlockedByActiveCall(job: job) {
+                Logger.info("Skipping media download due to active call: \(job.category).")
+                attachmentPointer.updateAttachmentPointerState(from: .enqueued,
+                                                               to: .pendingManualDownload,
+                                                               transaction: transaction)
+                return .cannotDownload
+            }
+            guard let message = TSMessage.anyFetchMessage(uniqueId: messageUniqueId, transaction: transaction) else {
+                Logger.info("Skipping media download due to missing message: \(job.category).")
+                return .attachmentDeleted
+            }
+            let blockedByPendingMessageRequest = self.isDownloadBlockedByPendingMessageRequest(
+                job: job,
+                attachmentPointer: attachmentPointer,
+                message: message,
+                tx: transaction
+            )
+            if blockedByPendingMessageRequest {
+                Logger.info("Skipping media download for thread with pending message request: \(job.category).")
+                attachmentPointer.updateAttachmentPointerState(from: .enqueued,
+                                                               to: .pendingMessageRequest,
+                                                               transaction: transaction)
+                return .cannotDownload
+            }
+            let blockedByAutoDownloadSettings = self.isDownloadBlockedByAutoDownloadSettings(
+                job: job,
+                attachmentPointer: attachmentPointer,
+                transaction: transaction
+            )
+            if blockedByAutoDownloadSettings {
+                Logger.info("Skipping media download for thread due to auto-download settings: \(job.category).")
+                attachmentPointer.updateAttachmentPointerState(from: .enqueued,
+                                                               to: .pendingManualDownload,
+                                                               transaction: transaction)
+                return .cannotDownload
+            }
+        case .storyMessageAttachment:
+            if DebugFlags.forceAttachmentDownloadFailures.get() {
+                Logger.info("Skipping media download for thread due to debug settings: \(job.category).")
+                attachmentPointer.updateAttachmentPointerState(from: .enqueued,
+                                                               to: .failed,
+                                                               transaction: transaction)
+                return .cannotDownload
             }
 
-            switch job.jobType {
-            case .messageAttachment(_, let messageUniqueId):
-                if DebugFlags.forceAttachmentDownloadFailures.get() {
-                    Logger.info("Skipping media download for thread due to debug settings: \(job.category).")
-                    attachmentPointer.updateAttachmentPointerState(from: .enqueued,
-                                                                   to: .failed,
-                                                                   transaction: transaction)
-                    return .cannotDownload
-                }
-
-                if self.isDownloadBlockedByActiveCall(job: job) {
-                    Logger.info("Skipping media download due to active call: \(job.category).")
-                    attachmentPointer.updateAttachmentPointerState(from: .enqueued,
-                                                                   to: .pendingManualDownload,
-                                                                   transaction: transaction)
-                    return .cannotDownload
-                }
-                guard let message = TSMessage.anyFetchMessage(uniqueId: messageUniqueId, transaction: transaction) else {
-                    Logger.info("Skipping media download due to missing message: \(job.category).")
-                    return .attachmentDeleted
-                }
-                let blockedByPendingMessageRequest = self.isDownloadBlockedByPendingMessageRequest(
-                    job: job,
-                    attachmentPointer: attachmentPointer,
-                    message: message,
-                    tx: transaction
-                )
-                if blockedByPendingMessageRequest {
-                    Logger.info("Skipping media download for thread with pending message request: \(job.category).")
-                    attachmentPointer.updateAttachmentPointerState(from: .enqueued,
-                                                                   to: .pendingMessageRequest,
-                                                                   transaction: transaction)
-                    return .cannotDownload
-                }
-                let blockedByAutoDownloadSettings = self.isDownloadBlockedByAutoDownloadSettings(
-                    job: job,
-                    attachmentPointer: attachmentPointer,
-                    transaction: transaction
-                )
-                if blockedByAutoDownloadSettings {
-                    Logger.info("Skipping media download for thread due to auto-download settings: \(job.category).")
-                    attachmentPointer.updateAttachmentPointerState(from: .enqueued,
-                                                                   to: .pendingManualDownload,
-                                                                   transaction: transaction)
-                    return .cannotDownload
-                }
-            case .storyMessageAttachment:
-                if DebugFlags.forceAttachmentDownloadFailures.get() {
-                    Logger.info("Skipping media download for thread due to debug settings: \(job.category).")
-                    attachmentPointer.updateAttachmentPointerState(from: .enqueued,
-                                                                   to: .failed,
-                                                                   transaction: transaction)
-                    return .cannotDownload
-                }
-
-                if self.isDownloadBlockedByActiveCall(job: job) {
-                    Logger.info("Skipping media download due to active call: \(job.category).")
-                    attachmentPointer.updateAttachmentPointerState(from: .enqueued,
-                                                                   to: .pendingManualDownload,
-                                                                   transaction: transaction)
-                    return .cannotDownload
-                }
-                let blockedByAutoDownloadSettings = self.isDownloadBlockedByAutoDownloadSettings(
-                    job: job,
-                    attachmentPointer: attachmentPointer,
-                    transaction: transaction
-                )
-                if blockedByAutoDownloadSettings {
-                    Logger.info("Skipping media download for thread due to auto-download settings: \(job.category).")
-                    attachmentPointer.updateAttachmentPointerState(from: .enqueued,
-                                                                   to: .pendingManualDownload,
-                                                                   transaction: transaction)
-                    return .cannotDownload
-                }
-            case .contactSync:
-                // We don't need to apply attachment download settings
-                // to contact sync attachments.
-                break
+            if self.isDownloadBlockedByActiveCall(job: job) {
+                Logger.info("Skipping media download due to active call: \(job.category).")
+                attachmentPointer.updateAttachmentPointerState(from: .enqueued,
+                                                               to: .pendingManualDownload,
+                                                               transaction: transaction)
+                return .cannotDownload
+            }
+            let blockedByAutoDownloadSettings = self.isDownloadBlockedByAutoDownloadSettings(
+                job: job,
+                attachmentPointer: attachmentPointer,
+                transaction: transaction
+            )
+            if blockedByAutoDownloadSettings {
+                Logger.info("Skipping media download for thread due to auto-download settings: \(job.category).")
+                attachmentPointer.updateAttachmentPointerState(from: .enqueued,
+                                                               to: .pendingManualDownload,
+                                                               transaction: transaction)
+                return .cannotDownload
             }
+        case .contactSync:
+            // We don't need to apply attachment download settings
+            // to contact sync attachments.
+            break
+        }
 
-            Logger.info("Downloading: \(job.category).")
+        Logger.info("Downloading: \(job.category).")
 
-            attachmentPointer.updateAttachmentPointerState(.downloading, transaction: transaction)
+        attachmentPointer.updateAttachmentPointerState(.downloading, transaction: transaction)
 
-            Self.touchAssociatedElement(for: job.jobType, tx: transaction)
+        Self.touchAssociatedElement(for: job.jobType, tx: transaction)
 
-            return .downloadable(attachmentPointer)
-        }
+        return .downloadable(attachmentPointer)
     }
 
     private func isDownloadBlockedByActiveCall(job: Job) -> Bool {
@@ -529,6 +536,8 @@ public class TSAttachmentDownloadManager: NSObject {
             Self.touchAssociatedElement(for: job.jobType, tx: transaction)
         }
 
+        OWSThumbnailService.shared.ensureAllThumbnails(forIngestedAttachment: attachmentStream)
+
         // TODO: Should we fulfill() if the attachmentPointer no longer existed?
         job.future.resolve(attachmentStream)
 
@@ -538,30 +547,28 @@ public class TSAttachmentDownloadManager: NSObject {
     private func downloadDidFail(error: Error, job: Job) {
         Logger.error("Attachment download failed with error: \(error)")
 
-        SSKEnvironment.shared.databaseStorageRef.write { transaction in
-            // Fetch latest to ensure we don't overwrite an attachment stream, resurrect an attachment, etc.
-            guard let attachmentPointer = job.loadLatestAttachment(transaction: transaction) as? TSAttachmentPointer else {
-                Logger.warn("Attachment pointer no longer exists.")
-                return
-            }
-            switch attachmentPointer.state {
-            case .failed, .pendingMessageRequest, .pendingManualDownload:
-                owsFailDebug("Unexpected state: \(NSStringForTSAttachmentPointerState(attachmentPointer.state))")
-            case .enqueued, .downloading:
-                // If the download was cancelled, mark as paused.                
-                if case AttachmentDownloadError.cancelled = error {
-                    attachmentPointer.updateAttachmentPointerState(.pendingManualDownload, transaction: transaction)
-                } else {
-                    attachmentPointer.updateAttachmentPointerState(.failed, transaction: transaction)
-                }
+        // If the download was cancelled, mark as paused.
+        let newState: TSAttachmentPointerState
+        if case AttachmentDownloadError.cancelled = error {
+            newState = .pendingManualDownload
+        } else {
+            newState = .failed
+        }
+        // Failures often arrive together (e.g. every image of an album when the
+        // network drops), so their writes are coalesced.
+        pointerStateUpdater.transitionState(
+            ofAttachmentId: job.attachmentId,
+            from: [.enqueued, .downloading],
+            to: newState,
+            sideEffects: { transaction in
+                Self.touchAssociatedElement(for: job.jobType, tx: transaction)
+            },
+            afterCommit: {
+                job.future.reject(error)
+
+                self.markJobComplete(job, isAttachmentDownloaded: false)
             }
-
-            Self.touchAssociatedElement(for: job.jobType, tx: transaction)
-        }
-
-        job.future.reject(error)
-
-        markJobComplete(job, isAttachmentDownloaded: false)
+        )
     }
 
     private static func touchAssociatedElement(for jobType: JobType, tx: SDSAnyWriteTransaction) {
@@ -1073,22 +1080,145 @@ public extension TSAttachmentDownloadManager {
 
         let downloadState = DownloadState(job: job, attachmentPointer: attachmentPointer)
 
-        return firstly(on: schedulers.sync) { () -> Promise<URL> in
+        if attachmentPointer.byteCount >= Self.rangedDownloadMinByteCount {
+            return rangedDownload(downloadState: downloadState, maxDownloadSizeBytes: maxDownloadSizeBytes)
+        }
+
+        return firstly(on: schedulers.sync) { () -> Promise<OWSUrlDownloadResponse> in
             self.downloadAttempt(
                 downloadState: downloadState,
                 maxDownloadSizeBytes: maxDownloadSizeBytes
             )
+        }.map(on: schedulers.global()) { (response: OWSUrlDownloadResponse) in
+            let downloadUrl = response.downloadUrl
+            guard let fileSize = OWSFileSystem.fileSize(of: downloadUrl) else {
+                throw OWSAssertionError("Could not determine attachment file size.")
+            }
+            guard fileSize.int64Value <= maxDownloadSizeBytes else {
+                throw OWSGenericError("Attachment download length exceeds max size.")
+            }
+            return downloadUrl
+        }
+    }
+
+    // MARK: - Ranged Downloads
+
+    /// Attachments at least this large are downloaded in segments, each of which
+    /// is persisted as it completes, so that a failed download resumes where it
+    /// left off rather than from byte zero.
+    private static let rangedDownloadMinByteCount: UInt32 = 8 * 1024 * 1024
+
+    private static let rangedDownloadSegmentByteCount: Int64 = 8 * 1024 * 1024
+
+    private func rangedDownload(
+        downloadState: DownloadState,
+        maxDownloadSizeBytes: UInt
+    ) -> Promise<URL> {
+        let partialDownloadStore = TSAttachmentPartialDownloadStore.shared
+        let attachmentPointer = downloadState.attachmentPointer
+
+        let (byteOffset, totalByteCount) = partialDownloadStore.resumableState(for: attachmentPointer)
+        if let totalByteCount, byteOffset >= totalByteCount {
+            return firstly(on: schedulers.global()) { () -> URL in
+                try partialDownloadStore.takeCompletedFile(for: attachmentPointer)
+            }
+        }
+        if byteOffset > 0 {
+            Logger.info("Resuming download at \(byteOffset) bytes: \(downloadState.job.category).")
+        }
+        let byteRange = byteOffset...(byteOffset + Self.rangedDownloadSegmentByteCount - 1)
+
+        return firstly(on: schedulers.sync) { () -> Promise<OWSUrlDownloadResponse> in
+            self.downloadAttempt(
+                downloadState: downloadState,
+                maxDownloadSizeBytes: maxDownloadSizeBytes,
+                byteRange: byteRange,
+                // Until the CDN tells us, the plaintext length is a close estimate.
+                knownTotalByteCount: totalByteCount ?? Int64(attachmentPointer.byteCount)
+            )
+        }.recover(on: schedulers.sync) { (error: Error) -> Promise<OWSUrlDownloadResponse> in
+            if error.httpStatusCode == 416 {
+                // Our offset doesn't fit the object on the CDN; start over next time.
+                partialDownloadStore.removePartialDownload(forAttachmentId: attachmentPointer.uniqueId)
+            }
+            throw error
+        }.then(on: schedulers.global()) { (response: OWSUrlDownloadResponse) -> Promise<URL> in
+            let downloadUrl = response.downloadUrl
+
+            guard response.statusCode == 206 else {
+                // The CDN ignored the range and sent the entire object.
+                partialDownloadStore.removePartialDownload(forAttachmentId: attachmentPointer.uniqueId)
+                guard let fileSize = OWSFileSystem.fileSize(of: downloadUrl) else {
+                    throw OWSAssertionError("Could not determine attachment file size.")
+                }
+                guard fileSize.int64Value <= maxDownloadSizeBytes else {
+                    throw OWSGenericError("Attachment download length exceeds max size.")
+                }
+                return .value(downloadUrl)
+            }
+
+            defer {
+                try? OWSFileSystem.deleteFileIfExists(url: downloadUrl)
+            }
+            guard
+                let contentRange = response.httpUrlResponse.value(forHTTPHeaderField: "Content-Range"),
+                let parsedContentRange = Self.parseContentRange(contentRange)
+            else {
+                throw OWSAssertionError("Missing or invalid content range.")
+            }
+            let totalByteCount = parsedContentRange.totalByteCount
+            guard parsedContentRange.rangeStart == byteOffset else {
+                partialDownloadStore.removePartialDownload(forAttachmentId: attachmentPointer.uniqueId)
+                throw OWSAssertionError("Unexpected content range start.")
+            }
+            guard totalByteCount <= maxDownloadSizeBytes else {
+                partialDownloadStore.removePartialDownload(forAttachmentId: attachmentPointer.uniqueId)
+                throw OWSGenericError("Attachment download length exceeds max size.")
+            }
+
+            let newByteOffset = try partialDownloadStore.appendSegment(
+                at: downloadUrl,
+                totalByteCount: totalByteCount,
+                for: attachmentPointer
+            )
+            if newByteOffset >= totalByteCount {
+                return .value(try partialDownloadStore.takeCompletedFile(for: attachmentPointer))
+            }
+            return self.rangedDownload(downloadState: downloadState, maxDownloadSizeBytes: maxDownloadSizeBytes)
+        }
+    }
+
+    /// Parses e.g. "bytes 0-1023/7630" into (0, 7630).
+    private static func parseContentRange(_ contentRange: String) -> (rangeStart: Int64, totalByteCount: Int64)? {
+        let pattern = "^bytes (\\d+)\\-\\d+/(\\d+)$"
+        guard
+            let regex = try? NSRegularExpression(pattern: pattern),
+            let match = regex.firstMatch(
+                in: contentRange,
+                range: NSRange(contentRange.startIndex..., in: contentRange)
+            ),
+            let rangeStartRange = Range(match.range(at: 1), in: contentRange),
+            let totalByteCountRange = Range(match.range(at: 2), in: contentRange),
+            let rangeStart = Int64(contentRange[rangeStartRange]),
+            let totalByteCount = Int64(contentRange[totalByteCountRange])
+        else {
+            return nil
         }
+        return (rangeStart, totalByteCount)
     }
 
+    // MARK: -
+
     private func downloadAttempt(
         downloadState: DownloadState,
         maxDownloadSizeBytes: UInt,
+        byteRange: ClosedRange<Int64>? = nil,
+        knownTotalByteCount: Int64? = nil,
         resumeData: Data? = nil,
         attemptIndex: UInt = 0
-    ) -> Promise<URL> {
+    ) -> Promise<OWSUrlDownloadResponse> {
 
-        let (promise, future) = Promise<URL>.pending()
+        let (promise, future) = Promise<OWSUrlDownloadResponse>.pending()
 
         firstly(on: schedulers.global()) { () -> Promise<OWSUrlDownloadResponse> in
             let attachmentPointer = downloadState.attachmentPointer
@@ -1097,15 +1227,20 @@ public extension TSAttachmentDownloadManager {
                 maxResponseSize: maxDownloadSizeBytes
             )
             let urlPath = try Self.urlPath(for: downloadState)
-            let headers: [String: String] = [
+            var headers: [String: String] = [
                 "Content-Type": MimeType.applicationOctetStream.rawValue
             ]
+            if let byteRange {
+                headers["Range"] = "bytes=\(byteRange.lowerBound)-\(byteRange.upperBound)"
+            }
 
             let progress = { (task: URLSessionTask, progress: Progress) in
                 self.handleDownloadProgress(
                     downloadState: downloadState,
                     task: task,
                     progress: progress,
+                    byteOffset: byteRange?.lowerBound ?? 0,
+                    knownTotalByteCount: knownTotalByteCount,
                     future: future
                 )
             }
@@ -1124,16 +1259,7 @@ public extension TSAttachmentDownloadManager {
                                                       headers: headers,
                                                       progress: progress)
             }
-        }.map(on: schedulers.global()) { (response: OWSUrlDownloadResponse) in
-            let downloadUrl = response.downloadUrl
-            guard let fileSize = OWSFileSystem.fileSize(of: downloadUrl) else {
-                throw OWSAssertionError("Could not determine attachment file size.")
-            }
-            guard fileSize.int64Value <= maxDownloadSizeBytes else {
-                throw OWSGenericError("Attachment download length exceeds max size.")
-            }
-            return downloadUrl
-        }.recover(on: schedulers.sync) { (error: Error) -> Promise<URL> in
+        }.recover(on: schedulers.sync) { (error: Error) -> Promise<OWSUrlDownloadResponse> in
             Logger.warn("Error: \(error)")
 
             let maxAttemptCount = 16
@@ -1143,12 +1269,14 @@ public extension TSAttachmentDownloadManager {
                 return firstly(on: Self.schedulers.sync) {
                     // Wait briefly before retrying.
                     Guarantee.after(on: Self.schedulers.global(), seconds: 0.25)
-                }.then(on: Self.schedulers.sync) { () -> Promise<URL> in
+                }.then(on: Self.schedulers.sync) { () -> Promise<OWSUrlDownloadResponse> in
                     if let resumeData = (error as NSError).userInfo[NSURLSessionDownloadTaskResumeData] as? Data,
                        !resumeData.isEmpty {
                         return self.downloadAttempt(
                             downloadState: downloadState,
                             maxDownloadSizeBytes: maxDownloadSizeBytes,
+                            byteRange: byteRange,
+                            knownTotalByteCount: knownTotalByteCount,
                             resumeData: resumeData,
                             attemptIndex: attemptIndex + 1
                         )
@@ -1156,6 +1284,8 @@ public extension TSAttachmentDownloadManager {
                         return self.downloadAttempt(
                             downloadState: downloadState,
                             maxDownloadSizeBytes: maxDownloadSizeBytes,
+                            byteRange: byteRange,
+                            knownTotalByteCount: knownTotalByteCount,
                             attemptIndex: attemptIndex + 1
                         )
                     }
@@ -1163,8 +1293,8 @@ public extension TSAttachmentDownloadManager {
             } else {
                 throw error
             }
-        }.done(on: schedulers.sync) { url in
-            future.resolve(url)
+        }.done(on: schedulers.sync) { response in
+            future.resolve(response)
         }.catch(on: schedulers.sync) { error in
             future.reject(error)
         }
@@ -1195,7 +1325,9 @@ public extension TSAttachmentDownloadManager {
         downloadState: DownloadState,
         task: URLSessionTask,
         progress: Progress,
-        future: Future<URL>
+        byteOffset: Int64,
+        knownTotalByteCount: Int64?,
+        future: Future<OWSUrlDownloadResponse>
     ) {
 
         guard !self.shouldCancelJob(downloadState: downloadState) else {
@@ -1210,12 +1342,20 @@ public extension TSAttachmentDownloadManager {
             return
         }
 
-        downloadState.job.progress = CGFloat(progress.fractionCompleted)
+        // Segments of a ranged download report progress toward the whole attachment.
+        let fractionCompleted: Double
+        if let knownTotalByteCount, knownTotalByteCount > 0 {
+            fractionCompleted = min(1, Double(byteOffset + progress.completedUnitCount) / Double(knownTotalByteCount))
+        } else {
+            fractionCompleted = progress.fractionCompleted
+        }
+
+        downloadState.job.progress = CGFloat(fractionCompleted)
 
         // Use a slightly non-zero value to ensure that the progress
         // indicator shows up as quickly as possible.
         let progressTheta: Double = 0.001
-        Self.fireProgressNotification(progress: max(progressTheta, progress.fractionCompleted),
+        Self.fireProgressNotification(progress: max(progressTheta, fractionCompleted),
                                       attachmentId: downloadState.attachmentPointer.uniqueId)
     }
 
@@ -1244,7 +1384,7 @@ public extension TSAttachmentDownloadManager {
                         throw OWSAssertionError("Missing encryptionKey.")
                     }
 
-                    try Cryptography.decryptAttachment(
+                    let plaintextSha256Digest = try Cryptography.decryptAttachmentComputingPlaintextSha256(
                         at: encryptedFileUrl,
                         metadata: EncryptionMetadata(
                             key: encryptionKey,
@@ -1254,6 +1394,13 @@ public extension TSAttachmentDownloadManager {
                         output: originalMediaURL
                     )
 
+                    // The same content is often received in several chats.
+                    TSAttachmentContentStore.shared.deduplicateFile(at: originalMediaURL, sha256Digest: plaintextSha256Digest)
+
+                    // Compute the media metadata before the stream is inserted
+                    // so that it is written with the row.
+                    attachmentStream.ensureMediaMetadata()
+
                     future.resolve(attachmentStream)
                 } catch let error {
                     do {
@@ -0,0 +1,196 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import Foundation
+
+/// Keeps the encrypted bytes of interrupted legacy attachment downloads so that
+/// a later attempt, even after a relaunch, resumes with an HTTP Range request
+/// instead of starting from byte zero.
+///
+/// Each partial download is a file named by the attachment's uniqueId holding
+/// the encrypted bytes received so far; its length is the offset to resume
+/// from. A sidecar records which CDN object the bytes came from, so they are
+/// discarded if the pointer is re-uploaded elsewhere. Decryption and digest
+/// verification run once the file is complete, exactly as for a download that
+/// was never interrupted.
+public class TSAttachmentPartialDownloadStore {
+
+    public static let shared = TSAttachmentPartialDownloadStore()
+
+    private struct Sidecar: Codable, Equatable {
+        let cdnNumber: UInt32
+        let cdnKey: String
+        let serverId: UInt64
+        var totalByteCount: Int64?
+    }
+
+    /// Partial downloads that haven't been resumed in this long are abandoned.
+    private static let maxAge: TimeInterval = 7 * kDayInterval
+
+    private let lock = UnfairLock()
+
+    private init() {
+        SwiftSingletons.register(self)
+    }
+
+    public static var dirPath: String {
+        return OWSFileSystem.appSharedDataDirectoryPath().appendingPathComponent("AttachmentPartialDownloads")
+    }
+
+    private static func filePath(forAttachmentId attachmentId: String) -> String {
+        return dirPath.appendingPathComponent(attachmentId)
+    }
+
+    private static func sidecarPath(forAttachmentId attachmentId: String) -> String {
+        return dirPath.appendingPathComponent(attachmentId).appendingFileExtension("plist")
+    }
+
+    private static func sidecar(for attachmentPointer: TSAttachmentPointer) -> Sidecar {
+        return Sidecar(
+            cdnNumber: attachmentPointer.cdnNumber,
+            cdnKey: attachmentPointer.cdnKey,
+            serverId: attachmentPointer.serverId,
+            totalByteCount: nil
+        )
+    }
+
+    // MARK: - Resuming
+
+    /// Returns how many encrypted bytes of the attachment are already on disk,
+    /// and the total encrypted length if a previous response reported it.
+    ///
+    /// Bytes from a different CDN object than the pointer's are discarded.
+    public func resumableState(for attachmentPointer: TSAttachmentPointer) -> (byteOffset: Int64, totalByteCount: Int64?) {
+        let attachmentId = attachmentPointer.uniqueId
+        return lock.withLock {
+            guard
+                let sidecar = Self.readSidecar(forAttachmentId: attachmentId),
+                sidecar.cdnNumber == attachmentPointer.cdnNumber,
+                sidecar.cdnKey == attachmentPointer.cdnKey,
+                sidecar.serverId == attachmentPointer.serverId,
+                let byteOffset = OWSFileSystem.fileSize(ofPath: Self.filePath(forAttachmentId: attachmentId))?.int64Value
+            else {
+                Self.removeFiles(forAttachmentId: attachmentId)
+                return (0, nil)
+            }
+            return (byteOffset, sidecar.totalByteCount)
+        }
+    }
+
+    /// Appends a downloaded segment that starts at the current offset.
+    ///
+    /// - Returns: The new byte offset.
+    public func appendSegment(
+        at segmentUrl: URL,
+        totalByteCount: Int64,
+        for attachmentPointer: TSAttachmentPointer
+    ) throws -> Int64 {
+        let attachmentId = attachmentPointer.uniqueId
+        return try lock.withLock {
+            guard OWSFileSystem.ensureDirectoryExists(Self.dirPath) else {
+                throw OWSAssertionError("Could not create partial downloads directory.")
+            }
+            var sidecar = Self.sidecar(for: attachmentPointer)
+            sidecar.totalByteCount = totalByteCount
+            if Self.readSidecar(forAttachmentId: attachmentId) != sidecar {
+                let encoder = PropertyListEncoder()
+                encoder.outputFormat = .binary
+                try encoder.encode(sidecar).write(
+                    to: URL(fileURLWithPath: Self.sidecarPath(forAttachmentId: attachmentId)),
+                    options: .atomic
+                )
+            }
+
+            let filePath = Self.filePath(forAttachmentId: attachmentId)
+            if !FileManager.default.fileExists(atPath: filePath) {
+                guard FileManager.default.createFile(atPath: filePath, contents: nil) else {
+                    throw OWSAssertionError("Could not create partial download file.")
+                }
+            }
+            let outputHandle = try FileHandle(forWritingTo: URL(fileURLWithPath: filePath))
+            defer { try? outputHandle.close() }
+            let byteOffset = try outputHandle.seekToEnd()
+
+            let inputHandle = try FileHandle(forReadingFrom: segmentUrl)
+            defer { try? inputHandle.close() }
+            var newByteOffset = Int64(byteOffset)
+            do {
+                while true {
+                    let didCopyChunk: Bool = try autoreleasepool {
+                        guard let chunk = try inputHandle.read(upToCount: 256 * 1024), !chunk.isEmpty else {
+                            return false
+                        }
+                        try outputHandle.write(contentsOf: chunk)
+                        newByteOffset += Int64(chunk.count)
+                        return true
+                    }
+                    guard didCopyChunk else {
+                        break
+                    }
+                }
+                try outputHandle.synchronize()
+            } catch {
+                // Never leave a torn segment behind; the offset must stay exact.
+                try? outputHandle.truncate(atOffset: byteOffset)
+                throw error
+            }
+            return newByteOffset
+        }
+    }
+
+    /// Moves the completed download out of the store into a temporary file.
+    public func takeCompletedFile(for attachmentPointer: TSAttachmentPointer) throws -> URL {
+        let attachmentId = attachmentPointer.uniqueId
+        return try lock.withLock {
+            let tempUrl = OWSFileSystem.temporaryFileUrl(isAvailableWhileDeviceLocked: true)
+            try FileManager.default.moveItem(
+                at: URL(fileURLWithPath: Self.filePath(forAttachmentId: attachmentId)),
+                to: tempUrl
+            )
+            Self.removeFiles(forAttachmentId: attachmentId)
+            return tempUrl
+        }
+    }
+
+    public func removePartialDownload(forAttachmentId attachmentId: String) {
+        lock.withLock {
+            Self.removeFiles(forAttachmentId: attachmentId)
+        }
+    }
+
+    /// Deletes partial downloads that were abandoned, e.g. because their
+    /// message was deleted before the download finished.
+    public func sweepStaleEntries() {
+        lock.withLock {
+            let fileNames = (try? FileManager.default.contentsOfDirectory(atPath: Self.dirPath)) ?? []
+            let cutoffDate = Date().addingTimeInterval(-Self.maxAge)
+            for fileName in fileNames {
+                let filePath = Self.dirPath.appendingPathComponent(fileName)
+                guard
+                    let attributes = try? FileManager.default.attributesOfItem(atPath: filePath),
+                    let modificationDate = attributes[.modificationDate] as? Date,
+                    modificationDate < cutoffDate
+                else {
+                    continue
+                }
+                OWSFileSystem.deleteFileIfExists(filePath)
+            }
+        }
+    }
+
+    // MARK: -
+
+    private static func readSidecar(forAttachmentId attachmentId: String) -> Sidecar? {
+        guard let data = FileManager.default.contents(atPath: sidecarPath(forAttachmentId: attachmentId)) else {
+            return nil
+        }
+        return try? PropertyListDecoder().decode(Sidecar.self, from: data)
+    }
+
+    private static func removeFiles(forAttachmentId attachmentId: String) {
+        OWSFileSystem.deleteFileIfExists(filePath(forAttachmentId: attachmentId))
+        OWSFileSystem.deleteFileIfExists(sidecarPath(forAttachmentId: attachmentId))
+    }
+}
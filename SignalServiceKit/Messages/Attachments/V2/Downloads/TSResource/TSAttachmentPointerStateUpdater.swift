@@ -0,0 +1,105 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import Foundation
+
+/// Gathers TSAttachmentPointer state transitions and commits all of those
+/// requested within one flush interval in a single write transaction.
+///
+/// Transitions are applied in the order they were requested, to the latest
+/// copy of each pointer, exactly as `updateAttachmentPointerState` would have
+/// applied them one transaction at a time; only the number of transactions
+/// changes.
+public class TSAttachmentPointerStateUpdater {
+
+    private struct Transition {
+        let attachmentId: String
+        /// If non-nil, the transition only applies if the pointer is in one of these states.
+        let fromStates: [TSAttachmentPointerState]?
+        let toState: TSAttachmentPointerState
+        let sideEffects: ((SDSAnyWriteTransaction) -> Void)?
+        let afterCommit: (() -> Void)?
+    }
+
+    private static let flushIntervalSeconds: TimeInterval = 0.1
+
+    private let lock = UnfairLock()
+
+    // This property should only be accessed with lock acquired.
+    private var pendingTransitions = [Transition]()
+
+    private lazy var flushEvent = DebouncedEvents.build(
+        mode: .lastOnly,
+        maxFrequencySeconds: Self.flushIntervalSeconds,
+        onQueue: .asyncOnQueue(queue: DispatchQueue(label: "org.signal.attachment-pointer-state-updater")),
+        notifyBlock: { [weak self] in
+            self?.flush()
+        }
+    )
+
+    public init() {}
+
+    /// Enqueues a state transition for the pointer with `attachmentId`.
+    ///
+    /// - Parameter fromStates: If non-nil, the pointer is only updated if it is
+    ///   in one of these states when the transition is committed.
+    /// - Parameter sideEffects: Runs in the same write transaction, after the
+    ///   transition, if the pointer still exists.
+    /// - Parameter afterCommit: Runs once the transaction has committed.
+    public func transitionState(
+        ofAttachmentId attachmentId: String,
+        from fromStates: [TSAttachmentPointerState]? = nil,
+        to toState: TSAttachmentPointerState,
+        sideEffects: ((SDSAnyWriteTransaction) -> Void)? = nil,
+        afterCommit: (() -> Void)? = nil
+    ) {
+        lock.withLock {
+            pendingTransitions.append(Transition(
+                attachmentId: attachmentId,
+                fromStates: fromStates,
+                toState: toState,
+                sideEffects: sideEffects,
+                afterCommit: afterCommit
+            ))
+        }
+        flushEvent.requestNotify()
+    }
+
+    /// Commits any pending transitions now.
+    public func flush() {
+        let transitions: [Transition] = lock.withLock {
+            let transitions = pendingTransitions
+            pendingTransitions = []
+            return transitions
+        }
+        guard !transitions.isEmpty else {
+            return
+        }
+
+        SSKEnvironment.shared.databaseStorageRef.write { tx in
+            for transition in transitions {
+                Self.apply(transition, tx: tx)
+            }
+        }
+
+        for transition in transitions {
+            transition.afterCommit?()
+        }
+    }
+
+    private static func apply(_ transition: Transition, tx: SDSAnyWriteTransaction) {
+        // Fetch latest to ensure we don't overwrite an attachment stream, resurrect an attachment, etc.
+        guard let attachmentPointer = TSAttachment.anyFetch(uniqueId: transition.attachmentId, transaction: tx) as? TSAttachmentPointer else {
+            Logger.warn("Attachment pointer no longer exists.")
+            return
+        }
+        if let fromStates = transition.fromStates, !fromStates.contains(attachmentPointer.state) {
+            owsFailDebug("Unexpected state: \(NSStringForTSAttachmentPointerState(attachmentPointer.state))")
+        } else {
+            attachmentPointer.updateAttachmentPointerState(transition.toState, transaction: tx)
+        }
+        transition.sideEffects?(tx)
+    }
+}
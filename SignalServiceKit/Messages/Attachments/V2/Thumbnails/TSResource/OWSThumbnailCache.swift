@@ -0,0 +1,86 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import Foundation
+
+/// A process-wide cache of decoded thumbnail images for legacy attachment streams.
+///
+/// Entries are keyed by (attachment uniqueId, thumbnail dimension points) and are
+/// bounded by the decoded byte size of the images rather than by entry count.
+/// The cache is purged under memory pressure; see ``CacheCoordinator``.
+@objc
+public class OWSThumbnailCache: NSObject {
+
+    @objc(shared)
+    public static let shared = OWSThumbnailCache()
+
+    private static let maxBytes = 48 * 1024 * 1024
+    private static let nseMaxBytes = 4 * 1024 * 1024
+
+    private let cache = NSCache<NSString, UIImage>()
+
+    private override init() {
+        cache.name = "OWSThumbnailCache"
+        cache.totalCostLimit = CurrentAppContext().isNSE ? Self.nseMaxBytes : Self.maxBytes
+
+        super.init()
+
+        SwiftSingletons.register(self)
+
+        CacheCoordinator.shared.register(name: "OWSThumbnailCache", priority: .media) { [weak self] in
+            self?.removeAll()
+        }
+    }
+
+    private static func cacheKey(uniqueId: String, thumbnailDimensionPoints: CGFloat) -> NSString {
+        return "\(uniqueId)-\(UInt(thumbnailDimensionPoints))" as NSString
+    }
+
+    /// The approximate number of bytes used by the decoded bitmap.
+    private static func cost(of image: UIImage) -> Int {
+        if let cgImage = image.cgImage {
+            return cgImage.bytesPerRow * cgImage.height
+        }
+        let pixelSize = image.pixelSize
+        return Int(pixelSize.width * pixelSize.height) * 4
+    }
+
+    @objc
+    public func image(forUniqueId uniqueId: String, thumbnailDimensionPoints: CGFloat) -> UIImage? {
+        let image = cache.object(forKey: Self.cacheKey(uniqueId: uniqueId, thumbnailDimensionPoints: thumbnailDimensionPoints))
+        PerformanceCounters.shared.recordThumbnailCacheLookup(isHit: image != nil)
+        return image
+    }
+
+    @objc
+    public func setImage(_ image: UIImage, forUniqueId uniqueId: String, thumbnailDimensionPoints: CGFloat) {
+        let cost = Self.cost(of: image)
+        guard cost <= cache.totalCostLimit / 4 else {
+            // Don't let a single very large thumbnail flush the rest of the cache.
+            return
+        }
+        cache.setObject(
+            image,
+            forKey: Self.cacheKey(uniqueId: uniqueId, thumbnailDimensionPoints: thumbnailDimensionPoints),
+            cost: cost
+        )
+    }
+
+    @objc
+    public func removeImages(forUniqueId uniqueId: String) {
+        let allQualities: [TSAttachmentThumbnailQuality] = [.small, .medium, .mediumLarge, .large]
+        for quality in allQualities {
+            let thumbnailDimensionPoints = TSAttachmentStream.thumbnailDimensionPoints(forThumbnailQuality: quality)
+            cache.removeObject(forKey: Self.cacheKey(uniqueId: uniqueId, thumbnailDimensionPoints: thumbnailDimensionPoints))
+        }
+    }
+
+    @objc
+    public func removeAll() {
+        autoreleasepool {
+            cache.removeAllObjects()
+        }
+    }
+}
@@ -0,0 +1,233 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import Foundation
+
+/// Lets the caller of a thumbnail request drop interest in the result.
+///
+/// If the request is cancelled before it completes, its failure block is
+/// invoked and its success block never will be. Other requests for the same
+/// thumbnail are unaffected.
+@objc
+public class OWSThumbnailLoadingToken: NSObject {
+
+    private let lock = UnfairLock()
+    private var _isCancelled = false
+    private var onCancel: (() -> Void)?
+
+    @objc
+    public var isCancelled: Bool {
+        lock.withLock { _isCancelled }
+    }
+
+    @objc
+    public func cancel() {
+        let onCancel: (() -> Void)? = lock.withLock {
+            guard !_isCancelled else {
+                return nil
+            }
+            _isCancelled = true
+            let onCancel = self.onCancel
+            self.onCancel = nil
+            return onCancel
+        }
+        onCancel?()
+    }
+
+    /// Returns false if the token was already cancelled.
+    fileprivate func setOnCancel(_ block: @escaping () -> Void) -> Bool {
+        lock.withLock {
+            guard !_isCancelled else {
+                return false
+            }
+            onCancel = block
+            return true
+        }
+    }
+
+    fileprivate func clearOnCancel() {
+        lock.withLock {
+            onCancel = nil
+        }
+    }
+}
+
+// MARK: -
+
+/// Schedules thumbnail loads for legacy attachment streams.
+///
+/// * Requests for the same key that are in flight at the same time share one load.
+/// * Visible requests are dequeued before background requests.
+/// * Cancelled requests that nobody else is waiting on are dropped before they start.
+/// * Concurrency scales with the number of active CPU cores.
+@objc
+public class OWSThumbnailLoadingQueue: NSObject {
+
+    public typealias SuccessBlock = (OWSLoadedThumbnail) -> Void
+    public typealias FailureBlock = () -> Void
+    public typealias WorkBlock = (@escaping SuccessBlock, @escaping FailureBlock) -> Void
+
+    @objc(shared)
+    public static let shared = OWSThumbnailLoadingQueue()
+
+    private class Waiter {
+        let success: SuccessBlock
+        let failure: FailureBlock
+        let token: OWSThumbnailLoadingToken?
+
+        init(success: @escaping SuccessBlock, failure: @escaping FailureBlock, token: OWSThumbnailLoadingToken?) {
+            self.success = success
+            self.failure = failure
+            self.token = token
+        }
+    }
+
+    private class PendingLoad {
+        let operation: BlockOperation
+        var waiters = [Waiter]()
+
+        init(operation: BlockOperation) {
+            self.operation = operation
+        }
+    }
+
+    private let operationQueue: OperationQueue
+
+    private let lock = UnfairLock()
+
+    // This property should only be accessed with lock acquired.
+    private var pendingLoads = [String: PendingLoad]()
+
+    // Exposed for testing; use `shared` elsewhere.
+    internal override init() {
+        let operationQueue = OperationQueue()
+        operationQueue.name = "ThumbnailLoading"
+        operationQueue.maxConcurrentOperationCount = Self.maxConcurrentLoads
+        self.operationQueue = operationQueue
+
+        super.init()
+
+        SwiftSingletons.register(self)
+    }
+
+    private static var maxConcurrentLoads: Int {
+        let coreCount = ProcessInfo.processInfo.activeProcessorCount
+        if CurrentAppContext().isNSE {
+            // Decoding is memory-hungry; keep the NSE's footprint small.
+            return 1
+        }
+        return max(2, min(coreCount, 8))
+    }
+
+    @objc
+    public var queuedLoadCount: Int {
+        lock.withLock { pendingLoads.count }
+    }
+
+    /// Enqueues `work` unless a load for `key` is already in flight, in which case
+    /// the caller shares its result.
+    ///
+    /// `work` must eventually call exactly one of its completion blocks.
+    /// success and failure will be called _off_ the main thread.
+    @objc
+    public func enqueueLoad(
+        key: String,
+        priority: OWSThumbnailLoadingPriority,
+        token: OWSThumbnailLoadingToken?,
+        work: @escaping WorkBlock,
+        success: @escaping SuccessBlock,
+        failure: @escaping FailureBlock
+    ) {
+        let waiter = Waiter(success: success, failure: failure, token: token)
+
+        // Add the waiter before registering for cancellation, so that a
+        // cancellation always finds the waiter to remove.
+        addWaiter(waiter, key: key, priority: priority, work: work)
+
+        if let token {
+            let didRegister = token.setOnCancel { [weak self, weak waiter] in
+                guard let self, let waiter else {
+                    return
+                }
+                self.cancel(waiter: waiter, key: key)
+            }
+            if !didRegister {
+                cancel(waiter: waiter, key: key)
+            }
+        }
+    }
+
+    private func addWaiter(_ waiter: Waiter, key: String, priority: OWSThumbnailLoadingPriority, work: @escaping WorkBlock) {
+        lock.withLock {
+            if let pendingLoad = pendingLoads[key] {
+                pendingLoad.waiters.append(waiter)
+                if priority == .visible, !pendingLoad.operation.isExecuting {
+                    pendingLoad.operation.queuePriority = .veryHigh
+                }
+                return
+            }
+
+            let operation = BlockOperation()
+            let pendingLoad = PendingLoad(operation: operation)
+            pendingLoad.waiters.append(waiter)
+            operation.queuePriority = priority == .visible ? .veryHigh : .low
+            operation.addExecutionBlock { [weak self, weak operation] in
+                guard let self, let operation, !operation.isCancelled else {
+                    return
+                }
+                autoreleasepool {
+                    work(
+                        { loadedThumbnail in self.complete(key: key, loadedThumbnail: loadedThumbnail) },
+                        { self.complete(key: key, loadedThumbnail: nil) }
+                    )
+                }
+            }
+            pendingLoads[key] = pendingLoad
+            PerformanceCounters.shared.setThumbnailQueueDepth(pendingLoads.count)
+            operationQueue.addOperation(operation)
+        }
+    }
+
+    private func complete(key: String, loadedThumbnail: OWSLoadedThumbnail?) {
+        let waiters: [Waiter] = lock.withLock {
+            guard let pendingLoad = pendingLoads.removeValue(forKey: key) else {
+                return []
+            }
+            PerformanceCounters.shared.setThumbnailQueueDepth(pendingLoads.count)
+            return pendingLoad.waiters
+        }
+        HotPathLog.record(.thumbnails, "Loaded thumbnail (succeeded, waiters)", loadedThumbnail == nil ? 0 : 1, Int64(waiters.count))
+        for waiter in waiters {
+            waiter.token?.clearOnCancel()
+            if let loadedThumbnail {
+                waiter.success(loadedThumbnail)
+            } else {
+                waiter.failure()
+            }
+        }
+    }
+
+    private func cancel(waiter: Waiter, key: String) {
+        let didRemoveWaiter: Bool = lock.withLock {
+            guard let pendingLoad = pendingLoads[key] else {
+                return false
+            }
+            guard let index = pendingLoad.waiters.firstIndex(where: { $0 === waiter }) else {
+                return false
+            }
+            pendingLoad.waiters.remove(at: index)
+            if pendingLoad.waiters.isEmpty, !pendingLoad.operation.isExecuting {
+                // Nobody else is interested; don't bother loading.
+                pendingLoad.operation.cancel()
+                pendingLoads.removeValue(forKey: key)
+                PerformanceCounters.shared.setThumbnailQueueDepth(pendingLoads.count)
+            }
+            return true
+        }
+        if didRemoveWaiter {
+            waiter.failure()
+        }
+    }
+}
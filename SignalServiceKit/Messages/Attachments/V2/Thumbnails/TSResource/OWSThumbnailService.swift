@@ -191,6 +191,10 @@ public class OWSThumbnailService: NSObject {
         } else {
             throw OWSThumbnailError.assertionFailure(description: "Invalid attachment type.")
         }
+        return try write(thumbnailImage: thumbnailImage, isWebp: isWebp, toPath: thumbnailPath)
+    }
+
+    private func write(thumbnailImage: UIImage, isWebp: Bool, toPath thumbnailPath: String) throws -> OWSLoadedThumbnail {
         let thumbnailData: Data
         if isWebp {
             guard let pngThumbnailData = thumbnailImage.pngData() else {
@@ -212,6 +216,124 @@ public class OWSThumbnailService: NSObject {
         return OWSLoadedThumbnail(image: thumbnailImage, data: thumbnailData)
     }
 
+    /// Persists a video's poster frame as its large thumbnail so that it
+    /// doesn't have to be decoded from the video again.
+    @objc
+    public func persistVideoStillImage(_ image: UIImage, forAttachment attachment: TSAttachmentStream) {
+        let thumbnailPath = attachment.path(
+            forThumbnailDimensionPoints: TSAttachmentStream.thumbnailDimensionPointsLarge()
+        )
+        serialQueue.async {
+            guard !FileManager.default.fileExists(atPath: thumbnailPath) else {
+                return
+            }
+            let thumbnailDirPath = (thumbnailPath as NSString).deletingLastPathComponent
+            guard OWSFileSystem.ensureDirectoryExists(thumbnailDirPath) else {
+                Logger.warn("Could not create attachment's thumbnail directory.")
+                return
+            }
+            do {
+                _ = try self.write(thumbnailImage: image, isWebp: false, toPath: thumbnailPath)
+            } catch {
+                Logger.warn("Could not persist video still: \(error)")
+            }
+        }
+    }
+
+    // MARK: - Ingest
+
+    /// Writes every thumbnail tier for a newly received attachment.
+    ///
+    /// The original is decoded once, downsampled by ImageIO to the largest tier, and
+    /// each smaller tier is scaled from that bitmap, rather than decoding the original
+    /// again for every tier on first display. Tiers that already exist, or that the
+    /// original is small enough to serve directly, are skipped.
+    ///
+    /// This is best-effort; any tier that isn't written here is generated lazily.
+    @objc
+    public func ensureAllThumbnails(forIngestedAttachment attachment: TSAttachmentStream) {
+        // The NSE can't afford the memory; the main app will generate these on demand.
+        guard !CurrentAppContext().isNSE else {
+            return
+        }
+        serialQueue.async {
+            autoreleasepool {
+                do {
+                    try self.processAllThumbnailTiers(attachment: attachment)
+                } catch {
+                    Logger.warn("Could not pre-generate thumbnails: \(error)")
+                }
+            }
+        }
+    }
+
+    // This should only be called on the serialQueue.
+    private func processAllThumbnailTiers(attachment: TSAttachmentStream) throws {
+        let isImage = attachment.isImageMimeType && attachment.contentType != MimeType.imageWebp.rawValue
+        let isVideo = attachment.isVideoMimeType
+        guard isImage || isVideo, attachment.isValidVisualMedia else {
+            return
+        }
+        guard let originalFilePath = attachment.originalFilePath else {
+            throw OWSThumbnailError.failure(description: "Missing original file path.")
+        }
+
+        let originalSizePoints = attachment.imageSizePoints
+        let allQualities: [TSAttachmentThumbnailQuality] = [.large, .mediumLarge, .medium, .small]
+        let pendingDimensionPoints: [CGFloat] = allQualities
+            .map { TSAttachmentStream.thumbnailDimensionPoints(forThumbnailQuality: $0) }
+            .sorted(by: >)
+            .filter { thumbnailDimensionPoints in
+                if
+                    isImage,
+                    originalSizePoints.width <= thumbnailDimensionPoints,
+                    originalSizePoints.height <= thumbnailDimensionPoints
+                {
+                    // The original will be used as-is for this tier.
+                    return false
+                }
+                let thumbnailPath = attachment.path(forThumbnailDimensionPoints: thumbnailDimensionPoints)
+                return !FileManager.default.fileExists(atPath: thumbnailPath)
+            }
+        guard let largestDimensionPoints = pendingDimensionPoints.first else {
+            return
+        }
+
+        let thumbnailDirPath = (attachment.path(forThumbnailDimensionPoints: largestDimensionPoints) as NSString)
+            .deletingLastPathComponent
+        guard OWSFileSystem.ensureDirectoryExists(thumbnailDirPath) else {
+            throw OWSThumbnailError.failure(description: "Could not create attachment's thumbnail directory.")
+        }
+
+        // The single decode.
+        let baseImage: UIImage
+        if isImage {
+            baseImage = try OWSMediaUtils.downsampledImage(
+                atPath: originalFilePath,
+                maxDimensionPixels: largestDimensionPoints * UIScreen.main.scale
+            )
+        } else {
+            baseImage = try OWSMediaUtils.thumbnail(
+                forVideoAtPath: originalFilePath,
+                maxDimensionPoints: largestDimensionPoints
+            )
+        }
+
+        for thumbnailDimensionPoints in pendingDimensionPoints {
+            try autoreleasepool {
+                let thumbnailImage = try OWSMediaUtils.thumbnail(
+                    forImage: baseImage,
+                    maxDimensionPoints: thumbnailDimensionPoints
+                )
+                _ = try write(
+                    thumbnailImage: thumbnailImage,
+                    isWebp: false,
+                    toPath: attachment.path(forThumbnailDimensionPoints: thumbnailDimensionPoints)
+                )
+            }
+        }
+    }
+
     @objc
     public class func thumbnailFileExtension(forContentType contentType: String) -> String {
         let isWebp = contentType == MimeType.imageWebp.rawValue
@@ -69,9 +69,13 @@ extension OWSOutgoingSentMessageTranscript {
         with sentBuilder: SSKProtoSyncMessageSentBuilder,
         tx: SDSAnyReadTransaction
     ) {
-        for recipientAddress in message.sentRecipientAddresses() {
-            guard let recipientState = message.recipientState(for: recipientAddress) else {
-                owsFailDebug("Unexpectedly missing recipient state for address?")
+        // Walk the recipient states once, rather than listing the sent
+        // recipients and then looking each one up again.
+        for (recipientAddress, recipientState) in message.recipientAddressStates ?? [:] {
+            switch recipientState.status {
+            case .sent, .delivered, .read, .viewed:
+                break
+            case .skipped, .sending, .pending, .failed:
                 continue
             }
             guard let recipientServiceId = recipientAddress.serviceId else {
@@ -267,9 +267,14 @@ public class EditManagerImpl: EditManager {
         /// fields, as a record of the now-prior revision of the now-edited
         /// message.
         ///
-        /// Keep the original message's timestamp, as well as its content.
+        /// Keep the original message's timestamp, as well as its content. If
+        /// it's smaller, store the body as a delta against the new latest
+        /// revision's body instead of copying it.
+        let priorRevisionBodyDelta = editTargetWrapper.message.body.flatMap {
+            EditRevisionBodyDelta(body: $0, newerBody: latestRevisionMessage.body)
+        }
         let priorRevisionMessageBuilder = editTargetWrapper.cloneAsBuilderWithoutAttachments(
-            applying: .noChanges(),
+            applying: priorRevisionBodyDelta == nil ? .noChanges() : .removingBody(),
             isLatestRevision: false
         )
         let priorRevisionMessage = EditTarget.build(
@@ -304,7 +309,8 @@ public class EditManagerImpl: EditManager {
         let editRecord = EditRecord(
             latestRevisionId: latestRevisionRowId,
             pastRevisionId: priorRevisionRowId,
-            read: editTargetWrapper.wasRead
+            read: editTargetWrapper.wasRead,
+            pastRevisionBodyDelta: priorRevisionBodyDelta
         )
         context.editMessageStore.insert(editRecord, tx: tx)
 
@@ -43,6 +43,9 @@ public protocol EditMessageStore {
 
     /// Fetches all past revisions for the given most-recent-revision message.
     ///
+    /// Past revisions whose body is stored as an ``EditRevisionBodyDelta``
+    /// have it rebuilt from the newer revisions.
+    ///
     /// - Returns
     /// An edit record and message instance (if one is found) for each past
     /// revision, from newest to oldest.
@@ -198,6 +201,10 @@ public class EditMessageStoreImpl: EditMessageStore {
             arguments: arguments
         )
 
+        /// Each delta is against the body of the next-newer revision, so walk
+        /// the revisions newest-to-oldest. If a revision is missing, the older
+        /// deltas can't be applied.
+        var newerBody: String?? = .some(message.body)
         return records.map { record -> (EditRecord, MessageType?) in
             let interaction = InteractionFinder.fetch(
                 rowId: record.pastRevisionId,
@@ -205,8 +212,21 @@ public class EditMessageStoreImpl: EditMessageStore {
             )
             guard let message = interaction as? MessageType else {
                 owsFailDebug("Interaction has unexpected type: \(type(of: interaction))")
+                newerBody = nil
                 return (record, nil)
             }
+            if
+                let bodyDelta = record.pastRevisionBodyDelta,
+                message.body == nil,
+                !message.wasRemotelyDeleted
+            {
+                if let newerBody, let body = bodyDelta.apply(toNewerBody: newerBody) {
+                    message.replaceBodyOfPastRevision(body)
+                } else {
+                    owsFailDebug("Couldn't rebuild the body of a past revision.")
+                }
+            }
+            newerBody = .some(message.body)
             return (record: record, edit: message)
         }
     }
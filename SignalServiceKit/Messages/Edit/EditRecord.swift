@@ -15,6 +15,9 @@ public import GRDB
 ///
 /// `pastRevisionId` is the new id created when a copy of the original edited message is inserted
 /// into the Interactions table.
+///
+/// `pastRevisionBodyDelta`, if present, holds the past revision's body, which
+/// is then omitted from its Interaction row; see ``EditRevisionBodyDelta``.
 public struct EditRecord: Codable, FetchableRecord, PersistableRecord {
     public static let databaseTableName: String = "EditRecord"
 
@@ -22,6 +25,7 @@ public struct EditRecord: Codable, FetchableRecord, PersistableRecord {
     public let latestRevisionId: Int64
     public let pastRevisionId: Int64
     public var read: Bool = false
+    public var pastRevisionBodyDelta: EditRevisionBodyDelta?
 
     mutating public func didInsert(with rowID: Int64, for column: String?) {
         id = rowID
@@ -30,11 +34,13 @@ public struct EditRecord: Codable, FetchableRecord, PersistableRecord {
     public init(
         latestRevisionId: Int64,
         pastRevisionId: Int64,
-        read: Bool = false
+        read: Bool = false,
+        pastRevisionBodyDelta: EditRevisionBodyDelta? = nil
     ) {
         self.latestRevisionId = latestRevisionId
         self.pastRevisionId = pastRevisionId
         self.read = read
+        self.pastRevisionBodyDelta = pastRevisionBodyDelta
     }
 
     public init(from decoder: Decoder) throws {
@@ -43,5 +49,6 @@ public struct EditRecord: Codable, FetchableRecord, PersistableRecord {
         self.latestRevisionId = try container.decode(Int64.self, forKey: .latestRevisionId)
         self.pastRevisionId = try container.decode(Int64.self, forKey: .pastRevisionId)
         self.read = try container.decodeIfPresent(Bool.self, forKey: .read) ?? false
+        self.pastRevisionBodyDelta = try container.decodeIfPresent(EditRevisionBodyDelta.self, forKey: .pastRevisionBodyDelta)
     }
 }
@@ -0,0 +1,82 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import Foundation
+
+/// The body of a past edit revision, stored as a change to the body of the
+/// next-newer revision rather than as a full copy.
+///
+/// Most edits are small (e.g., fixing a typo), so a past revision's body is
+/// usually the newer body with a single span replaced. The delta records the
+/// length of the unchanged prefix and suffix (in unicode scalars) and the
+/// span that the newer revision replaced.
+///
+/// Revisions chain newest-to-oldest: the newest past revision is relative to
+/// the latest revision, the one before it to the newest past revision, and
+/// so on. See ``EditMessageStore/findEditHistory(for:tx:)``.
+public struct EditRevisionBodyDelta: Codable, Equatable {
+    private enum CodingKeys: String, CodingKey {
+        case prefixLength = "p"
+        case suffixLength = "s"
+        case replacement = "r"
+    }
+
+    let prefixLength: Int
+    let suffixLength: Int
+    let replacement: String
+
+    /// Returns a delta that rebuilds `body` from `newerBody`, or nil if the
+    /// delta wouldn't be smaller than `body` itself.
+    init?(body: String, newerBody: String?) {
+        let bodyScalars = Array(body.unicodeScalars)
+        let newerBodyScalars = Array((newerBody ?? "").unicodeScalars)
+
+        var prefixLength = 0
+        while
+            prefixLength < bodyScalars.count,
+            prefixLength < newerBodyScalars.count,
+            bodyScalars[prefixLength] == newerBodyScalars[prefixLength]
+        {
+            prefixLength += 1
+        }
+
+        var suffixLength = 0
+        while
+            suffixLength < bodyScalars.count - prefixLength,
+            suffixLength < newerBodyScalars.count - prefixLength,
+            bodyScalars[bodyScalars.count - 1 - suffixLength] == newerBodyScalars[newerBodyScalars.count - 1 - suffixLength]
+        {
+            suffixLength += 1
+        }
+
+        var replacement = String.UnicodeScalarView()
+        replacement.append(contentsOf: bodyScalars[prefixLength..<(bodyScalars.count - suffixLength)])
+
+        self.prefixLength = prefixLength
+        self.suffixLength = suffixLength
+        self.replacement = String(replacement)
+
+        guard
+            let encodedDelta = try? JSONEncoder().encode(self),
+            encodedDelta.count < body.utf8.count
+        else {
+            return nil
+        }
+    }
+
+    /// Rebuilds the body this delta was made from, or returns nil if
+    /// `newerBody` isn't the body the delta was made against.
+    func apply(toNewerBody newerBody: String?) -> String? {
+        let newerBodyScalars = Array((newerBody ?? "").unicodeScalars)
+        guard prefixLength >= 0, suffixLength >= 0, prefixLength + suffixLength <= newerBodyScalars.count else {
+            return nil
+        }
+        var body = String.UnicodeScalarView()
+        body.append(contentsOf: newerBodyScalars[..<prefixLength])
+        body.append(contentsOf: replacement.unicodeScalars)
+        body.append(contentsOf: newerBodyScalars[(newerBodyScalars.count - suffixLength)...])
+        return String(body)
+    }
+}
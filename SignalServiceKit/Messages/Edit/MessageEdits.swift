@@ -96,6 +96,20 @@ public struct MessageEdits {
         )
     }
 
+    /// Returns a `MessageEdits` object that only removes the body, for a
+    /// past revision whose body is stored as an ``EditRevisionBodyDelta``.
+    static func removingBody() -> MessageEdits {
+        return MessageEdits(
+            timestamp: .keep,
+            receivedAtTimestamp: .keep,
+            serverTimestamp: .keep,
+            serverDeliveryTimestamp: .keep,
+            serverGuid: .keep,
+            body: .change(nil),
+            bodyRanges: .keep
+        )
+    }
+
     private init(
         timestamp: Edit<UInt64>,
         receivedAtTimestamp: Edit<UInt64>,
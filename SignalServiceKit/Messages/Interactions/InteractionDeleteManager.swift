@@ -156,18 +156,25 @@ final class InteractionDeleteManagerImpl: InteractionDeleteManager {
         sideEffects: SideEffects,
         tx: any DBWriteTransaction
     ) {
+        var deletedMessages = [TSMessage]()
         for interaction in interactions {
             guard interaction.shouldBeSaved else {
-                return
+                continue
             }
 
             _deleteInternal(
                 interaction: interaction,
                 knownAssociatedCallRecord: nil,
                 sideEffects: sideEffects,
+                removeReactionsAndMentions: false,
                 tx: SDSDB.shimOnlyBridge(tx)
             )
+
+            if let message = interaction as? TSMessage {
+                deletedMessages.append(message)
+            }
         }
+        TSMessage.removeAllReactionsAndMentions(of: deletedMessages, tx: SDSDB.shimOnlyBridge(tx))
 
         sendDeleteForMeSyncMessageIfNecessary(
             interactions: interactions,
@@ -195,6 +202,7 @@ final class InteractionDeleteManagerImpl: InteractionDeleteManager {
                 interaction: associatedInteraction,
                 knownAssociatedCallRecord: callRecord,
                 sideEffects: sideEffects,
+                removeReactionsAndMentions: true,
                 tx: SDSDB.shimOnlyBridge(tx)
             )
         }
@@ -233,10 +241,14 @@ final class InteractionDeleteManagerImpl: InteractionDeleteManager {
 
     // MARK: -
 
+    /// - Parameter removeReactionsAndMentions
+    /// Whether to remove the message's reactions and mentions. Callers deleting
+    /// many messages pass `false` and remove them for the whole batch.
     private func _deleteInternal(
         interaction: TSInteraction,
         knownAssociatedCallRecord: CallRecord?,
         sideEffects: SideEffects,
+        removeReactionsAndMentions: Bool,
         tx: SDSAnyWriteTransaction
     ) {
         willRemove(
@@ -254,6 +266,7 @@ final class InteractionDeleteManagerImpl: InteractionDeleteManager {
         didRemove(
             interaction: interaction,
             sideEffects: sideEffects,
+            removeReactionsAndMentions: removeReactionsAndMentions,
             tx: tx
         )
     }
@@ -309,6 +322,7 @@ final class InteractionDeleteManagerImpl: InteractionDeleteManager {
     private func didRemove(
         interaction: TSInteraction,
         sideEffects: SideEffects,
+        removeReactionsAndMentions: Bool,
         tx: SDSAnyWriteTransaction
     ) {
         switch sideEffects.updateThreadOnInteractionDelete {
@@ -324,15 +338,17 @@ final class InteractionDeleteManagerImpl: InteractionDeleteManager {
         interactionReadCache.didRemove(interaction: interaction, transaction: tx)
 
         if let message = interaction as? TSMessage {
-            FullTextSearchIndexer.delete(message, tx: tx)
+            FullTextSearchIndexer.scheduleIndexing(message, tx: tx)
 
             if !message.attachmentIds.isEmpty {
                 mediaGalleryResourceManager.didRemove(message: message, tx: tx.asV2Write)
             }
 
             message.removeAllAttachments(tx: tx)
-            message.removeAllReactions(transaction: tx)
-            message.removeAllMentions(transaction: tx)
+            if removeReactionsAndMentions {
+                message.removeAllReactions(transaction: tx)
+                message.removeAllMentions(transaction: tx)
+            }
             message.touchStoryMessageIfNecessary(replyCountIncrement: .replyDeleted, transaction: tx)
         }
     }
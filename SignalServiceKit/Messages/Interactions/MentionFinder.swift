@@ -91,6 +91,18 @@ public class MentionFinder: NSObject {
         transaction.execute(sql: sql, arguments: [message.uniqueId])
     }
 
+    /// Delete the mention records of many messages, with one statement per
+    /// chunk of messages rather than one per message.
+    public class func deleteAllMentions(forUniqueMessageIds uniqueMessageIds: [String], transaction: GRDBWriteTransaction) {
+        for uniqueMessageIdsChunk in uniqueMessageIds.chunked(by: 500) {
+            let sql = """
+                DELETE FROM \(TSMention.databaseTableName)
+                WHERE \(TSMention.columnName(.uniqueMessageId)) IN (\(uniqueMessageIdsChunk.map { _ in "?" }.joined(separator: ",")))
+            """
+            transaction.execute(sql: sql, arguments: StatementArguments(Array(uniqueMessageIdsChunk)))
+        }
+    }
+
     @objc
     public class func mentionedAddresses(for message: TSMessage, transaction: GRDBReadTransaction) -> [SignalServiceAddress] {
         let sql = """
@@ -0,0 +1,103 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import Foundation
+
+/// Preview text for info messages, error messages and legacy attachments.
+///
+/// The chat list rebuilds the preview of every visible row on each reload,
+/// and building one of these can mean localizing, formatting, checking
+/// MIME types and reading from the database. The text only changes when
+/// the model is updated or when a display name changes, so it's cached
+/// by unique id and locale.
+///
+/// An entry is removed when its model is updated (and again when that
+/// transaction commits, in case it was re-cached from a read that raced
+/// the write). All entries are discarded when names change, and after
+/// cross-process writes.
+@objc
+public final class PreviewTextCache: NSObject {
+
+    @objc
+    public static let shared = PreviewTextCache()
+
+    private let cache = LRUCache<String, String>(maxSize: 512, nseMaxSize: 64)
+
+    private override init() {
+        super.init()
+
+        let notificationNames: [Notification.Name] = [
+            .OWSContactsManagerSignalAccountsDidChange,
+            UserProfileNotifications.otherUsersProfileDidChange,
+            UserProfileNotifications.localProfileDidChange,
+            SDSDatabaseStorage.didReceiveCrossProcessNotificationAlwaysSync,
+        ]
+        for notificationName in notificationNames {
+            NotificationCenter.default.addObserver(
+                self,
+                selector: #selector(clear),
+                name: notificationName,
+                object: nil
+            )
+        }
+    }
+
+    // MARK: -
+
+    func infoMessagePreviewText(_ infoMessage: TSInfoMessage, transaction: SDSAnyReadTransaction) -> String {
+        switch infoMessage.messageType {
+        case .recipientHidden:
+            // Depends on whether the recipient is hidden now, not when the
+            // message was inserted.
+            return infoMessage.infoMessagePreviewText(with: transaction)
+        default:
+            return previewText(uniqueId: infoMessage.uniqueId) {
+                infoMessage.infoMessagePreviewText(with: transaction)
+            }
+        }
+    }
+
+    public func errorMessagePreviewText(_ errorMessage: TSErrorMessage, transaction: SDSAnyReadTransaction) -> String {
+        return previewText(uniqueId: errorMessage.uniqueId) {
+            errorMessage.previewText(transaction: transaction)
+        }
+    }
+
+    func attachmentPreviewText(_ attachment: TSAttachment) -> String {
+        return previewText(uniqueId: attachment.uniqueId) {
+            attachment.previewText()
+        }
+    }
+
+    private func previewText(uniqueId: String, build: () -> String) -> String {
+        let key = cacheKey(uniqueId: uniqueId)
+        if let previewText = cache.get(key: key) {
+            return previewText
+        }
+        let previewText = build()
+        cache.set(key: key, value: previewText)
+        return previewText
+    }
+
+    private func cacheKey(uniqueId: String) -> String {
+        return "\(Locale.current.identifier):\(uniqueId)"
+    }
+
+    // MARK: - Invalidation
+
+    @objc
+    func didUpdate(uniqueId: String, transaction: SDSAnyWriteTransaction) {
+        let key = cacheKey(uniqueId: uniqueId)
+        cache.remove(key: key)
+        transaction.addSyncCompletion {
+            self.cache.remove(key: key)
+        }
+    }
+
+    @objc
+    private func clear() {
+        cache.clear()
+    }
+}
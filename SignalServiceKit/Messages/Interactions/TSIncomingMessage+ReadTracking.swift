@@ -0,0 +1,154 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import Foundation
+import GRDB
+
+extension TSIncomingMessage {
+    /// Marks many messages in `thread` as read.
+    ///
+    /// Equivalent to calling `markAsRead(atTimestamp:...)` on each message,
+    /// but messages that don't disappear are updated with one statement, and
+    /// expirations, receipts and notifications are each handled in one pass.
+    static func markAsRead(
+        _ messages: [TSIncomingMessage],
+        atTimestamp readTimestamp: UInt64,
+        thread: TSThread,
+        circumstance: OWSReceiptCircumstance,
+        shouldClearNotifications: Bool,
+        transaction tx: SDSAnyWriteTransaction
+    ) {
+        let messages = messages.filter { $0.needsToBeMarkedAsRead(atTimestamp: readTimestamp) }
+        guard !messages.isEmpty else {
+            return
+        }
+
+        var bulkUpdatedMessages = [TSIncomingMessage]()
+        var expiringMessages = [TSIncomingMessage]()
+        for message in messages {
+            // Disappearing messages and story replies have side effects when
+            // they're updated, so they're saved individually.
+            if message.hasPerConversationExpiration || message.isStoryReply || message.grdbId == nil {
+                message.anyUpdateIncomingMessage(transaction: tx) { $0.applyReadState() }
+                expiringMessages.append(message)
+            } else {
+                bulkUpdatedMessages.append(message)
+            }
+        }
+
+        bulkUpdate(
+            bulkUpdatedMessages,
+            setClause: """
+                \(interactionColumn: .read) = 1,
+                \(interactionColumn: .editState) = CASE \(interactionColumn: .editState)
+                    WHEN \(TSEditState.latestRevisionUnread.rawValue) THEN \(TSEditState.latestRevisionRead.rawValue)
+                    ELSE \(interactionColumn: .editState)
+                END
+            """,
+            applyToModel: { $0.applyReadState() },
+            tx: tx
+        )
+
+        // readTimestamp may be earlier than now, so backdate the expiration if necessary.
+        SSKEnvironment.shared.disappearingMessagesJobRef.startAnyExpiration(
+            for: expiringMessages,
+            expirationStartedAt: readTimestamp,
+            transaction: tx
+        )
+
+        SSKEnvironment.shared.receiptManagerRef.messagesWereRead(
+            messages,
+            thread: thread,
+            circumstance: circumstance,
+            transaction: tx
+        )
+
+        if shouldClearNotifications {
+            SSKEnvironment.shared.notificationPresenterRef.cancelNotifications(messageIds: messages.map(\.uniqueId))
+        }
+    }
+
+    /// Marks many messages in `thread` as viewed.
+    ///
+    /// Equivalent to calling `markAsViewed(atTimestamp:...)` on each message,
+    /// but the messages are updated with one statement and their receipts are
+    /// enqueued in one pass.
+    static func markAsViewed(
+        _ messages: [TSIncomingMessage],
+        atTimestamp viewedTimestamp: UInt64,
+        thread: TSThread,
+        circumstance: OWSReceiptCircumstance,
+        transaction tx: SDSAnyWriteTransaction
+    ) {
+        var seenUniqueIds = Set<String>()
+        let messages = messages.filter { !$0.wasViewed && seenUniqueIds.insert($0.uniqueId).inserted }
+        guard !messages.isEmpty else {
+            return
+        }
+
+        var bulkUpdatedMessages = [TSIncomingMessage]()
+        for message in messages {
+            // Story replies have side effects when they're updated, so they're
+            // saved individually.
+            if message.isStoryReply || message.grdbId == nil {
+                message.anyUpdateIncomingMessage(transaction: tx) { $0.applyViewedState() }
+            } else {
+                bulkUpdatedMessages.append(message)
+            }
+        }
+
+        bulkUpdate(
+            bulkUpdatedMessages,
+            setClause: "\(interactionColumn: .viewed) = 1",
+            applyToModel: { $0.applyViewedState() },
+            tx: tx
+        )
+
+        SSKEnvironment.shared.receiptManagerRef.messagesWereViewed(
+            messages,
+            thread: thread,
+            circumstance: circumstance,
+            transaction: tx
+        )
+    }
+
+    /// Persists a change to messages whose update has no other side effects
+    /// with one statement, and keeps the models, the read cache and
+    /// observers in sync.
+    ///
+    /// - Parameter applyToModel: Makes the same change as `setClause` to a
+    ///   message's model.
+    private static func bulkUpdate(
+        _ messages: [TSIncomingMessage],
+        setClause: String,
+        applyToModel: (TSIncomingMessage) -> Void,
+        tx: SDSAnyWriteTransaction
+    ) {
+        guard let newestMessage = messages.last else {
+            return
+        }
+
+        for chunk in messages.chunked(by: 500) {
+            let rowIds = chunk.compactMap { $0.grdbId?.int64Value }
+            let sql = """
+                UPDATE \(InteractionRecord.databaseTableName)
+                SET \(setClause)
+                WHERE \(interactionColumn: .id) IN (\(rowIds.map { "\($0)" }.joined(separator: ",")))
+            """
+            tx.unwrapGrdbWrite.execute(sql: sql)
+        }
+
+        let databaseStorage = SSKEnvironment.shared.databaseStorageRef
+        let interactionReadCache = SSKEnvironment.shared.modelReadCachesRef.interactionReadCache
+        for message in messages {
+            applyToModel(message)
+            interactionReadCache.didUpdate(interaction: message, transaction: tx)
+            databaseStorage.touch(interaction: message, shouldReindex: false, transaction: tx)
+        }
+
+        // Every message is in the same thread, so one update covers them all.
+        newestMessage.thread(tx: tx)?.updateWithUpdatedMessage(newestMessage, transaction: tx)
+    }
+}
@@ -137,6 +137,17 @@ NS_DESIGNATED_INITIALIZER NS_SWIFT_NAME(init(grdbId:uniqueId:receivedAtTimestamp
                    circumstance:(OWSReceiptCircumstance)circumstance
                     transaction:(SDSAnyWriteTransaction *)transaction;
 
+/// Whether `markAsReadAtTimestamp:...` would change this message.
+- (BOOL)needsToBeMarkedAsReadAtTimestamp:(uint64_t)readTimestamp;
+
+/// Applies the model changes of being marked as read to this instance only.
+/// Used by bulk updates, which persist those changes themselves.
+- (void)applyReadState;
+
+/// Applies the model changes of being marked as viewed to this instance only.
+/// Used by bulk updates, which persist those changes themselves.
+- (void)applyViewedState;
+
 // convenience method for expiring a message which was just read
 - (void)debugonly_markAsReadNowWithTransaction:(SDSAnyWriteTransaction *)transaction
     NS_SWIFT_NAME(debugonly_markAsReadNow(transaction:));
@@ -217,17 +217,12 @@ const NSUInteger TSIncomingMessageSchemaVersion = 1;
 {
     OWSAssertDebug(transaction);
 
-    if (self.read && readTimestamp >= self.expireStartedAt) {
+    if (![self needsToBeMarkedAsReadAtTimestamp:readTimestamp]) {
         return;
     }
 
     [self anyUpdateIncomingMessageWithTransaction:transaction
-                                            block:^(TSIncomingMessage *message) {
-                                                message.read = YES;
-                                                if (self.editState == TSEditState_LatestRevisionUnread) {
-                                                    message.editState = TSEditState_LatestRevisionRead;
-                                                }
-                                            }];
+                                            block:^(TSIncomingMessage *message) { [message applyReadState]; }];
 
     // readTimestamp may be earlier than now, so backdate the expiration if necessary.
     [SSKEnvironment.shared.disappearingMessagesJobRef startAnyExpirationForMessage:self
@@ -244,6 +239,24 @@ const NSUInteger TSIncomingMessageSchemaVersion = 1;
     }
 }
 
+- (BOOL)needsToBeMarkedAsReadAtTimestamp:(uint64_t)readTimestamp
+{
+    return !(self.read && readTimestamp >= self.expireStartedAt);
+}
+
+- (void)applyReadState
+{
+    self.read = YES;
+    if (self.editState == TSEditState_LatestRevisionUnread) {
+        self.editState = TSEditState_LatestRevisionRead;
+    }
+}
+
+- (void)applyViewedState
+{
+    self.viewed = YES;
+}
+
 - (void)markAsViewedAtTimestamp:(uint64_t)viewedTimestamp
                          thread:(TSThread *)thread
                    circumstance:(OWSReceiptCircumstance)circumstance
@@ -256,7 +269,7 @@ const NSUInteger TSIncomingMessageSchemaVersion = 1;
     }
 
     [self anyUpdateIncomingMessageWithTransaction:transaction
-                                            block:^(TSIncomingMessage *message) { message.viewed = YES; }];
+                                            block:^(TSIncomingMessage *message) { [message applyViewedState]; }];
 
     [SSKEnvironment.shared.receiptManagerRef messageWasViewed:self
                                                        thread:thread
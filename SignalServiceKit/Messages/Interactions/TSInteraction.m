@@ -213,6 +213,7 @@ NSString *NSStringFromOWSInteractionType(OWSInteractionType value)
     [fetchedThread updateWithUpdatedMessage:self transaction:transaction];
 
     [SSKEnvironment.shared.modelReadCachesRef.interactionReadCache didUpdateInteraction:self transaction:transaction];
+    [PreviewTextCache.shared didUpdateWithUniqueId:self.uniqueId transaction:transaction];
 }
 
 #pragma mark -
@@ -4,6 +4,7 @@
 //
 
 import Foundation
+import GRDB
 
 extension TSInteraction {
 
@@ -123,30 +124,22 @@ extension TSInteraction {
         from sender: SignalServiceAddress,
         transaction: SDSAnyWriteTransaction
     ) -> Bool {
-        let placeholders: [TSInteraction]
+        let placeholders: [OWSRecoverableDecryptionPlaceholder]
         do {
-            placeholders = try InteractionFinder.interactions(
+            placeholders = try InteractionFinder.placeholders(
                 withTimestamp: timestamp,
-                filter: { candidate in
-                    guard let placeholder = candidate as? OWSRecoverableDecryptionPlaceholder else { return false }
-                    return placeholder.sender == sender && placeholder.timestamp == self.timestamp
-                },
                 transaction: transaction
-            )
+            ).filter { $0.sender == sender }
         } catch {
             owsFailDebug("Failed to fetch placeholder interaction: \(error)")
             return false
         }
 
-        guard !placeholders.isEmpty else {
+        guard let placeholder = placeholders.first else {
             return false
         }
 
         Logger.info("Fetched placeholder with timestamp: \(timestamp) from sender: \(sender). Performing replacement...")
-        guard let placeholder = (placeholders.first as? OWSRecoverableDecryptionPlaceholder) else {
-            owsFailDebug("Unexpected interaction type")
-            return false
-        }
 
         if placeholder.supportsReplacement {
             placeholder.replaceWithInteraction(self, writeTx: transaction)
@@ -175,3 +168,95 @@ extension TSInteraction {
         }
     }
 }
+
+// MARK: - Column Updates
+
+extension TSInteraction {
+
+    /// Equivalent to `anyUpdate(transaction:block:)`, except that only the
+    /// given columns are written rather than the entire re-serialized record.
+    ///
+    /// The update hooks run as they would for `anyUpdate`, and the columns
+    /// `anyWillUpdate` derives (e.g., `storedMessageState`) are always written.
+    ///
+    /// - Important
+    /// `block` must only change properties stored in `columns`.
+    static func anyUpdateColumns<T: TSInteraction>(
+        of interaction: T,
+        _ columns: [(InteractionRecord.CodingKeys, (T) -> DatabaseValueConvertible?)],
+        transaction tx: SDSAnyWriteTransaction,
+        block: (T) -> Void
+    ) {
+        block(interaction)
+
+        guard let dbCopy = TSInteraction.anyFetch(uniqueId: interaction.uniqueId, transaction: tx) as? T else {
+            return
+        }
+
+        // Don't apply the block twice to the same instance.
+        if dbCopy !== interaction {
+            block(dbCopy)
+        }
+
+        guard dbCopy.shouldBeSaved else {
+            return
+        }
+        guard let rowId = dbCopy.grdbId?.int64Value else {
+            owsFailDebug("Missing rowId.")
+            dbCopy.anyOverwritingUpdate(transaction: tx)
+            return
+        }
+
+        dbCopy.anyWillUpdate(with: tx)
+
+        var assignments: [(InteractionRecord.CodingKeys, DatabaseValueConvertible?)] = columns.map { ($0.0, $0.1(dbCopy)) }
+        if let message = dbCopy as? TSMessage {
+            assignments.append((.storedShouldStartExpireTimer, message.storedShouldStartExpireTimer))
+        }
+        if let outgoingMessage = dbCopy as? TSOutgoingMessage {
+            assignments.append((.storedMessageState, outgoingMessage.storedMessageState.rawValue))
+        }
+
+        let setClause = assignments.map { "\(InteractionRecord.columnName($0.0)) = ?" }.joined(separator: ", ")
+        var arguments = StatementArguments(assignments.map(\.1))
+        arguments += [rowId]
+        tx.unwrapGrdbWrite.executeAndCacheStatement(
+            sql: "UPDATE \(InteractionRecord.databaseTableName) SET \(setClause) WHERE \(interactionColumn: .id) = ?",
+            arguments: arguments
+        )
+
+        dbCopy.anyDidUpdate(with: tx)
+    }
+}
+
+// MARK: - Parallel Enumeration
+
+extension TSInteraction {
+
+    /// Like `anyEnumerate(transaction:batched:block:)`, but models are decoded
+    /// on worker threads. Meant for passes over the whole table.
+    ///
+    /// Interactions are delivered to `block` on the calling thread in the
+    /// order the table is read, as with `anyEnumerate`; decoding on other
+    /// threads doesn't reorder them. They aren't added to the interaction
+    /// read cache.
+    public static func anyEnumerateDecodingInParallel(
+        transaction: SDSAnyReadTransaction,
+        block: (TSInteraction, UnsafeMutablePointer<ObjCBool>) -> Void
+    ) {
+        do {
+            let cursor = try InteractionRecord.fetchCursor(transaction.unwrapGrdbRead.database)
+            try SDSParallelDecoder.enumerate(
+                cursor: cursor,
+                decode: { try TSInteraction.fromRecord($0) },
+                block: block
+            )
+        } catch {
+            DatabaseCorruptionState.flagDatabaseReadCorruptionIfNecessary(
+                userDefaults: CurrentAppContext().appUserDefaults(),
+                error: error
+            )
+            owsFailDebug("Couldn't enumerate interactions: \(error)")
+        }
+    }
+}
@@ -218,14 +218,28 @@ NS_DESIGNATED_INITIALIZER NS_SWIFT_NAME(init(grdbId:uniqueId:receivedAtTimestamp
 
 #endif
 
+// Past edit revisions may omit their body, which is stored as a delta on
+// their EditRecord instead; EditMessageStore fills in the rebuilt body.
+- (void)replaceBodyOfPastRevision:(nullable NSString *)body;
+
 #pragma mark - View Once
 
 - (void)updateWithViewOnceCompleteAndRemoveRenderableContentWithTransaction:(SDSAnyWriteTransaction *)transaction;
 
+// Pass NO for removeMentions if the caller has already removed the mentions,
+// e.g. for a batch of messages at once.
+- (void)updateWithViewOnceCompleteAndRemoveRenderableContentWithTransaction:(SDSAnyWriteTransaction *)transaction
+                                                             removeMentions:(BOOL)removeMentions;
+
 #pragma mark - Remote Delete
 
 - (void)updateWithRemotelyDeletedAndRemoveRenderableContentWithTransaction:(SDSAnyWriteTransaction *)transaction;
 
+// Pass NO for removeReactionsAndMentions if the caller has already removed
+// the reactions and mentions, e.g. for a batch of messages at once.
+- (void)updateWithRemotelyDeletedAndRemoveRenderableContentWithTransaction:(SDSAnyWriteTransaction *)transaction
+                                                removeReactionsAndMentions:(BOOL)removeReactionsAndMentions;
+
 #pragma mark - Partial Delete
 
 - (void)removeBodyTextWithTransaction:(SDSAnyWriteTransaction *)transaction NS_SWIFT_NAME(removeBodyText(transaction:));
@@ -310,7 +310,7 @@ static const NSUInteger OWSMessageSchemaVersion = 4;
     if (storyAuthorAci == nil) {
         return nil;
     }
-    return [[SignalServiceAddress alloc] initWithServiceIdObjC:storyAuthorAci];
+    return [SignalServiceAddress internedWithServiceIdObjC:storyAuthorAci];
 }
 
 - (BOOL)isStoryReply
@@ -444,8 +444,10 @@ static const NSUInteger OWSMessageSchemaVersion = 4;
     OWSAssertDebug(expireStartedAt > 0);
     OWSAssertDebug(self.expiresInSeconds > 0);
 
-    [self anyUpdateMessageWithTransaction:transaction
-                                    block:^(TSMessage *message) { [message setExpireStartedAt:expireStartedAt]; }];
+    [self anyUpdateExpirationColumnsWithTransaction:transaction
+                                              block:^(TSMessage *message) {
+                                                  [message setExpireStartedAt:expireStartedAt];
+                                              }];
 }
 
 - (void)updateWithLinkPreview:(OWSLinkPreview *)linkPreview transaction:(SDSAnyWriteTransaction *)transaction
@@ -496,34 +498,58 @@ static const NSUInteger OWSMessageSchemaVersion = 4;
 
 #endif
 
+- (void)replaceBodyOfPastRevision:(nullable NSString *)body
+{
+    OWSAssertDebug(self.editState == TSEditState_PastRevision);
+
+    _body = body;
+}
+
 #pragma mark - View Once
 
 - (void)updateWithViewOnceCompleteAndRemoveRenderableContentWithTransaction:(SDSAnyWriteTransaction *)transaction
+{
+    [self updateWithViewOnceCompleteAndRemoveRenderableContentWithTransaction:transaction removeMentions:YES];
+}
+
+- (void)updateWithViewOnceCompleteAndRemoveRenderableContentWithTransaction:(SDSAnyWriteTransaction *)transaction
+                                                             removeMentions:(BOOL)removeMentions
 {
     OWSAssertDebug(transaction);
     OWSAssertDebug(self.isViewOnceMessage);
     OWSAssertDebug(!self.isViewOnceComplete);
 
     [self removeAllRenderableContentWithTransaction:transaction
+                                     removeMentions:removeMentions
                                  messageUpdateBlock:^(TSMessage *message) { message.isViewOnceComplete = YES; }];
 }
 
 #pragma mark - Remote Delete
 
 - (void)updateWithRemotelyDeletedAndRemoveRenderableContentWithTransaction:(SDSAnyWriteTransaction *)transaction
+{
+    [self updateWithRemotelyDeletedAndRemoveRenderableContentWithTransaction:transaction removeReactionsAndMentions:YES];
+}
+
+- (void)updateWithRemotelyDeletedAndRemoveRenderableContentWithTransaction:(SDSAnyWriteTransaction *)transaction
+                                                removeReactionsAndMentions:(BOOL)removeReactionsAndMentions
 {
     OWSAssertDebug(transaction);
     OWSAssertDebug(!self.wasRemotelyDeleted);
 
-    [self removeAllReactionsWithTransaction:transaction];
+    if (removeReactionsAndMentions) {
+        [self removeAllReactionsWithTransaction:transaction];
+    }
 
     [self removeAllRenderableContentWithTransaction:transaction
+                                     removeMentions:removeReactionsAndMentions
                                  messageUpdateBlock:^(TSMessage *message) { message.wasRemotelyDeleted = YES; }];
 }
 
 #pragma mark - Remove Renderable Content
 
 - (void)removeAllRenderableContentWithTransaction:(SDSAnyWriteTransaction *)transaction
+                                   removeMentions:(BOOL)removeMentions
                                messageUpdateBlock:(void (^)(TSMessage *message))messageUpdateBlock
 {
     // We call removeAllAttachmentsWithTransaction() before
@@ -533,7 +559,9 @@ static const NSUInteger OWSMessageSchemaVersion = 4;
     // attachments once.
     [self anyReloadWithTransaction:transaction ignoreMissing:YES];
     [self removeAllAttachmentsWithTx:transaction];
-    [self removeAllMentionsWithTransaction:transaction];
+    if (removeMentions) {
+        [self removeAllMentionsWithTransaction:transaction];
+    }
     [MessageSendLogObjC deleteAllPayloadsForInteraction:self tx:transaction];
 
     [self anyUpdateMessageWithTransaction:transaction
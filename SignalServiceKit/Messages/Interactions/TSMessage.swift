@@ -173,6 +173,19 @@ public extension TSMessage {
         MentionFinder.deleteAllMentions(for: self, transaction: tx.unwrapGrdbWrite)
     }
 
+    /// Removes the reactions and mentions of `messages` together, rather than
+    /// with a statement per message.
+    static func removeAllReactionsAndMentions(of messages: [TSMessage], tx: SDSAnyWriteTransaction) {
+        let uniqueMessageIds = messages.map(\.uniqueId)
+        guard !uniqueMessageIds.isEmpty else {
+            return
+        }
+        if !CurrentAppContext().isRunningTests {
+            ReactionFinder.deleteAllReactions(forUniqueMessageIds: uniqueMessageIds, transaction: tx.unwrapGrdbWrite)
+        }
+        MentionFinder.deleteAllMentions(forUniqueMessageIds: uniqueMessageIds, transaction: tx.unwrapGrdbWrite)
+    }
+
     @objc
     func allReactionIds(transaction: SDSAnyReadTransaction) -> [String]? {
         return reactionFinder.allUniqueIds(transaction: transaction.unwrapGrdbRead)
@@ -396,16 +409,39 @@ public extension TSMessage {
 
     private func markMessageAsRemotelyDeleted(transaction: SDSAnyWriteTransaction) {
 
-        // Delete the current interaction
-        updateWithRemotelyDeletedAndRemoveRenderableContent(with: transaction)
-
-        // Delete any past edit revisions.
+        // Delete the current interaction and any past edit revisions.
+        var messages = [self]
         try! processEdits(transaction: transaction) { record, message in
-            message?.updateWithRemotelyDeletedAndRemoveRenderableContent(with: transaction)
+            if let message {
+                messages.append(message)
+            }
         }
+        Self.updateWithRemotelyDeletedAndRemoveRenderableContent(messages, tx: transaction)
+
         SSKEnvironment.shared.notificationPresenterRef.cancelNotifications(messageIds: [self.uniqueId])
     }
 
+    /// Like `updateWithRemotelyDeletedAndRemoveRenderableContent(with:)` for
+    /// each of `messages`, but removes their reactions and mentions together.
+    static func updateWithRemotelyDeletedAndRemoveRenderableContent(_ messages: [TSMessage], tx: SDSAnyWriteTransaction) {
+        removeAllReactionsAndMentions(of: messages, tx: tx)
+        for message in messages {
+            message.updateWithRemotelyDeletedAndRemoveRenderableContent(with: tx, removeReactionsAndMentions: false)
+        }
+    }
+
+    /// Like `updateWithViewOnceCompleteAndRemoveRenderableContent(with:)` for
+    /// each of `messages`, but removes their mentions together.
+    ///
+    /// View-once completion has never removed reactions, so this doesn't either.
+    static func updateWithViewOnceCompleteAndRemoveRenderableContent(_ messages: [TSMessage], tx: SDSAnyWriteTransaction) {
+        let uniqueMessageIds = messages.map(\.uniqueId)
+        MentionFinder.deleteAllMentions(forUniqueMessageIds: uniqueMessageIds, transaction: tx.unwrapGrdbWrite)
+        for message in messages {
+            message.updateWithViewOnceCompleteAndRemoveRenderableContent(with: tx, removeMentions: false)
+        }
+    }
+
     // MARK: - Preview text
 
     @objc(previewTextForGiftBadgeWithTransaction:)
@@ -520,7 +556,7 @@ public extension TSMessage {
 
     private func previewText(_ tx: SDSAnyReadTransaction) -> PreviewText {
         if let infoMessage = self as? TSInfoMessage {
-            return .infoMessage(infoMessage.infoMessagePreviewText(with: tx))
+            return .infoMessage(PreviewTextCache.shared.infoMessagePreviewText(infoMessage, transaction: tx))
         }
 
         if (self is OWSPaymentMessage || self is OWSArchivedPaymentMessage) {
@@ -671,12 +707,12 @@ public extension TSMessage {
 
     @objc
     internal func _anyDidInsert(tx: SDSAnyWriteTransaction) {
-        FullTextSearchIndexer.insert(self, tx: tx)
+        FullTextSearchIndexer.scheduleIndexing(self, isInsert: true, tx: tx)
     }
 
     @objc
     internal func _anyDidUpdate(tx: SDSAnyWriteTransaction) {
-        FullTextSearchIndexer.update(self, tx: tx)
+        FullTextSearchIndexer.scheduleIndexing(self, tx: tx)
     }
 }
 
@@ -781,3 +817,20 @@ extension TSMessageBuilder {
         return false
     }
 }
+
+// MARK: - Column Updates
+
+extension TSMessage {
+    @objc
+    func anyUpdateExpirationColumns(transaction: SDSAnyWriteTransaction, block: (TSMessage) -> Void) {
+        TSInteraction.anyUpdateColumns(
+            of: self,
+            [
+                (.expireStartedAt, { $0.expireStartedAt }),
+                (.expiresAt, { $0.expiresAt }),
+            ],
+            transaction: transaction,
+            block: block
+        )
+    }
+}
@@ -10,7 +10,9 @@
 #import "TSGroupThread.h"
 #import "TSQuotedMessage.h"
 #import <SignalServiceKit/NSDate+OWS.h>
+#import <SignalServiceKit/OWSSignpost.h>
 #import <SignalServiceKit/SignalServiceKit-Swift.h>
+#import <os/lock.h>
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -46,9 +48,40 @@ NSString *NSStringForOutgoingMessageState(TSOutgoingMessageState value)
 
 #pragma mark -
 
+// A built data message (without the profile key) and everything it was built from
+// that can change during the message's lifetime.
+@interface TSOutgoingMessageDataMessageCacheEntry : NSObject
+
+@property (nonatomic, readonly) NSArray *contentComponents;
+@property (nonatomic, readonly) SSKProtoDataMessage *dataMessage;
+
+@end
+
+#pragma mark -
+
+@implementation TSOutgoingMessageDataMessageCacheEntry
+
+- (instancetype)initWithContentComponents:(NSArray *)contentComponents dataMessage:(SSKProtoDataMessage *)dataMessage
+{
+    self = [super init];
+    if (self) {
+        _contentComponents = contentComponents;
+        _dataMessage = dataMessage;
+    }
+    return self;
+}
+
+@end
+
+#pragma mark -
+
 NSUInteger const TSOutgoingMessageSchemaVersion = 1;
 
-@interface TSOutgoingMessage ()
+@interface TSOutgoingMessage () {
+    // Not properties, so that Mantle neither persists nor copies them.
+    os_unfair_lock _dataMessageCacheLock;
+    TSOutgoingMessageDataMessageCacheEntry *_Nullable _dataMessageCacheEntry;
+}
 
 @property (atomic) BOOL hasSyncedTranscript;
 @property (atomic, nullable) NSString *customMessage;
@@ -301,8 +334,7 @@ NSUInteger const TSOutgoingMessageSchemaVersion = 1;
 
 - (TSOutgoingMessageState)messageState
 {
-    TSOutgoingMessageState newMessageState =
-        [TSOutgoingMessage messageStateForRecipientStates:self.recipientAddressStates.allValues];
+    TSOutgoingMessageState newMessageState = self.messageStateFromRecipientStates;
     if (self.hasLegacyMessageState) {
         if (newMessageState == TSOutgoingMessageStateSent || self.legacyMessageState == TSOutgoingMessageStateSent) {
             return TSOutgoingMessageStateSent;
@@ -313,7 +345,7 @@ NSUInteger const TSOutgoingMessageSchemaVersion = 1;
 
 - (BOOL)wasDeliveredToAnyRecipient
 {
-    if (self.deliveredRecipientAddresses.count > 0) {
+    if (self.hasDeliveredRecipient) {
         return YES;
     }
     return (self.hasLegacyMessageState && self.legacyWasDelivered && self.messageState == TSOutgoingMessageStateSent);
@@ -321,7 +353,7 @@ NSUInteger const TSOutgoingMessageSchemaVersion = 1;
 
 - (BOOL)wasSentToAnyRecipient
 {
-    if (self.sentRecipientAddresses.count > 0) {
+    if (self.hasSentRecipient) {
         return YES;
     }
     return (self.hasLegacyMessageState && self.messageState == TSOutgoingMessageStateSent);
@@ -403,10 +435,10 @@ NSUInteger const TSOutgoingMessageSchemaVersion = 1;
 
 - (void)updateWithHasSyncedTranscript:(BOOL)hasSyncedTranscript transaction:(SDSAnyWriteTransaction *)transaction
 {
-    [self anyUpdateOutgoingMessageWithTransaction:transaction
-                                            block:^(TSOutgoingMessage *message) {
-                                                [message setHasSyncedTranscript:hasSyncedTranscript];
-                                            }];
+    [self anyUpdateHasSyncedTranscriptColumnWithTransaction:transaction
+                                                      block:^(TSOutgoingMessage *message) {
+                                                          [message setHasSyncedTranscript:hasSyncedTranscript];
+                                                      }];
 }
 
 #pragma mark -
@@ -594,23 +626,109 @@ NSUInteger const TSOutgoingMessageSchemaVersion = 1;
 {
     OWSAssertDebug(thread);
     OWSAssertDebug([thread.uniqueId isEqualToString:self.uniqueThreadId]);
+
+    SSKProtoDataMessage *_Nullable baseDataMessage = [self buildBaseDataMessage:thread transaction:transaction];
+    if (!baseDataMessage) {
+        return nil;
+    }
+
+    // Whether the profile key is shared depends on the thread's current
+    // whitelist state, so it's added to every build rather than cached.
+    SSKProtoDataMessageBuilder *builder = [baseDataMessage asBuilder];
+    [ProtoUtils addLocalProfileKeyIfNecessary:thread dataMessageBuilder:builder transaction:transaction];
+
+    NSError *error;
+    SSKProtoDataMessage *_Nullable dataProto = [builder buildAndReturnError:&error];
+    if (error || !dataProto) {
+        OWSFailDebug(@"could not build protobuf: %@", error);
+        return nil;
+    }
+    return dataProto;
+}
+
+// The data message is identical for every recipient, retry and sync transcript
+// of a send, so it is built once per instance and reused until the content it
+// was built from changes.
+//
+// Only plain messages without attachments are cached. Subclasses add state of
+// their own to the data message, and attachment pointers are read from the
+// database and change as uploads complete.
+- (nullable SSKProtoDataMessage *)buildBaseDataMessage:(TSThread *)thread
+                                           transaction:(SDSAnyReadTransaction *)transaction
+{
+    BOOL isCacheable = [self class] == [TSOutgoingMessage class];
+    NSArray *_Nullable contentComponents = nil;
+    if (isCacheable) {
+        contentComponents = [self dataMessageContentComponentsWithThread:thread];
+
+        os_unfair_lock_lock(&_dataMessageCacheLock);
+        TSOutgoingMessageDataMessageCacheEntry *_Nullable cacheEntry = _dataMessageCacheEntry;
+        os_unfair_lock_unlock(&_dataMessageCacheLock);
+        if (cacheEntry != nil && [cacheEntry.contentComponents isEqualToArray:contentComponents]) {
+            return cacheEntry.dataMessage;
+        }
+    }
+
+    os_signpost_id_t signpostID = OWSSignpostIntervalBegin("DataMessageBuilder");
     SSKProtoDataMessageBuilder *_Nullable builder = [self dataMessageBuilderWithThread:thread transaction:transaction];
+    OWSSignpostIntervalEnd("DataMessageBuilder", signpostID);
     if (!builder) {
         OWSFailDebug(@"could not build protobuf.");
         return nil;
     }
 
-    [ProtoUtils addLocalProfileKeyIfNecessary:thread dataMessageBuilder:builder transaction:transaction];
-
     NSError *error;
     SSKProtoDataMessage *_Nullable dataProto = [builder buildAndReturnError:&error];
     if (error || !dataProto) {
         OWSFailDebug(@"could not build protobuf: %@", error);
         return nil;
     }
+
+    if (contentComponents != nil && ![TSOutgoingMessage dataMessageHasAttachments:dataProto]) {
+        os_unfair_lock_lock(&_dataMessageCacheLock);
+        _dataMessageCacheEntry =
+            [[TSOutgoingMessageDataMessageCacheEntry alloc] initWithContentComponents:contentComponents
+                                                                          dataMessage:dataProto];
+        os_unfair_lock_unlock(&_dataMessageCacheLock);
+    }
     return dataProto;
 }
 
++ (BOOL)dataMessageHasAttachments:(SSKProtoDataMessage *)dataMessage
+{
+    // Quotes, contact shares, link previews and stickers can all carry attachment pointers.
+    return (dataMessage.attachments.count > 0 || dataMessage.quote != nil || dataMessage.contact.count > 0
+        || dataMessage.preview.count > 0 || dataMessage.sticker != nil);
+}
+
+// Everything dataMessageBuilderWithThread: reads that can change after the
+// message is created. The objects are retained by the cache entry, so identity
+// comparisons (which MTLModel's isEqual: tries first) stay sound.
+- (NSArray *)dataMessageContentComponentsWithThread:(TSThread *)thread
+{
+    uint32_t groupRevision = 0;
+    if ([thread isKindOfClass:[TSGroupThread class]]) {
+        TSGroupModel *groupModel = ((TSGroupThread *)thread).groupModel;
+        if ([groupModel isKindOfClass:[TSGroupModelV2 class]]) {
+            groupRevision = ((TSGroupModelV2 *)groupModel).revision;
+        }
+    }
+    return @[
+        thread.uniqueId,
+        @(groupRevision),
+        @(self.expiresInSeconds),
+        self.expireTimerVersion ?: [NSNull null],
+        self.body ?: [NSNull null],
+        self.bodyRanges ?: [NSNull null],
+        self.quotedMessage ?: [NSNull null],
+        self.contactShare ?: [NSNull null],
+        self.linkPreview ?: [NSNull null],
+        self.messageSticker ?: [NSNull null],
+        @(self.isViewOnceComplete),
+        @(self.wasRemotelyDeleted),
+    ];
+}
+
 - (nullable SSKProtoContentBuilder *)contentBuilderWithThread:(TSThread *)thread
                                                   transaction:(SDSAnyReadTransaction *)transaction
 {
@@ -625,6 +743,15 @@ NSUInteger const TSOutgoingMessageSchemaVersion = 1;
 }
 
 - (nullable NSData *)buildPlainTextData:(TSThread *)thread transaction:(SDSAnyWriteTransaction *)transaction
+{
+    os_signpost_id_t signpostID = OWSSignpostIntervalBegin("BuildPlainTextData");
+    NSData *_Nullable contentData = [self reallyBuildPlainTextData:thread transaction:transaction];
+    OWSSignpostIntervalEnd("BuildPlainTextData", signpostID);
+    [PipelineWatermarks.shared sampleStage:PipelineWatermarkStageProtoBuild];
+    return contentData;
+}
+
+- (nullable NSData *)reallyBuildPlainTextData:(TSThread *)thread transaction:(SDSAnyWriteTransaction *)transaction
 {
     SSKProtoContentBuilder *_Nullable contentBuilder = [self contentBuilderWithThread:thread transaction:transaction];
     if (!contentBuilder) {
@@ -93,6 +93,45 @@ extension TSOutgoingMessage {
         }
     }
 
+    /// Whether the message has been sent to any recipient; equivalent to
+    /// `!sentRecipientAddresses().isEmpty` without building the list.
+    @objc
+    var hasSentRecipient: Bool {
+        return hasRecipientState { state in
+            switch state.status {
+            case .sent, .delivered, .read, .viewed: return true
+            case .skipped, .sending, .pending, .failed: return false
+            }
+        }
+    }
+
+    /// Whether the message has been delivered to any recipient; equivalent to
+    /// `!deliveredRecipientAddresses().isEmpty` without building the list.
+    @objc
+    var hasDeliveredRecipient: Bool {
+        return hasRecipientState { state in
+            switch state.status {
+            case .delivered, .read, .viewed: return true
+            case .skipped, .sending, .sent, .pending, .failed: return false
+            }
+        }
+    }
+
+    /// The message state implied by the recipient states alone.
+    @objc
+    var messageStateFromRecipientStates: TSOutgoingMessageState {
+        guard let recipientAddressStates else {
+            return Self.messageState(forRecipientStates: [])
+        }
+        return Self.messageState(forRecipientStates: recipientAddressStates.values)
+    }
+
+    private func hasRecipientState(where predicate: (TSOutgoingMessageRecipientState) -> Bool) -> Bool {
+        guard let recipientAddressStates else { return false }
+
+        return recipientAddressStates.values.contains(where: predicate)
+    }
+
     private func filterRecipientAddresses(
         predicate: (TSOutgoingMessageRecipientState) -> Bool
     ) -> [SignalServiceAddress] {
@@ -321,6 +360,12 @@ public extension TSOutgoingMessage {
     static func messageStateForRecipientStates(
         _ recipientStates: [TSOutgoingMessageRecipientState]
     ) -> TSOutgoingMessageState {
+        return messageState(forRecipientStates: recipientStates)
+    }
+
+    fileprivate static func messageState<S: Sequence>(
+        forRecipientStates recipientStates: S
+    ) -> TSOutgoingMessageState where S.Element == TSOutgoingMessageRecipientState {
         var hasFailedRecipient: Bool = false
 
         for recipientState in recipientStates {
@@ -669,6 +714,18 @@ extension TSOutgoingMessage {
             recipientDatabaseTable: DependenciesBridge.shared.recipientDatabaseTable,
             signalServiceAddressCache: SSKEnvironment.shared.signalServiceAddressCacheRef
         )
+
+        // Updating the message re-archives every recipient's state, which is
+        // expensive for large groups, so skip receipts that wouldn't change
+        // anything (e.g. a delivery receipt that arrives after the read receipt).
+        if
+            let latestMessage = TSOutgoingMessage.anyFetchOutgoingMessage(uniqueId: uniqueId, transaction: tx),
+            let recipientState = latestMessage.recipientAddressStates?[recipientAddress],
+            !Self.receipt(ofType: receiptType, timestamp: receiptTimestamp, wouldChange: recipientState)
+        {
+            return
+        }
+
         anyUpdateOutgoingMessage(transaction: tx) { message in
             guard let recipientState: TSOutgoingMessageRecipientState = {
                 if let existingMatch = message.recipientAddressStates?[recipientAddress] {
@@ -689,35 +746,7 @@ extension TSOutgoingMessage {
                 return
             }
 
-            /// We want to avoid "downgrading" the recipient status; for
-            /// example, if we receive a delivery receipt after a read receipt,
-            /// we want to preserve the `.read` status.
-            ///
-            /// We do, however, support overwriting the recipient status'
-            /// timestamp when receiving a receipt matching the existing
-            /// recipient status (e.g., receiving a `.read` receipt when the
-            /// recipient status is already `.read`).
-            let shouldUpdateRecipientStatus: Bool = {
-                switch (recipientState.status, receiptType) {
-                case (.failed, _), (.sending, _), (.sent, _), (.skipped, _), (.pending, _):
-                    return true
-                case
-                        (.delivered, .delivered),
-                        (.delivered, .read),
-                        (.delivered, .viewed),
-                        (.read, .read),
-                        (.read, .viewed),
-                        (.viewed, .viewed):
-                    return true
-                case
-                        (.read, .delivered),
-                        (.viewed, .delivered),
-                        (.viewed, .read):
-                    return false
-                }
-            }()
-
-            if shouldUpdateRecipientStatus {
+            if Self.shouldUpdate(recipientState, forReceiptType: receiptType) {
                 recipientState.updateStatus(
                     receiptType.asRecipientStatus,
                     statusTimestamp: receiptTimestamp
@@ -726,6 +755,52 @@ extension TSOutgoingMessage {
             }
         }
     }
+
+    /// We want to avoid "downgrading" the recipient status; for
+    /// example, if we receive a delivery receipt after a read receipt,
+    /// we want to preserve the `.read` status.
+    ///
+    /// We do, however, support overwriting the recipient status'
+    /// timestamp when receiving a receipt matching the existing
+    /// recipient status (e.g., receiving a `.read` receipt when the
+    /// recipient status is already `.read`).
+    private static func shouldUpdate(
+        _ recipientState: TSOutgoingMessageRecipientState,
+        forReceiptType receiptType: IncomingReceiptType
+    ) -> Bool {
+        switch (recipientState.status, receiptType) {
+        case (.failed, _), (.sending, _), (.sent, _), (.skipped, _), (.pending, _):
+            return true
+        case
+                (.delivered, .delivered),
+                (.delivered, .read),
+                (.delivered, .viewed),
+                (.read, .read),
+                (.read, .viewed),
+                (.viewed, .viewed):
+            return true
+        case
+                (.read, .delivered),
+                (.viewed, .delivered),
+                (.viewed, .read):
+            return false
+        }
+    }
+
+    private static func receipt(
+        ofType receiptType: IncomingReceiptType,
+        timestamp receiptTimestamp: UInt64,
+        wouldChange recipientState: TSOutgoingMessageRecipientState
+    ) -> Bool {
+        guard shouldUpdate(recipientState, forReceiptType: receiptType) else {
+            return false
+        }
+        return (
+            recipientState.status != receiptType.asRecipientStatus
+            || recipientState.statusTimestamp != receiptTimestamp
+            || recipientState.errorCode != nil
+        )
+    }
 }
 
 // MARK: - Sender Key + Message Send Log
@@ -838,3 +913,17 @@ public extension TSOutgoingMessage {
         try await SSKEnvironment.shared.messageSenderRef.performMessageSend(messageSend, sealedSenderParameters: nil)
     }
 }
+
+// MARK: - Column Updates
+
+extension TSOutgoingMessage {
+    @objc
+    func anyUpdateHasSyncedTranscriptColumn(transaction: SDSAnyWriteTransaction, block: (TSOutgoingMessage) -> Void) {
+        TSInteraction.anyUpdateColumns(
+            of: self,
+            [(.hasSyncedTranscript, { $0.hasSyncedTranscript })],
+            transaction: transaction,
+            block: block
+        )
+    }
+}
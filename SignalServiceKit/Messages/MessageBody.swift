@@ -73,7 +73,7 @@ public class MessageBody: NSObject, NSCopying, NSSecureCoding {
         let recipientAddresses: Set<SignalServiceAddress>
         if let groupThread = context as? TSGroupThread, groupThread.isGroupV2Thread {
             isGroupThread = true
-            recipientAddresses = Set(groupThread.recipientAddresses(with: transaction.asAnyRead))
+            recipientAddresses = groupThread.recipientAddressSet(with: transaction.asAnyRead)
         } else {
             isGroupThread = false
             recipientAddresses = .init()
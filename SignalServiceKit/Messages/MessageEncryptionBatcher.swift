@@ -0,0 +1,78 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import Foundation
+
+/// Runs the per-device encryptions of concurrent fan-out sends in shared write
+/// transactions.
+///
+/// Encrypting advances the session's ratchet, so each encryption needs a write
+/// transaction. Fan-out sends to every recipient concurrently, but with one
+/// transaction per device those encryptions queue on the database's serial
+/// write queue and a large group send spends most of its time opening and
+/// committing transactions. Instead, every encryption requested while a batch
+/// is being committed is run in the next transaction, up to a limit.
+///
+/// Each block's result (or thrown error) is delivered only after the
+/// transaction it ran in has committed, and a throwing block doesn't affect
+/// the others in its batch, exactly as if each had its own transaction.
+final class MessageEncryptionBatcher {
+
+    private typealias Job = (SDSAnyWriteTransaction) -> (() -> Void)
+
+    /// Keeps any one transaction, and so the write lock, short.
+    private static let maxJobsPerTransaction = 64
+
+    private let queue = DispatchQueue(label: "org.signal.message-encryption-batcher", qos: .userInitiated)
+
+    private let lock = UnfairLock()
+
+    // These properties should only be accessed with lock acquired.
+    private var pendingJobs = [Job]()
+    private var isDraining = false
+
+    init() {}
+
+    func write<T>(_ block: @escaping (SDSAnyWriteTransaction) throws -> T) async throws -> T {
+        let result: Result<T, Error> = await withCheckedContinuation { continuation in
+            let job: Job = { tx in
+                let result = Result { try block(tx) }
+                return { continuation.resume(returning: result) }
+            }
+            let shouldStartDraining: Bool = lock.withLock {
+                pendingJobs.append(job)
+                guard !isDraining else {
+                    return false
+                }
+                isDraining = true
+                return true
+            }
+            if shouldStartDraining {
+                queue.async { self.drain() }
+            }
+        }
+        return try result.get()
+    }
+
+    private func drain() {
+        while true {
+            let jobs: [Job] = lock.withLock {
+                let jobs = Array(pendingJobs.prefix(Self.maxJobsPerTransaction))
+                pendingJobs.removeFirst(jobs.count)
+                if jobs.isEmpty {
+                    isDraining = false
+                }
+                return jobs
+            }
+            guard !jobs.isEmpty else {
+                return
+            }
+            let completions = SSKEnvironment.shared.databaseStorageRef.write { tx in
+                jobs.map { $0(tx) }
+            }
+            completions.forEach { $0() }
+        }
+    }
+}
@@ -311,11 +311,20 @@ public class MessageProcessor: NSObject {
 
         // We want a value that is just high enough to yield perf benefits.
         let kIncomingMessageBatchSize = 16
+        // When catching up on a large backlog, commit more envelopes per
+        // transaction. Decryption and processing share the transaction, so the
+        // fixed cost of each one dominates otherwise.
+        let kBacklogBatchSize = 64
         // If the app is in the background, use batch size of 1.
         // This reduces the risk of us never being able to drain any
         // messages from the queue. We should fine tune this number
         // to yield the best perf we can get.
-        let batchSize = CurrentAppContext().isInBackground() ? 1 : kIncomingMessageBatchSize
+        let batchSize: Int = {
+            if CurrentAppContext().isInBackground() {
+                return 1
+            }
+            return pendingEnvelopes.count > kBacklogBatchSize ? kBacklogBatchSize : kIncomingMessageBatchSize
+        }()
         let batch = pendingEnvelopes.nextBatch(batchSize: batchSize)
         let batchEnvelopes = batch.batchEnvelopes
         let pendingEnvelopesCount = batch.pendingEnvelopesCount
@@ -443,6 +452,12 @@ public class MessageProcessor: NSObject {
         tx: SDSAnyWriteTransaction
     ) {
         let error = reallyHandleProcessingRequest(request, context: context, localIdentifiers: localIdentifiers, transaction: tx)
+        HotPathLog.record(
+            .messageProcessing,
+            "Handled envelope (timestamp, failed)",
+            Int64(bitPattern: request.receivedEnvelope.envelope.timestamp),
+            error == nil ? 0 : 1
+        )
         tx.addAsyncCompletionOffMain { request.receivedEnvelope.completion(error) }
     }
 
@@ -752,15 +767,27 @@ private struct ReceivedEnvelope {
                 return .serverReceipt(try ServerReceiptEnvelope(validatedEnvelope))
             case .identifiedSender(let cipherType):
                 return .decryptedMessage(
-                    try messageDecrypter.decryptIdentifiedEnvelope(
-                        validatedEnvelope, cipherType: cipherType, localIdentifiers: localIdentifiers, tx: tx
-                    )
+                    try Signpost.interval("Decrypt") {
+                        defer {
+                            PipelineWatermarks.shared.sample(.messageDecode)
+                            PerformanceCounters.shared.recordDecryption()
+                        }
+                        return try messageDecrypter.decryptIdentifiedEnvelope(
+                            validatedEnvelope, cipherType: cipherType, localIdentifiers: localIdentifiers, tx: tx
+                        )
+                    }
                 )
             case .unidentifiedSender:
                 return .decryptedMessage(
-                    try messageDecrypter.decryptUnidentifiedSenderEnvelope(
-                        validatedEnvelope, localIdentifiers: localIdentifiers, localDeviceId: localDeviceId, tx: tx
-                    )
+                    try Signpost.interval("Decrypt") {
+                        defer {
+                            PipelineWatermarks.shared.sample(.messageDecode)
+                            PerformanceCounters.shared.recordDecryption()
+                        }
+                        return try messageDecrypter.decryptUnidentifiedSenderEnvelope(
+                            validatedEnvelope, localIdentifiers: localIdentifiers, localDeviceId: localDeviceId, tx: tx
+                        )
+                    }
                 )
             }
 
@@ -787,18 +814,6 @@ private struct ReceivedEnvelope {
             }
         }
     }
-
-    func isDuplicateOf(_ other: ReceivedEnvelope) -> Bool {
-        guard let serverGuid = self.envelope.serverGuid else {
-            owsFailDebug("Missing serverGuid.")
-            return false
-        }
-        guard let otherServerGuid = other.envelope.serverGuid else {
-            owsFailDebug("Missing other.serverGuid.")
-            return false
-        }
-        return serverGuid == otherServerGuid
-    }
 }
 
 // MARK: -
@@ -819,6 +834,12 @@ public enum EnvelopeSource {
 private class PendingEnvelopes {
     private let unfairLock = UnfairLock()
     private var pendingEnvelopes = [ReceivedEnvelope]()
+    /// The number of envelopes ever removed from the front of `pendingEnvelopes`.
+    private var removedEnvelopesCount = 0
+    /// Maps each pending serverGuid to its envelope's position, offset by
+    /// `removedEnvelopesCount`, so that finding a duplicate doesn't require
+    /// scanning a large backlog.
+    private var positionsByServerGuid = [String: Int]()
 
     var isEmpty: Bool {
         unfairLock.withLock { pendingEnvelopes.isEmpty }
@@ -844,17 +865,31 @@ private class PendingEnvelopes {
 
     func removeProcessedEnvelopes(_ processedEnvelopesCount: Int) {
         unfairLock.withLock {
+            for processedEnvelope in pendingEnvelopes.prefix(processedEnvelopesCount) {
+                if let serverGuid = processedEnvelope.envelope.serverGuid {
+                    positionsByServerGuid[serverGuid] = nil
+                }
+            }
             pendingEnvelopes.removeFirst(processedEnvelopesCount)
+            removedEnvelopesCount += processedEnvelopesCount
         }
     }
 
     func enqueue(_ receivedEnvelope: ReceivedEnvelope) -> ReceivedEnvelope? {
         return unfairLock.withLock { () -> ReceivedEnvelope? in
-            if let indexToReplace = pendingEnvelopes.firstIndex(where: { receivedEnvelope.isDuplicateOf($0) }) {
+            // Envelopes with the same serverGuid are duplicates of one another.
+            guard let serverGuid = receivedEnvelope.envelope.serverGuid else {
+                owsFailDebug("Missing serverGuid.")
+                pendingEnvelopes.append(receivedEnvelope)
+                return nil
+            }
+            if let position = positionsByServerGuid[serverGuid] {
+                let indexToReplace = position - removedEnvelopesCount
                 let replacedEnvelope = pendingEnvelopes[indexToReplace]
                 pendingEnvelopes[indexToReplace] = receivedEnvelope
                 return replacedEnvelope
             } else {
+                positionsByServerGuid[serverGuid] = removedEnvelopesCount + pendingEnvelopes.count
                 pendingEnvelopes.append(receivedEnvelope)
                 return nil
             }
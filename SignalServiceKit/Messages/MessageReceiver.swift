@@ -324,11 +324,10 @@ public final class MessageReceiver {
     /// just clear the placeholder.
     private func clearLeftoverPlaceholders(for envelope: DecryptedIncomingEnvelope, tx: SDSAnyWriteTransaction) {
         do {
-            let placeholders = try InteractionFinder.interactions(
+            let placeholders = try InteractionFinder.placeholders(
                 withTimestamp: envelope.timestamp,
-                filter: { ($0 as? OWSRecoverableDecryptionPlaceholder)?.sender?.serviceId == envelope.sourceAci },
                 transaction: tx
-            )
+            ).filter { $0.sender?.serviceId == envelope.sourceAci }
             owsAssertDebug(placeholders.count <= 1)
             for placeholder in placeholders {
                 DependenciesBridge.shared.interactionDeleteManager
@@ -272,6 +272,7 @@ extension MessageSender {
     }
 
     private struct PrepareDistributionResult {
+        var distributionId: SenderKeyStore.DistributionId?
         var readyRecipients = [ServiceId]()
         var failedRecipients = [(ServiceId, SenderKeyError)]()
         var senderKeyDistributionMessageSends = [(OWSMessageSend, SealedSenderParameters?)]()
@@ -309,6 +310,7 @@ extension MessageSender {
         }
 
         var result = PrepareDistributionResult()
+        result.distributionId = SSKEnvironment.shared.senderKeyStoreRef.distributionIdForSendingToThread(thread, writeTx: writeTx)
         for serviceId in recipients {
             guard recipientsInNeedOfSenderKey.contains(serviceId) else {
                 result.readyRecipients.append(serviceId)
@@ -363,11 +365,35 @@ extension MessageSender {
             return (prepareResult.readyRecipients, prepareResult.failedRecipients)
         }
 
+        // If another send is already distributing the key to a recipient, wait
+        // for it instead of sending a second SKDM.
+        var startedDistributions = [(OWSMessageSend, SealedSenderParameters?, SenderKeyDistributionTracker.Key?, Future<Void>?)]()
+        var inProgressDistributions = [(ServiceId, Promise<Void>)]()
+        for (messageSend, sealedSenderParameters) in prepareResult.senderKeyDistributionMessageSends {
+            guard let distributionId = prepareResult.distributionId else {
+                owsFailDebug("Missing distributionId.")
+                startedDistributions.append((messageSend, sealedSenderParameters, nil, nil))
+                continue
+            }
+            let key = SenderKeyDistributionTracker.Key(
+                threadUniqueId: thread.uniqueId,
+                serviceId: messageSend.serviceId,
+                distributionId: distributionId
+            )
+            switch senderKeyDistributionTracker.beginDistribution(for: key) {
+            case .started(let future):
+                startedDistributions.append((messageSend, sealedSenderParameters, key, future))
+            case .inProgress(let promise):
+                Logger.info("Waiting for in-progress SKDM to \(messageSend.serviceId) in thread \(thread.uniqueId)")
+                inProgressDistributions.append((messageSend.serviceId, promise))
+            }
+        }
+
         let distributionResults = await withTaskGroup(
             of: (ServiceId, Result<SentSenderKey, any Error>).self,
             returning: [(ServiceId, Result<SentSenderKey, any Error>)].self
         ) { taskGroup in
-            for (messageSend, sealedSenderParameters) in prepareResult.senderKeyDistributionMessageSends {
+            for (messageSend, sealedSenderParameters, _, _) in startedDistributions {
                 taskGroup.addTask {
                     do {
                         let sentMessages = try await self.performMessageSend(messageSend, sealedSenderParameters: sealedSenderParameters)
@@ -384,7 +410,7 @@ extension MessageSender {
             return await taskGroup.reduce(into: [], { $0.append($1) })
         }
 
-        return await SSKEnvironment.shared.databaseStorageRef.awaitableWrite { tx in
+        var (readyRecipients, failedRecipients) = await SSKEnvironment.shared.databaseStorageRef.awaitableWrite { tx -> ([ServiceId], [(ServiceId, SenderKeyError)]) in
             var readyRecipients = prepareResult.readyRecipients
             var failedRecipients = prepareResult.failedRecipients
             var sentSenderKeys = [SentSenderKey]()
@@ -417,6 +443,27 @@ extension MessageSender {
             }
             return (readyRecipients, failedRecipients)
         }
+
+        let failedRecipientErrors = Dictionary(failedRecipients.map { ($0.0, $0.1) }, uniquingKeysWith: { first, _ in first })
+        for case let (messageSend, _, key?, future?) in startedDistributions {
+            let result: Result<Void, Error>
+            if let error = failedRecipientErrors[messageSend.serviceId] {
+                result = .failure(error)
+            } else {
+                result = .success(())
+            }
+            senderKeyDistributionTracker.endDistribution(for: key, future: future, result: result)
+        }
+
+        for (serviceId, promise) in inProgressDistributions {
+            do {
+                try await promise.awaitable()
+                readyRecipients.append(serviceId)
+            } catch {
+                failedRecipients.append((serviceId, SenderKeyError.recipientSKDMFailed(error)))
+            }
+        }
+        return (readyRecipients, failedRecipients)
     }
 
     fileprivate struct SenderKeySendResult {
@@ -39,6 +39,10 @@ public class MessageSender {
 
     private let pendingTasks = PendingTasks(label: "Message Sends")
 
+    private let encryptionBatcher = MessageEncryptionBatcher()
+
+    let senderKeyDistributionTracker = SenderKeyDistributionTracker()
+
     public func pendingSendsPromise() -> Promise<Void> {
         // This promise blocks on all operations already in the queue,
         // but will not block on new operations added after this promise
@@ -491,6 +495,9 @@ public class MessageSender {
         let pendingTask = pendingTasks.buildPendingTask(label: "Message Send")
         defer { pendingTask.complete() }
 
+        PerformanceCounters.shared.sendDidStart()
+        defer { PerformanceCounters.shared.sendDidFinish() }
+
         try await withCheckedThrowingContinuation { continuation in
             let sendMessageOperation = AwaitableAsyncBlockOperation(completionContinuation: continuation) {
                 try await preparedOutgoingMessage.send(self.sendPreparedMessage(_:))
@@ -829,6 +836,10 @@ public class MessageSender {
                 return nil
             }
 
+            // Encrypting for each recipient checks their identity. Load the ones that
+            // aren't cached in one query so that those checks are served by the cache.
+            _ = DependenciesBridge.shared.identityManager.recipientIdentities(for: serviceIds, tx: tx.asV2Read)
+
             guard let serializedMessage = self.buildAndRecordMessage(message, in: thread, tx: tx) else {
                 throw OWSAssertionError("Couldn't build message.")
             }
@@ -1424,7 +1435,8 @@ public class MessageSender {
             }
         }
 
-        return try await SSKEnvironment.shared.databaseStorageRef.awaitableWrite { tx in
+        // Concurrent sends share transactions for this step; see MessageEncryptionBatcher.
+        return try await encryptionBatcher.write { tx in
             do {
                 switch messageEncryptionStyle {
                 case .whisper:
@@ -1517,6 +1529,7 @@ public class MessageSender {
         let message: TSOutgoingMessage = messageSend.message
 
         Logger.info("Successfully sent message: \(type(of: message)), serviceId: \(messageSend.serviceId), timestamp: \(message.timestamp), wasSentByUD: \(wasSentByUD), wasSentByWebsocket: \(wasSentByWebsocket)")
+        HotPathLog.record(.sends, "Sent to recipient (timestamp, devices)", Int64(bitPattern: message.timestamp), Int64(deviceMessages.count))
 
         let sentDeviceMessages = deviceMessages.map {
             return SentDeviceMessage(
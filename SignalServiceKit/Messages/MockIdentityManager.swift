@@ -21,6 +21,15 @@ open class MockIdentityManager: OWSIdentityManager {
         return recipientIdentities[recipientUniqueId]
     }
 
+    open func recipientIdentities(for serviceIds: [ServiceId], tx: DBReadTransaction) -> [ServiceId: OWSRecipientIdentity] {
+        var result = [ServiceId: OWSRecipientIdentity]()
+        for serviceId in serviceIds {
+            guard let recipientUniqueId = try? recipientIdFinder.recipientUniqueId(for: serviceId, tx: tx)?.get() else { continue }
+            result[serviceId] = recipientIdentities[recipientUniqueId]
+        }
+        return result
+    }
+
     open func removeRecipientIdentity(for recipientUniqueId: RecipientUniqueId, tx: DBWriteTransaction) {
         recipientIdentities[recipientUniqueId] = nil
     }
@@ -88,6 +88,26 @@ public final class OWSDisappearingMessagesJob: NSObject {
         }
     }
 
+    /// Like `startAnyExpiration(for:expirationStartedAt:transaction:)`, but
+    /// schedules a single run for all of `messages`.
+    func startAnyExpiration(for messages: [TSMessage], expirationStartedAt: UInt64, transaction: SDSAnyWriteTransaction) {
+        let messages = messages.filter { $0.shouldStartExpireTimer() }
+        guard !messages.isEmpty else { return }
+
+        for message in messages {
+            // Don't clobber if multiple actions simultaneously triggered expiration.
+            if message.expireStartedAt == 0 || message.expireStartedAt > expirationStartedAt {
+                message.updateWithExpireStarted(at: expirationStartedAt, transaction: transaction)
+            }
+        }
+
+        transaction.addAsyncCompletionOffMain { [self] in
+            if let firstExpiresAt = messages.lazy.map(\.expiresAt).min() {
+                scheduleRun(by: firstExpiresAt)
+            }
+        }
+    }
+
     /// - Parameter timestamp: milliseconds since the unix epoch
     func scheduleRun(by timestamp: UInt64) {
         scheduleRun(by: Date(millisecondsSince1970: timestamp))
@@ -100,10 +120,13 @@ public final class OWSDisappearingMessagesJob: NSObject {
 
             // Don't run more often than once per second.
             let kMinDelaySeconds: TimeInterval = 1.0
-            let delaySeconds = max(kMinDelaySeconds, date.timeIntervalSinceNow)
-            let newTimerScheduleDate = Date(timeIntervalSinceNow: delaySeconds)
+            let newTimerScheduleDate = Self.expirationBucketStart(
+                for: max(date, Date(timeIntervalSinceNow: kMinDelaySeconds))
+            )
+            let delaySeconds = newTimerScheduleDate.timeIntervalSinceNow
 
             // don't do anything if this timer would be later than the next one
+            // (or in the same bucket)
             guard nextDisappearanceDate == nil || nextDisappearanceDate! > newTimerScheduleDate else {
                 return
             }
@@ -117,9 +140,41 @@ public final class OWSDisappearingMessagesJob: NSObject {
                     self?.disapperanceTimerDidFire()
                 }
             }
+            // Let the system coalesce this wakeup with others, but not so much
+            // that messages linger noticeably past their expiration.
+            nextDisappearanceTimer?.tolerance = Self.expirationTimerTolerance
         }
     }
 
+    /// Expirations are grouped into buckets of this width.
+    ///
+    /// With several busy chats on short timers, messages expire every few
+    /// milliseconds. Runs are scheduled for the start of a bucket and delete
+    /// everything that expires before the end of the current bucket, so a
+    /// single run (and, usually, transaction) deletes every message that
+    /// expires in that bucket, and scheduling another expiration in the same
+    /// bucket doesn't reschedule the timer. Messages may disappear up to one
+    /// bucket early, but never a bucket late.
+    static let expirationBucketInterval: TimeInterval = 0.25
+
+    private static let expirationTimerTolerance: TimeInterval = 0.1
+
+    static func expirationBucketStart(for date: Date) -> Date {
+        let bucketIndex = (date.timeIntervalSince1970 / expirationBucketInterval).rounded(.down)
+        return Date(timeIntervalSince1970: bucketIndex * expirationBucketInterval)
+    }
+
+    static func expirationBucketEnd(for date: Date) -> Date {
+        let bucketIndex = (date.timeIntervalSince1970 / expirationBucketInterval).rounded(.up)
+        return Date(timeIntervalSince1970: bucketIndex * expirationBucketInterval)
+    }
+
+    /// Messages and stories that expire before this timestamp are deleted by
+    /// the current run.
+    private static func expirationCutoffTimestamp() -> UInt64 {
+        return expirationBucketEnd(for: Date()).ows_millisecondsSince1970
+    }
+
     /// Clean up any messages that expired since last launch immediately
     /// and continue cleaning in the background.
     public func startIfNecessary() {
@@ -260,7 +315,7 @@ public final class OWSDisappearingMessagesJob: NSObject {
 
     private func deleteSomeExpiredMessages(tx: DBWriteTransaction) throws -> Int {
         let sdsTx = SDSDB.shimOnlyBridge(tx)
-        let now = Date.ows_millisecondTimestamp()
+        let now = Self.expirationCutoffTimestamp()
         let rowIds = try InteractionFinder.fetchSomeExpiredMessageRowIds(now: now, limit: Constants.fetchCount, tx: sdsTx)
         for rowId in rowIds {
             guard let message = InteractionFinder.fetch(rowId: rowId, transaction: sdsTx) else {
@@ -283,7 +338,7 @@ public final class OWSDisappearingMessagesJob: NSObject {
 
     private func deleteSomeExpiredStories(tx: DBWriteTransaction) throws -> Int {
         let tx = SDSDB.shimOnlyBridge(tx)
-        let now = Date.ows_millisecondTimestamp()
+        let now = Self.expirationCutoffTimestamp()
         let storyMessages = try StoryFinder.fetchSomeExpiredStories(now: now, limit: Constants.fetchCount, tx: tx)
         for storyMessage in storyMessages {
             storyMessage.anyRemove(transaction: tx)
@@ -19,6 +19,7 @@ public protocol OWSIdentityManager {
 
     func recipientIdentity(for address: SignalServiceAddress, tx: DBReadTransaction) -> OWSRecipientIdentity?
     func recipientIdentity(for recipientUniqueId: RecipientUniqueId, tx: DBReadTransaction) -> OWSRecipientIdentity?
+    func recipientIdentities(for serviceIds: [ServiceId], tx: DBReadTransaction) -> [ServiceId: OWSRecipientIdentity]
     func removeRecipientIdentity(for recipientUniqueId: RecipientUniqueId, tx: DBWriteTransaction)
 
     func identityKeyPair(for identity: OWSIdentity, tx: DBReadTransaction) -> ECKeyPair?
@@ -298,6 +299,10 @@ public class OWSIdentityManagerImpl: OWSIdentityManager {
         return OWSRecipientIdentity.anyFetch(uniqueId: recipientUniqueId, transaction: SDSDB.shimOnlyBridge(tx))
     }
 
+    public func recipientIdentities(for serviceIds: [ServiceId], tx: DBReadTransaction) -> [ServiceId: OWSRecipientIdentity] {
+        return OWSRecipientIdentity.recipientIdentities(for: serviceIds, tx: SDSDB.shimOnlyBridge(tx))
+    }
+
     public func removeRecipientIdentity(for recipientUniqueId: RecipientUniqueId, tx: DBWriteTransaction) {
         recipientIdentity(for: recipientUniqueId, tx: tx)?.anyRemove(transaction: SDSDB.shimOnlyBridge(tx))
     }
@@ -75,6 +75,8 @@ public class OWSReceiptManager: NSObject {
     }
 
     private var isProcessing = AtomicValue(false, lock: .init())
+    /// The wait between processing passes, if one is in progress.
+    private let linkedDeviceBatchWait = AtomicOptional<Task<Void, Never>>(nil, lock: .init())
     private var areReadReceiptsEnabledCached = AtomicOptional<Bool>(nil, lock: .init())
 
     static let keyValueStore = SDSKeyValueStore(collection: "OWSReadReceiptManagerCollection")
@@ -83,6 +85,9 @@ public class OWSReceiptManager: NSObject {
 
     private static let kOwsReceiptManagerAreReadReceiptsEnabled = "areReadReceiptsEnabled"
 
+    /// Keeps each sync message well under the maximum message size.
+    private static let maxReceiptsPerLinkedDeviceMessage = 500
+
     init(appReadiness: any AppReadiness,
          databaseStorage: SDSDatabaseStorage,
          messageSenderJobQueue: MessageSenderJobQueue,
@@ -94,11 +99,25 @@ public class OWSReceiptManager: NSObject {
 
         SwiftSingletons.register(self)
 
+        NotificationCenter.default.addObserver(
+            self,
+            selector: #selector(applicationDidEnterBackground),
+            name: .OWSApplicationDidEnterBackground,
+            object: nil
+        )
+
         self.appReadiness.runNowOrWhenAppDidBecomeReadyAsync { [self] in
             scheduleProcessing()
         }
     }
 
+    @objc
+    private func applicationDidEnterBackground() {
+        // Send what's accumulated now rather than risk the app being suspended
+        // before the wait is over.
+        linkedDeviceBatchWait.get()?.cancel()
+    }
+
     /// Schedules a processing pass, unless one is already scheduled.
     private func scheduleProcessing() {
         owsAssertDebug(appReadiness.isAppReady)
@@ -147,6 +166,72 @@ public class OWSReceiptManager: NSObject {
         }
     }
 
+    /// Equivalent to calling `messageWasRead` for each of `messages`, which
+    /// must all belong to `thread`, but enqueues their receipts in bulk.
+    func messagesWereRead(_ messages: [TSIncomingMessage], thread: TSThread, circumstance: OWSReceiptCircumstance, transaction: SDSAnyWriteTransaction) {
+        guard !messages.isEmpty else {
+            return
+        }
+        switch circumstance {
+        case .onLinkedDevice:
+            break
+        case .onLinkedDeviceWhilePendingMessageRequest, .onThisDeviceWhilePendingMessageRequest:
+            messages.forEach { messageWasRead($0, thread: thread, circumstance: circumstance, transaction: transaction) }
+        case .onThisDevice:
+            // Only the newest "linked device" read receipt for a thread is kept.
+            if let newestMessage = messages.max(by: { $0.timestamp < $1.timestamp }) {
+                enqueueLinkedDeviceReadReceipt(forMessage: newestMessage, transaction: transaction)
+            }
+            transaction.addAsyncCompletionOffMain { self.scheduleProcessing() }
+            guard areReadReceiptsEnabled() else {
+                break
+            }
+            for (authorAddress, receipts) in receiptsByAuthor(for: messages) {
+                receiptSender.enqueueReadReceipts(for: authorAddress, timestampsAndMessageUniqueIds: receipts, tx: transaction)
+            }
+        }
+    }
+
+    /// Equivalent to calling `messageWasViewed` for each of `messages`, which
+    /// must all belong to `thread`, but enqueues their receipts in bulk.
+    func messagesWereViewed(_ messages: [TSIncomingMessage], thread: TSThread, circumstance: OWSReceiptCircumstance, transaction: SDSAnyWriteTransaction) {
+        guard !messages.isEmpty else {
+            return
+        }
+        switch circumstance {
+        case .onLinkedDevice:
+            break
+        case .onLinkedDeviceWhilePendingMessageRequest, .onThisDeviceWhilePendingMessageRequest:
+            messages.forEach { messageWasViewed($0, thread: thread, circumstance: circumstance, transaction: transaction) }
+        case .onThisDevice:
+            for message in messages {
+                enqueueLinkedDeviceViewedReceipt(forIncomingMessage: message, transaction: transaction)
+            }
+            transaction.addAsyncCompletionOffMain { self.scheduleProcessing() }
+            guard areReadReceiptsEnabled() else {
+                break
+            }
+            for (authorAddress, receipts) in receiptsByAuthor(for: messages) {
+                receiptSender.enqueueViewedReceipts(for: authorAddress, timestampsAndMessageUniqueIds: receipts, tx: transaction)
+            }
+        }
+    }
+
+    private func receiptsByAuthor(
+        for messages: [TSIncomingMessage]
+    ) -> [SignalServiceAddress: [(timestamp: UInt64, messageUniqueId: String?)]] {
+        var result = [SignalServiceAddress: [(timestamp: UInt64, messageUniqueId: String?)]]()
+        for message in messages {
+            let authorAddress = message.authorAddress
+            if authorAddress.isLocalAddress {
+                owsFailDebug("We don't support incoming messages from self.")
+                continue
+            }
+            result[authorAddress, default: []].append((message.timestamp, message.uniqueId))
+        }
+        return result
+    }
+
     @objc
     public func messageWasViewed(_ message: TSIncomingMessage, thread: TSThread, circumstance: OWSReceiptCircumstance, transaction: SDSAnyWriteTransaction) {
         switch (circumstance) {
@@ -290,10 +375,10 @@ extension OWSReceiptManager {
 
         if !readReceiptsForLinkedDevices.isEmpty {
             let readReceiptsToSend = readReceiptsForLinkedDevices.compactMap { $0.asLinkedDeviceReadReceipt }
-            if !readReceiptsToSend.isEmpty {
+            for readReceiptBatch in readReceiptsToSend.chunked(by: Self.maxReceiptsPerLinkedDeviceMessage) {
                 let message = OWSReadReceiptsForLinkedDevicesMessage(
                     thread: thread,
-                    readReceipts: readReceiptsToSend,
+                    readReceipts: Array(readReceiptBatch),
                     transaction: transaction
                 )
                 let preparedMessage = PreparedOutgoingMessage.preprepared(transientMessageWithoutAttachments: message)
@@ -304,10 +389,10 @@ extension OWSReceiptManager {
 
         if !viewedReceiptsForLinkedDevices.isEmpty {
             let viewedReceiptsToSend = viewedReceiptsForLinkedDevices.compactMap { $0.asLinkedDeviceViewedReceipt }
-            if !viewedReceiptsToSend.isEmpty {
+            for viewedReceiptBatch in viewedReceiptsToSend.chunked(by: Self.maxReceiptsPerLinkedDeviceMessage) {
                 let message = OWSViewedReceiptsForLinkedDevicesMessage(
                     thread: thread,
-                    viewedReceipts: viewedReceiptsToSend,
+                    viewedReceipts: Array(viewedReceiptBatch),
                     transaction: transaction
                 )
                 let preparedMessage = PreparedOutgoingMessage.preprepared(transientMessageWithoutAttachments: message)
@@ -328,11 +413,15 @@ extension OWSReceiptManager {
             //
             // We want a value high enough to allow us to effectively de-duplicate,
             // read receipts without being so high that we risk not sending read
-            // receipts due to app exit.
-            do {
-                try await Task.sleep(nanoseconds: 3 * NSEC_PER_SEC)
-                await processReceiptsForLinkedDevices()
-            } catch {}
+            // receipts due to app exit. The wait ends early if the app is
+            // backgrounded.
+            let batchWait = Task {
+                try? await Task.sleep(nanoseconds: 3 * NSEC_PER_SEC)
+            }
+            linkedDeviceBatchWait.set(batchWait)
+            await batchWait.value
+            linkedDeviceBatchWait.set(nil)
+            await processReceiptsForLinkedDevices()
         }
     }
 
@@ -390,6 +479,27 @@ extension OWSReceiptManager {
         )
     }
 
+    /// Queues the receipt with the other receipts for linked devices, so that
+    /// marking a thread as read sends them all in as few messages as possible.
+    private func enqueueLinkedDeviceReadReceipt(
+        forMessageWithUnreadReactions message: TSOutgoingMessage,
+        localAci: Aci,
+        readTimestamp: UInt64,
+        transaction: SDSAnyWriteTransaction
+    ) {
+        let newReadReceipt = ReceiptForLinkedDevice(
+            senderAddress: SignalServiceAddress(localAci),
+            messageUniqueId: message.uniqueId,
+            messageIdTimestamp: message.timestamp,
+            timestamp: readTimestamp
+        )
+        do {
+            try Self.toLinkedDevicesReadReceiptMapStore.setCodable(newReadReceipt, key: message.uniqueId, transaction: transaction)
+        } catch {
+            owsFailDebug("Error: \(error)")
+        }
+    }
+
     func enqueueLinkedDeviceReadReceipt(
         forStoryMessage message: StoryMessage,
         transaction: SDSAnyWriteTransaction
@@ -572,18 +682,38 @@ extension OWSReceiptManager {
         viewedTimestamp: UInt64,
         tx: SDSAnyWriteTransaction
     ) -> [SSKProtoSyncMessageViewed] {
-        return processReceiptsFromLinkedDevice(
+        // Incoming messages are marked in bulk, per thread, once every receipt
+        // has been matched.
+        var incomingMessagesByThreadId = [String: [TSIncomingMessage]]()
+        let earlyReceiptProtos = processReceiptsFromLinkedDevice(
             viewedReceiptProtos,
             senderAci: \.senderAci,
             messageTimestamp: \.timestamp,
             tx: tx,
             markMessage: {
-                markMessageAsViewedOnLinkedDevice($0, viewedTimestamp: viewedTimestamp, tx: tx)
+                if let incomingMessage = $0 as? TSIncomingMessage, incomingMessage.giftBadge == nil {
+                    incomingMessagesByThreadId[incomingMessage.uniqueThreadId, default: []].append(incomingMessage)
+                } else {
+                    markMessageAsViewedOnLinkedDevice($0, viewedTimestamp: viewedTimestamp, tx: tx)
+                }
             },
             markStoryMessage: {
                 $0.markAsViewed(at: viewedTimestamp, circumstance: .onLinkedDevice, transaction: tx)
             }
         )
+        for incomingMessages in incomingMessagesByThreadId.values {
+            guard let thread = incomingMessages.first?.thread(tx: tx) else {
+                continue
+            }
+            TSIncomingMessage.markAsViewed(
+                incomingMessages,
+                atTimestamp: viewedTimestamp,
+                thread: thread,
+                circumstance: linkedDeviceReceiptCircumstance(for: thread, tx: tx),
+                transaction: tx
+            )
+        }
+        return earlyReceiptProtos
     }
 
     // MARK: - Mark as read
@@ -628,22 +758,18 @@ extension OWSReceiptManager {
             repeat {
                 batchQuotaRemaining = maxBatchSize
                 SSKEnvironment.shared.databaseStorageRef.write { transaction in
-                    var cursor = interactionFinder.fetchUnreadMessages(beforeSortId: sortId,
-                                                                       transaction: transaction)
-                    do {
-                        while batchQuotaRemaining > 0, let readItem = try cursor.next() {
-                            readItem.markAsRead(atTimestamp: readTimestamp,
-                                                thread: thread,
-                                                circumstance: circumstance,
-                                                shouldClearNotifications: true,
-                                                transaction: transaction)
-                            batchQuotaRemaining -= 1
-                        }
-                    } catch {
-                        owsFailDebug("unexpected failure fetching unread messages: \(error)")
-                        // Bail out of the outer loop by leaving the quota > 0;
-                        // we're likely to hit the error multiple times.
-                    }
+                    let readUniqueIds = self.markUnreadItemsAsRead(
+                        beforeSortId: sortId,
+                        thread: thread,
+                        readTimestamp: readTimestamp,
+                        circumstance: circumstance,
+                        shouldClearNotifications: true,
+                        limit: maxBatchSize,
+                        transaction: transaction
+                    )
+                    // On failure, bail out of the outer loop by leaving the
+                    // quota > 0; we're likely to hit the error multiple times.
+                    batchQuotaRemaining -= readUniqueIds?.count ?? 0
                 }
                 // Continue until we process a batch and have some quota left.
             } while batchQuotaRemaining == 0
@@ -652,7 +778,6 @@ extension OWSReceiptManager {
             repeat {
                 batchQuotaRemaining = maxBatchSize
                 SSKEnvironment.shared.databaseStorageRef.write { transaction in
-                    var receiptsForMessage: [OWSLinkedDeviceReadReceipt] = []
                     var cursor = interactionFinder.fetchMessagesWithUnreadReactions(
                         beforeSortId: sortId,
                         transaction: transaction)
@@ -662,13 +787,12 @@ extension OWSReceiptManager {
                             message.markUnreadReactionsAsRead(transaction: transaction)
 
                             if let localAci {
-                                let receipt = OWSLinkedDeviceReadReceipt(
-                                    senderAci: AciObjC(localAci),
-                                    messageUniqueId: message.uniqueId,
-                                    messageIdTimestamp: message.timestamp,
-                                    readTimestamp: readTimestamp
+                                self.enqueueLinkedDeviceReadReceipt(
+                                    forMessageWithUnreadReactions: message,
+                                    localAci: localAci,
+                                    readTimestamp: readTimestamp,
+                                    transaction: transaction
                                 )
-                                receiptsForMessage.append(receipt)
                             }
 
                             batchQuotaRemaining -= 1
@@ -679,17 +803,7 @@ extension OWSReceiptManager {
                         // we're likely to hit the error multiple times.
                     }
 
-                    if !receiptsForMessage.isEmpty {
-                        let message = OWSReadReceiptsForLinkedDevicesMessage(
-                            thread: thread,
-                            readReceipts: receiptsForMessage,
-                            transaction: transaction
-                        )
-                        let preparedMessage = PreparedOutgoingMessage.preprepared(
-                            transientMessageWithoutAttachments: message
-                        )
-                        self.messageSenderJobQueue.add(message: preparedMessage, transaction: transaction)
-                    }
+                    transaction.addAsyncCompletionOffMain { self.scheduleProcessing() }
                 }
                 // Continue until we process a batch and have some quota left.
             } while batchQuotaRemaining == 0
@@ -706,25 +820,68 @@ extension OWSReceiptManager {
                     transaction: SDSAnyWriteTransaction) -> [String] {
         owsAssertDebug(sortId > 0)
 
+        return markUnreadItemsAsRead(
+            beforeSortId: sortId,
+            thread: thread,
+            readTimestamp: readTimestamp,
+            circumstance: circumstance,
+            shouldClearNotifications: shouldClearNotifications,
+            limit: nil,
+            transaction: transaction
+        ) ?? []
+    }
+
+    /// Marks up to `limit` unread items in `thread`, up to and including
+    /// `sortId`, as read.
+    ///
+    /// Incoming messages make up most of any large unread range, so they're
+    /// marked as read in bulk.
+    ///
+    /// - Returns: The uniqueIds of the items marked as read, or nil if they
+    ///   couldn't be fetched.
+    private func markUnreadItemsAsRead(
+        beforeSortId sortId: UInt64,
+        thread: TSThread,
+        readTimestamp: UInt64,
+        circumstance: OWSReceiptCircumstance,
+        shouldClearNotifications: Bool,
+        limit: Int?,
+        transaction: SDSAnyWriteTransaction
+    ) -> [String]? {
         var readUniqueIds = [String]()
+        var incomingMessages = [TSIncomingMessage]()
+        var didFail = false
         let interactionFinder = InteractionFinder(threadUniqueId: thread.uniqueId)
         var cursor = interactionFinder.fetchUnreadMessages(beforeSortId: sortId,
                                                            transaction: transaction)
         do {
-            while let readItem = try cursor.next() {
-                readItem.markAsRead(atTimestamp: readTimestamp,
-                                    thread: thread,
-                                    circumstance: circumstance,
-                                    shouldClearNotifications: shouldClearNotifications,
-                                    transaction: transaction)
+            while limit.map({ readUniqueIds.count < $0 }) ?? true, let readItem = try cursor.next() {
+                if let incomingMessage = readItem as? TSIncomingMessage {
+                    incomingMessages.append(incomingMessage)
+                } else {
+                    readItem.markAsRead(atTimestamp: readTimestamp,
+                                        thread: thread,
+                                        circumstance: circumstance,
+                                        shouldClearNotifications: shouldClearNotifications,
+                                        transaction: transaction)
+                }
                 readUniqueIds.append(readItem.uniqueId)
             }
         } catch {
             owsFailDebug("unexpected failure fetching unread messages: \(error)")
-            return []
+            didFail = true
         }
 
-        return readUniqueIds
+        TSIncomingMessage.markAsRead(
+            incomingMessages,
+            atTimestamp: readTimestamp,
+            thread: thread,
+            circumstance: circumstance,
+            shouldClearNotifications: shouldClearNotifications,
+            transaction: transaction
+        )
+
+        return didFail ? nil : readUniqueIds
     }
 
     func markMessageAsReadOnLinkedDevice(
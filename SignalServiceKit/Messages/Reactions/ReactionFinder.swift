@@ -134,4 +134,16 @@ public class ReactionFinder {
         """
         transaction.execute(sql: sql, arguments: [uniqueMessageId])
     }
+
+    /// Delete the reaction records of many messages, with one statement per
+    /// chunk of messages rather than one per message.
+    public static func deleteAllReactions(forUniqueMessageIds uniqueMessageIds: [String], transaction: GRDBWriteTransaction) {
+        for uniqueMessageIdsChunk in uniqueMessageIds.chunked(by: 500) {
+            let sql = """
+                DELETE FROM \(OWSReaction.databaseTableName)
+                WHERE \(OWSReaction.columnName(.uniqueMessageId)) IN (\(uniqueMessageIdsChunk.map { _ in "?" }.joined(separator: ",")))
+            """
+            transaction.execute(sql: sql, arguments: StatementArguments(Array(uniqueMessageIdsChunk)))
+        }
+    }
 }
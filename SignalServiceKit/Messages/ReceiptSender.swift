@@ -53,8 +53,24 @@ public class ReceiptSender: NSObject {
     private let pendingTasks = PendingTasks(label: #fileID)
     private let sendingState: AtomicValue<SendingState>
 
-    public init(appReadiness: AppReadiness, kvStoreFactory: KeyValueStoreFactory, recipientDatabaseTable: any RecipientDatabaseTable) {
+    /// How long to wait after sending before the next pass, so that a batch
+    /// of receipts for each sender can accumulate.
+    private let batchWindow: TimeInterval
+
+    /// Once this many receipts have been enqueued while waiting, the next
+    /// pass starts without waiting for the rest of the window.
+    private let maxReceiptsPerBatch: Int
+
+    public init(
+        appReadiness: AppReadiness,
+        kvStoreFactory: KeyValueStoreFactory,
+        recipientDatabaseTable: any RecipientDatabaseTable,
+        batchWindow: TimeInterval = 3,
+        maxReceiptsPerBatch: Int = 500
+    ) {
         self.appReadiness = appReadiness
+        self.batchWindow = batchWindow
+        self.maxReceiptsPerBatch = maxReceiptsPerBatch
         self.recipientDatabaseTable = recipientDatabaseTable
         self.deliveryReceiptStore = kvStoreFactory.keyValueStore(collection: "kOutgoingDeliveryReceiptManagerCollection")
         self.readReceiptStore = kvStoreFactory.keyValueStore(collection: "kOutgoingReadReceiptManagerCollection")
@@ -124,6 +140,25 @@ public class ReceiptSender: NSObject {
         )
     }
 
+    /// Enqueues read receipts for many messages from the same author,
+    /// loading and storing the author's pending receipts only once.
+    func enqueueReadReceipts(
+        for address: SignalServiceAddress,
+        timestampsAndMessageUniqueIds: [(timestamp: UInt64, messageUniqueId: String?)],
+        tx: SDSAnyWriteTransaction
+    ) {
+        guard let aci = address.aci else {
+            Logger.warn("Dropping receipts for messages without ACI.")
+            return
+        }
+        enqueueReceipts(
+            for: aci,
+            timestampsAndMessageUniqueIds: timestampsAndMessageUniqueIds,
+            receiptType: .read,
+            tx: tx
+        )
+    }
+
     @objc
     public func enqueueViewedReceipt(
         for address: SignalServiceAddress,
@@ -144,6 +179,25 @@ public class ReceiptSender: NSObject {
         )
     }
 
+    /// Enqueues viewed receipts for many messages from the same author,
+    /// loading and storing the author's pending receipts only once.
+    func enqueueViewedReceipts(
+        for address: SignalServiceAddress,
+        timestampsAndMessageUniqueIds: [(timestamp: UInt64, messageUniqueId: String?)],
+        tx: SDSAnyWriteTransaction
+    ) {
+        guard let aci = address.aci else {
+            Logger.warn("Dropping receipts for messages without ACI.")
+            return
+        }
+        enqueueReceipts(
+            for: aci,
+            timestampsAndMessageUniqueIds: timestampsAndMessageUniqueIds,
+            receiptType: .viewed,
+            tx: tx
+        )
+    }
+
     private func enqueueReceipt(
         for aci: Aci,
         timestamp: UInt64,
@@ -151,16 +205,41 @@ public class ReceiptSender: NSObject {
         receiptType: ReceiptType,
         tx: SDSAnyWriteTransaction
     ) {
-        guard timestamp >= 1 else {
-            owsFailDebug("Invalid timestamp.")
+        enqueueReceipts(
+            for: aci,
+            timestampsAndMessageUniqueIds: [(timestamp, messageUniqueId)],
+            receiptType: receiptType,
+            tx: tx
+        )
+    }
+
+    private func enqueueReceipts(
+        for aci: Aci,
+        timestampsAndMessageUniqueIds: [(timestamp: UInt64, messageUniqueId: String?)],
+        receiptType: ReceiptType,
+        tx: SDSAnyWriteTransaction
+    ) {
+        let validReceipts = timestampsAndMessageUniqueIds.filter { receipt in
+            guard receipt.timestamp >= 1 else {
+                owsFailDebug("Invalid timestamp.")
+                return false
+            }
+            return true
+        }
+        guard !validReceipts.isEmpty else {
             return
         }
         let pendingTask = pendingTasks.buildPendingTask(label: "Receipt Send")
         let persistedSet = fetchReceiptSet(receiptType: receiptType, aci: aci, tx: tx.asV2Read)
-        persistedSet.insert(timestamp: timestamp, messageUniqueId: messageUniqueId)
+        for receipt in validReceipts {
+            persistedSet.insert(timestamp: receipt.timestamp, messageUniqueId: receipt.messageUniqueId)
+        }
         storeReceiptSet(persistedSet, receiptType: receiptType, aci: aci, tx: tx.asV2Write)
         tx.addAsyncCompletionOffMain {
-            self.sendingState.update { $0.mightHavePendingReceipts = true }
+            let fullBatchWait = self.sendingState.update { state in
+                state.didEnqueueReceipt(count: validReceipts.count, maxReceiptsPerBatch: self.maxReceiptsPerBatch)
+            }
+            fullBatchWait?.cancel()
             self.sendPendingReceiptsIfNeeded(pendingTask: pendingTask)
         }
     }
@@ -176,14 +255,33 @@ public class ReceiptSender: NSObject {
         /// sent when the app launches.
         var mightHavePendingReceipts = true
 
+        /// How many receipts have been enqueued since the last pass started.
+        var enqueuedReceiptCount = 0
+
+        /// The wait between passes, if one is in progress.
+        var batchWait: Task<Void, Never>?
+
         mutating func startIfPossible() -> Bool {
             guard mightHavePendingReceipts, !inProgress else {
                 return false
             }
             mightHavePendingReceipts = false
+            enqueuedReceiptCount = 0
             inProgress = true
             return true
         }
+
+        /// Returns the wait between passes if it should be cut short because
+        /// a full batch has accumulated.
+        mutating func didEnqueueReceipt(count: Int = 1, maxReceiptsPerBatch: Int) -> Task<Void, Never>? {
+            mightHavePendingReceipts = true
+            enqueuedReceiptCount += count
+            return isBatchFull(maxReceiptsPerBatch: maxReceiptsPerBatch) ? batchWait : nil
+        }
+
+        func isBatchFull(maxReceiptsPerBatch: Int) -> Bool {
+            return enqueuedReceiptCount >= maxReceiptsPerBatch
+        }
     }
 
     /// Schedules a processing pass, unless one is already scheduled.
@@ -208,9 +306,25 @@ public class ReceiptSender: NSObject {
         // batch to accumulate.
         //
         // We want a value high enough to allow us to effectively de-duplicate
-        // receipts without being so high that the user notices.
-        try? await Task.sleep(nanoseconds: 3 * NSEC_PER_SEC)
-        sendingState.update(block: { $0.inProgress = false })
+        // receipts without being so high that the user notices. If a full batch
+        // accumulates sooner (e.g. the user marked a busy group as read), there's
+        // nothing to gain by waiting longer.
+        let batchWindow = self.batchWindow
+        let batchWait = Task {
+            try? await Task.sleep(nanoseconds: UInt64(batchWindow * Double(NSEC_PER_SEC)))
+        }
+        let isBatchFull = sendingState.update { state in
+            state.batchWait = batchWait
+            return state.isBatchFull(maxReceiptsPerBatch: maxReceiptsPerBatch)
+        }
+        if isBatchFull {
+            batchWait.cancel()
+        }
+        await batchWait.value
+        sendingState.update(block: {
+            $0.batchWait = nil
+            $0.inProgress = false
+        })
         await _sendPendingReceiptsIfNeeded(pendingTask: nil)
     }
 
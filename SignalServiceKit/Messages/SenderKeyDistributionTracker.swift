@@ -0,0 +1,60 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import LibSignalClient
+
+/// Tracks the Sender Key Distribution Messages that are currently being sent,
+/// so that concurrent sends to the same group share one SKDM per recipient.
+///
+/// Sends to a thread are mostly serialized, but media, text, and call messages
+/// for the same group can be sent concurrently. Each of them would otherwise
+/// see that a new member or device needs the key and send its own copy.
+final class SenderKeyDistributionTracker {
+
+    struct Key: Hashable {
+        let threadUniqueId: String
+        let serviceId: ServiceId
+        let distributionId: SenderKeyStore.DistributionId
+    }
+
+    enum Distribution {
+        /// The caller must send the SKDM, then resolve the future once the
+        /// send has been recorded in the `SenderKeyStore`.
+        case started(Future<Void>)
+        /// Another send is already distributing the key; this promise resolves
+        /// once it has been recorded.
+        case inProgress(Promise<Void>)
+    }
+
+    private let lock = UnfairLock()
+
+    // This property should only be accessed with lock acquired.
+    private var inProgressDistributions = [Key: Promise<Void>]()
+
+    init() {}
+
+    func beginDistribution(for key: Key) -> Distribution {
+        return lock.withLock {
+            if let promise = inProgressDistributions[key] {
+                return .inProgress(promise)
+            }
+            let (promise, future) = Promise<Void>.pending()
+            inProgressDistributions[key] = promise
+            return .started(future)
+        }
+    }
+
+    func endDistribution(for key: Key, future: Future<Void>, result: Result<Void, Error>) {
+        lock.withLock {
+            _ = inProgressDistributions.removeValue(forKey: key)
+        }
+        switch result {
+        case .success:
+            future.resolve(())
+        case .failure(let error):
+            future.reject(error)
+        }
+    }
+}
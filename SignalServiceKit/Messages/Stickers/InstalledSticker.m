@@ -96,6 +96,8 @@ NS_ASSUME_NONNULL_BEGIN
 
     [SSKEnvironment.shared.modelReadCachesRef.installedStickerCache didInsertOrUpdateInstalledSticker:self
                                                                                           transaction:transaction];
+
+    [StickerManager addStickerToEmojiMap:self tx:transaction];
 }
 
 - (void)anyDidUpdateWithTransaction:(SDSAnyWriteTransaction *)transaction
@@ -112,6 +114,8 @@ NS_ASSUME_NONNULL_BEGIN
 
     [SSKEnvironment.shared.modelReadCachesRef.installedStickerCache didRemoveInstalledSticker:self
                                                                                   transaction:transaction];
+
+    [StickerManager removeStickerFromEmojiMap:self tx:transaction];
 }
 
 @end
@@ -8,7 +8,10 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
-@implementation StickerInfo
+@implementation StickerInfo {
+    // Built lazily; not a property so that Mantle doesn't archive or compare it.
+    NSString *_Nullable _key;
+}
 
 - (instancetype)initWithPackId:(NSData *)packId packKey:(NSData *)packKey stickerId:(UInt32)stickerId
 {
@@ -29,7 +32,12 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (NSString *)asKey
 {
-    return [StickerInfo keyWithPackId:self.packId stickerId:self.stickerId];
+    @synchronized(self) {
+        if (_key == nil) {
+            _key = [StickerInfo keyWithPackId:self.packId stickerId:self.stickerId];
+        }
+        return _key;
+    }
 }
 
 + (NSString *)keyWithPackId:(NSData *)packId stickerId:(UInt32)stickerId
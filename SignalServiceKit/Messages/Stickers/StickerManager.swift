@@ -40,6 +40,12 @@ public class StickerManager: NSObject {
     public static let packsDidChange = Notification.Name("packsDidChange")
     public static let stickersOrPacksDidChange = Notification.Name("stickersOrPacksDidChange")
     public static let recentStickersDidChange = Notification.Name("recentStickersDidChange")
+    /// Posted once an installed pack's cover and stickers have been
+    /// downloaded; the object is the `StickerPack`.
+    public static let stickerPackDidInstall = Notification.Name("stickerPackDidInstall")
+    /// Posted once an uninstalled pack's stickers have been removed; the
+    /// object is the `StickerPack`.
+    public static let stickerPackDidUninstall = Notification.Name("stickerPackDidUninstall")
 
     private static let packsDidChangeEvent: DebouncedEvent = DebouncedEvents.build(
         mode: .firstLast,
@@ -63,7 +69,10 @@ public class StickerManager: NSObject {
     // MARK: - Properties
 
     public static let store = SDSKeyValueStore(collection: "recentStickers")
-    public static let emojiMapStore = SDSKeyValueStore(collection: "emojiMap")
+    /// Maps each emoji to the unique ids of the installed stickers tagged
+    /// with it, most recently installed first. It's read on every keystroke
+    /// for sticker suggestions, so its values are cached.
+    public static let emojiMapStore = SDSKeyValueStore(collection: "emojiMap", isCached: true)
 
     public enum InstallMode: Int {
         case doNotInstall
@@ -241,6 +250,9 @@ public class StickerManager: NSObject {
 
         transaction.addAsyncCompletionOffMain {
             packsDidChangeEvent.requestNotify()
+            if shouldRemove {
+                NotificationCenter.default.postNotificationNameAsync(stickerPackDidUninstall, object: stickerPack)
+            }
         }
     }
 
@@ -394,7 +406,9 @@ public class StickerManager: NSObject {
 
         stickerPack.update(withIsInstalled: true, transaction: transaction)
 
-        let promise = installStickerPackContents(stickerPack: stickerPack, transaction: transaction)
+        let promise = installStickerPackContents(stickerPack: stickerPack, transaction: transaction).done {
+            NotificationCenter.default.postNotificationNameAsync(stickerPackDidInstall, object: stickerPack)
+        }
 
         if wasLocallyInitiated {
             enqueueStickerSyncMessage(
@@ -629,8 +643,6 @@ public class StickerManager: NSObject {
 
         removeFromRecentStickers(stickerInfo, transaction: transaction)
 
-        removeStickerFromEmojiMap(installedSticker, tx: transaction)
-
         guard let stickerDataUrl = self.stickerDataUrl(forInstalledSticker: installedSticker, verifyExists: false) else {
             owsFailDebug("Could not generate sticker data URL.")
             return
@@ -719,8 +731,6 @@ public class StickerManager: NSObject {
             }
 
             installedSticker.anyInsert(transaction: transaction)
-
-            self.addStickerToEmojiMap(installedSticker, tx: transaction)
             return true
         }
     }
@@ -823,7 +833,11 @@ public class StickerManager: NSObject {
         return allEmoji(in: emojiString).first.map(String.init)
     }
 
-    private class func addStickerToEmojiMap(_ installedSticker: InstalledSticker, tx: SDSAnyWriteTransaction) {
+    // The emoji map is maintained by InstalledSticker's insert and remove
+    // hooks; a sticker's emojiString doesn't change after it's installed.
+
+    @objc
+    class func addStickerToEmojiMap(_ installedSticker: InstalledSticker, tx: SDSAnyWriteTransaction) {
         guard let emojiString = installedSticker.emojiString else {
             return
         }
@@ -833,7 +847,8 @@ public class StickerManager: NSObject {
         }
     }
 
-    private class func removeStickerFromEmojiMap(_ installedSticker: InstalledSticker, tx: SDSAnyWriteTransaction) {
+    @objc
+    class func removeStickerFromEmojiMap(_ installedSticker: InstalledSticker, tx: SDSAnyWriteTransaction) {
         guard let emojiString = installedSticker.emojiString else {
             return
         }
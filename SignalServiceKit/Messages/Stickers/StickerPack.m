@@ -46,7 +46,13 @@ NS_ASSUME_NONNULL_BEGIN
 
 #pragma mark -
 
-@implementation StickerPack
+@implementation StickerPack {
+    // These are built lazily from info, cover and items, which don't change
+    // after initialization. They aren't properties so that Mantle doesn't
+    // archive or compare them.
+    StickerInfo *_Nullable _coverInfo;
+    NSArray<StickerInfo *> *_Nullable _stickerInfos;
+}
 
 - (nullable instancetype)initWithCoder:(NSCoder *)coder
 {
@@ -93,16 +99,28 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (StickerInfo *)coverInfo
 {
-    return [[StickerInfo alloc] initWithPackId:self.packId packKey:self.packKey stickerId:self.cover.stickerId];
+    @synchronized(self) {
+        if (_coverInfo == nil) {
+            _coverInfo = [[StickerInfo alloc] initWithPackId:self.packId
+                                                     packKey:self.packKey
+                                                   stickerId:self.cover.stickerId];
+        }
+        return _coverInfo;
+    }
 }
 
 - (NSArray<StickerInfo *> *)stickerInfos
 {
-    NSMutableArray<StickerInfo *> *stickerInfos = [NSMutableArray new];
-    for (StickerPackItem *item in self.items) {
-        [stickerInfos addObject:[item stickerInfoWithStickerPack:self]];
+    @synchronized(self) {
+        if (_stickerInfos == nil) {
+            NSMutableArray<StickerInfo *> *stickerInfos = [NSMutableArray arrayWithCapacity:self.items.count];
+            for (StickerPackItem *item in self.items) {
+                [stickerInfos addObject:[item stickerInfoWithStickerPack:self]];
+            }
+            _stickerInfos = [stickerInfos copy];
+        }
+        return _stickerInfos;
     }
-    return stickerInfos;
 }
 
 // --- CODE GENERATION MARKER
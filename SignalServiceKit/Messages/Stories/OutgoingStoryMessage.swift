@@ -45,6 +45,31 @@ public class OutgoingStoryMessage: TSOutgoingMessage {
         )
     }
 
+    /// For private story sends, whose recipients have already been resolved
+    /// by a ``PrivateStoryFanOutPlan``.
+    init(
+        thread: TSPrivateStoryThread,
+        storyMessage: StoryMessage,
+        storyMessageRowId: Int64,
+        storyAllowsReplies: Bool,
+        skipSyncTranscript: Bool,
+        recipientAddressStates: [SignalServiceAddress: TSOutgoingMessageRecipientState]
+    ) {
+        self.storyMessageId = storyMessage.uniqueId
+        self.storyMessageRowId = storyMessageRowId
+        self.storyAllowsReplies = NSNumber(value: storyAllowsReplies)
+        self.isPrivateStorySend = NSNumber(value: true)
+        self.skipSyncTranscript = NSNumber(value: skipSyncTranscript)
+        let builder: TSOutgoingMessageBuilder = .withDefaultValues(
+            thread: thread,
+            timestamp: storyMessage.timestamp
+        )
+        super.init(
+            outgoingMessageWith: builder,
+            recipientAddressStates: recipientAddressStates
+        )
+    }
+
     @objc
     public convenience init(
         thread: TSThread,
@@ -193,76 +218,4 @@ public class OutgoingStoryMessage: TSOutgoingMessage {
 
         storyMessage.updateRecipientStatesWithOutgoingMessageStates(recipientAddressStates, transaction: transaction)
     }
-
-    /// When sending to private stories, each private story list may have overlap in recipients. We want to
-    /// dedupe sends such that we only send one copy of a given story to each recipient even though they
-    /// are represented in multiple targeted lists.
-    ///
-    /// Additionally, each private story has different levels of permissions. Some may allow replies & reactions
-    /// while others do not. Since we convey to the recipient if this is allowed in the sent proto, it's important that
-    /// we send to a recipient only from the thread with the most privilege (or randomly select one with equal privilege)
-    public static func createDedupedOutgoingMessages(
-        for storyMessage: StoryMessage,
-        sendingTo threads: [TSPrivateStoryThread],
-        tx: SDSAnyWriteTransaction
-    ) -> [OutgoingStoryMessage] {
-
-        class OutgoingMessageBuilder {
-            let thread: TSPrivateStoryThread
-            let allowsReplies: Bool
-            var skippedRecipients = Set<SignalServiceAddress>()
-
-            init(thread: TSPrivateStoryThread) {
-                self.thread = thread
-                self.allowsReplies = thread.allowsReplies
-            }
-        }
-
-        var messageBuilders = [OutgoingMessageBuilder]()
-        var perRecipientBuilders = [SignalServiceAddress: OutgoingMessageBuilder]()
-        for thread in threads {
-            let builderForCurrentThread = OutgoingMessageBuilder(thread: thread)
-            for recipient in thread.addresses {
-                // We only want to send one message per recipient,
-                // and it should be the thread with the most privileges.
-                guard let existingBuilderForThisRecipient = perRecipientBuilders[recipient] else {
-                    // If this is the first time we see this recipient, do nothing.
-                    perRecipientBuilders[recipient] = builderForCurrentThread
-                    continue
-                }
-                // Otherwise skip this recipient in the message with _fewer_ privileges.
-                if
-                    !existingBuilderForThisRecipient.allowsReplies,
-                    builderForCurrentThread.allowsReplies
-                {
-                    // Current thread has more privileges, prefer it for this recipient.
-                    existingBuilderForThisRecipient.skippedRecipients.insert(recipient)
-                    perRecipientBuilders[recipient] = builderForCurrentThread
-                } else {
-                    // Existing has more privileges, skip the recipient for the current thread.
-                    builderForCurrentThread.skippedRecipients.insert(recipient)
-                }
-            }
-            messageBuilders.append(builderForCurrentThread)
-        }
-
-        let outgoingMessages = messageBuilders.enumerated().map { (index, builder) in
-            let message = OutgoingStoryMessage(
-                thread: builder.thread,
-                storyMessage: storyMessage,
-                storyMessageRowId: storyMessage.id!,
-                storyAllowsReplies: builder.allowsReplies,
-                isPrivateStorySend: true,
-                // Only send one sync transcript, even if we're sending to multiple threads
-                skipSyncTranscript: index > 0,
-                transaction: tx
-            )
-            builder.skippedRecipients.forEach {
-                message.updateWithSkippedRecipient($0, transaction: tx)
-            }
-            return message
-        }
-
-        return outgoingMessages
-    }
 }
@@ -0,0 +1,120 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import Foundation
+public import LibSignalClient
+
+/// Who a story sent to one or more private story threads goes to, resolved
+/// once for the whole send.
+///
+/// Resolving a private story's recipients can be expensive; for My Story in
+/// "all except" mode it's every whitelisted contact. A plan resolves each
+/// thread once, and then builds the manifest and the outgoing messages for
+/// any number of stories (e.g., one per attachment) from that.
+///
+/// Private story lists may overlap, but we only want to send one copy of a
+/// story to each recipient. Each private story has different permissions,
+/// and we convey to the recipient whether replies are allowed, so each
+/// recipient is sent the story from a thread with the most privilege; every
+/// other thread skips them.
+public struct PrivateStoryFanOutPlan {
+
+    private struct ThreadPlan {
+        let thread: TSPrivateStoryThread
+        let recipientAddresses: [SignalServiceAddress]
+        var skippedRecipients = Set<SignalServiceAddress>()
+    }
+
+    private let threadPlans: [ThreadPlan]
+
+    /// The recipients of a story sent with this plan, for its manifest.
+    public let recipientStates: [ServiceId: StoryRecipientState]
+
+    public init(threads: [TSPrivateStoryThread], tx: SDSAnyReadTransaction) throws {
+        var threadPlans = [ThreadPlan]()
+        var recipientStates = [ServiceId: StoryRecipientState]()
+        // For each recipient, the index of the thread plan that sends to them.
+        var sendingThreadPlanIndexes = [SignalServiceAddress: Int]()
+
+        for thread in threads {
+            guard let threadUuid = UUID(uuidString: thread.uniqueId) else {
+                throw OWSAssertionError("Invalid uniqueId for thread \(thread.uniqueId)")
+            }
+
+            let threadPlanIndex = threadPlans.count
+            var threadPlan = ThreadPlan(thread: thread, recipientAddresses: thread.recipientAddresses(with: tx))
+
+            for recipientAddress in threadPlan.recipientAddresses {
+                if let serviceId = recipientAddress.serviceId {
+                    let existingState = recipientStates[serviceId] ?? .init(allowsReplies: false, contexts: [])
+                    recipientStates[serviceId] = StoryRecipientState(
+                        allowsReplies: existingState.allowsReplies || thread.allowsReplies,
+                        contexts: existingState.contexts + [threadUuid]
+                    )
+                }
+
+                guard let sendingThreadPlanIndex = sendingThreadPlanIndexes[recipientAddress] else {
+                    // If this is the first time we see this recipient, send from this thread.
+                    sendingThreadPlanIndexes[recipientAddress] = threadPlanIndex
+                    continue
+                }
+                if !threadPlans[sendingThreadPlanIndex].thread.allowsReplies, thread.allowsReplies {
+                    // This thread has more privileges, prefer it for this recipient.
+                    threadPlans[sendingThreadPlanIndex].skippedRecipients.insert(recipientAddress)
+                    sendingThreadPlanIndexes[recipientAddress] = threadPlanIndex
+                } else {
+                    // The existing thread has at least as many privileges.
+                    threadPlan.skippedRecipients.insert(recipientAddress)
+                }
+            }
+
+            threadPlans.append(threadPlan)
+        }
+
+        self.threadPlans = threadPlans
+        self.recipientStates = recipientStates
+    }
+
+    /// Builds one outgoing message per thread for `storyMessage`, with each
+    /// recipient already marked as sending or skipped.
+    ///
+    /// - Parameter recipientFilter
+    /// If set, only these recipients are sent to (e.g., when resending to the
+    /// recipients a send failed for); all others are skipped.
+    public func outgoingMessages(
+        for storyMessage: StoryMessage,
+        recipientFilter: Set<ServiceId>? = nil
+    ) -> [OutgoingStoryMessage] {
+        return threadPlans.enumerated().map { index, threadPlan in
+            var recipientAddressStates = [SignalServiceAddress: TSOutgoingMessageRecipientState]()
+            for recipientAddress in threadPlan.recipientAddresses {
+                guard recipientAddress.isValid else {
+                    owsFailDebug("Ignoring invalid address.")
+                    continue
+                }
+                let isSkipped: Bool = {
+                    if threadPlan.skippedRecipients.contains(recipientAddress) {
+                        return true
+                    }
+                    if let recipientFilter {
+                        return !(recipientAddress.serviceId.map(recipientFilter.contains) ?? false)
+                    }
+                    return false
+                }()
+                recipientAddressStates[recipientAddress] = TSOutgoingMessageRecipientState(status: isSkipped ? .skipped : .sending)
+            }
+
+            return OutgoingStoryMessage(
+                thread: threadPlan.thread,
+                storyMessage: storyMessage,
+                storyMessageRowId: storyMessage.id!,
+                storyAllowsReplies: threadPlan.thread.allowsReplies,
+                // Only send one sync transcript, even if we're sending to multiple threads
+                skipSyncTranscript: index > 0,
+                recipientAddressStates: recipientAddressStates
+            )
+        }
+    }
+}
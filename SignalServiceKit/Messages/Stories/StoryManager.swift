@@ -14,6 +14,11 @@ public class StoryManager: NSObject {
         cacheAreStoriesEnabled()
         cacheAreViewReceiptsEnabled()
 
+        // The NSE doesn't send stories; leave this write to the app.
+        guard !CurrentAppContext().isNSE else {
+            return
+        }
+
         appReadiness.runNowOrWhenAppDidBecomeReadyAsync {
             SSKEnvironment.shared.databaseStorageRef.asyncWrite { transaction in
                 // Create My Story thread if necessary
@@ -941,15 +941,21 @@ public final class StoryMessage: NSObject, SDSCodableModel, Decodable {
 
         let messages: [OutgoingStoryMessage]
         if let groupId = groupId, let groupThread = TSGroupThread.fetch(groupId: groupId, transaction: transaction) {
-            messages = [
-                OutgoingStoryMessage(
-                    thread: groupThread,
-                    storyMessage: self,
-                    storyMessageRowId: self.id!,
-                    skipSyncTranscript: false,
-                    transaction: transaction
-                )
-            ]
+            let message = OutgoingStoryMessage(
+                thread: groupThread,
+                storyMessage: self,
+                storyMessageRowId: self.id!,
+                skipSyncTranscript: false,
+                transaction: transaction
+            )
+
+            // Only send to recipients in the "failed" state
+            for (serviceId, state) in recipientStates {
+                guard state.sendingState != .failed else { continue }
+                message.updateWithSkippedRecipient(SignalServiceAddress(serviceId), transaction: transaction)
+            }
+
+            messages = [message]
         } else {
             let contexts = Set(recipientStates.values.flatMap({ $0.contexts }))
             let privateStoryThreads = contexts.compactMap {
@@ -958,17 +964,15 @@ public final class StoryMessage: NSObject, SDSCodableModel, Decodable {
                     transaction: transaction
                 )
             }
-            messages = OutgoingStoryMessage.createDedupedOutgoingMessages(
-                for: self,
-                sendingTo: privateStoryThreads,
-                tx: transaction
-            )
-        }
-
-        // Only send to recipients in the "failed" state
-        for (serviceId, state) in recipientStates {
-            guard state.sendingState != .failed else { continue }
-            messages.forEach { $0.updateWithSkippedRecipient(SignalServiceAddress(serviceId), transaction: transaction) }
+            do {
+                // Only send to recipients in the "failed" state
+                messages = try PrivateStoryFanOutPlan(threads: privateStoryThreads, tx: transaction).outgoingMessages(
+                    for: self,
+                    recipientFilter: Set(recipientStates.lazy.filter { $0.value.sendingState == .failed }.map { $0.key })
+                )
+            } catch {
+                return owsFailDebug("Couldn't plan resend: \(error)")
+            }
         }
 
         messages.forEach { message in
@@ -52,6 +52,10 @@ public class MockCallRecordQuerier: CallRecordQuerier {
     public func fetchCursorForUnread(threadRowId: Int64, callStatus: CallRecord.CallStatus, ordering: FetchOrdering, tx: DBReadTransaction) -> CallRecordCursor? {
         return Cursor(applyOrdering(mockCallRecords.filter { $0.conversationId == .thread(threadRowId: threadRowId) && $0.callStatus == callStatus && $0.unreadStatus == .unread }, ordering: ordering))
     }
+
+    public func countUnread(callStatus: CallRecord.CallStatus, tx: DBReadTransaction) -> UInt {
+        return UInt(mockCallRecords.filter { $0.callStatus == callStatus && $0.unreadStatus == .unread }.count)
+    }
 }
 
 #endif
@@ -0,0 +1,141 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import Foundation
+
+/// The fields of a serialized `SSKProtoEnvelope` needed to triage and dedupe
+/// it, read without decoding the whole envelope.
+///
+/// Decoding an `SSKProtoEnvelope` copies its (possibly large) encrypted
+/// content. This walks the protobuf wire format instead and skips over every
+/// field except the ones below.
+public struct EnvelopeHeader: Equatable {
+    public private(set) var type: SSKProtoEnvelopeType?
+    public private(set) var timestamp: UInt64?
+    public private(set) var sourceServiceId: String?
+    public private(set) var sourceDevice: UInt32?
+    public private(set) var serverGuid: String?
+
+    private enum FieldNumber: UInt64 {
+        case type = 1
+        case timestamp = 5
+        case sourceDevice = 7
+        case serverGuid = 9
+        case sourceServiceId = 11
+    }
+
+    private enum WireType: UInt64 {
+        case varint = 0
+        case fixed64 = 1
+        case lengthDelimited = 2
+        case fixed32 = 5
+    }
+
+    /// Returns nil if `envelopeData` isn't a well-formed protobuf message.
+    public init?(envelopeData: Data) {
+        let header: EnvelopeHeader? = envelopeData.withUnsafeBytes { bytes in
+            var reader = Reader(bytes: bytes)
+            return Self(reader: &reader)
+        }
+        guard let header else {
+            return nil
+        }
+        self = header
+    }
+
+    private init?(reader: inout Reader) {
+        while !reader.isAtEnd {
+            guard
+                let tag = reader.readVarint(),
+                let wireType = WireType(rawValue: tag & 0x7)
+            else {
+                return nil
+            }
+            let fieldNumber = FieldNumber(rawValue: tag >> 3)
+
+            switch wireType {
+            case .varint:
+                guard let value = reader.readVarint() else {
+                    return nil
+                }
+                switch fieldNumber {
+                case .type:
+                    type = SSKProtoEnvelopeType(rawValue: Int32(truncatingIfNeeded: value))
+                case .timestamp:
+                    timestamp = value
+                case .sourceDevice:
+                    sourceDevice = UInt32(truncatingIfNeeded: value)
+                case .serverGuid, .sourceServiceId, nil:
+                    break
+                }
+            case .lengthDelimited:
+                guard let length = reader.readVarint(), let value = reader.readBytes(count: length) else {
+                    return nil
+                }
+                switch fieldNumber {
+                case .serverGuid:
+                    serverGuid = String(decoding: value, as: UTF8.self)
+                case .sourceServiceId:
+                    sourceServiceId = String(decoding: value, as: UTF8.self)
+                case .type, .timestamp, .sourceDevice, nil:
+                    break
+                }
+            case .fixed64:
+                guard reader.readBytes(count: 8) != nil else {
+                    return nil
+                }
+            case .fixed32:
+                guard reader.readBytes(count: 4) != nil else {
+                    return nil
+                }
+            }
+        }
+    }
+
+    private struct Reader {
+        let bytes: UnsafeRawBufferPointer
+        var offset = 0
+
+        var isAtEnd: Bool { offset >= bytes.count }
+
+        mutating func readVarint() -> UInt64? {
+            var result: UInt64 = 0
+            var shift: UInt64 = 0
+            while offset < bytes.count, shift < 64 {
+                let byte = bytes[offset]
+                offset += 1
+                result |= UInt64(byte & 0x7f) << shift
+                if byte & 0x80 == 0 {
+                    return result
+                }
+                shift += 7
+            }
+            return nil
+        }
+
+        mutating func readBytes(count: UInt64) -> UnsafeRawBufferPointer? {
+            guard count <= UInt64(bytes.count - offset) else {
+                return nil
+            }
+            let result = UnsafeRawBufferPointer(rebasing: bytes[offset..<(offset + Int(count))])
+            offset += Int(count)
+            return result
+        }
+    }
+}
+
+extension IncomingGroupsV2MessageJob {
+    /// Reads the envelope's header fields without decoding all of it.
+    public var envelopeHeader: EnvelopeHeader? {
+        return EnvelopeHeader(envelopeData: envelopeData)
+    }
+}
+
+extension OWSMessageContentJob {
+    /// Reads the envelope's header fields without decoding all of it.
+    public var envelopeHeader: EnvelopeHeader? {
+        return EnvelopeHeader(envelopeData: envelopeData)
+    }
+}
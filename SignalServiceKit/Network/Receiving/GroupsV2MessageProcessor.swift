@@ -334,7 +334,9 @@ internal class GroupsMessageProcessor: MessageProcessingPipelineStage {
 
     private typealias BatchCompletionBlock = ([IncomingGroupsV2MessageJob], Bool, SDSAnyWriteTransaction) -> Void
 
-    private func processWorkStep(retryDelayAfterFailure: TimeInterval = 1.0) {
+    /// - Parameter isDrainingBacklog: Whether the previous batch was full, so
+    ///   more jobs are likely already queued, e.g. after a long offline period.
+    private func processWorkStep(retryDelayAfterFailure: TimeInterval = 1.0, isDrainingBacklog: Bool = false) {
         owsAssertDebug(isDrainingQueue.get())
 
         let canProcess = (
@@ -350,10 +352,18 @@ internal class GroupsMessageProcessor: MessageProcessingPipelineStage {
 
         // We want a value that is just high enough to yield perf benefits.
         let kIncomingMessageBatchSize: UInt = 16
+        // When there's a backlog, apply more messages per write transaction;
+        // the group state is resolved once per batch.
+        let kBacklogBatchSize: UInt = 64
         // If the app is in the background, use batch size of 1.
         // This reduces the cost of being interrupted and rolled back if
         // app is suspended.
-        let batchSize: UInt = CurrentAppContext().isInBackground() ? 1 : kIncomingMessageBatchSize
+        let batchSize: UInt = {
+            if CurrentAppContext().isInBackground() {
+                return 1
+            }
+            return isDrainingBacklog ? kBacklogBatchSize : kIncomingMessageBatchSize
+        }()
 
         let batchJobs = SSKEnvironment.shared.databaseStorageRef.read { transaction in
             self.finder.nextJobs(forGroupId: self.groupId, batchSize: batchSize, transaction: transaction.unwrapGrdbRead)
@@ -397,6 +407,10 @@ internal class GroupsMessageProcessor: MessageProcessingPipelineStage {
                     DispatchQueue.global().asyncAfter(deadline: DispatchTime.now() + retryDelayAfterFailure) {
                         self.tryToProcess(retryDelayAfterFailure: retryDelayAfterFailure * 2)
                     }
+                } else if batchJobs.count == batchSize, processedJobs.count == batchJobs.count, batchSize > 1 {
+                    // The batch was full, so the next one is already waiting;
+                    // there's nothing to gain by waiting for it to grow.
+                    self.processWorkStep(isDrainingBacklog: true)
                 } else {
                     // Wait always a bit in hopes of increasing the size of the next batch.
                     // This delay won't affect the first message to arrive when this queue is idle,
@@ -507,6 +521,7 @@ internal class GroupsMessageProcessor: MessageProcessingPipelineStage {
     // message at the head of the queue.
     private func canJobBeProcessedWithoutUpdate(
         jobInfo: IncomingGroupsV2MessageJobInfo,
+        groupModel: TSGroupModelV2?,
         tx: SDSAnyReadTransaction
     ) -> Bool {
         if .discard == Self.discardMode(forJobInfo: jobInfo, hasGroupBeenUpdated: false, tx: tx) {
@@ -520,10 +535,17 @@ internal class GroupsMessageProcessor: MessageProcessingPipelineStage {
             owsFailDebug("Missing groupContextInfo.")
             return true
         }
+        guard groupContextInfo.groupId == groupId else {
+            owsFailDebug("Job enqueued for another group.")
+            return GroupsV2MessageProcessor.canContextBeProcessedWithoutUpdate(
+                groupContext: groupContext,
+                groupContextInfo: groupContextInfo,
+                tx: tx
+            )
+        }
         return GroupsV2MessageProcessor.canContextBeProcessedWithoutUpdate(
             groupContext: groupContext,
-            groupContextInfo: groupContextInfo,
-            tx: tx
+            groupModel: groupModel
         )
     }
 
@@ -541,11 +563,20 @@ internal class GroupsMessageProcessor: MessageProcessingPipelineStage {
         //
         // "Update" jobs may require interaction with the service, namely
         // fetching group changes or latest group state.
+        //
+        // Every job in the batch is for this group, so load its state once.
+        // "No update" jobs don't change the group model, so it stays valid
+        // for the whole batch.
+        let groupModel = TSGroupThread.fetch(groupId: groupId, transaction: tx)?.groupModel as? TSGroupModelV2
         var isUpdateBatch = false
         var jobInfos = [IncomingGroupsV2MessageJobInfo]()
         for job in jobs {
             let jobInfo = Self.jobInfo(forJob: job, tx: tx)
-            let canJobBeProcessedWithoutUpdate = self.canJobBeProcessedWithoutUpdate(jobInfo: jobInfo, tx: tx)
+            let canJobBeProcessedWithoutUpdate = self.canJobBeProcessedWithoutUpdate(
+                jobInfo: jobInfo,
+                groupModel: groupModel,
+                tx: tx
+            )
             if !canJobBeProcessedWithoutUpdate {
                 if jobInfos.count > 0 {
                     // Can't add "update" job to "no update" batch, abort and process jobs
@@ -979,6 +1010,18 @@ public class GroupsV2MessageProcessor: NSObject {
             Logger.warn("Invalid group model; possibly needs to be migrated.")
             return false
         }
+        return canContextBeProcessedWithoutUpdate(groupContext: groupContext, groupModel: groupModel)
+    }
+
+    /// - Parameter groupModel: The current model of the group the context
+    ///   belongs to, or nil if it's missing or not a v2 group.
+    fileprivate class func canContextBeProcessedWithoutUpdate(
+        groupContext: SSKProtoGroupContextV2,
+        groupModel: TSGroupModelV2?
+    ) -> Bool {
+        guard let groupModel else {
+            return false
+        }
         let messageRevision = groupContext.revision
         let modelRevision = groupModel.revision
         if messageRevision <= modelRevision {
@@ -8,6 +8,16 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+@interface IncomingGroupsV2MessageJob () {
+    // The envelope is parsed at most once; these ivars are not persisted.
+    SSKProtoEnvelope *_Nullable _cachedEnvelope;
+    BOOL _hasParsedEnvelope;
+}
+
+@end
+
+#pragma mark -
+
 @implementation IncomingGroupsV2MessageJob
 
 - (instancetype)initWithEnvelopeData:(NSData *)envelopeData
@@ -77,6 +87,17 @@ NS_ASSUME_NONNULL_BEGIN
 }
 
 - (nullable SSKProtoEnvelope *)envelope
+{
+    @synchronized(self) {
+        if (!_hasParsedEnvelope) {
+            _hasParsedEnvelope = YES;
+            _cachedEnvelope = [self parseEnvelope];
+        }
+        return _cachedEnvelope;
+    }
+}
+
+- (nullable SSKProtoEnvelope *)parseEnvelope
 {
     NSError *error;
     SSKProtoEnvelope *_Nullable result = [[SSKProtoEnvelope alloc] initWithSerializedData:self.envelopeData
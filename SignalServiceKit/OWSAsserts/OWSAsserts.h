@@ -10,6 +10,28 @@ NS_ASSUME_NONNULL_BEGIN
 
 #ifndef OWSAssert
 
+// In release builds, assertion failures aren't logged (or have already been
+// logged), but they're counted per call site so that we learn how often they
+// happen. A counter is a static struct; recording a failure is an atomic
+// increment. See OWSAssertionFailureReport().
+typedef struct OWSAssertionFailureSite {
+    const char *file;
+    int line;
+    uint32_t count;
+    struct OWSAssertionFailureSite *_Nullable next;
+} OWSAssertionFailureSite;
+
+void OWSRecordAssertionFailure(OWSAssertionFailureSite *site);
+
+/// One line per call site that has failed an assertion, with its count.
+NSString *OWSAssertionFailureReport(void);
+
+#define OWSRecordAssertionFailureAtCallSite()                                                                          \
+    do {                                                                                                               \
+        static OWSAssertionFailureSite _owsAssertionFailureSite = { __FILE__, __LINE__, 0, NULL };                     \
+        OWSRecordAssertionFailure(&_owsAssertionFailureSite);                                                          \
+    } while (NO)
+
 #define CONVERT_TO_STRING(X) #X
 #define CONVERT_EXPR_TO_STRING(X) CONVERT_TO_STRING(X)
 
@@ -77,12 +99,17 @@ NS_ASSUME_NONNULL_BEGIN
 
 #else
 
-#define OWSAssertDebug(X)
-#define OWSCAssertDebug(X)
-#define OWSFailWithoutLogging(message, ...)
-#define OWSCFailWithoutLogging(message, ...)
-#define OWSFailNoFormat(X)
-#define OWSCFailNoFormat(X)
+#define OWSAssertDebug(X)                                                                                              \
+    do {                                                                                                               \
+        if (!(X)) {                                                                                                    \
+            OWSRecordAssertionFailureAtCallSite();                                                                     \
+        }                                                                                                              \
+    } while (NO)
+#define OWSCAssertDebug(X) OWSAssertDebug(X)
+#define OWSFailWithoutLogging(message, ...) OWSRecordAssertionFailureAtCallSite()
+#define OWSCFailWithoutLogging(message, ...) OWSRecordAssertionFailureAtCallSite()
+#define OWSFailNoFormat(X) OWSRecordAssertionFailureAtCallSite()
+#define OWSCFailNoFormat(X) OWSRecordAssertionFailureAtCallSite()
 
 #endif
 
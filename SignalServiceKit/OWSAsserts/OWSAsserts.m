@@ -5,9 +5,39 @@
 
 #import "OWSAsserts.h"
 #import <SignalServiceKit/SignalServiceKit-Swift.h>
+#import <os/lock.h>
 
 NS_ASSUME_NONNULL_BEGIN
 
+static os_unfair_lock assertionFailureSitesLock = OS_UNFAIR_LOCK_INIT;
+// This should only be accessed with assertionFailureSitesLock acquired.
+static OWSAssertionFailureSite *_Nullable assertionFailureSites = NULL;
+
+void OWSRecordAssertionFailure(OWSAssertionFailureSite *site)
+{
+    if (__atomic_fetch_add(&site->count, 1, __ATOMIC_RELAXED) != 0) {
+        return;
+    }
+    // This is the site's first failure.
+    os_unfair_lock_lock(&assertionFailureSitesLock);
+    site->next = assertionFailureSites;
+    assertionFailureSites = site;
+    os_unfair_lock_unlock(&assertionFailureSitesLock);
+}
+
+NSString *OWSAssertionFailureReport(void)
+{
+    NSMutableArray<NSString *> *lines = [NSMutableArray new];
+    os_unfair_lock_lock(&assertionFailureSitesLock);
+    for (OWSAssertionFailureSite *_Nullable site = assertionFailureSites; site != NULL; site = site->next) {
+        NSString *fileName = @(site->file).lastPathComponent;
+        uint32_t count = __atomic_load_n(&site->count, __ATOMIC_RELAXED);
+        [lines addObject:[NSString stringWithFormat:@"%@:%d: %u", fileName, site->line, count]];
+    }
+    os_unfair_lock_unlock(&assertionFailureSitesLock);
+    return [lines componentsJoinedByString:@"\n"];
+}
+
 void SwiftExit(NSString *message, const char *file, const char *function, int line)
 {
     NSString *_file = [NSString stringWithFormat:@"%s", file];
@@ -84,6 +84,38 @@ public class PaymentFinder: NSObject {
         }
     }
 
+    /// The most recent payment models, by `sortDate`, newest first.
+    ///
+    /// - Parameter isIncoming: If non-nil, only payments in this direction
+    ///   are returned.
+    public class func mostRecentPaymentModels(isIncoming: Bool?,
+                                              limit: Int,
+                                              transaction: SDSAnyReadTransaction) -> [TSPaymentModel] {
+        let uniqueIds = PaymentModelAggregates.shared.mostRecentPaymentUniqueIds(isIncoming: isIncoming,
+                                                                                  limit: limit,
+                                                                                  transaction: transaction)
+        var paymentModelsByUniqueId = [String: TSPaymentModel]()
+        // Stay well under SQLite's limit on bound parameters.
+        for batch in uniqueIds.chunked(by: 500) {
+            let placeholders = Array(repeating: "?", count: batch.count).joined(separator: ",")
+            let sql = """
+            SELECT * FROM \(PaymentModelRecord.databaseTableName)
+            WHERE \(paymentModelColumn: .uniqueId) IN (\(placeholders))
+            """
+            do {
+                let cursor = TSPaymentModel.grdbFetchCursor(sql: sql,
+                                                            arguments: StatementArguments(Array(batch)),
+                                                            transaction: transaction.unwrapGrdbRead)
+                while let paymentModel = try cursor.next() {
+                    paymentModelsByUniqueId[paymentModel.uniqueId] = paymentModel
+                }
+            } catch {
+                owsFailDebug("unexpected error \(error)")
+            }
+        }
+        return uniqueIds.compactMap { paymentModelsByUniqueId[$0] }
+    }
+
     // MARK: -
 
     @objc
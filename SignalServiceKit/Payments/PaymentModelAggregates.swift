@@ -0,0 +1,287 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import Foundation
+
+/// Aggregates over every `TSPaymentModel`, maintained incrementally.
+///
+/// The payment history used to load (and unarchive) every payment model to
+/// find the most recent ones. The aggregates are loaded with one pass over the table, and are
+/// then updated by the payment model's insert, update and remove hooks
+/// when their transactions commit.
+///
+/// The aggregates reflect committed transactions. Transactions that
+/// started before the last commit, and write transactions with changes of
+/// their own, see a different snapshot, so they load the aggregates from
+/// the database without keeping them. The aggregates are discarded after
+/// cross-process writes and reloaded on the next read.
+@objc
+public final class PaymentModelAggregates: NSObject {
+
+    @objc
+    public static let shared = PaymentModelAggregates()
+
+    private let lock = UnfairLock()
+
+    // These properties should only be accessed with lock acquired.
+    private var contents: PaymentModelAggregateContents?
+    /// Writes whose transactions haven't committed yet. Contents loaded
+    /// while a write is pending may be missing its changes, so they aren't
+    /// kept.
+    private var pendingWriteCount = 0
+    /// Incremented on every commit and evacuation, so that loads that raced
+    /// with a write aren't kept.
+    private var generation: UInt64 = 0
+    /// When the contents last changed; older transactions can't use them.
+    private var lastChangeDate: Date?
+
+    private override init() {
+        super.init()
+
+        NotificationCenter.default.addObserver(
+            self,
+            selector: #selector(didReceiveCrossProcessNotification),
+            name: SDSDatabaseStorage.didReceiveCrossProcessNotificationAlwaysSync,
+            object: nil
+        )
+    }
+
+    // MARK: - Reads
+
+    public func totals(paymentState: TSPaymentState, transaction: SDSAnyReadTransaction) -> PaymentModelStateTotals {
+        return read(transaction: transaction) { $0.totalsByState[paymentState] ?? PaymentModelStateTotals() }
+    }
+
+    public func latestSortDate(transaction: SDSAnyReadTransaction) -> Date? {
+        return read(transaction: transaction) { $0.latestSortDate() }
+    }
+
+    /// The unique ids of the most recent payments, by `sortDate`, newest
+    /// first.
+    ///
+    /// - Parameter isIncoming: If non-nil, only payments in this direction
+    ///   are returned.
+    public func mostRecentPaymentUniqueIds(
+        isIncoming: Bool?,
+        limit: Int,
+        transaction: SDSAnyReadTransaction
+    ) -> [String] {
+        return read(transaction: transaction) { $0.mostRecentUniqueIds(isIncoming: isIncoming, limit: limit) }
+    }
+
+    private func read<T>(transaction: SDSAnyReadTransaction, block: (inout PaymentModelAggregateContents) -> T) -> T {
+        let isWriteTransaction = transaction is SDSAnyWriteTransaction
+        let (generation, canUseContents, cachedResult): (UInt64, Bool, T?) = lock.withLock {
+            let canUseContents = isCurrent(transaction: transaction, isWriteTransaction: isWriteTransaction)
+            guard canUseContents, contents != nil else {
+                return (self.generation, canUseContents, nil)
+            }
+            return (self.generation, canUseContents, block(&contents!))
+        }
+        if let cachedResult {
+            return cachedResult
+        }
+
+        var loadedContents = PaymentModelAggregateContents()
+        TSPaymentModel.anyEnumerate(transaction: transaction, batched: true) { paymentModel, _ in
+            loadedContents.update(uniqueId: paymentModel.uniqueId, summary: PaymentModelSummary(paymentModel))
+        }
+        let result = block(&loadedContents)
+        guard canUseContents else {
+            return result
+        }
+        lock.withLock {
+            guard self.generation == generation, pendingWriteCount == 0, contents == nil else {
+                return
+            }
+            contents = loadedContents
+        }
+        return result
+    }
+
+    // This method should only be called with lock acquired.
+    private func isCurrent(transaction: SDSAnyReadTransaction, isWriteTransaction: Bool) -> Bool {
+        if let lastChangeDate, lastChangeDate > transaction.startDate {
+            return false
+        }
+        // Writes are serialized, so pending writes belong to this transaction.
+        if isWriteTransaction, pendingWriteCount > 0 {
+            return false
+        }
+        return true
+    }
+
+    // MARK: - Writes
+
+    @objc
+    func didWrite(paymentModel: TSPaymentModel, transaction: SDSAnyWriteTransaction) {
+        // Capture the values now; the model may be mutated before the commit.
+        didWrite(uniqueId: paymentModel.uniqueId, summary: PaymentModelSummary(paymentModel), transaction: transaction)
+    }
+
+    @objc
+    func didRemove(paymentModel: TSPaymentModel, transaction: SDSAnyWriteTransaction) {
+        didWrite(uniqueId: paymentModel.uniqueId, summary: nil, transaction: transaction)
+    }
+
+    private func didWrite(uniqueId: String, summary: PaymentModelSummary?, transaction: SDSAnyWriteTransaction) {
+        lock.withLock {
+            pendingWriteCount += 1
+        }
+        transaction.addSyncCompletion {
+            self.lock.withLock {
+                self.pendingWriteCount -= 1
+                self.generation += 1
+                self.lastChangeDate = Date()
+                self.contents?.update(uniqueId: uniqueId, summary: summary)
+            }
+        }
+    }
+
+    private func evacuate() {
+        lock.withLock {
+            generation += 1
+            lastChangeDate = Date()
+            contents = nil
+        }
+    }
+
+    @objc
+    private func didReceiveCrossProcessNotification(_ notification: Notification) {
+        AssertIsOnMainThread()
+        evacuate()
+    }
+}
+
+// MARK: -
+
+public struct PaymentModelStateTotals: Equatable {
+    public var count: Int = 0
+    public var picoMob: UInt64 = 0
+    public var feePicoMob: UInt64 = 0
+}
+
+// MARK: -
+
+struct PaymentModelSummary: Equatable {
+    var paymentState: TSPaymentState
+    var isIncoming: Bool
+    var isUnread: Bool
+    var sortDate: Date
+    var picoMob: UInt64
+    var feePicoMob: UInt64
+
+    init(
+        paymentState: TSPaymentState,
+        isIncoming: Bool,
+        isUnread: Bool,
+        sortDate: Date,
+        picoMob: UInt64,
+        feePicoMob: UInt64
+    ) {
+        self.paymentState = paymentState
+        self.isIncoming = isIncoming
+        self.isUnread = isUnread
+        self.sortDate = sortDate
+        self.picoMob = picoMob
+        self.feePicoMob = feePicoMob
+    }
+
+    init(_ paymentModel: TSPaymentModel) {
+        self.init(
+            paymentState: paymentModel.paymentState,
+            isIncoming: paymentModel.isIncoming,
+            isUnread: paymentModel.isUnread,
+            sortDate: paymentModel.sortDate,
+            picoMob: paymentModel.paymentAmount?.picoMob ?? 0,
+            feePicoMob: paymentModel.mobileCoin?.feeAmount?.picoMob ?? 0
+        )
+    }
+}
+
+// MARK: -
+
+struct PaymentModelAggregateContents {
+    private(set) var summaries = [String: PaymentModelSummary]()
+    private(set) var totalsByState = [TSPaymentState: PaymentModelStateTotals]()
+    private(set) var unreadCount = 0
+    /// Nil if it must be recomputed (e.g. after the latest payment was
+    /// removed).
+    private var cachedLatestSortDate: Date??
+    /// The payments, newest first; nil if they must be re-sorted.
+    private var cachedSortedUniqueIds: [String]?
+
+    /// Applies an insert or update, or a removal if `summary` is nil.
+    mutating func update(uniqueId: String, summary: PaymentModelSummary?) {
+        let oldSummary = summaries[uniqueId]
+        guard oldSummary != summary else {
+            return
+        }
+        if let oldSummary {
+            apply(oldSummary, sign: -1)
+        }
+        if let summary {
+            apply(summary, sign: 1)
+        }
+        summaries[uniqueId] = summary
+
+        if oldSummary?.sortDate != summary?.sortDate {
+            cachedSortedUniqueIds = nil
+            switch (oldSummary, summary, cachedLatestSortDate) {
+            case (nil, let summary?, let latestSortDate?):
+                // An insert can only advance the latest date.
+                cachedLatestSortDate = .some(max(latestSortDate ?? summary.sortDate, summary.sortDate))
+            default:
+                cachedLatestSortDate = nil
+            }
+        }
+    }
+
+    private mutating func apply(_ summary: PaymentModelSummary, sign: Int) {
+        var totals = totalsByState[summary.paymentState] ?? PaymentModelStateTotals()
+        totals.count += sign
+        if sign > 0 {
+            totals.picoMob += summary.picoMob
+            totals.feePicoMob += summary.feePicoMob
+        } else {
+            totals.picoMob -= summary.picoMob
+            totals.feePicoMob -= summary.feePicoMob
+        }
+        totalsByState[summary.paymentState] = totals.count > 0 ? totals : nil
+        if summary.isUnread {
+            unreadCount += sign
+        }
+    }
+
+    mutating func latestSortDate() -> Date? {
+        if let cachedLatestSortDate {
+            return cachedLatestSortDate
+        }
+        let latestSortDate = summaries.values.lazy.map(\.sortDate).max()
+        cachedLatestSortDate = .some(latestSortDate)
+        return latestSortDate
+    }
+
+    mutating func mostRecentUniqueIds(isIncoming: Bool?, limit: Int) -> [String] {
+        let sortedUniqueIds: [String]
+        if let cachedSortedUniqueIds {
+            sortedUniqueIds = cachedSortedUniqueIds
+        } else {
+            sortedUniqueIds = summaries.sorted { $0.value.sortDate > $1.value.sortDate }.map(\.key)
+            cachedSortedUniqueIds = sortedUniqueIds
+        }
+        var result = [String]()
+        for uniqueId in sortedUniqueIds {
+            guard result.count < limit else {
+                break
+            }
+            if let isIncoming, summaries[uniqueId]?.isIncoming != isIncoming {
+                continue
+            }
+            result.append(uniqueId)
+        }
+        return result
+    }
+}
@@ -139,6 +139,16 @@ NS_DESIGNATED_INITIALIZER NS_SWIFT_NAME(init(grdbId:uniqueId:addressUuidString:c
                              transaction:(SDSAnyWriteTransaction *)transaction
     NS_SWIFT_NAME(update(mcLedgerBlockTimestamp:transaction:));
 
+// Applies a ledger block (and the state transition it implies) in a single update.
+// The block index and timestamp are only set if they're non-zero and the payment
+// doesn't have them yet; the amount is only set if it's non-nil.
+- (void)updateWithMCLedgerBlockIndex:(uint64_t)ledgerBlockIndex
+                ledgerBlockTimestamp:(uint64_t)ledgerBlockTimestamp
+                       paymentAmount:(nullable TSPaymentAmount *)paymentAmount
+                        paymentState:(TSPaymentState)paymentState
+                         transaction:(SDSAnyWriteTransaction *)transaction
+    NS_SWIFT_NAME(update(mcLedgerBlockIndex:mcLedgerBlockTimestamp:paymentAmount:paymentState:transaction:));
+
 - (void)updateWithPaymentFailure:(TSPaymentFailure)paymentFailure
                     paymentState:(TSPaymentState)paymentState
                      transaction:(SDSAnyWriteTransaction *)transaction
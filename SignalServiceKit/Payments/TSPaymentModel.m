@@ -209,6 +209,36 @@ NS_ASSUME_NONNULL_BEGIN
                              }];
 }
 
+- (void)updateWithMCLedgerBlockIndex:(uint64_t)ledgerBlockIndex
+                ledgerBlockTimestamp:(uint64_t)ledgerBlockTimestamp
+                       paymentAmount:(nullable TSPaymentAmount *)paymentAmount
+                        paymentState:(TSPaymentState)paymentState
+                         transaction:(SDSAnyWriteTransaction *)transaction
+{
+    [self anyUpdateWithTransaction:transaction
+                             block:^(TSPaymentModel *paymentModel) {
+                                 OWSAssertDebug([PaymentUtils isIncomingPaymentState:paymentModel.paymentState] ==
+                                     [PaymentUtils isIncomingPaymentState:paymentState]);
+
+                                 if (ledgerBlockIndex > 0 && !paymentModel.hasMCLedgerBlockIndex) {
+                                     paymentModel.mobileCoin = [MobileCoinPayment copy:paymentModel.mobileCoin
+                                                                  withLedgerBlockIndex:ledgerBlockIndex];
+                                     paymentModel.mcLedgerBlockIndex = ledgerBlockIndex;
+                                 }
+                                 if (ledgerBlockTimestamp > 0 && !paymentModel.hasMCLedgerBlockTimestamp) {
+                                     paymentModel.mobileCoin = [MobileCoinPayment copy:paymentModel.mobileCoin
+                                                              withLedgerBlockTimestamp:ledgerBlockTimestamp];
+                                 }
+                                 if (paymentAmount != nil) {
+                                     OWSAssertDebug(paymentModel.paymentAmount == nil
+                                         || (paymentModel.paymentAmount.currency == paymentAmount.currency
+                                             && paymentModel.paymentAmount.picoMob == paymentAmount.picoMob));
+                                     paymentModel.paymentAmount = paymentAmount;
+                                 }
+                                 paymentModel.paymentState = paymentState;
+                             }];
+}
+
 - (void)updateWithPaymentFailure:(TSPaymentFailure)paymentFailure
                     paymentState:(TSPaymentState)paymentState
                      transaction:(SDSAnyWriteTransaction *)transaction
@@ -273,6 +303,8 @@ NS_ASSUME_NONNULL_BEGIN
     OWSAssertDebug(self.isValid);
 
     [super anyDidInsertWithTransaction:transaction];
+
+    [PaymentModelAggregates.shared didWriteWithPaymentModel:self transaction:transaction];
 }
 
 - (void)anyWillUpdateWithTransaction:(SDSAnyWriteTransaction *)transaction
@@ -289,6 +321,15 @@ NS_ASSUME_NONNULL_BEGIN
     OWSAssertDebug(self.isValid);
 
     [super anyDidUpdateWithTransaction:transaction];
+
+    [PaymentModelAggregates.shared didWriteWithPaymentModel:self transaction:transaction];
+}
+
+- (void)anyDidRemoveWithTransaction:(SDSAnyWriteTransaction *)transaction
+{
+    [super anyDidRemoveWithTransaction:transaction];
+
+    [PaymentModelAggregates.shared didRemoveWithPaymentModel:self transaction:transaction];
 }
 
 @end
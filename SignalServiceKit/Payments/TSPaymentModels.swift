@@ -285,6 +285,59 @@ public extension TSPaymentModel {
 
 // MARK: -
 
+/// A verified ledger block for a payment, and the state transition it implies.
+public struct PaymentLedgerBlockUpdate {
+    public let paymentModel: TSPaymentModel
+    public let ledgerBlockIndex: UInt64
+    /// Zero if the block has no timestamp.
+    public let ledgerBlockTimestamp: UInt64
+    /// Only set for incoming payments, whose amount is only known once their
+    /// receipt is verified.
+    public let paymentAmount: TSPaymentAmount?
+    public let fromState: TSPaymentState
+    public let toState: TSPaymentState
+
+    public init(
+        paymentModel: TSPaymentModel,
+        ledgerBlockIndex: UInt64,
+        ledgerBlockTimestamp: UInt64,
+        paymentAmount: TSPaymentAmount? = nil,
+        fromState: TSPaymentState,
+        toState: TSPaymentState
+    ) {
+        self.paymentModel = paymentModel
+        self.ledgerBlockIndex = ledgerBlockIndex
+        self.ledgerBlockTimestamp = ledgerBlockTimestamp
+        self.paymentAmount = paymentAmount
+        self.fromState = fromState
+        self.toState = toState
+    }
+}
+
+public extension TSPaymentModel {
+
+    /// Applies the block index, block timestamp, amount and state of
+    /// `update` in a single write.
+    ///
+    /// Throws if the payment isn't in `fromState` (in memory and in the
+    /// database).
+    func applyLedgerBlockUpdate(_ update: PaymentLedgerBlockUpdate, transaction: SDSAnyWriteTransaction) throws {
+        owsAssertDebug(update.paymentModel === self)
+        owsAssertDebug(update.ledgerBlockIndex > 0)
+
+        guard isCurrentPaymentState(paymentState: update.fromState, transaction: transaction) else {
+            throw OWSAssertionError("Payment model has unexpected state.")
+        }
+        self.update(mcLedgerBlockIndex: update.ledgerBlockIndex,
+                    mcLedgerBlockTimestamp: update.ledgerBlockTimestamp,
+                    paymentAmount: update.paymentAmount,
+                    paymentState: update.toState,
+                    transaction: transaction)
+    }
+}
+
+// MARK: -
+
 @objc
 extension TSPaymentModel: TSPaymentBaseModel {
 
@@ -1231,6 +1231,7 @@ CREATE
     ON DELETE
         RESTRICT
         ,"read" BOOLEAN NOT NULL DEFAULT 0
+        ,"pastRevisionBodyDelta" TEXT
 )
 ;
 
@@ -2307,3 +2308,19 @@ CREATE
         ON "DeletedCallRecord"("deletedAtTimestamp"
 )
 ;
+
+CREATE
+    TABLE
+        IF NOT EXISTS "indexable_text_pending" (
+            "id" INTEGER PRIMARY KEY AUTOINCREMENT NOT NULL
+            ,"uniqueId" TEXT NOT NULL UNIQUE
+        )
+;
+
+CREATE
+    INDEX "index_interactions_on_timestamp_for_placeholders"
+        ON "model_TSInteraction"("timestamp"
+)
+WHERE
+    "recordType" = 70
+;
@@ -261,7 +261,10 @@ public class SSKEnvironment: NSObject {
         DependenciesBridge.shared.svr.warmCaches()
         SSKEnvironment.shared.typingIndicatorsRef.warmCaches()
         SSKEnvironment.shared.paymentsHelperRef.warmCaches()
-        SSKEnvironment.shared.paymentsCurrenciesRef.warmCaches()
+        if !CurrentAppContext().isNSE {
+            // Currencies are only needed to display payments.
+            SSKEnvironment.shared.paymentsCurrenciesRef.warmCaches()
+        }
         StoryManager.setup(appReadiness: appReadiness)
         DependenciesBridge.shared.db.read { tx in appExpiryRef.warmCaches(with: tx) }
 
@@ -274,6 +277,12 @@ public class SSKEnvironment: NSObject {
             self.smJobQueuesRef.receiptCredentialJobQueue.start(appContext: CurrentAppContext())
             self.smJobQueuesRef.sendGiftBadgeJobQueue.start(appContext: CurrentAppContext())
             self.smJobQueuesRef.sessionResetJobQueue.start(appContext: CurrentAppContext())
+            if CurrentAppContext().isMainApp {
+                TSAttachmentPurger.shared.resumePendingPurges()
+                DispatchQueue.global(qos: .utility).async {
+                    TSAttachmentPartialDownloadStore.shared.sweepStaleEntries()
+                }
+            }
         }
 
         NotificationCenter.default.post(name: SSKEnvironment.warmCachesNotification, object: nil)
@@ -342,7 +342,9 @@ public class OWSRecipientIdentityCursor: NSObject, SDSCursor {
         guard let record = try cursor.next() else {
             return nil
         }
-        return try OWSRecipientIdentity.fromRecord(record)
+        let value = try OWSRecipientIdentity.fromRecord(record)
+        SSKEnvironment.shared.modelReadCachesRef.recipientIdentityReadCache.didReadRecipientIdentity(value, transaction: transaction.asAnyRead)
+        return value
     }
 
     public func all() throws -> [OWSRecipientIdentity] {
@@ -381,6 +383,20 @@ public extension OWSRecipientIdentity {
                         transaction: SDSAnyReadTransaction) -> OWSRecipientIdentity? {
         assert(!uniqueId.isEmpty)
 
+        return anyFetch(uniqueId: uniqueId, transaction: transaction, ignoreCache: false)
+    }
+
+    // Fetches a single model by "unique id".
+    class func anyFetch(uniqueId: String,
+                        transaction: SDSAnyReadTransaction,
+                        ignoreCache: Bool) -> OWSRecipientIdentity? {
+        assert(!uniqueId.isEmpty)
+
+        if !ignoreCache,
+            let cachedCopy = SSKEnvironment.shared.modelReadCachesRef.recipientIdentityReadCache.getRecipientIdentity(uniqueId: uniqueId, transaction: transaction) {
+            return cachedCopy
+        }
+
         switch transaction.readTransaction {
         case .grdbRead(let grdbTransaction):
             let sql = "SELECT * FROM \(RecipientIdentityRecord.databaseTableName) WHERE \(recipientIdentityColumn: .uniqueId) = ?"
@@ -571,7 +587,9 @@ public extension OWSRecipientIdentity {
                 return nil
             }
 
-            return try OWSRecipientIdentity.fromRecord(record)
+            let value = try OWSRecipientIdentity.fromRecord(record)
+            SSKEnvironment.shared.modelReadCachesRef.recipientIdentityReadCache.didReadRecipientIdentity(value, transaction: transaction.asAnyRead)
+            return value
         } catch {
             owsFailDebug("error: \(error)")
             return nil
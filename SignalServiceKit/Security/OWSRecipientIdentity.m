@@ -158,6 +158,30 @@ NSUInteger const RecipientIdentitySchemaVersion = 1;
 
 // --- CODE GENERATION MARKER
 
+- (void)anyDidInsertWithTransaction:(SDSAnyWriteTransaction *)transaction
+{
+    [super anyDidInsertWithTransaction:transaction];
+
+    [SSKEnvironment.shared.modelReadCachesRef.recipientIdentityReadCache didInsertOrUpdateRecipientIdentity:self
+                                                                                                transaction:transaction];
+}
+
+- (void)anyDidUpdateWithTransaction:(SDSAnyWriteTransaction *)transaction
+{
+    [super anyDidUpdateWithTransaction:transaction];
+
+    [SSKEnvironment.shared.modelReadCachesRef.recipientIdentityReadCache didInsertOrUpdateRecipientIdentity:self
+                                                                                                transaction:transaction];
+}
+
+- (void)anyDidRemoveWithTransaction:(SDSAnyWriteTransaction *)transaction
+{
+    [super anyDidRemoveWithTransaction:transaction];
+
+    [SSKEnvironment.shared.modelReadCachesRef.recipientIdentityReadCache didRemoveRecipientIdentity:self
+                                                                                        transaction:transaction];
+}
+
 - (void)updateWithVerificationState:(OWSVerificationState)verificationState
                         transaction:(SDSAnyWriteTransaction *)transaction
 {
@@ -117,6 +117,93 @@ extension OWSRecipientIdentity {
         return sql
     }
 
+    /// Fetches the identities of `serviceIds`, querying only for those that
+    /// aren't in the identity cache.
+    ///
+    /// As with `OWSIdentityManager.recipientIdentity(for:tx:)`, a PNI's
+    /// identity isn't returned if its recipient also has an ACI.
+    public class func recipientIdentities(
+        for serviceIds: [ServiceId],
+        tx: SDSAnyReadTransaction
+    ) -> [ServiceId: OWSRecipientIdentity] {
+        guard !serviceIds.isEmpty else {
+            return [:]
+        }
+        let readCache = SSKEnvironment.shared.modelReadCachesRef.recipientIdentityReadCache
+        do {
+            let recipientUniqueIds = try recipientUniqueIds(for: serviceIds, tx: tx)
+            var recipientIdentities = readCache.getRecipientIdentitiesIfInCache(
+                forUniqueIds: Array(Set(recipientUniqueIds.values)),
+                transaction: tx
+            )
+
+            let missingUniqueIds = Set(recipientUniqueIds.values).subtracting(recipientIdentities.keys)
+            if !missingUniqueIds.isEmpty {
+                let placeholders = Array(repeating: "?", count: missingUniqueIds.count).joined(separator: ", ")
+                let sql = """
+                    SELECT * FROM \(RecipientIdentityRecord.databaseTableName)
+                    WHERE \(recipientIdentityColumn: .uniqueId) IN (\(placeholders))
+                """
+                let cursor = try RecipientIdentityRecord.fetchCursor(
+                    tx.unwrapGrdbRead.database,
+                    sql: sql,
+                    arguments: StatementArguments(Array(missingUniqueIds))
+                )
+                while let record = try cursor.next() {
+                    let recipientIdentity = try OWSRecipientIdentity.fromRecord(record)
+                    readCache.didReadRecipientIdentity(recipientIdentity, transaction: tx)
+                    recipientIdentities[recipientIdentity.uniqueId] = recipientIdentity
+                }
+            }
+
+            return recipientUniqueIds.compactMapValues { recipientIdentities[$0] }
+        } catch {
+            owsFailDebug("error: \(error)")
+            return [:]
+        }
+    }
+
+    /// Finds the recipients of `serviceIds` in one query. PNIs whose
+    /// recipient also has an ACI are omitted.
+    private class func recipientUniqueIds(
+        for serviceIds: [ServiceId],
+        tx: SDSAnyReadTransaction
+    ) throws -> [ServiceId: RecipientUniqueId] {
+        let serviceIdStrings = serviceIds.map { $0.serviceIdUppercaseString }
+        let placeholders = Array(repeating: "?", count: serviceIdStrings.count).joined(separator: ", ")
+
+        let recipient_aciString = "\(signalRecipientColumnFullyQualified: .aciString)"
+        let recipient_pniString = "\(signalRecipientColumnFullyQualified: .pni)"
+        let recipient_uniqueID = "\(signalRecipientColumnFullyQualified: .uniqueId)"
+        let sql = """
+            SELECT \(recipient_uniqueID) AS recipientUniqueId, \(recipient_aciString) AS recipientAciString, \(recipient_pniString) AS recipientPniString
+            FROM \(SignalRecipient.databaseTableName)
+            WHERE
+                \(recipient_aciString) IN (\(placeholders))
+                OR \(recipient_pniString) IN (\(placeholders))
+        """
+
+        let requestedServiceIds = Set(serviceIds)
+        var result = [ServiceId: RecipientUniqueId]()
+        let cursor = try Row.fetchCursor(
+            tx.unwrapGrdbRead.database,
+            sql: sql,
+            arguments: StatementArguments(serviceIdStrings + serviceIdStrings)
+        )
+        while let row = try cursor.next() {
+            let recipientUniqueId: RecipientUniqueId = row["recipientUniqueId"]
+            let aci = (row["recipientAciString"] as String?).flatMap { try? Aci.parseFrom(serviceIdString: $0) }
+            let pni = (row["recipientPniString"] as String?).flatMap { try? Pni.parseFrom(serviceIdString: $0) }
+            if let aci, requestedServiceIds.contains(aci) {
+                result[aci] = recipientUniqueId
+            }
+            if let pni, aci == nil, requestedServiceIds.contains(pni) {
+                result[pni] = recipientUniqueId
+            }
+        }
+        return result
+    }
+
     private class func groupMemberIdentityKeys(
         in threadUniqueId: String,
         matching verificationState: OWSVerificationState,
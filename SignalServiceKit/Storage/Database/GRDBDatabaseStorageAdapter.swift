@@ -428,6 +428,7 @@ extension GRDBDatabaseStorageAdapter: SDSDatabaseStorageAdapter {
         var syncCompletions: [GRDBWriteTransaction.CompletionBlock] = []
         var asyncCompletions: [GRDBWriteTransaction.AsyncCompletion] = []
 
+        let startTime = CACurrentMediaTime()
         try pool.write { database in
             autoreleasepool {
                 let transaction = GRDBWriteTransaction(database: database)
@@ -438,6 +439,8 @@ extension GRDBDatabaseStorageAdapter: SDSDatabaseStorageAdapter {
                 asyncCompletions = transaction.asyncCompletions
             }
         }
+        // This includes waiting for the writer and committing.
+        PerformanceCounters.shared.recordWriteTransaction(duration: CACurrentMediaTime() - startTime)
 
         checkpointState.update { mutableState in
             mutableState.budget -= 1
@@ -612,6 +615,13 @@ extension GRDBDatabaseStorageAdapter: SDSDatabaseStorageAdapter {
             owsAssertDebug(GRDBStorage.checkpointTimeout == nil)
         }
 
+        // Truncating checkpoints hold this process's writer while they wait
+        // (via the busy-handler) for readers and writers in every process,
+        // including the main app. Extensions, in particular the NSE, have tight
+        // deadlines, so they only integrate what they can without waiting and
+        // leave truncating the WAL to the main app.
+        let checkpointMode: Database.CheckpointMode = CurrentAppContext().isMainApp ? .truncate : .passive
+
         pool.writeWithoutTransaction { database in
             guard database.sqliteConnection != nil else {
                 Logger.warn("Skipping checkpoint for database that's already closed.")
@@ -619,7 +629,7 @@ extension GRDBDatabaseStorageAdapter: SDSDatabaseStorageAdapter {
             }
             Bench(title: "Checkpoint", logIfLongerThan: 0.25, logInProduction: true) {
                 do {
-                    try database.checkpoint(.truncate)
+                    try database.checkpoint(checkpointMode)
 
                     // If the checkpoint succeeded, wait N writes before performing another checkpoint.
                     let currentTimestamp = CheckpointState.currentTimestamp()
@@ -301,6 +301,10 @@ public class GRDBSchemaMigrator: NSObject {
         case addBackupStickerPackDownloadQueue
         case createOrphanedBackupAttachmentTable
         case addCallLinkTable
+        case upgradeTSAttachmentSchemaVersion
+        case addIndexableTextPendingTable
+        case addEditRecordPastRevisionBodyDelta
+        case addRecoverableDecryptionPlaceholderIndex
 
         // NOTE: Every time we add a migration id, consider
         // incrementing grdbSchemaVersionLatest.
@@ -3630,6 +3634,61 @@ public class GRDBSchemaMigrator: NSObject {
             return .success(())
         }
 
+        migrator.registerMigration(.upgradeTSAttachmentSchemaVersion) { tx in
+            // Applies -[TSAttachmentStream upgradeFromAttachmentSchemaVersion:]
+            // to every row, so it no longer runs (and writes) when legacy
+            // attachments are loaded. Older video attachments could
+            // incorrectly be marked as not valid before we increased our
+            // size limits to allow 4k video.
+            try tx.database.execute(sql: """
+                UPDATE "model_TSAttachment"
+                SET
+                    "isValidVideoCached" = CASE
+                        WHEN "recordType" = \(SDSRecordType.attachmentStream.rawValue) AND "isValidVideoCached" = 0 THEN NULL
+                        ELSE "isValidVideoCached"
+                    END,
+                    "attachmentSchemaVersion" = 1
+                WHERE "attachmentSchemaVersion" < 1
+            """)
+            return .success(())
+        }
+
+        migrator.registerMigration(.addIndexableTextPendingTable) { tx in
+            /// Messages whose search index content needs to be updated; see
+            /// `FullTextSearchIndexer.pendingTableName`.
+            try tx.database.create(table: "indexable_text_pending") { table in
+                table.autoIncrementedPrimaryKey("id").notNull()
+                table.column("uniqueId", .text).notNull().unique()
+            }
+            return .success(())
+        }
+
+        migrator.registerMigration(.addEditRecordPastRevisionBodyDelta) { tx in
+            /// See `EditRevisionBodyDelta`. Existing past revisions keep their
+            /// full body and have no delta.
+            try tx.database.alter(table: "EditRecord") { table in
+                table.add(column: "pastRevisionBodyDelta", .text)
+            }
+            return .success(())
+        }
+
+        migrator.registerMigration(.addRecoverableDecryptionPlaceholderIndex) { tx in
+            // Every incoming message looks for a placeholder with its
+            // timestamp, and expiry enumerates all placeholders. A partial
+            // index keeps both proportional to the number of placeholders.
+            //
+            // This constant should not change. If it does change, this
+            // migration should not be updated with the new value. Instead,
+            // we'd need a new migration to drop this index and re-build it.
+            assert(SDSRecordType.recoverableDecryptionPlaceholder.rawValue == 70)
+            try tx.database.execute(sql: """
+                CREATE INDEX "index_interactions_on_timestamp_for_placeholders"
+                ON "model_TSInteraction"("timestamp")
+                WHERE "recordType" = 70
+            """)
+            return .success(())
+        }
+
         // MARK: - Schema Migration Insertion Point
     }
 
@@ -413,14 +413,45 @@ public class InteractionFinder: NSObject {
         }
     }
 
+    /// Fetches the placeholders with the given timestamp.
+    ///
+    /// This is checked for every incoming message, so it uses the partial
+    /// index on placeholders' timestamps rather than loading every
+    /// interaction with the same timestamp. The `recordType` condition must
+    /// match the index's condition exactly (a literal, not a parameter) for
+    /// SQLite to use it.
+    static func placeholders(
+        withTimestamp timestamp: UInt64,
+        transaction: SDSAnyReadTransaction
+    ) throws -> [OWSRecoverableDecryptionPlaceholder] {
+        let sql = """
+            SELECT *
+            FROM \(InteractionRecord.databaseTableName)
+            WHERE \(interactionColumn: .recordType) = \(SDSRecordType.recoverableDecryptionPlaceholder.rawValue)
+            AND \(interactionColumn: .timestamp) = ?
+        """
+        return try TSInteraction.grdbFetchCursor(
+            sql: sql,
+            arguments: [timestamp],
+            transaction: transaction.unwrapGrdbRead
+        ).all().compactMap { interaction in
+            guard let placeholder = interaction as? OWSRecoverableDecryptionPlaceholder else {
+                owsFailDebug("Unexpected type: \(type(of: interaction))")
+                return nil
+            }
+            return placeholder
+        }
+    }
+
     static func enumeratePlaceholders(
         transaction: SDSAnyReadTransaction,
         block: (OWSRecoverableDecryptionPlaceholder) -> Void
     ) {
+        // Uses the partial index on placeholders; see `placeholders(withTimestamp:transaction:)`.
         let sql = """
             SELECT *
             FROM \(InteractionRecord.databaseTableName)
-            WHERE \(interactionColumn: .recordType) IS \(SDSRecordType.recoverableDecryptionPlaceholder.rawValue)
+            WHERE \(interactionColumn: .recordType) = \(SDSRecordType.recoverableDecryptionPlaceholder.rawValue)
         """
         do {
             let cursor = TSInteraction.grdbFetchCursor(
@@ -614,6 +645,38 @@ public class InteractionFinder: NSObject {
         )
     }
 
+    /// Fetches the thread's "invalid identity key" error messages, using
+    /// the index on recordType, uniqueThreadId and errorType rather than
+    /// scanning every interaction in the thread.
+    @objc
+    public func fetchInvalidIdentityKeyReceivingErrorMessages(
+        transaction: SDSAnyReadTransaction
+    ) -> [TSInvalidIdentityKeyReceivingErrorMessage] {
+        let sql = """
+            SELECT *
+            FROM \(InteractionRecord.databaseTableName)
+            WHERE \(interactionColumn: .recordType) = ?
+            AND \(interactionColumn: .threadUniqueId) = ?
+            AND \(interactionColumn: .errorType) = ?
+            ORDER BY \(interactionColumn: .id)
+        """
+        let arguments: StatementArguments = [
+            SDSRecordType.invalidIdentityKeyReceivingErrorMessage.rawValue,
+            threadUniqueId,
+            TSErrorMessageType.wrongTrustedIdentityKey.rawValue
+        ]
+        do {
+            return try TSInteraction.grdbFetchCursor(
+                sql: sql,
+                arguments: arguments,
+                transaction: transaction.unwrapGrdbRead
+            ).all().compactMap { $0 as? TSInvalidIdentityKeyReceivingErrorMessage }
+        } catch {
+            owsFailDebug("Couldn't fetch invalid identity key error messages: \(error)")
+            return []
+        }
+    }
+
     @objc
     public func mostRecentInteractionForInbox(
         transaction: SDSAnyReadTransaction
@@ -1245,6 +1308,100 @@ public class InteractionFinder: NSObject {
         ).enumerate(block: block)
     }
 
+    /// Enumerate interactions covered by this finder with one of the given
+    /// record types, filtered and ordered as they should appear in the
+    /// conversation view.
+    ///
+    /// Interactions with other record types are skipped by the query, rather
+    /// than deserialized and then discarded by the caller.
+    ///
+    /// - Parameter block
+    /// A block executed for each enumerated interaction. Returns `true` if
+    /// enumeration should continue, and `false` otherwise.
+    public func enumerateInteractionsForConversationView(
+        recordTypes: [SDSRecordType],
+        rowIdFilter: RowIdFilter,
+        tx: SDSAnyReadTransaction,
+        block: (TSInteraction) -> Bool
+    ) throws {
+        guard !recordTypes.isEmpty else {
+            return
+        }
+        try buildInteractionCursor(
+            rowIdFilter: rowIdFilter,
+            additionalFiltering: .filterForConversationViewWithRecordTypes(recordTypes),
+            limit: nil,
+            tx: tx
+        ).enumerate(block: block)
+    }
+
+    /// The identifying columns of an interaction, read without deserializing
+    /// the interaction itself.
+    public struct InteractionProjection {
+        public let rowId: Int64
+        public let uniqueId: String
+        public let recordType: SDSRecordType?
+
+        /// Fetches and deserializes the full interaction.
+        public func fetchInteraction(tx: SDSAnyReadTransaction) -> TSInteraction? {
+            return TSInteraction.anyFetch(uniqueId: uniqueId, transaction: tx)
+        }
+    }
+
+    /// Enumerate the projections of interactions covered by this finder,
+    /// filtered and ordered as they should appear in the conversation view.
+    ///
+    /// Only the row ID, unique ID and record type are read from each row, so
+    /// callers that inspect the kind of interaction before deciding whether
+    /// they need it only pay to deserialize the interactions they use.
+    ///
+    /// - Parameter recordTypes
+    /// If non-nil, only interactions with one of these record types are
+    /// enumerated.
+    /// - Parameter block
+    /// A block executed for each enumerated projection. Returns `true` if
+    /// enumeration should continue, and `false` otherwise.
+    public func enumerateInteractionProjectionsForConversationView(
+        recordTypes: [SDSRecordType]? = nil,
+        rowIdFilter: RowIdFilter,
+        tx: SDSAnyReadTransaction,
+        block: (InteractionProjection) -> Bool
+    ) throws {
+        let additionalFiltering: InteractionsByRowIdAdditionalFiltering
+        if let recordTypes {
+            guard !recordTypes.isEmpty else {
+                return
+            }
+            additionalFiltering = .filterForConversationViewWithRecordTypes(recordTypes)
+        } else {
+            additionalFiltering = .filterForConversationView
+        }
+        let (rowIdClause, arguments, _) = sqlClauseForInteractionsByRowId(
+            rowIdFilter: rowIdFilter,
+            additionalFiltering: additionalFiltering,
+            limit: nil
+        )
+        let cursor = try Row.fetchCursor(
+            tx.unwrapGrdbRead.database,
+            sql: """
+                SELECT \(interactionColumn: .id), \(interactionColumn: .uniqueId), \(interactionColumn: .recordType)
+                FROM \(InteractionRecord.databaseTableName)
+                \(rowIdClause)
+            """,
+            arguments: arguments
+        )
+        while let row = try cursor.next() {
+            let projection = InteractionProjection(
+                rowId: row[0],
+                uniqueId: row[1],
+                recordType: SDSRecordType(rawValue: row[2])
+            )
+            guard block(projection) else {
+                break
+            }
+        }
+    }
+
     /// Fetch all interactions covered by this finder.
     func fetchAllInteractions(
         rowIdFilter: RowIdFilter,
@@ -1315,6 +1472,14 @@ public class InteractionFinder: NSObject {
         /// Relies on `index_model_TSInteraction_UnreadMessages`.
         case filterForConversationView
 
+        /// Filter the fetched interactions as for `filterForConversationView`,
+        /// and further to those with one of the given record types.
+        ///
+        /// Relies on `index_model_TSInteraction_UnreadMessages`, or on
+        /// `index_interactions_on_recordType_and_threadUniqueId_and_errorType`
+        /// when the record types are selective.
+        case filterForConversationViewWithRecordTypes([SDSRecordType])
+
         /// Filter the fetched interactions to ``TSIncomingMessage``s.
         ///
         /// Relies on `index_interactions_on_recordType_and_threadUniqueId_and_errorType`,
@@ -1395,6 +1560,13 @@ public class InteractionFinder: NSObject {
             \(Self.filterEditHistoryClause())
             \(Self.filterPlaceholdersClause)
             """
+        case .filterForConversationViewWithRecordTypes(let recordTypes):
+            """
+            AND \(interactionColumn: .recordType) IN (\(recordTypes.map { "\($0.rawValue)" }.joined(separator: ",")))
+            \(Self.filterGroupStoryRepliesClause())
+            \(Self.filterEditHistoryClause())
+            \(Self.filterPlaceholdersClause)
+            """
         case .filterForIncomingMessages:
             "AND recordType = \(SDSRecordType.incomingMessage.rawValue) AND errorType is NULL"
         case .filterForOutgoingMessages:
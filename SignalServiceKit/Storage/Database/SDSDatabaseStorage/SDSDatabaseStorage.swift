@@ -13,6 +13,10 @@ public class SDSDatabaseStorage: NSObject {
 
     private let asyncWriteQueue = DispatchQueue(label: "org.signal.database.write-async", qos: .userInitiated)
 
+    // Implicitly unwrapped because it needs to refer to self. It's set in the
+    // initializer and never changes, so it's safe to read from any thread.
+    private var writeCoalescer: SDSWriteCoalescer!
+
     private var hasPendingCrossProcessWrite = false
 
     // Implicitly unwrapped because it is set in the initializer but after initialization completes because it
@@ -39,6 +43,8 @@ public class SDSDatabaseStorage: NSObject {
 
         super.init()
 
+        self.writeCoalescer = SDSWriteCoalescer(databaseStorage: self)
+
         if CurrentAppContext().isRunningTests {
             self.crossProcess = SDSCrossProcess(callback: {})
         } else {
@@ -190,27 +196,29 @@ public class SDSDatabaseStorage: NSObject {
             }
         }
         if shouldReindex, let message = interaction as? TSMessage {
-            FullTextSearchIndexer.update(message, tx: transaction)
+            FullTextSearchIndexer.scheduleIndexing(message, tx: transaction)
         }
     }
 
     /// See note on `shouldUpdateChatListUi` parameter in docs for ``TSGroupThread.updateWithGroupModel:shouldUpdateChatListUi:transaction``.
     @objc(touchThread:shouldReindex:shouldUpdateChatListUi:transaction:)
     public func touch(thread: TSThread, shouldReindex: Bool, shouldUpdateChatListUi: Bool, transaction: SDSAnyWriteTransaction) {
-        switch transaction.writeTransaction {
-        case .grdbWrite(let grdb):
-            DatabaseChangeObserver.serializedSync {
-                if let databaseChangeObserver = grdbStorage.databaseChangeObserver {
-                    databaseChangeObserver.didTouch(thread: thread, shouldUpdateChatListUi: shouldUpdateChatListUi, transaction: grdb)
-                } else if appReadiness.isAppReady {
-                    // This can race with observation setup when app becomes ready.
-                    Logger.warn("databaseChangeObserver was unexpectedly nil")
+        Signpost.interval("TouchThread") {
+            switch transaction.writeTransaction {
+            case .grdbWrite(let grdb):
+                DatabaseChangeObserver.serializedSync {
+                    if let databaseChangeObserver = grdbStorage.databaseChangeObserver {
+                        databaseChangeObserver.didTouch(thread: thread, shouldUpdateChatListUi: shouldUpdateChatListUi, transaction: grdb)
+                    } else if appReadiness.isAppReady {
+                        // This can race with observation setup when app becomes ready.
+                        Logger.warn("databaseChangeObserver was unexpectedly nil")
+                    }
                 }
             }
-        }
-        if shouldReindex {
-            let searchableNameIndexer = DependenciesBridge.shared.searchableNameIndexer
-            searchableNameIndexer.update(thread, tx: transaction.asV2Write)
+            if shouldReindex {
+                let searchableNameIndexer = DependenciesBridge.shared.searchableNameIndexer
+                searchableNameIndexer.update(thread, tx: transaction.asV2Write)
+            }
         }
     }
 
@@ -505,6 +513,27 @@ public class SDSDatabaseStorage: NSObject {
         }
     }
 
+    // MARK: - Coalesced
+
+    /// Performs `block` in a write transaction shared with other coalesced
+    /// writes, within a short delay.
+    ///
+    /// Use this for small writes that don't need to be committed right away
+    /// and don't depend on other writes. `block` must handle its own errors
+    /// and can't roll back; see `SDSWriteCoalescer`.
+    @objc(asyncCoalescedWriteWithBlock:)
+    public func asyncCoalescedWrite(block: @escaping (SDSAnyWriteTransaction) -> Void) {
+        writeCoalescer.enqueue(block: block)
+    }
+
+    public func asyncCoalescedWrite(
+        block: @escaping (SDSAnyWriteTransaction) -> Void,
+        completionQueue: DispatchQueue,
+        completion: @escaping () -> Void
+    ) {
+        writeCoalescer.enqueue(block: block, completionQueue: completionQueue, completion: completion)
+    }
+
     // MARK: - Awaitable
 
     public func awaitableWrite<T>(
@@ -0,0 +1,113 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import Foundation
+
+/// Commits small, independent async writes together.
+///
+/// Every write transaction waits for the single writer and ends with a
+/// commit (and fsync). Writes such as cached media metadata or deferred
+/// thread touches don't need their own transaction, so they're queued for
+/// up to `maxDelay` and then performed, in order, in one transaction.
+///
+/// Blocks must be independent of one another: each should tolerate the
+/// others having run first in the same transaction.
+///
+/// Blocks can't throw, and the batch is always committed: a block whose
+/// statement fails must catch the error and leave the transaction usable,
+/// and can't rely on a rollback to undo writes it made before failing.
+final class SDSWriteCoalescer {
+
+    private struct PendingWrite {
+        let block: (SDSAnyWriteTransaction) -> Void
+        let completionQueue: DispatchQueue
+        let completion: (() -> Void)?
+    }
+
+    private let databaseStorage: SDSDatabaseStorage
+    private let maxDelay: TimeInterval
+    private let maxBatchCount: Int
+
+    private let lock = UnfairLock()
+
+    // These properties should only be accessed with lock acquired.
+    private var pendingWrites = [PendingWrite]()
+    private var isFlushScheduled = false
+
+    init(databaseStorage: SDSDatabaseStorage, maxDelay: TimeInterval = 0.05, maxBatchCount: Int = 64) {
+        self.databaseStorage = databaseStorage
+        self.maxDelay = maxDelay
+        self.maxBatchCount = maxBatchCount
+    }
+
+    func enqueue(
+        block: @escaping (SDSAnyWriteTransaction) -> Void,
+        completionQueue: DispatchQueue = .main,
+        completion: (() -> Void)? = nil
+    ) {
+        enum Action {
+            case none
+            case scheduleFlush
+            case flush([PendingWrite])
+        }
+        let action: Action = lock.withLock {
+            pendingWrites.append(PendingWrite(block: block, completionQueue: completionQueue, completion: completion))
+            if pendingWrites.count >= maxBatchCount {
+                // A flush may still be scheduled; it'll pick up later writes.
+                let batch = pendingWrites
+                pendingWrites = []
+                return .flush(batch)
+            }
+            guard !isFlushScheduled else {
+                return .none
+            }
+            isFlushScheduled = true
+            return .scheduleFlush
+        }
+        switch action {
+        case .none:
+            break
+        case .scheduleFlush:
+            DispatchQueue.global().asyncAfter(deadline: .now() + maxDelay) { [weak self] in
+                self?.flushScheduledWrites()
+            }
+        case .flush(let batch):
+            perform(batch)
+        }
+    }
+
+    private func flushScheduledWrites() {
+        let batch: [PendingWrite] = lock.withLock {
+            let batch = pendingWrites
+            pendingWrites = []
+            isFlushScheduled = false
+            return batch
+        }
+        perform(batch)
+    }
+
+    private func perform(_ batch: [PendingWrite]) {
+        guard !batch.isEmpty else {
+            return
+        }
+        databaseStorage.asyncWrite(
+            block: { tx in
+                for pendingWrite in batch {
+                    autoreleasepool {
+                        pendingWrite.block(tx)
+                    }
+                }
+            },
+            completionQueue: .global(),
+            completion: {
+                for pendingWrite in batch {
+                    if let completion = pendingWrite.completion {
+                        pendingWrite.completionQueue.async(execute: completion)
+                    }
+                }
+            }
+        )
+    }
+}
@@ -101,6 +101,15 @@ public class SDSDeserialization {
         }
     }
 
+    /// Archived string arrays (e.g., `attachmentIds`) are decoded for nearly
+    /// every interaction that's loaded, and most of them are byte-identical
+    /// (usually empty). `[String]` is a value type, so decoded values can be
+    /// shared, and looking one up is much cheaper than `NSKeyedUnarchiver`.
+    private static let stringArrayCache = LRUCache<Data, [String]>(maxSize: 256, nseMaxSize: 32)
+
+    /// Larger blobs are unlikely to repeat.
+    private static let maxCachedStringArrayBlobSize = 1024
+
     public class func optionalUnarchive<T: Any>(_ encoded: Data?, name: String) throws -> T? {
         guard let encoded = encoded else {
             return nil
@@ -120,11 +129,19 @@ public class SDSDeserialization {
             throw SDSError.missingRequiredField(file, function, line)
         }
 
+        let isCacheableStringArray = T.self == [String].self && encoded.count <= maxCachedStringArrayBlobSize
+        if isCacheableStringArray, let cached = stringArrayCache.get(key: encoded) {
+            return cached as! T
+        }
+
         do {
             guard let decoded = try NSKeyedUnarchiver.unarchiveTopLevelObjectWithData(encoded) as? T else {
                 owsFailDebug("Invalid value: \(name).")
                 throw SDSError.invalidValue(file, function, line)
             }
+            if isCacheableStringArray, let stringArray = decoded as? [String] {
+                stringArrayCache.set(key: encoded, value: stringArray)
+            }
             return decoded
         } catch {
             owsFailDebug("Read failed[\(name)]: \(error).")
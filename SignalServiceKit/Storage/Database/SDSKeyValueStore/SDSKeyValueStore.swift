@@ -33,9 +33,21 @@ public class SDSKeyValueStore: NSObject {
         ]
     )
 
+    private let cache: SDSKeyValueStoreCache?
+
     @objc
-    public required init(collection: String) {
+    public required convenience init(collection: String) {
+        self.init(collection: collection, isCached: false)
+    }
+
+    /// - Parameter isCached: If true, decoded values are kept in memory so
+    ///   that repeated reads of the same key don't hit the database. Only
+    ///   use this for collections whose values are immutable and read often.
+    @objc
+    public init(collection: String, isCached: Bool) {
         self.collection = collection
+        // Cross-process writes are only observed by the main app.
+        self.cache = (isCached && CurrentAppContext().isMainApp) ? SDSKeyValueStoreCache() : nil
 
         super.init()
     }
@@ -360,6 +372,7 @@ public class SDSKeyValueStore: NSObject {
     public func removeAll(transaction: SDSAnyWriteTransaction) {
         switch transaction.writeTransaction {
         case .grdbWrite(let grdbWrite):
+            cache?.willWrite(key: nil, transaction: transaction)
             let sql = """
                 DELETE
                 FROM \(SDSKeyValueStore.table.tableName)
@@ -611,6 +624,15 @@ public class SDSKeyValueStore: NSObject {
     }
 
     private func readRawObject(_ key: String, transaction: SDSAnyReadTransaction) -> Any? {
+        guard let cache else {
+            return readUncachedRawObject(key, transaction: transaction)
+        }
+        return cache.value(forKey: key, transaction: transaction) {
+            readUncachedRawObject(key, transaction: transaction)
+        }
+    }
+
+    private func readUncachedRawObject(_ key: String, transaction: SDSAnyReadTransaction) -> Any? {
         // GRDB values are serialized to data by this class.
         switch transaction.readTransaction {
         case .grdbRead:
@@ -687,6 +709,8 @@ public class SDSKeyValueStore: NSObject {
 
         let collection = self.collection
 
+        cache?.willWrite(key: key, transaction: transaction)
+
         switch transaction.writeTransaction {
         case .grdbWrite(let grdbTransaction):
             do {
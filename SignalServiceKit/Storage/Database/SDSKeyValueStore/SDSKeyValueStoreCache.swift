@@ -0,0 +1,135 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import Foundation
+
+/// An in-memory cache of the decoded values in one `SDSKeyValueStore`
+/// collection.
+///
+/// Values are shared between readers, so only collections that store
+/// immutable values (numbers, strings, dates, data, etc.) should be cached.
+///
+/// Like `ModelReadCache`, this cache "excludes" keys that are being written
+/// until the write transaction has committed, and it is evacuated after
+/// cross-process writes. Read transactions that started before a key's last
+/// write may see its old value, so they bypass the cache for that key.
+final class SDSKeyValueStoreCache {
+
+    private enum CachedValue {
+        case present(Any)
+        case absent
+    }
+
+    private let lock = UnfairLock()
+
+    // These properties should only be accessed with lock acquired.
+    private var values = [String: CachedValue]()
+    private var excludedKeyCounts = [String: Int]()
+    private var allKeysExclusionCount = 0
+    private var exclusionDates = [String: Date]()
+    private var allKeysExclusionDate: Date?
+    /// Incremented on every write and evacuation, so that reads that raced
+    /// with a write don't populate the cache.
+    private var generation: UInt64 = 0
+
+    init() {
+        NotificationCenter.default.addObserver(
+            self,
+            selector: #selector(didReceiveCrossProcessNotification),
+            name: SDSDatabaseStorage.didReceiveCrossProcessNotificationAlwaysSync,
+            object: nil
+        )
+    }
+
+    /// Returns the cached value for `key`, or reads it with `readValue` and
+    /// caches the result.
+    func value(forKey key: String, transaction: SDSAnyReadTransaction, readValue: () -> Any?) -> Any? {
+        let generation: UInt64? = lock.withLock {
+            guard !isExcluded(key: key, transaction: transaction) else {
+                return nil
+            }
+            return self.generation
+        }
+        guard let generation else {
+            return readValue()
+        }
+        if let cachedValue = lock.withLock({ values[key] }) {
+            switch cachedValue {
+            case .present(let value):
+                return value
+            case .absent:
+                return nil
+            }
+        }
+        let value = readValue()
+        lock.withLock {
+            guard self.generation == generation, !isExcluded(key: key, transaction: transaction) else {
+                return
+            }
+            values[key] = value.map { .present($0) } ?? .absent
+        }
+        return value
+    }
+
+    /// Call before writing `key` to the database, or with nil before
+    /// removing every key in the collection.
+    func willWrite(key: String?, transaction: SDSAnyWriteTransaction) {
+        lock.withLock {
+            generation += 1
+            if let key {
+                values[key] = nil
+                excludedKeyCounts[key, default: 0] += 1
+            } else {
+                values.removeAll()
+                allKeysExclusionCount += 1
+            }
+        }
+        // Other transactions may read the old value until this one commits.
+        transaction.addSyncCompletion {
+            self.lock.withLock {
+                self.generation += 1
+                if let key {
+                    self.values[key] = nil
+                    self.exclusionDates[key] = Date()
+                    let count = (self.excludedKeyCounts[key] ?? 1) - 1
+                    self.excludedKeyCounts[key] = count > 0 ? count : nil
+                } else {
+                    self.values.removeAll()
+                    self.allKeysExclusionDate = Date()
+                    self.allKeysExclusionCount -= 1
+                }
+            }
+        }
+    }
+
+    func evacuate() {
+        lock.withLock {
+            generation += 1
+            values.removeAll()
+            // Another process may have written any key.
+            allKeysExclusionDate = Date()
+        }
+    }
+
+    // This method should only be called with lock acquired.
+    private func isExcluded(key: String, transaction: SDSAnyReadTransaction) -> Bool {
+        if allKeysExclusionCount > 0 || excludedKeyCounts[key] != nil {
+            return true
+        }
+        if let allKeysExclusionDate, allKeysExclusionDate > transaction.startDate {
+            return true
+        }
+        if let exclusionDate = exclusionDates[key], exclusionDate > transaction.startDate {
+            return true
+        }
+        return false
+    }
+
+    @objc
+    private func didReceiveCrossProcessNotification(_ notification: Notification) {
+        AssertIsOnMainThread()
+        evacuate()
+    }
+}
@@ -0,0 +1,115 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import Foundation
+import GRDB
+
+/// Enumerates a record cursor, converting records to models concurrently.
+///
+/// Converting a record to a model (unarchiving its blob columns, running
+/// the model's initializer) usually costs more than fetching the row.
+/// Records are fetched in pages on the calling thread; each page is
+/// converted on worker threads while the next page is fetched. Models are
+/// delivered to `block` on the calling thread, in cursor order, so `block`
+/// may use the transaction as usual.
+///
+/// `decode` runs on worker threads and must not touch the transaction.
+enum SDSParallelDecoder {
+
+    static let defaultPageSize = 256
+
+    static func enumerate<Record: FetchableRecord, Model>(
+        cursor: RecordCursor<Record>,
+        pageSize: Int = defaultPageSize,
+        decode: @escaping (Record) throws -> Model,
+        block: (Model, UnsafeMutablePointer<ObjCBool>) -> Void
+    ) throws {
+        owsAssertDebug(pageSize > 0)
+
+        var pendingPage: DecodedPage<Record, Model>?
+        // Workers must finish before the models (or the caller) go away.
+        defer { pendingPage?.wait() }
+
+        var stop: ObjCBool = false
+        while true {
+            var records = [Record]()
+            records.reserveCapacity(pageSize)
+            try autoreleasepool {
+                while records.count < pageSize, let record = try cursor.next() {
+                    records.append(record)
+                }
+            }
+
+            let page = records.isEmpty ? nil : DecodedPage(records: records, decode: decode)
+
+            if let previousPage = pendingPage {
+                pendingPage = page
+                previousPage.wait()
+                autoreleasepool {
+                    previousPage.deliver(block: block, stop: &stop)
+                }
+                if stop.boolValue {
+                    return
+                }
+            } else {
+                pendingPage = page
+            }
+
+            guard page != nil else {
+                return
+            }
+        }
+    }
+}
+
+// MARK: -
+
+private final class DecodedPage<Record, Model> {
+    private let group = DispatchGroup()
+    private let count: Int
+    private let results: UnsafeMutablePointer<Result<Model, Error>?>
+
+    init(records: [Record], decode: @escaping (Record) throws -> Model) {
+        let count = records.count
+        let results = UnsafeMutablePointer<Result<Model, Error>?>.allocate(capacity: count)
+        results.initialize(repeating: nil, count: count)
+        self.count = count
+        self.results = results
+
+        DispatchQueue.global(qos: .userInitiated).async(group: group) {
+            // Each iteration only writes its own element.
+            DispatchQueue.concurrentPerform(iterations: count) { index in
+                autoreleasepool {
+                    results[index] = Result { try decode(records[index]) }
+                }
+            }
+        }
+    }
+
+    deinit {
+        results.deinitialize(count: count)
+        results.deallocate()
+    }
+
+    func wait() {
+        group.wait()
+    }
+
+    func deliver(block: (Model, UnsafeMutablePointer<ObjCBool>) -> Void, stop: inout ObjCBool) {
+        for index in 0..<count {
+            switch results[index] {
+            case .success(let model):
+                block(model, &stop)
+                if stop.boolValue {
+                    return
+                }
+            case .failure(let error):
+                owsFailDebug("Couldn't decode model: \(error)")
+            case nil:
+                owsFailDebug("Missing decoded model.")
+            }
+        }
+    }
+}
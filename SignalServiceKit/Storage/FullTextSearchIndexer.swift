@@ -78,6 +78,17 @@ public enum FullTextSearchIndexer {
     // We want to match by prefix for "search as you type" functionality.
     // SQLite does not support suffix or contains matches.
     public static func buildQuery(for searchText: String) -> String {
+        // Allow partial match of each term.
+        //
+        // Note that we use double-quotes to enclose each search term.
+        // Quoted search terms can include a few more characters than
+        // "bareword" (non-quoted) search terms.  This shouldn't matter,
+        // since we're filtering all of the affected characters, but
+        // quoting protects us from any bugs in that logic.
+        return queryTerms(for: searchText).map { "\"\($0)\"*" }.joined(separator: " ")
+    }
+
+    private static func queryTerms(for searchText: String) -> [String] {
         // 1. Normalize the search text.
         //
         // TODO: We could arguably convert to lowercase since the search
@@ -107,24 +118,8 @@ public enum FullTextSearchIndexer {
         //        and the order won't affect the search results.
         queryTerms = Array(Set(queryTerms)).sorted()
 
-        // 5. Filter the query terms.
-        let filteredQueryTerms = queryTerms.filter {
-            // Ignore empty terms.
-            $0.count > 0
-        }.map {
-            // Allow partial match of each term.
-            //
-            // Note that we use double-quotes to enclose each search term.
-            // Quoted search terms can include a few more characters than
-            // "bareword" (non-quoted) search terms.  This shouldn't matter,
-            // since we're filtering all of the affected characters, but
-            // quoting protects us from any bugs in that logic.
-            "\"\($0)\"*"
-        }
-
-        // 6. Join terms into query string.
-        let query = filteredQueryTerms.joined(separator: " ")
-        return query
+        // 5. Ignore empty terms.
+        return queryTerms.filter { $0.count > 0 }.map { String($0) }
     }
 }
 
@@ -141,17 +136,22 @@ extension FullTextSearchIndexer {
     static let collectionColumn = "collection"
     static let ftsContentColumn = "ftsIndexableContent"
 
+    /// Messages whose index content is out of date, in the order they changed.
+    ///
+    /// Inserting, editing & deleting messages only appends a row here; the
+    /// (comparatively expensive) work of fetching the body, normalizing it
+    /// and updating the FTS index happens in batches, in later transactions.
+    /// Search consults this table so that the results stay consistent.
+    static let pendingTableName = "indexable_text_pending"
+    static let pendingIdColumn = "id"
+
     private static let legacyCollectionName = "TSInteraction"
 
+    /// Determines the length of the snippet.
+    private static let snippetTokenCount = 15
+
     private static func indexableContent(for message: TSMessage, tx: SDSAnyReadTransaction) -> String? {
-        guard !message.isViewOnceMessage else {
-            // Don't index "view-once messages".
-            return nil
-        }
-        guard !message.isGroupStoryReply else {
-            return nil
-        }
-        guard message.editState != .pastRevision else {
+        guard !isExcludedFromIndex(message) else {
             return nil
         }
         guard let bodyText = message.rawBody(transaction: tx) else {
@@ -160,6 +160,22 @@ extension FullTextSearchIndexer {
         return normalizeText(bodyText)
     }
 
+    private static func isExcludedFromIndex(_ message: TSMessage) -> Bool {
+        if message.isViewOnceMessage {
+            // Don't index "view-once messages".
+            return true
+        }
+        if message.isGroupStoryReply {
+            return true
+        }
+        if message.editState == .pastRevision {
+            return true
+        }
+        return false
+    }
+
+    /// Indexes `message` immediately. Most callers should use
+    /// `scheduleIndexing(_:isInsert:tx:)` instead.
     public static func insert(_ message: TSMessage, tx: SDSAnyWriteTransaction) {
         guard let ftsContent = indexableContent(for: message, tx: tx) else {
             return
@@ -176,21 +192,52 @@ extension FullTextSearchIndexer {
         )
     }
 
-    public static func update(_ message: TSMessage, tx: SDSAnyWriteTransaction) {
-        delete(message, tx: tx)
-        insert(message, tx: tx)
+    /// Records that `message` was inserted, updated or deleted; its index
+    /// content is brought up to date after the transaction commits.
+    public static func scheduleIndexing(_ message: TSMessage, isInsert: Bool = false, tx: SDSAnyWriteTransaction) {
+        if isInsert, isExcludedFromIndex(message) {
+            // There's nothing in the index to remove, and nothing to add.
+            return
+        }
+        if pendingCount(tx: tx) >= maxPendingCount {
+            // Search matches each pending message separately, so don't let
+            // the log grow without bound (e.g. while only the NSE runs).
+            reindex(message, tx: tx)
+            return
+        }
+        executeUpdate(
+            sql: "INSERT OR IGNORE INTO \(pendingTableName) (\(uniqueIdColumn)) VALUES (?)",
+            arguments: [message.uniqueId],
+            tx: tx
+        )
+        if CurrentAppContext().isNSE || CurrentAppContext().isRunningTests {
+            // Leave the work for the main app (the NSE's time and memory are
+            // limited), or for the test; search is correct either way.
+            return
+        }
+        if isPendingIndexingScheduled.tryToSetFlag() {
+            tx.addSyncCompletion {
+                DispatchQueue.global(qos: .utility).asyncAfter(deadline: .now() + pendingIndexingDelay) {
+                    indexAllPendingMessages()
+                }
+            }
+        }
     }
 
-    public static func delete(_ message: TSMessage, tx: SDSAnyWriteTransaction) {
+    /// Brings the index content for `message` up to date immediately.
+    private static func reindex(_ message: TSMessage, tx: SDSAnyWriteTransaction) {
         executeUpdate(
             sql: """
             DELETE FROM \(contentTableName)
-            WHERE \(uniqueIdColumn) == ?
-            AND \(collectionColumn) == ?
+            WHERE \(collectionColumn) == ?
+            AND \(uniqueIdColumn) == ?
             """,
-            arguments: [message.uniqueId, legacyCollectionName],
+            arguments: [legacyCollectionName, message.uniqueId],
             tx: tx
         )
+        if TSInteraction.anyExists(uniqueId: message.uniqueId, transaction: tx) {
+            insert(message, tx: tx)
+        }
     }
 
     private static func executeUpdate(
@@ -204,8 +251,358 @@ extension FullTextSearchIndexer {
         )
     }
 
+    // MARK: - Pending Messages
+
+    private static let pendingIndexingBatchSize = 200
+
+    /// Messages changed while the log is this long are indexed immediately.
+    static let maxPendingCount = 500
+
+    private static func pendingCount(tx: SDSAnyReadTransaction) -> Int {
+        do {
+            return try Int.fetchOne(
+                tx.unwrapGrdbRead.database,
+                sql: "SELECT COUNT(*) FROM \(pendingTableName)"
+            ) ?? 0
+        } catch {
+            owsFailDebug("Couldn't count pending messages: \(error.grdbErrorForLogging)")
+            return 0
+        }
+    }
+
+    /// Lets a burst of changes (e.g. a catch-up after being offline) land
+    /// before the first batch.
+    private static let pendingIndexingDelay: TimeInterval = 0.5
+
+    /// Set while a pass over the pending messages is scheduled or running.
+    /// It's only cleared in the write transaction that handles the last
+    /// pending message, so a message scheduled after that transaction
+    /// schedules a new pass.
+    private static let isPendingIndexingScheduled = AtomicBool(false, lock: .init())
+
+    /// Brings the index up to date for messages left pending (e.g. by the
+    /// NSE or by a previous launch).
+    public static func indexPendingMessagesOnLaunch() {
+        guard isPendingIndexingScheduled.tryToSetFlag() else {
+            return
+        }
+        DispatchQueue.global(qos: .utility).async {
+            indexAllPendingMessages()
+        }
+    }
+
+    private static func indexAllPendingMessages() {
+        let databaseStorage = SSKEnvironment.shared.databaseStorageRef
+        var indexedCount = 0
+        while true {
+            let batchCount = databaseStorage.write { tx in
+                let batchCount = indexPendingMessages(limit: pendingIndexingBatchSize, tx: tx)
+                if batchCount < pendingIndexingBatchSize {
+                    isPendingIndexingScheduled.set(false)
+                }
+                return batchCount
+            }
+            indexedCount += batchCount
+            if batchCount < pendingIndexingBatchSize {
+                break
+            }
+        }
+        if indexedCount >= pendingIndexingBatchSize {
+            Logger.info("Indexed \(indexedCount) pending messages")
+        }
+    }
+
+    /// Updates the index for up to `limit` pending messages, oldest first.
+    /// Returns the number of pending messages that were handled.
+    @discardableResult
+    static func indexPendingMessages(limit: Int, tx: SDSAnyWriteTransaction) -> Int {
+        let database = tx.unwrapGrdbWrite.database
+        let rows: [Row]
+        do {
+            rows = try Row.fetchAll(
+                database,
+                sql: """
+                SELECT \(pendingIdColumn), \(uniqueIdColumn)
+                FROM \(pendingTableName)
+                ORDER BY \(pendingIdColumn)
+                LIMIT ?
+                """,
+                arguments: [limit]
+            )
+        } catch {
+            owsFailDebug("Couldn't fetch pending messages: \(error.grdbErrorForLogging)")
+            return 0
+        }
+        guard let maxPendingId: Int64 = rows.last?[pendingIdColumn] else {
+            return 0
+        }
+        let uniqueIds: [String] = rows.map { $0[uniqueIdColumn] }
+
+        // Remove the stale content for the whole batch at once, then add
+        // back whatever is still indexable.
+        database.executeHandlingErrors(
+            sql: """
+            DELETE FROM \(contentTableName)
+            WHERE \(collectionColumn) == ?
+            AND \(uniqueIdColumn) IN (\(uniqueIds.map { _ in "?" }.joined(separator: ", ")))
+            """,
+            arguments: StatementArguments([legacyCollectionName] + uniqueIds)
+        )
+        for uniqueId in uniqueIds {
+            guard let message = TSMessage.anyFetchMessage(uniqueId: uniqueId, transaction: tx) else {
+                // The message was deleted.
+                continue
+            }
+            insert(message, tx: tx)
+        }
+        database.executeHandlingErrors(
+            sql: "DELETE FROM \(pendingTableName) WHERE \(pendingIdColumn) <= ?",
+            arguments: [maxPendingId]
+        )
+        return uniqueIds.count
+    }
+
+    /// Where a pending message matches the query.
+    struct PendingContentMatch {
+        /// In the format of FTS5's `snippet()`.
+        let snippet: String
+        /// The number of matches of each query phrase.
+        let phraseMatchCounts: [Int]
+        let tokenCount: Int
+    }
+
+    /// Matches the content of a pending message against the query phrases
+    /// (see `queryPhrases(for:tokenizer:)`) like the FTS query built by
+    /// `buildQuery(for:)` does: every phrase must match, and the last token
+    /// of each phrase matches by prefix.
+    ///
+    /// Returns nil if the content doesn't match.
+    static func matchPendingContent(
+        _ content: String,
+        queryPhrases: [[String]],
+        tokenizer: FTS5Tokenizer
+    ) -> PendingContentMatch? {
+        guard !queryPhrases.isEmpty else {
+            return nil
+        }
+        let tokens = Self.tokens(in: content, tokenization: .document, tokenizer: tokenizer)
+        var isMatchingToken = [Bool](repeating: false, count: tokens.count)
+        var phraseMatchCounts = [Int]()
+        for phrase in queryPhrases {
+            var matchCount = 0
+            for startIndex in tokens.indices where startIndex + phrase.count <= tokens.count {
+                let isMatch = phrase.enumerated().allSatisfy { offset, queryToken in
+                    let token = tokens[startIndex + offset].token
+                    return offset == phrase.count - 1 ? token.hasPrefix(queryToken) : token == queryToken
+                }
+                guard isMatch else {
+                    continue
+                }
+                matchCount += 1
+                for offset in phrase.indices {
+                    isMatchingToken[startIndex + offset] = true
+                }
+            }
+            guard matchCount > 0 else {
+                return nil
+            }
+            phraseMatchCounts.append(matchCount)
+        }
+
+        let firstMatchIndex = isMatchingToken.firstIndex(of: true)!
+        let startIndex = max(0, min(firstMatchIndex - 2, tokens.count - snippetTokenCount))
+        let endIndex = min(tokens.count, startIndex + snippetTokenCount)
+        var snippet = startIndex > 0 ? "…" : ""
+        // Like `snippet()`, keep the text between the tokens as it is.
+        var textIndex = tokens[startIndex].range.lowerBound
+        for index in startIndex..<endIndex {
+            let range = tokens[index].range
+            snippet += content[textIndex..<range.lowerBound]
+            if isMatchingToken[index] {
+                snippet += "<\(matchTag)>\(content[range])</\(matchTag)>"
+            } else {
+                snippet += content[range]
+            }
+            textIndex = range.upperBound
+        }
+        if endIndex < tokens.count {
+            snippet += "…"
+        }
+        return PendingContentMatch(snippet: snippet, phraseMatchCounts: phraseMatchCounts, tokenCount: tokens.count)
+    }
+
+    /// The tokens of each query term, as the FTS query sees them: a term
+    /// that the tokenizer splits is a phrase. Terms without tokens are
+    /// dropped.
+    static func queryPhrases(for searchText: String, tokenizer: FTS5Tokenizer) -> [(queryTerm: String, tokens: [String])] {
+        return queryTerms(for: searchText).compactMap { queryTerm in
+            let queryTokens = Self.tokens(in: queryTerm, tokenization: .query, tokenizer: tokenizer).map(\.token)
+            return queryTokens.isEmpty ? nil : (queryTerm, queryTokens)
+        }
+    }
+
+    private final class TokenCollector {
+        var tokens = [(token: String, startOffset: Int, endOffset: Int)]()
+    }
+
+    /// Tokenizes `text` with the index's tokenizer, so that pending messages
+    /// are split and folded (case, diacritics) exactly like indexed ones.
+    private static func tokens(
+        in text: String,
+        tokenization: FTS5Tokenization,
+        tokenizer: FTS5Tokenizer
+    ) -> [(token: String, range: Range<String.Index>)] {
+        let collector = TokenCollector()
+        let utf8 = ContiguousArray(text.utf8)
+        let resultCode = utf8.withUnsafeBufferPointer { buffer -> Int32 in
+            guard let baseAddress = buffer.baseAddress else {
+                return ResultCode.SQLITE_OK.rawValue
+            }
+            return baseAddress.withMemoryRebound(to: Int8.self, capacity: buffer.count) { pText in
+                tokenizer.tokenize(
+                    context: Unmanaged.passUnretained(collector).toOpaque(),
+                    tokenization: tokenization,
+                    pText: pText,
+                    nText: Int32(buffer.count),
+                    tokenCallback: { context, _, pToken, nToken, iStart, iEnd in
+                        guard let context, let pToken else {
+                            return ResultCode.SQLITE_OK.rawValue
+                        }
+                        let collector = Unmanaged<TokenCollector>.fromOpaque(context).takeUnretainedValue()
+                        let tokenBytes = UnsafeRawBufferPointer(start: pToken, count: Int(nToken))
+                        collector.tokens.append((String(decoding: tokenBytes, as: UTF8.self), Int(iStart), Int(iEnd)))
+                        return ResultCode.SQLITE_OK.rawValue
+                    }
+                )
+            }
+        }
+        if resultCode != ResultCode.SQLITE_OK.rawValue {
+            owsFailDebug("Couldn't tokenize text: \(resultCode)")
+        }
+        return collector.tokens.map { token, startOffset, endOffset in
+            let startIndex = text.utf8.index(text.utf8.startIndex, offsetBy: startOffset)
+            let endIndex = text.utf8.index(text.utf8.startIndex, offsetBy: endOffset)
+            return (token, startIndex..<endIndex)
+        }
+    }
+
+    // MARK: - Ranking
+
+    /// The index's row count and average token count, which FTS5 keeps for
+    /// `bm25()` in the "averages" record of its data table.
+    private struct IndexTotals {
+        let rowCount: Int64
+        let averageTokenCount: Double
+    }
+
+    private static func fetchIndexTotals(database: Database) throws -> IndexTotals? {
+        guard let block = try Data.fetchOne(database, sql: "SELECT block FROM \(ftsTableName)_data WHERE id = 1") else {
+            return nil
+        }
+        var offset = block.startIndex
+        // The values are SQLite varints: big-endian groups of 7 bits, with
+        // the high bit set on all but the last byte (or a full 9th byte).
+        func readVarint() -> Int64? {
+            var value: UInt64 = 0
+            for byteIndex in 0..<9 {
+                guard offset < block.endIndex else {
+                    return nil
+                }
+                let byte = block[offset]
+                offset += 1
+                if byteIndex == 8 {
+                    value = (value << 8) | UInt64(byte)
+                    break
+                }
+                value = (value << 7) | UInt64(byte & 0x7f)
+                if byte & 0x80 == 0 {
+                    break
+                }
+            }
+            return Int64(bitPattern: value)
+        }
+        guard let rowCount = readVarint(), let totalTokenCount = readVarint(), rowCount > 0 else {
+            return nil
+        }
+        return IndexTotals(rowCount: rowCount, averageTokenCount: Double(totalTokenCount) / Double(rowCount))
+    }
+
+    /// Computes the FTS5 `rank` (i.e., `bm25()`) that a pending message would
+    /// have if it were indexed, so that its result can be merged with the
+    /// index's.
+    private static func rank(
+        of match: PendingContentMatch,
+        phraseRowCounts: [Int64],
+        totals: IndexTotals
+    ) -> Double {
+        // The same constants as FTS5's `bm25()`.
+        let k1 = 1.2
+        let b = 0.75
+        var score = 0.0
+        for (matchCount, phraseRowCount) in zip(match.phraseMatchCounts, phraseRowCounts) {
+            let rowCount = Double(max(totals.rowCount, phraseRowCount))
+            var idf = log((rowCount - Double(phraseRowCount) + 0.5) / (Double(phraseRowCount) + 0.5))
+            if idf <= 0 {
+                idf = 1e-6
+            }
+            let frequency = Double(matchCount)
+            let lengthNormalization = 1 - b + b * Double(match.tokenCount) / totals.averageTokenCount
+            score += idf * (frequency * (k1 + 1)) / (frequency + k1 * lengthNormalization)
+        }
+        return -score
+    }
+
     // MARK: - Querying
 
+    private struct SearchResult {
+        let message: TSMessage
+        let snippet: String
+        let rank: Double
+    }
+
+    /// Matches the pending messages directly; they're sorted by rank.
+    private static func pendingSearchResults(
+        for searchText: String,
+        pendingUniqueIds: [String],
+        tx: SDSAnyReadTransaction
+    ) throws -> [SearchResult] {
+        let database = tx.unwrapGrdbRead.database
+        let tokenizer = try database.makeTokenizer(.unicode61())
+        let queryPhrases = Self.queryPhrases(for: searchText, tokenizer: tokenizer)
+        let queryPhraseTokens = queryPhrases.map { $0.tokens }
+        var matches = [(message: TSMessage, match: PendingContentMatch)]()
+        for uniqueId in pendingUniqueIds {
+            guard
+                let message = TSMessage.anyFetchMessage(uniqueId: uniqueId, transaction: tx),
+                let content = indexableContent(for: message, tx: tx),
+                let match = matchPendingContent(content, queryPhrases: queryPhraseTokens, tokenizer: tokenizer)
+            else {
+                continue
+            }
+            matches.append((message, match))
+        }
+        guard !matches.isEmpty else {
+            return []
+        }
+
+        let totals = try fetchIndexTotals(database: database)
+        let phraseRowCounts = try queryPhrases.map { queryPhrase in
+            try Int64.fetchOne(
+                database,
+                sql: "SELECT COUNT(*) FROM \(ftsTableName) WHERE \(ftsContentColumn) MATCH ?",
+                arguments: [buildQuery(for: queryPhrase.queryTerm)]
+            ) ?? 0
+        }
+        let results = matches.map { message, match in
+            // If the index is empty, there's nothing to merge with.
+            let rank = totals.map { Self.rank(of: match, phraseRowCounts: phraseRowCounts, totals: $0) } ?? 0
+            return SearchResult(message: message, snippet: match.snippet, rank: rank)
+        }
+        // Like `ORDER BY rank`. The sort is stable, so ties stay most recent
+        // first.
+        return results.sorted { $0.rank < $1.rank }
+    }
+
     public static func search(
         for searchText: String,
         maxResults: Int,
@@ -223,41 +620,84 @@ extension FullTextSearchIndexer {
 
         // Search with the query interface or SQL
         do {
-            // GRDB TODO: We could use bm25() instead of rank to order results.
+            let database = tx.unwrapGrdbRead.database
+
+            // The index content for pending messages is missing or out of
+            // date, so match these messages directly and ignore their rows
+            // in the index. There are at most `maxPendingCount` of them.
+            let pendingUniqueIds = try String.fetchAll(
+                database,
+                sql: "SELECT \(uniqueIdColumn) FROM \(pendingTableName) ORDER BY \(pendingIdColumn) DESC"
+            )
+            let pendingUniqueIdSet = Set(pendingUniqueIds)
+            let pendingResults: [SearchResult]
+            if pendingUniqueIds.isEmpty {
+                pendingResults = []
+            } else {
+                pendingResults = try pendingSearchResults(for: searchText, pendingUniqueIds: pendingUniqueIds, tx: tx)
+            }
+
             let indexOfContentColumnInFTSTable = 0
-            // Determines the length of the snippet.
-            let numTokens: UInt = 15
             let matchSnippet = "match_snippet"
+            let matchRank = "match_rank"
             let sql: String = """
             SELECT
                 \(contentTableName).\(collectionColumn),
                 \(contentTableName).\(uniqueIdColumn),
-                SNIPPET(\(ftsTableName), \(indexOfContentColumnInFTSTable), '<\(matchTag)>', '</\(matchTag)>', '…', \(numTokens)) AS \(matchSnippet)
+                SNIPPET(\(ftsTableName), \(indexOfContentColumnInFTSTable), '<\(matchTag)>', '</\(matchTag)>', '…', \(snippetTokenCount)) AS \(matchSnippet),
+                rank AS \(matchRank)
             FROM \(ftsTableName)
             LEFT JOIN \(contentTableName) ON \(contentTableName).rowId = \(ftsTableName).rowId
             WHERE \(ftsTableName).\(ftsContentColumn) MATCH ?
             ORDER BY rank
-            LIMIT \(maxResults)
+            LIMIT \(maxResults + pendingUniqueIdSet.count)
             """
 
-            let cursor = try Row.fetchCursor(tx.unwrapGrdbRead.database, sql: sql, arguments: [query])
-            while let row = try cursor.next() {
-                let collection: String = row[collectionColumn]
-                guard collection == legacyCollectionName else {
-                    owsFailDebug("Found something other than a message in the FTS table")
-                    continue
-                }
-                guard let uniqueId = (row[uniqueIdColumn] as String).nilIfEmpty else {
-                    owsFailDebug("Found a message with a uniqueId in the FTS table")
-                    continue
+            let cursor = try Row.fetchCursor(database, sql: sql, arguments: [query])
+            func nextIndexedResult() throws -> SearchResult? {
+                while let row = try cursor.next() {
+                    let collection: String = row[collectionColumn]
+                    guard collection == legacyCollectionName else {
+                        owsFailDebug("Found something other than a message in the FTS table")
+                        continue
+                    }
+                    guard let uniqueId = (row[uniqueIdColumn] as String).nilIfEmpty else {
+                        owsFailDebug("Found a message with a uniqueId in the FTS table")
+                        continue
+                    }
+                    guard !pendingUniqueIdSet.contains(uniqueId) else {
+                        continue
+                    }
+                    guard let message = TSMessage.anyFetchMessage(uniqueId: uniqueId, transaction: tx) else {
+                        owsFailDebug("Couldn't find message that exists in the FTS table")
+                        continue
+                    }
+                    return SearchResult(message: message, snippet: row[matchSnippet], rank: row[matchRank])
                 }
-                let snippet: String = row[matchSnippet]
-                guard let message = TSMessage.anyFetchMessage(uniqueId: uniqueId, transaction: tx) else {
-                    owsFailDebug("Couldn't find message that exists in the FTS table")
-                    continue
+                return nil
+            }
+
+            // Merge the pending results into the index's by rank.
+            var resultCount = 0
+            var pendingIndex = pendingResults.startIndex
+            var indexedResult = try nextIndexedResult()
+            while resultCount < maxResults {
+                let result: SearchResult
+                if
+                    pendingIndex < pendingResults.endIndex,
+                    indexedResult.map({ pendingResults[pendingIndex].rank <= $0.rank }) ?? true
+                {
+                    result = pendingResults[pendingIndex]
+                    pendingIndex += 1
+                } else if let nextResult = indexedResult {
+                    result = nextResult
+                    indexedResult = try nextIndexedResult()
+                } else {
+                    break
                 }
+                resultCount += 1
                 var stop = false
-                block(message, snippet, &stop)
+                block(result.message, result.snippet, &stop)
                 if stop {
                     break
                 }
@@ -0,0 +1,90 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import Foundation
+import QuartzCore
+
+/// Records how long threads wait on locks and semaphores.
+///
+/// Waits are aggregated by "site", a short constant name for the lock or
+/// semaphore. It's only enabled in beta and internal builds; otherwise
+/// recording a wait does nothing.
+@objc
+public final class ContentionProfiler: NSObject {
+
+    @objc
+    public static let shared = ContentionProfiler(isEnabled: DebugFlags.contentionProfiling)
+
+    public struct SiteStatistics: Equatable {
+        public fileprivate(set) var waitCount: Int = 0
+        public fileprivate(set) var totalWaitTime: TimeInterval = 0
+        public fileprivate(set) var maxWaitTime: TimeInterval = 0
+    }
+
+    @objc
+    public let isEnabled: Bool
+
+    private let lock = UnfairLock()
+
+    // This property should only be accessed with lock acquired.
+    private var siteStatistics = [String: SiteStatistics]()
+
+    init(isEnabled: Bool) {
+        self.isEnabled = isEnabled
+        super.init()
+    }
+
+    /// Returns a value to pass to `recordWait(site:startTime:)` once the
+    /// wait is over.
+    @objc
+    public static func currentTime() -> CFTimeInterval {
+        return CACurrentMediaTime()
+    }
+
+    @objc
+    public func recordWait(site: String, startTime: CFTimeInterval) {
+        guard isEnabled else {
+            return
+        }
+        let waitTime = max(0, CACurrentMediaTime() - startTime)
+        lock.withLock {
+            var statistics = siteStatistics[site] ?? SiteStatistics()
+            statistics.waitCount += 1
+            statistics.totalWaitTime += waitTime
+            statistics.maxWaitTime = max(statistics.maxWaitTime, waitTime)
+            siteStatistics[site] = statistics
+        }
+    }
+
+    /// Runs `block` (which should wait on `site`) and records the wait.
+    public func measureWait<T>(site: String, _ block: () throws -> T) rethrows -> T {
+        guard isEnabled else {
+            return try block()
+        }
+        let startTime = CACurrentMediaTime()
+        defer { recordWait(site: site, startTime: startTime) }
+        return try block()
+    }
+
+    /// The sites with the most total wait time, worst first.
+    public func worstOffenders(limit: Int) -> [(site: String, statistics: SiteStatistics)] {
+        let siteStatistics = lock.withLock { self.siteStatistics }
+        return siteStatistics
+            .sorted { $0.value.totalWaitTime > $1.value.totalWaitTime }
+            .prefix(limit)
+            .map { (site: $0.key, statistics: $0.value) }
+    }
+
+    public func logWorstOffenders(limit: Int = 10) {
+        guard isEnabled else {
+            return
+        }
+        for (site, statistics) in worstOffenders(limit: limit) {
+            let totalWaitMs = String(format: "%.1f", statistics.totalWaitTime * 1000)
+            let maxWaitMs = String(format: "%.1f", statistics.maxWaitTime * 1000)
+            Logger.info("\(site): \(statistics.waitCount) waits, \(totalWaitMs)ms total, \(maxWaitMs)ms max")
+        }
+    }
+}
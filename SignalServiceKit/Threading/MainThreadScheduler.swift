@@ -0,0 +1,144 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import Foundation
+import QuartzCore
+
+/// Batches small blocks that are dispatched to the main thread.
+///
+/// Dispatching each block separately (thumbnail callbacks, UI updates,
+/// etc.) can flood the main queue during catch-up, and frames are dropped
+/// until it drains. Instead, blocks are queued here and run in slices: each
+/// slice runs queued blocks, higher priorities first, until `sliceBudget`
+/// is used up, then yields the main thread (so that the run loop can commit
+/// a frame) before the next slice.
+///
+/// Blocks enqueued on the main thread run immediately.
+@objc
+public final class MainThreadScheduler: NSObject {
+
+    @objc
+    public static let shared = MainThreadScheduler(sliceBudget: 0.004)
+
+    private let sliceBudget: TimeInterval
+
+    private let lock = UnfairLock()
+
+    // These properties should only be accessed with lock acquired.
+    private var userVisibleBlocks = BlockQueue()
+    private var backgroundBlocks = BlockQueue()
+    private var isSliceScheduled = false
+
+    init(sliceBudget: TimeInterval) {
+        self.sliceBudget = sliceBudget
+        super.init()
+    }
+
+    @objc
+    public func schedule(priority: MainThreadWorkPriority, block: @escaping @MainActor () -> Void) {
+        if Thread.isMainThread {
+            MainActor.assumeIsolated(block)
+            return
+        }
+        let shouldScheduleSlice: Bool = lock.withLock {
+            switch priority {
+            case .userVisible:
+                userVisibleBlocks.append(block)
+            case .background:
+                backgroundBlocks.append(block)
+            }
+            PerformanceCounters.shared.setMainThreadBacklog(userVisibleBlocks.count + backgroundBlocks.count)
+            guard !isSliceScheduled else {
+                return false
+            }
+            isSliceScheduled = true
+            return true
+        }
+        if shouldScheduleSlice {
+            scheduleSlice()
+        }
+    }
+
+    private func scheduleSlice() {
+        DispatchQueue.main.async {
+            self.runSlice()
+        }
+    }
+
+    @MainActor
+    private func runSlice() {
+        let deadline = CACurrentMediaTime() + sliceBudget
+        while true {
+            let block: (@MainActor () -> Void)? = lock.withLock {
+                defer { PerformanceCounters.shared.setMainThreadBacklog(userVisibleBlocks.count + backgroundBlocks.count) }
+                if let block = userVisibleBlocks.popFirst() ?? backgroundBlocks.popFirst() {
+                    return block
+                }
+                isSliceScheduled = false
+                return nil
+            }
+            guard let block else {
+                return
+            }
+            autoreleasepool {
+                block()
+            }
+            if CACurrentMediaTime() >= deadline {
+                break
+            }
+        }
+        // The budget is used up; the remaining blocks (if any) wait for the
+        // next slice.
+        let hasRemainingBlocks: Bool = lock.withLock {
+            guard !userVisibleBlocks.isEmpty || !backgroundBlocks.isEmpty else {
+                isSliceScheduled = false
+                return false
+            }
+            return true
+        }
+        if hasRemainingBlocks {
+            scheduleSlice()
+        }
+    }
+}
+
+// MARK: -
+
+extension MainThreadScheduler {
+
+    /// A FIFO queue of blocks that pops in O(1).
+    ///
+    /// Popped blocks are released immediately; their slots are reclaimed
+    /// once at least half of the storage is popped.
+    fileprivate struct BlockQueue {
+        private var blocks = [(@MainActor () -> Void)?]()
+        private var headIndex = 0
+
+        var count: Int { blocks.count - headIndex }
+
+        var isEmpty: Bool { count == 0 }
+
+        mutating func append(_ block: @escaping @MainActor () -> Void) {
+            blocks.append(block)
+        }
+
+        mutating func popFirst() -> (@MainActor () -> Void)? {
+            guard headIndex < blocks.count else {
+                return nil
+            }
+            let block = blocks[headIndex]
+            blocks[headIndex] = nil
+            headIndex += 1
+            if headIndex == blocks.count {
+                blocks.removeAll(keepingCapacity: true)
+                headIndex = 0
+            } else if headIndex * 2 >= blocks.count {
+                blocks.removeFirst(headIndex)
+                headIndex = 0
+            }
+            return block
+        }
+    }
+}
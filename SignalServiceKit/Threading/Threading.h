@@ -10,10 +10,22 @@ NS_ASSUME_NONNULL_BEGIN
 // main thread.
 void DispatchMainThreadSafeObjc(dispatch_block_t block);
 
-/// Returns YES if the result returned from dispatch_get_current_queue() matches
-/// the provided queue. There's all sorts of different circumstances where these queue
-/// comparisons may fail (queue hierarchies, etc.) so this should only be used optimistically
-/// for perf optimizations. This should never be used to determine if some pattern of block dispatch is deadlock free.
+typedef NS_CLOSED_ENUM(NSInteger, MainThreadWorkPriority) {
+    // Work the user is waiting to see, e.g. on-screen thumbnails.
+    MainThreadWorkPriorityUserVisible,
+    // Everything else; this runs after any user-visible work.
+    MainThreadWorkPriorityBackground,
+};
+
+// Like DispatchMainThreadSafeObjc, but blocks dispatched from other threads
+// are batched by MainThreadScheduler rather than dispatched one at a time.
+void DispatchMainThreadSafeBatchedObjc(MainThreadWorkPriority priority, dispatch_block_t block);
+
+/// Returns YES if the current block is running on the provided queue (or on a queue that
+/// targets it). Queues are tagged with a queue-specific key the first time they're checked;
+/// queues that can't be tagged (the global queues) fall back to dispatch_get_current_queue().
+/// This should only be used optimistically for perf optimizations. This should never be used
+/// to determine if some pattern of block dispatch is deadlock free.
 BOOL DispatchQueueIsCurrentQueue(dispatch_queue_t queue);
 
 /// Returns a value [0.0, 1.0] indicating the proportion of the current thread's stack that's in-use
@@ -16,8 +16,27 @@ void DispatchMainThreadSafeObjc(dispatch_block_t block)
     [ThreadingObjcBridge dispatchMainThreadSafe:block];
 }
 
+void DispatchMainThreadSafeBatchedObjc(MainThreadWorkPriority priority, dispatch_block_t block)
+{
+    OWSCAssertDebug(block);
+
+    [MainThreadScheduler.shared scheduleWithPriority:priority block:block];
+}
+
 BOOL DispatchQueueIsCurrentQueue(dispatch_queue_t testQueue)
 {
+    // Each queue is tagged with its own address as both key and value, so a
+    // queue targeting testQueue (which inherits its specifics) still matches.
+    // The value isn't retained; it's only compared with testQueuePtr.
+    void *testQueuePtr = (__bridge void *)testQueue;
+    if (dispatch_queue_get_specific(testQueue, testQueuePtr) == NULL) {
+        dispatch_queue_set_specific(testQueue, testQueuePtr, testQueuePtr, NULL);
+    }
+    if (dispatch_queue_get_specific(testQueue, testQueuePtr) == testQueuePtr) {
+        return dispatch_get_specific(testQueuePtr) == testQueuePtr;
+    }
+
+    // Global queues can't be tagged.
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wdeprecated-declarations"
     void *currentQueuePtr = (__bridge void *)dispatch_get_current_queue();
@@ -0,0 +1,119 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import Foundation
+
+/// Purges the process-wide in-memory caches when memory runs low, cheapest
+/// to rebuild first.
+///
+/// Each cache still has its own limits (and its own, smaller limits in the
+/// NSE); this only decides who gives memory back under pressure, and when.
+/// The kernel's memory pressure events are delivered to every process,
+/// including the NSE and share extension, which never see UIKit's memory
+/// warnings.
+///
+/// - A memory pressure warning purges placeholder and media caches.
+/// - Critical memory pressure, or a UIKit memory warning, purges every cache.
+public final class CacheCoordinator {
+
+    public static let shared = CacheCoordinator(observesMemoryPressure: true)
+
+    /// The order in which caches are purged.
+    public enum Priority: Int, CaseIterable, Comparable {
+        /// Cheap to recompute, e.g., decoded blurHash placeholders.
+        case placeholder
+        /// Decoded or downloaded media, e.g., thumbnails and avatars.
+        case media
+        /// Database models; purging these costs reads on the hot path.
+        case model
+
+        public static func < (lhs: Self, rhs: Self) -> Bool {
+            return lhs.rawValue < rhs.rawValue
+        }
+    }
+
+    public enum PressureLevel {
+        case warning
+        case critical
+
+        /// The lowest priority that survives a purge at this level.
+        fileprivate var retainedPriority: Priority? {
+            switch self {
+            case .warning:
+                return .model
+            case .critical:
+                return nil
+            }
+        }
+    }
+
+    private struct RegisteredCache {
+        let name: String
+        let priority: Priority
+        let purge: () -> Void
+    }
+
+    private let lock = UnfairLock()
+
+    // This property should only be accessed with lock acquired.
+    private var caches = [RegisteredCache]()
+
+    private var memoryPressureSource: DispatchSourceMemoryPressure?
+
+    init(observesMemoryPressure: Bool) {
+        guard observesMemoryPressure else {
+            return
+        }
+
+        let memoryPressureSource = DispatchSource.makeMemoryPressureSource(
+            eventMask: [.warning, .critical],
+            queue: DispatchQueue(label: "org.signal.cache-coordinator", qos: .utility)
+        )
+        memoryPressureSource.setEventHandler { [weak self, weak memoryPressureSource] in
+            guard let event = memoryPressureSource?.data else {
+                return
+            }
+            self?.purgeCaches(for: event.contains(.critical) ? .critical : .warning)
+        }
+        memoryPressureSource.activate()
+        self.memoryPressureSource = memoryPressureSource
+
+        NotificationCenter.default.addObserver(
+            forName: UIApplication.didReceiveMemoryWarningNotification,
+            object: nil,
+            queue: nil
+        ) { [weak self] _ in
+            self?.purgeCaches(for: .critical)
+        }
+    }
+
+    /// Registers a cache to be purged under memory pressure.
+    ///
+    /// `purge` may be called on any thread. Registrations last for the
+    /// lifetime of the process, so `purge` shouldn't retain its cache unless
+    /// the cache is a singleton.
+    public func register(name: String, priority: Priority, purge: @escaping () -> Void) {
+        lock.withLock {
+            caches.append(RegisteredCache(name: name, priority: priority, purge: purge))
+        }
+    }
+
+    func purgeCaches(for pressureLevel: PressureLevel) {
+        let caches = lock.withLock { self.caches }
+        let cachesToPurge = caches
+            .filter { cache in
+                guard let retainedPriority = pressureLevel.retainedPriority else {
+                    return true
+                }
+                return cache.priority < retainedPriority
+            }
+            .sorted { $0.priority < $1.priority }
+
+        Logger.info("Purging caches for \(pressureLevel) memory pressure: \(cachesToPurge.map(\.name).joined(separator: ", "))")
+        for cache in cachesToPurge {
+            cache.purge()
+        }
+    }
+}
@@ -106,6 +106,8 @@ public enum DebugFlags {
 
     public static let betaLogging = build.includes(.beta)
 
+    public static let contentionProfiling = build.includes(.beta)
+
     public static let testPopulationErrorAlerts = build.includes(.beta)
 
     public static let audibleErrorLogging = build.includes(.internal)
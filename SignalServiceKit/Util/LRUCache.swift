@@ -63,7 +63,8 @@ public class AnyLRUCache: NSObject {
 
 // MARK: -
 
-// A simple LRU cache bounded by the number of entries.
+// A simple LRU cache bounded by the number of entries and, optionally,
+// by the total cost of its entries.
 public class LRUCache<KeyType: Hashable & Equatable, ValueType> {
 
     private let cache = NSCache<AnyObject, AnyObject>()
@@ -71,6 +72,12 @@ public class LRUCache<KeyType: Hashable & Equatable, ValueType> {
     public var resetCount: UInt {
         _resetCount.get()
     }
+    private let evictionCounter = LRUCacheEvictionCounter()
+    /// The approximate number of entries that NSCache has evicted, either
+    /// because a limit was reached or because of memory pressure.
+    public var evictionCount: UInt {
+        evictionCounter.evictionCount.get()
+    }
     public var maxSize: Int {
         get {
             return cache.countLimit
@@ -80,10 +87,19 @@ public class LRUCache<KeyType: Hashable & Equatable, ValueType> {
         }
     }
 
+    public var totalCostLimit: Int {
+        cache.totalCostLimit
+    }
+
+    /// - Parameter totalCostLimit: If non-zero, entries are evicted once the
+    ///   total of the costs passed to `set(key:value:cost:)` exceeds it.
     public init(maxSize: Int,
                 nseMaxSize: Int = 0,
+                totalCostLimit: Int = 0,
                 shouldEvacuateInBackground: Bool = false) {
         self.cache.countLimit = CurrentAppContext().isNSE ? nseMaxSize : maxSize
+        self.cache.totalCostLimit = totalCostLimit
+        self.cache.delegate = evictionCounter
 
         if CurrentAppContext().isMainApp,
            shouldEvacuateInBackground {
@@ -113,6 +129,10 @@ public class LRUCache<KeyType: Hashable & Equatable, ValueType> {
     }
 
     public func set(key: KeyType, value: ValueType) {
+        set(key: key, value: value, cost: 0)
+    }
+
+    public func set(key: KeyType, value: ValueType, cost: Int) {
         if value is NSNull {
             owsFailDebug("Nil value.")
             remove(key: key)
@@ -121,7 +141,7 @@ public class LRUCache<KeyType: Hashable & Equatable, ValueType> {
         guard cache.countLimit > 0 else {
             return
         }
-        cache.setObject(value as AnyObject, forKey: key as AnyObject)
+        cache.setObject(value as AnyObject, forKey: key as AnyObject, cost: cost)
     }
 
     public func remove(key: KeyType) {
@@ -132,9 +152,11 @@ public class LRUCache<KeyType: Hashable & Equatable, ValueType> {
     public func clear() {
         _resetCount.increment()
 
+        evictionCounter.clearDepth.increment()
         autoreleasepool {
             cache.removeAllObjects()
         }
+        evictionCounter.clearDepth.decrementOrZero()
     }
 
     public subscript(key: KeyType) -> ValueType? {
@@ -171,6 +193,22 @@ public class LRUCache<KeyType: Hashable & Equatable, ValueType> {
 
 // MARK: -
 
+private class LRUCacheEvictionCounter: NSObject, NSCacheDelegate {
+    let evictionCount = AtomicUInt(0, lock: .sharedGlobal)
+    /// NSCache also notifies its delegate about entries removed by
+    /// `removeAllObjects()`; those aren't evictions.
+    let clearDepth = AtomicUInt(0, lock: .sharedGlobal)
+
+    func cache(_ cache: NSCache<AnyObject, AnyObject>, willEvictObject obj: Any) {
+        guard clearDepth.get() == 0 else {
+            return
+        }
+        evictionCount.increment()
+    }
+}
+
+// MARK: -
+
 // NSCache sometimes evacuates entries off the main thread.
 // Some cached entities should only be deallocated on the main thread.
 // This handle can be used to ensure that cache entries are released
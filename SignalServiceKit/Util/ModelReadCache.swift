@@ -50,15 +50,44 @@ class ModelCacheAdapter<KeyType: Hashable & Equatable, ValueType> {
         fatalError("Unimplemented")
     }
 
+    /// The approximate number of bytes used by a cached value. Only used if
+    /// the adapter has a `cacheCostLimit`.
+    func estimatedCost(value: ValueType) -> Int {
+        return 0
+    }
+
     let cacheName: String
 
     let cacheCountLimit: Int
     let cacheCountLimitNSE: Int
+    /// If non-zero, the cache is also bounded by the total estimated cost
+    /// of its values.
+    let cacheCostLimit: Int
 
-    init(cacheName: String, cacheCountLimit: Int, cacheCountLimitNSE: Int) {
+    init(cacheName: String, cacheCountLimit: Int, cacheCountLimitNSE: Int, cacheCostLimit: Int = 0) {
         self.cacheName = cacheName
         self.cacheCountLimit = cacheCountLimit
         self.cacheCountLimitNSE = cacheCountLimitNSE
+        self.cacheCostLimit = cacheCostLimit
+    }
+}
+
+// MARK: -
+
+public struct ModelReadCacheStatistics {
+    public let cacheName: String
+    public let hitCount: UInt64
+    public let missCount: UInt64
+    public let evictionCount: UInt
+    public let countLimit: Int
+    public let costLimit: Int
+
+    public var hitRate: Double {
+        let lookupCount = hitCount + missCount
+        guard lookupCount > 0 else {
+            return 0
+        }
+        return Double(hitCount) / Double(lookupCount)
     }
 }
 
@@ -107,6 +136,10 @@ class ModelReadCache<KeyType: Hashable & Equatable, ValueType> {
 
     private let disableCachesInNSE = true
 
+    // These properties should only be accessed within performSync().
+    private var hitCount: UInt64 = 0
+    private var missCount: UInt64 = 0
+
     init(
         mode: Mode,
         adapter: ModelCacheAdapter<KeyType, ValueType>,
@@ -116,7 +149,8 @@ class ModelReadCache<KeyType: Hashable & Equatable, ValueType> {
         self.mode = mode
         self.adapter = adapter
         self.cache = LRUCache(maxSize: adapter.cacheCountLimit,
-                              nseMaxSize: disableCachesInNSE ? 0 : adapter.cacheCountLimitNSE)
+                              nseMaxSize: disableCachesInNSE ? 0 : adapter.cacheCountLimitNSE,
+                              totalCostLimit: adapter.cacheCostLimit)
 
         switch mode {
         case .read:
@@ -132,10 +166,25 @@ class ModelReadCache<KeyType: Hashable & Equatable, ValueType> {
                 name: ModelReadCaches.evacuateAllModelCaches,
                 object: nil
             )
+            CacheCoordinator.shared.register(name: logName, priority: .model) { [weak self] in
+                self?.evacuateCache()
+            }
         }
     }
 
-    private func evacuateCache() {
+    var statistics: ModelReadCacheStatistics {
+        let (hitCount, missCount) = performSync { (self.hitCount, self.missCount) }
+        return ModelReadCacheStatistics(
+            cacheName: cacheName,
+            hitCount: hitCount,
+            missCount: missCount,
+            evictionCount: cache.evictionCount,
+            countLimit: cache.maxSize,
+            costLimit: cache.totalCostLimit
+        )
+    }
+
+    func evacuateCache() {
         // Right now, we call `cache.removeAllObjects()` on background threads. For
         // now, this is OK because LRUCache is thread safe, but if we ever do more
         // work here we should re-evaluate.
@@ -241,6 +290,9 @@ class ModelReadCache<KeyType: Hashable & Equatable, ValueType> {
 
         return performSync {
             let maybeValues = self.cachedValues(for: cacheKeys, transaction: transaction)
+            let hitCount = maybeValues.lazy.filter { $0 != nil }.count
+            self.hitCount += UInt64(hitCount)
+            self.missCount += UInt64(maybeValues.count - hitCount)
             let keyValueTuples = Array(zip(cacheKeys, maybeValues))
             typealias KeyValuePair = (ModelCacheKey<KeyType>, ModelCacheValueBox<ValueType>?)
             return Refinery<KeyValuePair, ValueType>(keyValueTuples).refine { (entry: KeyValuePair) -> Bool in
@@ -385,7 +437,8 @@ class ModelReadCache<KeyType: Hashable & Equatable, ValueType> {
     // MARK: -
 
     func writeToCache(cacheKey: ModelCacheKey<KeyType>, value: ValueType?) {
-        cache.setObject(ModelCacheValueBox(value: value), forKey: cacheKey.key)
+        let cost = value.map { adapter.estimatedCost(value: $0) } ?? 0
+        cache.set(key: cacheKey.key, value: ModelCacheValueBox(value: value), cost: cost)
     }
 
     func readFromCache(cacheKey: ModelCacheKey<KeyType>) -> ModelCacheValueBox<ValueType>? {
@@ -526,9 +579,28 @@ public class ThreadReadCache: NSObject {
     private let cache: ModelReadCache<KeyType, ValueType>
     private let adapter = Adapter(cacheName: "TSThread", cacheCountLimit: 32, cacheCountLimitNSE: 8)
 
+    var statistics: ModelReadCacheStatistics {
+        cache.statistics
+    }
+
     @objc
     public init(_ factory: ModelReadCacheFactory) {
         cache = factory.create(mode: .read, adapter: adapter)
+
+        super.init()
+
+        for name in [
+            SDSDatabaseStorage.didReceiveCrossProcessNotificationAlwaysSync,
+            ModelReadCaches.evacuateAllModelCaches,
+            NSNotification.Name.registrationStateDidChange,
+        ] {
+            NotificationCenter.default.addObserver(
+                self,
+                selector: #selector(evacuateRecipientSnapshots),
+                name: name,
+                object: nil
+            )
+        }
     }
 
     @objc(getThreadForUniqueId:transaction:)
@@ -546,20 +618,110 @@ public class ThreadReadCache: NSObject {
         }))
     }
 
+    /// Removes every cached thread and recipient snapshot.
+    func evacuate() {
+        cache.evacuateCache()
+        evacuateRecipientSnapshots()
+    }
+
     @objc(didRemoveThread:transaction:)
     public func didRemove(thread: TSThread, transaction: SDSAnyWriteTransaction) {
         cache.didRemove(value: thread, transaction: transaction)
+        didWriteRecipients(nil, forThreadUniqueId: thread.uniqueId, transaction: transaction)
     }
 
     @objc(didInsertOrUpdateThread:transaction:)
     public func didInsertOrUpdate(thread: TSThread, transaction: SDSAnyWriteTransaction) {
         cache.didInsertOrUpdate(value: thread, transaction: transaction)
+        // Story recipients are expensive to compute, so those are only
+        // invalidated and are reloaded when next needed.
+        let recipientAddresses = thread is TSPrivateStoryThread ? nil : thread.recipientAddresses(with: transaction)
+        didWriteRecipients(recipientAddresses, forThreadUniqueId: thread.uniqueId, transaction: transaction)
     }
 
     @objc
     public func didReadThread(_ thread: TSThread, transaction: SDSAnyReadTransaction) {
         cache.didRead(value: thread, transaction: transaction)
     }
+
+    // MARK: - Recipient Snapshots
+
+    /// The committed recipients of recently-used threads, so that callers
+    /// (often UI code on the main thread) can get them without waiting for a
+    /// read transaction while the database is busy writing.
+    private struct RecipientSnapshots {
+        var recipientAddresses = [String: [SignalServiceAddress]]()
+        /// Incremented whenever a write commits, so that reads which raced
+        /// with a write aren't published.
+        var generation = 0
+    }
+
+    private static let maxRecipientSnapshotCount = 256
+
+    private let recipientSnapshots = AtomicValue<RecipientSnapshots>(RecipientSnapshots(), lock: .init())
+
+    /// Returns the recipients of the thread, if they're known.
+    @objc
+    public func recipientAddressesSnapshot(forThreadUniqueId threadUniqueId: String) -> [SignalServiceAddress]? {
+        return recipientSnapshots.get().recipientAddresses[threadUniqueId]
+    }
+
+    /// Returns a token to pass to `didReadRecipients`; get it before the read
+    /// transaction is opened.
+    @objc
+    public func recipientSnapshotGeneration() -> Int {
+        return recipientSnapshots.get().generation
+    }
+
+    @objc
+    public func didReadRecipients(
+        _ recipientAddresses: [SignalServiceAddress],
+        forThreadUniqueId threadUniqueId: String,
+        generation: Int
+    ) {
+        recipientSnapshots.update { snapshots in
+            guard snapshots.generation == generation else {
+                return
+            }
+            Self.setRecipients(recipientAddresses, forThreadUniqueId: threadUniqueId, in: &snapshots)
+        }
+    }
+
+    private func didWriteRecipients(
+        _ recipientAddresses: [SignalServiceAddress]?,
+        forThreadUniqueId threadUniqueId: String,
+        transaction: SDSAnyWriteTransaction
+    ) {
+        transaction.addSyncCompletion { [recipientSnapshots] in
+            recipientSnapshots.update { snapshots in
+                snapshots.generation += 1
+                Self.setRecipients(recipientAddresses, forThreadUniqueId: threadUniqueId, in: &snapshots)
+            }
+        }
+    }
+
+    private static func setRecipients(
+        _ recipientAddresses: [SignalServiceAddress]?,
+        forThreadUniqueId threadUniqueId: String,
+        in snapshots: inout RecipientSnapshots
+    ) {
+        guard let recipientAddresses else {
+            snapshots.recipientAddresses.removeValue(forKey: threadUniqueId)
+            return
+        }
+        if snapshots.recipientAddresses.count >= maxRecipientSnapshotCount {
+            snapshots.recipientAddresses.removeAll()
+        }
+        snapshots.recipientAddresses[threadUniqueId] = recipientAddresses
+    }
+
+    @objc
+    private func evacuateRecipientSnapshots() {
+        recipientSnapshots.update { snapshots in
+            snapshots.generation += 1
+            snapshots.recipientAddresses.removeAll()
+        }
+    }
 }
 
 // MARK: -
@@ -587,10 +749,25 @@ public class InteractionReadCache: NSObject {
         override func copy(value: ValueType) throws -> ValueType {
             return try DeepCopies.deepCopy(value)
         }
+
+        override func estimatedCost(value: ValueType) -> Int {
+            // Long text messages dominate the size of most interactions.
+            let bodyCost = (value as? TSMessage)?.body?.utf8.count ?? 0
+            return 1024 + bodyCost
+        }
     }
 
     private let cache: ModelReadCache<KeyType, ValueType>
-    private let adapter = Adapter(cacheName: "TSInteraction", cacheCountLimit: 1024, cacheCountLimitNSE: 32)
+    private let adapter = Adapter(
+        cacheName: "TSInteraction",
+        cacheCountLimit: 1024,
+        cacheCountLimitNSE: 32,
+        cacheCostLimit: 4 * 1024 * 1024
+    )
+
+    var statistics: ModelReadCacheStatistics {
+        cache.statistics
+    }
 
     @objc
     public init(_ factory: ModelReadCacheFactory) {
@@ -607,6 +784,12 @@ public class InteractionReadCache: NSObject {
         return cache.getValuesIfInCache(for: uniqueIds, transaction: transaction)
     }
 
+    /// Removes every cached interaction, for changes made with SQL that
+    /// bypasses the models.
+    func evacuate() {
+        cache.evacuateCache()
+    }
+
     @objc(didRemoveInteraction:transaction:)
     public func didRemove(interaction: TSInteraction, transaction: SDSAnyWriteTransaction) {
         cache.didRemove(value: interaction, transaction: transaction)
@@ -657,6 +840,10 @@ public class AttachmentReadCache: NSObject {
     private let cache: ModelReadCache<KeyType, ValueType>
     private let adapter = Adapter(cacheName: "TSAttachment", cacheCountLimit: 256, cacheCountLimitNSE: 16)
 
+    var statistics: ModelReadCacheStatistics {
+        cache.statistics
+    }
+
     @objc
     public init(_ factory: ModelReadCacheFactory) {
         cache = factory.create(mode: .read, adapter: adapter)
@@ -725,6 +912,10 @@ public class InstalledStickerCache: NSObject {
                                   cacheCountLimit: InstalledStickerCache.cacheCountLimit,
                                   cacheCountLimitNSE: 8)
 
+    var statistics: ModelReadCacheStatistics {
+        cache.statistics
+    }
+
     @objc
     public init(_ factory: ModelReadCacheFactory) {
         cache = factory.create(mode: .read, adapter: adapter)
@@ -754,6 +945,138 @@ public class InstalledStickerCache: NSObject {
 
 // MARK: -
 
+/// Caches configurations by thread unique id (or the universal timer's
+/// key). Every message that's built or received reads its thread's
+/// configuration, and most threads have none, so misses are cached too.
+@objc
+public class DisappearingMessagesConfigurationReadCache: NSObject {
+    typealias KeyType = String
+    typealias ValueType = OWSDisappearingMessagesConfiguration
+
+    private class Adapter: ModelCacheAdapter<KeyType, ValueType> {
+        override func read(key: KeyType, transaction: SDSAnyReadTransaction) -> ValueType? {
+            return OWSDisappearingMessagesConfiguration.anyFetch(uniqueId: key,
+                                                                 transaction: transaction,
+                                                                 ignoreCache: true)
+        }
+
+        override func key(forValue value: ValueType) -> KeyType {
+            value.uniqueId
+        }
+
+        override func cacheKey(forKey key: KeyType) -> ModelCacheKey<KeyType> {
+            return ModelCacheKey(key: key)
+        }
+
+        override func copy(value: ValueType) throws -> ValueType {
+            return try DeepCopies.deepCopy(value)
+        }
+    }
+
+    private let cache: ModelReadCache<KeyType, ValueType>
+    private let adapter = Adapter(cacheName: "OWSDisappearingMessagesConfiguration", cacheCountLimit: 256, cacheCountLimitNSE: 16)
+
+    var statistics: ModelReadCacheStatistics {
+        cache.statistics
+    }
+
+    @objc
+    public init(_ factory: ModelReadCacheFactory) {
+        cache = factory.create(mode: .read, adapter: adapter)
+    }
+
+    @objc(getConfigurationForUniqueId:transaction:)
+    public func getConfiguration(uniqueId: String, transaction: SDSAnyReadTransaction) -> OWSDisappearingMessagesConfiguration? {
+        let cacheKey = adapter.cacheKey(forKey: uniqueId)
+        return cache.getValue(for: cacheKey, transaction: transaction)
+    }
+
+    @objc(didRemoveConfiguration:transaction:)
+    public func didRemove(configuration: OWSDisappearingMessagesConfiguration, transaction: SDSAnyWriteTransaction) {
+        cache.didRemove(value: configuration, transaction: transaction)
+    }
+
+    @objc(didInsertOrUpdateConfiguration:transaction:)
+    public func didInsertOrUpdate(configuration: OWSDisappearingMessagesConfiguration, transaction: SDSAnyWriteTransaction) {
+        cache.didInsertOrUpdate(value: configuration, transaction: transaction)
+    }
+
+    @objc
+    public func didReadConfiguration(_ configuration: OWSDisappearingMessagesConfiguration, transaction: SDSAnyReadTransaction) {
+        cache.didRead(value: configuration, transaction: transaction)
+    }
+}
+
+// MARK: -
+
+/// Caches identities by recipient unique id. Every encryption and
+/// decryption checks the peer's identity.
+@objc
+public class RecipientIdentityReadCache: NSObject {
+    typealias KeyType = String
+    typealias ValueType = OWSRecipientIdentity
+
+    private class Adapter: ModelCacheAdapter<KeyType, ValueType> {
+        override func read(key: KeyType, transaction: SDSAnyReadTransaction) -> ValueType? {
+            return OWSRecipientIdentity.anyFetch(uniqueId: key,
+                                                 transaction: transaction,
+                                                 ignoreCache: true)
+        }
+
+        override func key(forValue value: ValueType) -> KeyType {
+            value.uniqueId
+        }
+
+        override func cacheKey(forKey key: KeyType) -> ModelCacheKey<KeyType> {
+            return ModelCacheKey(key: key)
+        }
+
+        override func copy(value: ValueType) throws -> ValueType {
+            return try DeepCopies.deepCopy(value)
+        }
+    }
+
+    private let cache: ModelReadCache<KeyType, ValueType>
+    // Large enough to hold the members of a large group.
+    private let adapter = Adapter(cacheName: "OWSRecipientIdentity", cacheCountLimit: 1024, cacheCountLimitNSE: 32)
+
+    var statistics: ModelReadCacheStatistics {
+        cache.statistics
+    }
+
+    @objc
+    public init(_ factory: ModelReadCacheFactory) {
+        cache = factory.create(mode: .read, adapter: adapter)
+    }
+
+    @objc(getRecipientIdentityForUniqueId:transaction:)
+    public func getRecipientIdentity(uniqueId: String, transaction: SDSAnyReadTransaction) -> OWSRecipientIdentity? {
+        let cacheKey = adapter.cacheKey(forKey: uniqueId)
+        return cache.getValue(for: cacheKey, transaction: transaction)
+    }
+
+    public func getRecipientIdentitiesIfInCache(forUniqueIds uniqueIds: [String], transaction: SDSAnyReadTransaction) -> [String: OWSRecipientIdentity] {
+        return cache.getValuesIfInCache(for: uniqueIds, transaction: transaction)
+    }
+
+    @objc(didRemoveRecipientIdentity:transaction:)
+    public func didRemove(recipientIdentity: OWSRecipientIdentity, transaction: SDSAnyWriteTransaction) {
+        cache.didRemove(value: recipientIdentity, transaction: transaction)
+    }
+
+    @objc(didInsertOrUpdateRecipientIdentity:transaction:)
+    public func didInsertOrUpdate(recipientIdentity: OWSRecipientIdentity, transaction: SDSAnyWriteTransaction) {
+        cache.didInsertOrUpdate(value: recipientIdentity, transaction: transaction)
+    }
+
+    @objc
+    public func didReadRecipientIdentity(_ recipientIdentity: OWSRecipientIdentity, transaction: SDSAnyReadTransaction) {
+        cache.didRead(value: recipientIdentity, transaction: transaction)
+    }
+}
+
+// MARK: -
+
 @objc
 public class ModelReadCaches: NSObject {
     @objc(initWithModelReadCacheFactory:)
@@ -762,6 +1085,8 @@ public class ModelReadCaches: NSObject {
         interactionReadCache = InteractionReadCache(factory)
         attachmentReadCache = AttachmentReadCache(factory)
         installedStickerCache = InstalledStickerCache(factory)
+        disappearingMessagesConfigurationReadCache = DisappearingMessagesConfigurationReadCache(factory)
+        recipientIdentityReadCache = RecipientIdentityReadCache(factory)
     }
 
     @objc
@@ -772,14 +1097,35 @@ public class ModelReadCaches: NSObject {
     public let attachmentReadCache: AttachmentReadCache
     @objc
     public let installedStickerCache: InstalledStickerCache
+    @objc
+    public let disappearingMessagesConfigurationReadCache: DisappearingMessagesConfigurationReadCache
+    @objc
+    public let recipientIdentityReadCache: RecipientIdentityReadCache
 
     @objc
-    fileprivate static let evacuateAllModelCaches = Notification.Name("EvacuateAllModelCaches")
+    static let evacuateAllModelCaches = Notification.Name("EvacuateAllModelCaches")
 
     @objc
     public func evacuateAllCaches() {
         NotificationCenter.default.post(name: Self.evacuateAllModelCaches, object: nil)
     }
+
+    public var statistics: [ModelReadCacheStatistics] {
+        return [
+            threadReadCache.statistics,
+            interactionReadCache.statistics,
+            attachmentReadCache.statistics,
+            installedStickerCache.statistics,
+            disappearingMessagesConfigurationReadCache.statistics,
+            recipientIdentityReadCache.statistics,
+        ]
+    }
+
+    public func logStatistics() {
+        for statistics in self.statistics {
+            Logger.info("\(statistics.cacheName): hits: \(statistics.hitCount), misses: \(statistics.missCount), hit rate: \(String(format: "%.2f", statistics.hitRate)), evictions: \(statistics.evictionCount), count limit: \(statistics.countLimit), cost limit: \(statistics.costLimit)")
+        }
+    }
 }
 
 class TestableModelReadCache<KeyType: Hashable & Equatable, ValueType>: ModelReadCache<KeyType, ValueType> {
@@ -9,7 +9,7 @@ import GRDB
 @objc
 public class SSKPreferences: NSObject {
 
-    public static let store = SDSKeyValueStore(collection: "SSKPreferences")
+    public static let store = SDSKeyValueStore(collection: "SSKPreferences", isCached: true)
 
     private var store: SDSKeyValueStore {
         return SSKPreferences.store
@@ -55,23 +55,15 @@ public class SSKPreferences: NSObject {
     }
 
     private let hasSavedThreadKey = "hasSavedThread"
-    // Only access this queue within db transactions.
-    private var hasSavedThreadCache: Bool?
 
     @objc
     public func hasSavedThread(transaction: SDSAnyReadTransaction) -> Bool {
-        if let value = hasSavedThreadCache {
-            return value
-        }
-        let value = store.getBool(hasSavedThreadKey, defaultValue: false, transaction: transaction)
-        hasSavedThreadCache = value
-        return value
+        return store.getBool(hasSavedThreadKey, defaultValue: false, transaction: transaction)
     }
 
     @objc
     public func setHasSavedThread(_ newValue: Bool, transaction: SDSAnyWriteTransaction) {
         store.setBool(newValue, key: hasSavedThreadKey, transaction: transaction)
-        hasSavedThreadCache = newValue
     }
 
     // MARK: -
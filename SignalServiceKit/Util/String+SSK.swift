@@ -791,6 +791,16 @@ public extension String {
     }
 
     func trimmedIfNeeded(maxByteCount: Int) -> String? {
+        // This is O(1) for native strings.
+        if self.utf8.count <= maxByteCount {
+            return nil
+        }
+        let asciiByteCount = self.utf8.withContiguousStorageIfAvailable {
+            Self.trimmedByteCountIfAscii($0, maxByteCount: maxByteCount)
+        }
+        if let asciiByteCount = asciiByteCount ?? nil {
+            return String(self[..<self.utf8.index(self.utf8.startIndex, offsetBy: asciiByteCount)])
+        }
         var utf8Count = 0
         for index in self.indices {
             utf8Count += self[index].utf8.count
@@ -804,6 +814,39 @@ public extension String {
     func trimToUtf8ByteCount(_ maxByteCount: Int) -> String {
         return self.trimmedIfNeeded(maxByteCount: maxByteCount) ?? self
     }
+
+    /// If the bytes up to and including the first one past `maxByteCount` are
+    /// all ASCII, returns the byte count `trimmedIfNeeded(maxByteCount:)`
+    /// trims to without walking the string's characters.
+    ///
+    /// Every ASCII byte is its own character except for "\r\n", and a
+    /// non-ASCII byte could extend the last character (e.g. a combining
+    /// accent), which is why the byte past the limit must be checked too.
+    private static func trimmedByteCountIfAscii(_ bytes: UnsafeBufferPointer<UInt8>, maxByteCount: Int) -> Int? {
+        guard maxByteCount >= 0, bytes.count > maxByteCount, let baseAddress = bytes.baseAddress else {
+            return nil
+        }
+        let checkedByteCount = maxByteCount + 1
+        let rawBytes = UnsafeRawPointer(baseAddress)
+        var offset = 0
+        // Check 8 bytes at a time.
+        while offset + 8 <= checkedByteCount {
+            if rawBytes.loadUnaligned(fromByteOffset: offset, as: UInt64.self) & 0x8080_8080_8080_8080 != 0 {
+                return nil
+            }
+            offset += 8
+        }
+        while offset < checkedByteCount {
+            if bytes[offset] & 0x80 != 0 {
+                return nil
+            }
+            offset += 1
+        }
+        if maxByteCount > 0, bytes[maxByteCount - 1] == UInt8(ascii: "\r"), bytes[maxByteCount] == UInt8(ascii: "\n") {
+            return maxByteCount - 1
+        }
+        return maxByteCount
+    }
 }
 
 @objc
@@ -825,6 +868,11 @@ public extension NSString {
     }
 
     func trimToUtf8ByteCount(_ maxByteCount: Int) -> String {
+        // Each UTF-16 code unit encodes to at most 3 UTF-8 bytes, so short
+        // strings don't need to be measured, let alone bridged and walked.
+        if self.length <= maxByteCount / 3 || self.lengthOfBytes(using: String.Encoding.utf8.rawValue) <= maxByteCount {
+            return self as String
+        }
         return (self as String).trimToUtf8ByteCount(maxByteCount)
     }
 }
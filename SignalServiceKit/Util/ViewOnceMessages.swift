@@ -43,9 +43,11 @@ public class ViewOnceMessages: NSObject {
         SSKEnvironment.shared.databaseStorageRef.write { (transaction) in
             let messages = ViewOnceMessageFinder()
                 .allMessagesWithViewOnceMessage(transaction: transaction)
-            for message in messages {
-                completeIfNecessary(message: message, transaction: transaction)
-            }
+            markAsComplete(
+                messages: messages.filter { shouldComplete(message: $0) },
+                sendSyncMessages: true,
+                transaction: transaction
+            )
         }
 
         // We need to "check for auto-completion" once per day.
@@ -58,28 +60,32 @@ public class ViewOnceMessages: NSObject {
     public class func completeIfNecessary(message: TSMessage,
                                           transaction: SDSAnyWriteTransaction) {
 
+        guard shouldComplete(message: message) else {
+            return
+        }
+        markAsComplete(message: message,
+                       sendSyncMessages: true,
+                       transaction: transaction)
+    }
+
+    private class func shouldComplete(message: TSMessage) -> Bool {
         guard message.isViewOnceMessage,
             !message.isViewOnceComplete else {
-            return
+            return false
         }
 
         // If message should auto-complete, complete.
         guard !shouldMessageAutoComplete(message) else {
-            markAsComplete(message: message,
-                           sendSyncMessages: true,
-                           transaction: transaction)
-            return
+            return true
         }
 
         // If outgoing message and is "sent", complete.
         guard !isOutgoingSent(message: message) else {
-            markAsComplete(message: message,
-                           sendSyncMessages: true,
-                           transaction: transaction)
-            return
+            return true
         }
 
         // Message should not yet complete.
+        return false
     }
 
     private class func isOutgoingSent(message: TSMessage) -> Bool {
@@ -122,6 +128,28 @@ public class ViewOnceMessages: NSObject {
         }
     }
 
+    /// Like `markAsComplete(message:sendSyncMessages:transaction:)` for each
+    /// of `messages`, but removes their renderable content as a batch.
+    public class func markAsComplete(messages: [TSMessage],
+                                     sendSyncMessages: Bool,
+                                     transaction: SDSAnyWriteTransaction) {
+        let messages = messages.filter { message in
+            guard message.isViewOnceMessage else {
+                owsFailDebug("Not a view-once message.")
+                return false
+            }
+            // Skip messages that are already complete.
+            return !message.isViewOnceComplete
+        }
+        TSMessage.updateWithViewOnceCompleteAndRemoveRenderableContent(messages, tx: transaction)
+
+        if sendSyncMessages {
+            for message in messages {
+                sendSyncMessage(forMessage: message, transaction: transaction)
+            }
+        }
+    }
+
     // MARK: - Sync Messages
 
     private class func sendSyncMessage(forMessage message: TSMessage,
@@ -314,6 +314,21 @@ final class CallRecordQuerierTest: XCTestCase {
         }
     }
 
+    func testCountUnreadByCallStatus() {
+        _ = insertCallRecordsForThread(callStatuses: [.group(.ringingMissed)], unreadStatus: .unread)
+        _ = insertCallRecordsForThread(callStatuses: [.group(.ringingMissed)], unreadStatus: .read)
+        _ = insertCallRecordsForThread(callStatuses: [.group(.ringingMissed)], unreadStatus: .unread)
+        _ = insertCallRecordsForThread(callStatuses: [.individual(.incomingMissed)], unreadStatus: .unread)
+
+        inMemoryDB.read { tx in
+            XCTAssertEqual(callRecordQuerier.countUnread(callStatus: .group(.ringingMissed), tx: tx), 2)
+            assertExplanation(contains: "CallRecord_callStatus_unreadStatus_callBeganTimestamp")
+
+            XCTAssertEqual(callRecordQuerier.countUnread(callStatus: .individual(.incomingMissed), tx: tx), 1)
+            XCTAssertEqual(callRecordQuerier.countUnread(callStatus: .individual(.notAccepted), tx: tx), 0)
+        }
+    }
+
     func testFetchUnreadByCallStatusInConversation() {
         /// This is a contrived scenario, since we won't in practice have an
         /// unread `.group(.ringingDeclined)` call, but it's useful here to test
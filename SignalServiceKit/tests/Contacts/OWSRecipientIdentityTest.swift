@@ -168,4 +168,35 @@ class OWSRecipientIdentityTest: SSKBaseTest {
             XCTAssertFalse(identityManager.groupContainsUnverifiedMember(groupThread.uniqueId, tx: tx.asV2Read))
         }
     }
+
+    func testBatchFetch() {
+        let unknownAci = Aci.randomForTesting()
+        // The second pass is served by the identity cache.
+        for _ in 0..<2 {
+            read { tx in
+                let recipientIdentities = identityManager.recipientIdentities(for: [aliceAci, bobAci, unknownAci], tx: tx.asV2Read)
+                XCTAssertEqual(Set(recipientIdentities.keys), [aliceAci, bobAci])
+                XCTAssertEqual(recipientIdentities[aliceAci]?.identityKey, identityKey(aliceAci))
+                XCTAssertEqual(recipientIdentities[bobAci]?.identityKey, identityKey(bobAci))
+            }
+        }
+    }
+
+    func testVerificationStateIsWrittenThrough() {
+        read { tx in
+            XCTAssertEqual(identityManager.verificationState(for: SignalServiceAddress(aliceAci), tx: tx.asV2Read), .implicit(isAcknowledged: false))
+        }
+        write { tx in
+            _ = identityManager.setVerificationState(
+                .verified,
+                of: identityKey(aliceAci),
+                for: SignalServiceAddress(aliceAci),
+                isUserInitiatedChange: true,
+                tx: tx.asV2Write
+            )
+        }
+        read { tx in
+            XCTAssertEqual(identityManager.verificationState(for: SignalServiceAddress(aliceAci), tx: tx.asV2Read), .verified)
+        }
+    }
 }
@@ -40,4 +40,76 @@ class TSContactThreadTest: SSKBaseTest {
     func testCanSendChatMessagesToThread() {
         XCTAssertTrue(contactThread().canSendChatMessagesToThread())
     }
+
+    func testLastVisibleInteraction() {
+        let contactThread = self.contactThread()
+        let lastVisibleInteraction = TSThread.LastVisibleInteraction(sortId: 3, onScreenPercentage: 0.5)
+
+        SSKEnvironment.shared.databaseStorageRef.write { tx in
+            XCTAssertNil(contactThread.lastVisibleInteraction(transaction: tx))
+            contactThread.setLastVisibleInteraction(lastVisibleInteraction, transaction: tx)
+            XCTAssertEqual(contactThread.lastVisibleInteraction(transaction: tx), lastVisibleInteraction)
+        }
+        SSKEnvironment.shared.databaseStorageRef.read { tx in
+            XCTAssertEqual(contactThread.lastVisibleInteraction(transaction: tx), lastVisibleInteraction)
+        }
+        SSKEnvironment.shared.databaseStorageRef.write { tx in
+            contactThread.clearLastVisibleInteraction(transaction: tx)
+            XCTAssertFalse(contactThread.hasLastVisibleInteraction(transaction: tx))
+        }
+        SSKEnvironment.shared.databaseStorageRef.read { tx in
+            XCTAssertFalse(contactThread.hasLastVisibleInteraction(transaction: tx))
+        }
+    }
+
+    func testInsertingMessagesUpdatesLastInteractionRowId() throws {
+        let contactThread = self.contactThread()
+
+        let lastMessage = SSKEnvironment.shared.databaseStorageRef.write { tx in
+            let messages = (0..<3).map { _ in
+                let message = TSOutgoingMessage(in: contactThread, messageBody: "Hello")
+                message.anyInsert(transaction: tx)
+                return message
+            }
+            return messages.last!
+        }
+
+        let fetchedThread = try XCTUnwrap(SSKEnvironment.shared.databaseStorageRef.read { tx in
+            TSThread.anyFetch(uniqueId: contactThread.uniqueId, transaction: tx, ignoreCache: true)
+        })
+        XCTAssertTrue(fetchedThread.shouldThreadBeVisible)
+        XCTAssertEqual(fetchedThread.lastInteractionRowId, lastMessage.sortId)
+    }
+
+    func testRemovingMessagesUpdatesLastInteractionRowId() throws {
+        let contactThread = self.contactThread()
+
+        let messages = SSKEnvironment.shared.databaseStorageRef.write { tx in
+            return (0..<3).map { _ in
+                let message = TSOutgoingMessage(in: contactThread, messageBody: "Hello")
+                message.anyInsert(transaction: tx)
+                return message
+            }
+        }
+
+        SSKEnvironment.shared.databaseStorageRef.write { tx in
+            contactThread.setLastVisibleInteraction(sortId: messages[2].sortId, onScreenPercentage: 1, transaction: tx)
+        }
+
+        SSKEnvironment.shared.databaseStorageRef.write { tx in
+            DependenciesBridge.shared.interactionDeleteManager.delete(
+                interactions: [messages[2], messages[1]],
+                sideEffects: .default(),
+                tx: tx.asV2Write
+            )
+        }
+
+        let fetchedThread = try XCTUnwrap(SSKEnvironment.shared.databaseStorageRef.read { tx in
+            TSThread.anyFetch(uniqueId: contactThread.uniqueId, transaction: tx, ignoreCache: true)
+        })
+        XCTAssertEqual(fetchedThread.lastInteractionRowId, messages[0].sortId)
+        SSKEnvironment.shared.databaseStorageRef.read { tx in
+            XCTAssertEqual(fetchedThread.lastVisibleInteraction(transaction: tx)?.sortId, messages[0].sortId)
+        }
+    }
 }
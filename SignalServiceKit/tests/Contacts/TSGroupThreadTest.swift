@@ -12,3 +12,32 @@ class TSGroupThreadTest: XCTestCase {
         XCTAssertFalse(groupThread.hasSafetyNumbers())
     }
 }
+
+class TSGroupThreadRecipientsTest: SSKBaseTest {
+    override func setUp() {
+        super.setUp()
+        SSKEnvironment.shared.databaseStorageRef.write { tx in
+            (DependenciesBridge.shared.registrationStateChangeManager as! RegistrationStateChangeManagerImpl).registerForTests(
+                localIdentifiers: .forUnitTests,
+                tx: tx.asV2Write
+            )
+        }
+    }
+
+    func testRecipientAddresses() {
+        let localAddress = LocalIdentifiers.forUnitTests.aciAddress
+        let otherAddresses = [SignalServiceAddress(Aci.randomForTesting()), SignalServiceAddress(Aci.randomForTesting())]
+        let groupThread = TSGroupThread.forUnitTest(groupMembers: [localAddress] + otherAddresses)
+
+        SSKEnvironment.shared.databaseStorageRef.read { tx in
+            let recipientAddresses = groupThread.recipientAddresses(with: tx)
+            XCTAssertEqual(Set(recipientAddresses), Set(otherAddresses))
+            XCTAssertEqual(recipientAddresses.count, otherAddresses.count)
+            XCTAssertEqual(groupThread.recipientAddressSet(with: tx), Set(otherAddresses))
+
+            XCTAssertTrue(groupThread.isRecipientAddress(otherAddresses[0], tx: tx))
+            XCTAssertFalse(groupThread.isRecipientAddress(localAddress, tx: tx))
+            XCTAssertFalse(groupThread.isRecipientAddress(SignalServiceAddress(Aci.randomForTesting()), tx: tx))
+        }
+    }
+}
@@ -0,0 +1,39 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import XCTest
+
+@testable import SignalServiceKit
+
+class ThreadTouchCoalescerTest: XCTestCase {
+    func testCoalescesTouchesWithinInterval() {
+        let coalescer = ThreadTouchCoalescer(coalescingInterval: 1)
+        let now = Date()
+
+        XCTAssertTrue(coalescer.shouldTouchNow(threadUniqueId: "a", now: now))
+        XCTAssertTrue(coalescer.shouldTouchNow(threadUniqueId: "b", now: now))
+        XCTAssertFalse(coalescer.shouldTouchNow(threadUniqueId: "a", now: now.addingTimeInterval(0.2)))
+        XCTAssertFalse(coalescer.shouldTouchNow(threadUniqueId: "a", now: now.addingTimeInterval(0.4)))
+
+        // Deferred touches wait for the flush, even after the interval.
+        XCTAssertFalse(coalescer.shouldTouchNow(threadUniqueId: "a", now: now.addingTimeInterval(2)))
+        XCTAssertTrue(coalescer.shouldTouchNow(threadUniqueId: "b", now: now.addingTimeInterval(2)))
+
+        let flushDate = now.addingTimeInterval(2)
+        XCTAssertEqual(coalescer.takeDeferredThreadUniqueIds(now: flushDate), ["a"])
+        XCTAssertEqual(coalescer.takeDeferredThreadUniqueIds(now: flushDate), [])
+
+        // The flush counts as a touch.
+        XCTAssertFalse(coalescer.shouldTouchNow(threadUniqueId: "a", now: flushDate.addingTimeInterval(0.5)))
+        XCTAssertTrue(coalescer.shouldTouchNow(threadUniqueId: "c", now: flushDate.addingTimeInterval(0.5)))
+    }
+
+    func testZeroIntervalNeverDefers() {
+        let coalescer = ThreadTouchCoalescer(coalescingInterval: 0)
+        let now = Date()
+        XCTAssertTrue(coalescer.shouldTouchNow(threadUniqueId: "a", now: now))
+        XCTAssertTrue(coalescer.shouldTouchNow(threadUniqueId: "a", now: now))
+    }
+}
@@ -121,6 +121,56 @@ class GroupModelsTest: SSKBaseTest {
         XCTAssertEqual(membership4, membership5)
     }
 
+    func testGroupMembershipArchiving() throws {
+        var builder = GroupMembership.Builder()
+        builder.addFullMember(.aci1, role: .normal)
+        builder.addFullMember(.aci2, role: .administrator)
+        builder.addRequestingMember(Aci.aci3)
+        let membership = builder.build()
+
+        let encodedData = try NSKeyedArchiver.archivedData(withRootObject: membership, requiringSecureCoding: false)
+        let decodedMembership = try XCTUnwrap(NSKeyedUnarchiver.unarchivedObject(
+            ofClass: GroupMembership.self,
+            from: encodedData,
+            requiringSecureCoding: false
+        ))
+
+        // These are answered by the ACI index.
+        XCTAssertTrue(decodedMembership.isFullMember(Aci.aci1))
+        XCTAssertTrue(decodedMembership.isFullMember(SignalServiceAddress(Aci.aci2)))
+        XCTAssertFalse(decodedMembership.isFullMember(Aci.aci3))
+        XCTAssertEqual(decodedMembership.fullMembers, [SignalServiceAddress(Aci.aci1), SignalServiceAddress(Aci.aci2)])
+
+        // Re-archiving before the member states are decoded preserves them.
+        let reencodedData = try NSKeyedArchiver.archivedData(withRootObject: decodedMembership, requiringSecureCoding: false)
+        let redecodedMembership = try XCTUnwrap(NSKeyedUnarchiver.unarchivedObject(
+            ofClass: GroupMembership.self,
+            from: reencodedData,
+            requiringSecureCoding: false
+        ))
+
+        for decodedMembership in [decodedMembership, redecodedMembership] {
+            XCTAssertEqual(decodedMembership, membership)
+            XCTAssertTrue(decodedMembership.isRequestingMember(Aci.aci3))
+            XCTAssertTrue(decodedMembership.isFullMemberAndAdministrator(Aci.aci2))
+            XCTAssertTrue(decodedMembership.isFullMember(Aci.aci1))
+        }
+    }
+
+    func testGroupMemberAciIndex() throws {
+        let acis = (0..<50).map { _ in Aci.randomForTesting() }
+        let index = try XCTUnwrap(GroupMemberAciIndex(fullMemberAddresses: Set(acis.map { SignalServiceAddress($0) })))
+        XCTAssertEqual(index.count, acis.count)
+        XCTAssertEqual(Set(index.acis), Set(acis))
+        for aci in acis {
+            XCTAssertTrue(index.contains(aci))
+        }
+        XCTAssertFalse(index.contains(Aci.randomForTesting()))
+
+        // Addresses without an ACI can't be indexed.
+        XCTAssertNil(GroupMemberAciIndex(fullMemberAddresses: [SignalServiceAddress.legacyAddress(serviceId: nil, phoneNumber: "+16505550100")]))
+    }
+
     func testTSGroupModelBackwardsCompatibleDeserialization() throws {
         let groupIdLength = 16 // Taken from kGroupIdLength at the time of archiving.
         let expectedGroupId = Data(repeating: 8, count: groupIdLength)
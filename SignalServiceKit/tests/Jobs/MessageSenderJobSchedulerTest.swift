@@ -0,0 +1,58 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import XCTest
+
+@testable import SignalServiceKit
+
+class MessageSenderJobSchedulerTest: XCTestCase {
+
+    private typealias Candidate = MessageSenderJobScheduler.Candidate
+
+    private func nextIndex(_ candidates: [Candidate], consecutivePreemptions: Int = 0) -> Int? {
+        return MessageSenderJobScheduler.nextIndex(in: candidates, consecutivePreemptions: consecutivePreemptions)
+    }
+
+    func testEmpty() {
+        XCTAssertNil(nextIndex([]))
+    }
+
+    func testUserVisibleJumpsAhead() {
+        let candidates = [
+            Candidate(orderingKey: "a", sendClass: .receiptsAndSyncs),
+            Candidate(orderingKey: "b", sendClass: .background),
+            Candidate(orderingKey: "c", sendClass: .userVisible),
+            Candidate(orderingKey: "d", sendClass: .userVisible),
+        ]
+        XCTAssertEqual(nextIndex(candidates), 2)
+    }
+
+    func testReceiptsBeforeBackground() {
+        let candidates = [
+            Candidate(orderingKey: "a", sendClass: .background),
+            Candidate(orderingKey: "b", sendClass: .receiptsAndSyncs),
+            Candidate(orderingKey: "c", sendClass: .receiptsAndSyncs),
+        ]
+        XCTAssertEqual(nextIndex(candidates), 1)
+    }
+
+    func testThreadOrderIsPreserved() {
+        let candidates = [
+            Candidate(orderingKey: "a", sendClass: .background),
+            Candidate(orderingKey: "a", sendClass: .userVisible),
+            Candidate(orderingKey: "b", sendClass: .receiptsAndSyncs),
+        ]
+        XCTAssertEqual(nextIndex(candidates), 2)
+    }
+
+    func testOldestJobEventuallyRuns() {
+        let candidates = [
+            Candidate(orderingKey: "a", sendClass: .background),
+            Candidate(orderingKey: "b", sendClass: .userVisible),
+        ]
+        XCTAssertEqual(nextIndex(candidates, consecutivePreemptions: MessageSenderJobScheduler.maxConsecutivePreemptions - 1), 1)
+        XCTAssertEqual(nextIndex(candidates, consecutivePreemptions: MessageSenderJobScheduler.maxConsecutivePreemptions), 0)
+    }
+}
@@ -88,6 +88,70 @@ class EditManagerTests: SSKBaseTest {
         }
     }
 
+    func testPastRevisionBodyStoredAsDelta() throws {
+        let originalBody = "Meet me at the cafe on the corner of 5th and Main at noon"
+        let editedBody = "Meet me at the café on the corner of 5th and Main at noon"
+        let targetMessage = createIncomingMessage(with: thread) { builder in
+            builder.messageBody = originalBody
+            builder.authorAci = authorAci
+        }
+
+        let editMessage = createEditDataMessage { $0.setBody(editedBody) }
+        let dataStoreMock = EditManagerDataStoreMock(targetMessage: targetMessage)
+        let editMessageStoreMock = EditMessageStoreMock()
+        let editManager = EditManagerImpl(context:
+            .init(
+                dataStore: dataStoreMock,
+                editManagerAttachments: MockEditManagerTSResources(),
+                editMessageStore: editMessageStoreMock,
+                receiptManagerShim: ReceiptManagerMock(),
+                tsResourceStore: TSResourceStoreMock()
+            )
+        )
+
+        try db.write { tx in
+            _ = try editManager.processIncomingEditMessage(
+                editMessage,
+                serverTimestamp: 1,
+                serverGuid: UUID().uuidString,
+                serverDeliveryTimestamp: 1234,
+                thread: thread,
+                editTarget: .incomingMessage(IncomingEditMessageWrapper(
+                    message: targetMessage,
+                    thread: thread,
+                    authorAci: authorAci
+                )),
+                tx: tx
+            )
+        }
+
+        XCTAssertEqual(dataStoreMock.editMessageCopy?.body, editedBody)
+        XCTAssertNil(dataStoreMock.oldMessageCopy?.body)
+        let bodyDelta = try XCTUnwrap(editMessageStoreMock.editRecord?.pastRevisionBodyDelta)
+        XCTAssertEqual(bodyDelta.apply(toNewerBody: editedBody), originalBody)
+    }
+
+    func testBodyDelta() {
+        let bodies: [(String, String?)] = [
+            ("Hello there, how is everyone doing today?", "Hello there, how is everybody doing today?"),
+            ("Family: 👨‍👩‍👧 and flags 🇨🇦🇺🇸 in a much longer message than before", "Family: 👨‍👩‍👦 and flags 🇨🇦 in a much longer message than before"),
+            ("The quick brown fox jumps over the lazy dog", "The quick brown fox jumps over the lazy dog and the cat"),
+        ]
+        for (body, newerBody) in bodies {
+            let delta = EditRevisionBodyDelta(body: body, newerBody: newerBody)
+            XCTAssertNotNil(delta)
+            XCTAssertEqual(delta?.apply(toNewerBody: newerBody), body)
+        }
+
+        // Unrelated or short bodies aren't worth a delta.
+        XCTAssertNil(EditRevisionBodyDelta(body: "BAR", newerBody: "FOO"))
+        XCTAssertNil(EditRevisionBodyDelta(body: "Completely different text", newerBody: nil))
+
+        // A delta can't be applied to a body it wasn't made against.
+        let delta = EditRevisionBodyDelta(body: "Hello there, how is everyone doing today?", newerBody: "Hello there, how is everybody doing today?")
+        XCTAssertNil(delta?.apply(toNewerBody: "Hi"))
+    }
+
     func testViewOnceMessage() {
         let targetMessage = createIncomingMessage(with: thread) { builder in
             builder.authorAci = authorAci
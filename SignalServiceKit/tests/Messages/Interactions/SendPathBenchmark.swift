@@ -0,0 +1,191 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import LibSignalClient
+import XCTest
+
+@testable import SignalServiceKit
+
+/// Times the stages of building an outgoing message's plaintext across
+/// content mixes and recipient counts.
+///
+/// Each iteration fetches a fresh copy of the message (so nothing cached
+/// on the instance carries over), then times `dataMessageBuilderWithThread:`,
+/// the first `buildDataMessage:`, and one `buildPlainTextData:` per
+/// recipient, as a fan-out send would.
+///
+/// Set `SIGNAL_BENCHMARKS` to run; see `BenchmarkHarness`.
+class SendPathBenchmark: SSKBaseTest {
+    private let iterations = 200
+    private let recipientCounts = [1, 8, 64]
+
+    private var identityManager: OWSIdentityManager { DependenciesBridge.shared.identityManager }
+
+    override func setUp() {
+        super.setUp()
+        write { tx in
+            (DependenciesBridge.shared.registrationStateChangeManager as! RegistrationStateChangeManagerImpl).registerForTests(
+                localIdentifiers: .forUnitTests,
+                tx: tx.asV2Write
+            )
+        }
+        identityManager.generateAndPersistNewIdentityKey(for: .aci)
+        identityManager.generateAndPersistNewIdentityKey(for: .pni)
+    }
+
+    // MARK: - Variants
+
+    private enum Variant: String, CaseIterable {
+        case shortBody
+        case longBody
+        case bodyRanges
+        case quote
+        case linkPreview
+        case sticker
+        case contactShare
+        case storyContext
+        case groupV2
+    }
+
+    private let otherAci = Aci.constantForTesting("00000000-0000-4000-8000-0000000000a1")
+
+    /// Just short of the length at which the body is sent as an attachment.
+    private static let longBody: String = {
+        let sentence = "The quick brown fox jumps over the lazy dog. "
+        let body = String(repeating: sentence, count: Int(kOversizeTextMessageSizeThreshold) / sentence.utf8.count + 1)
+        return String(body.utf8.prefix(Int(kOversizeTextMessageSizeThreshold) - 1))!
+    }()
+
+    private func makeThread(variant: Variant, transaction tx: SDSAnyWriteTransaction) throws -> TSThread {
+        switch variant {
+        case .groupV2:
+            let members = [SignalServiceAddress(otherAci)] + (0..<30).map { _ in SignalServiceAddress.randomForTesting() }
+            return try GroupManager.createGroupForTests(members: members, name: "Book Club", transaction: tx)
+        default:
+            return TSContactThread.getOrCreateThread(withContactAddress: SignalServiceAddress(otherAci), transaction: tx)
+        }
+    }
+
+    private func makeMessage(variant: Variant, thread: TSThread, transaction tx: SDSAnyWriteTransaction) -> TSOutgoingMessage {
+        let builder = TSOutgoingMessageBuilder.withDefaultValues(
+            thread: thread,
+            messageBody: "Are we still on for dinner tomorrow?",
+            expiresInSeconds: 7 * UInt32(kDayInterval)
+        )
+        switch variant {
+        case .shortBody, .groupV2:
+            break
+        case .longBody:
+            builder.messageBody = Self.longBody
+        case .bodyRanges:
+            builder.messageBody = "@ are we still on for dinner tomorrow? It's at 7."
+            builder.bodyRanges = MessageBodyRanges(
+                mentions: [NSRange(location: 0, length: 1): otherAci],
+                styles: [
+                    .init(.bold, range: NSRange(location: 2, length: 16)),
+                    .init(.italic, range: NSRange(location: 19, length: 6)),
+                    .init(.spoiler, range: NSRange(location: 47, length: 1)),
+                ]
+            )
+        case .quote:
+            builder.quotedMessage = TSQuotedMessage(
+                timestamp: NSNumber(value: Date.ows_millisecondTimestamp()),
+                authorAddress: SignalServiceAddress(otherAci),
+                body: "Dinner tomorrow?",
+                bodyRanges: nil,
+                quotedAttachmentForSending: nil,
+                isGiftBadge: false
+            )
+        case .linkPreview:
+            builder.messageBody = "https://signal.org"
+            builder.linkPreview = OWSLinkPreview.withoutImage(
+                urlString: "https://signal.org",
+                title: "Signal",
+                ownerType: .message
+            )
+        case .sticker:
+            builder.messageBody = nil
+            let attachment = TSAttachmentPointer(
+                serverId: 0,
+                cdnKey: "sticker-cdn-key",
+                cdnNumber: 3,
+                key: Randomness.generateRandomBytes(64),
+                digest: Randomness.generateRandomBytes(32),
+                byteCount: 20_000,
+                contentType: MimeType.imageWebp.rawValue,
+                clientUuid: UUID(),
+                sourceFilename: nil,
+                caption: nil,
+                albumMessageId: nil,
+                attachmentType: .default,
+                mediaSize: CGSize(width: 512, height: 512),
+                blurHash: nil,
+                uploadTimestamp: Date.ows_millisecondTimestamp(),
+                videoDuration: nil
+            )
+            attachment.anyInsert(transaction: tx)
+            builder.messageSticker = MessageSticker.withLegacyAttachment(
+                info: StickerInfo(
+                    packId: Randomness.generateRandomBytes(16),
+                    packKey: Randomness.generateRandomBytes(32),
+                    stickerId: 1
+                ),
+                legacyAttachmentId: attachment.uniqueId,
+                emoji: "🎉"
+            )
+        case .contactShare:
+            builder.messageBody = nil
+            builder.contactShare = OWSContact(
+                name: OWSContactName(givenName: "Luke", familyName: "Skywalker"),
+                phoneNumbers: [.init(type: .mobile, phoneNumber: "+15555555555")],
+                emails: [.init(type: .home, email: "luke@tatooine.planet")],
+                addresses: [],
+                avatarAttachmentId: nil
+            )
+        case .storyContext:
+            builder.storyAuthorAci = AciObjC(otherAci)
+            builder.storyTimestamp = NSNumber(value: Date.ows_millisecondTimestamp())
+        }
+        let message = builder.build(transaction: tx)
+        message.anyInsert(transaction: tx)
+        return message
+    }
+
+    // MARK: - Benchmarks
+
+    func testBuildPlainTextData() throws {
+        try BenchmarkHarness.skipUnlessEnabled()
+
+        for variant in Variant.allCases {
+            try write { tx in
+                let thread = try makeThread(variant: variant, transaction: tx)
+                let messageUniqueId = makeMessage(variant: variant, thread: thread, transaction: tx).uniqueId
+
+                for recipientCount in recipientCounts {
+                    BenchmarkHarness.measureStages(
+                        "\(variant.rawValue), \(recipientCount) recipients",
+                        iterations: iterations
+                    ) { stopwatch in
+                        let message = TSInteraction.anyFetch(
+                            uniqueId: messageUniqueId,
+                            transaction: tx,
+                            ignoreCache: true
+                        ) as! TSOutgoingMessage
+
+                        stopwatch.start()
+                        _ = message.dataMessageBuilder(with: thread, transaction: tx)!
+                        stopwatch.lap("dataMessageBuilderWithThread:")
+                        _ = message.buildDataMessage(thread, transaction: tx)!
+                        stopwatch.lap("buildDataMessage:")
+                        for _ in 0..<recipientCount {
+                            _ = message.buildPlainTextData(thread, transaction: tx)!
+                        }
+                        stopwatch.lap("buildPlainTextData: (all recipients)")
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,108 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import LibSignalClient
+import XCTest
+
+@testable import SignalServiceKit
+
+class TSIncomingMessageReadTrackingTest: SSKBaseTest {
+    private var thread: TSContactThread!
+
+    override func setUp() {
+        super.setUp()
+
+        SSKEnvironment.shared.databaseStorageRef.write { tx in
+            (DependenciesBridge.shared.registrationStateChangeManager as! RegistrationStateChangeManagerImpl).registerForTests(
+                localIdentifiers: .forUnitTests,
+                tx: tx.asV2Write
+            )
+        }
+        self.thread = TSContactThread.getOrCreateThread(contactAddress: SignalServiceAddress(Aci.randomForTesting()))
+    }
+
+    private func insertMessage(
+        editState: TSEditState = .none,
+        expiresInSeconds: UInt32 = 0,
+        tx: SDSAnyWriteTransaction
+    ) -> TSIncomingMessage {
+        let message = TSIncomingMessageBuilder.withDefaultValues(
+            thread: thread,
+            authorAci: thread.contactAddress.aci,
+            editState: editState,
+            expiresInSeconds: expiresInSeconds
+        ).build()
+        message.anyInsert(transaction: tx)
+        return message
+    }
+
+    private func fetchFromDatabase(_ message: TSIncomingMessage, tx: SDSAnyReadTransaction) -> TSIncomingMessage? {
+        return TSInteraction.anyFetch(uniqueId: message.uniqueId, transaction: tx, ignoreCache: true) as? TSIncomingMessage
+    }
+
+    func testBulkMarkAsRead() throws {
+        let readTimestamp = Date.ows_millisecondTimestamp()
+
+        let (plainMessage, editedMessage, expiringMessage) = SSKEnvironment.shared.databaseStorageRef.write { tx in
+            return (
+                insertMessage(tx: tx),
+                insertMessage(editState: .latestRevisionUnread, tx: tx),
+                insertMessage(expiresInSeconds: 60, tx: tx)
+            )
+        }
+
+        SSKEnvironment.shared.databaseStorageRef.write { tx in
+            TSIncomingMessage.markAsRead(
+                [plainMessage, editedMessage, expiringMessage],
+                atTimestamp: readTimestamp,
+                thread: thread,
+                circumstance: .onLinkedDevice,
+                shouldClearNotifications: false,
+                transaction: tx
+            )
+        }
+
+        try SSKEnvironment.shared.databaseStorageRef.read { tx in
+            let plainMessage = try XCTUnwrap(fetchFromDatabase(plainMessage, tx: tx))
+            XCTAssertTrue(plainMessage.wasRead)
+            XCTAssertEqual(plainMessage.editState, .none)
+
+            let editedMessage = try XCTUnwrap(fetchFromDatabase(editedMessage, tx: tx))
+            XCTAssertTrue(editedMessage.wasRead)
+            XCTAssertEqual(editedMessage.editState, .latestRevisionRead)
+
+            let expiringMessage = try XCTUnwrap(fetchFromDatabase(expiringMessage, tx: tx))
+            XCTAssertTrue(expiringMessage.wasRead)
+            XCTAssertEqual(expiringMessage.expireStartedAt, readTimestamp)
+        }
+
+        // The in-memory copies reflect the update, too.
+        XCTAssertTrue(plainMessage.wasRead)
+        XCTAssertEqual(editedMessage.editState, .latestRevisionRead)
+    }
+
+    func testBulkMarkAsViewed() throws {
+        let messages = SSKEnvironment.shared.databaseStorageRef.write { tx in
+            return (0..<3).map { _ in insertMessage(tx: tx) }
+        }
+
+        SSKEnvironment.shared.databaseStorageRef.write { tx in
+            TSIncomingMessage.markAsViewed(
+                messages,
+                atTimestamp: Date.ows_millisecondTimestamp(),
+                thread: thread,
+                circumstance: .onLinkedDevice,
+                transaction: tx
+            )
+        }
+
+        try SSKEnvironment.shared.databaseStorageRef.read { tx in
+            for message in messages {
+                XCTAssertTrue(try XCTUnwrap(fetchFromDatabase(message, tx: tx)).wasViewed)
+                XCTAssertTrue(message.wasViewed)
+            }
+        }
+    }
+}
@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: AGPL-3.0-only
 //
 
+import LibSignalClient
 @testable import SignalServiceKit
 import XCTest
 
@@ -101,4 +102,32 @@ class TSMessageTest: SSKBaseTest {
             XCTAssertFalse(message.canBeRemotelyDeleted)
         }
     }
+
+    func testBulkRemoteDelete() {
+        let mentionedAci = Aci.randomForTesting()
+        let messages = (0..<3).map { index in
+            let builder = TSOutgoingMessageBuilder.outgoingMessageBuilder(thread: self.thread, messageBody: "message \(index)")
+            return SSKEnvironment.shared.databaseStorageRef.read { builder.build(transaction: $0) }
+        }
+        SSKEnvironment.shared.databaseStorageRef.write { tx in
+            for message in messages {
+                message.anyInsert(transaction: tx)
+                TSMention(uniqueMessageId: message.uniqueId, uniqueThreadId: thread.uniqueId, aci: mentionedAci).anyInsert(transaction: tx)
+            }
+            TSMessage.updateWithRemotelyDeletedAndRemoveRenderableContent(Array(messages.prefix(2)), tx: tx)
+        }
+
+        SSKEnvironment.shared.databaseStorageRef.read { tx in
+            for message in messages.prefix(2) {
+                let reloadedMessage = TSMessage.anyFetchMessage(uniqueId: message.uniqueId, transaction: tx)!
+                XCTAssertTrue(reloadedMessage.wasRemotelyDeleted)
+                XCTAssertNil(reloadedMessage.body)
+                XCTAssertEqual(MentionFinder.mentionedAddresses(for: message, transaction: tx.unwrapGrdbRead), [])
+            }
+            XCTAssertEqual(
+                MentionFinder.mentionedAddresses(for: messages[2], transaction: tx.unwrapGrdbRead),
+                [SignalServiceAddress(mentionedAci)]
+            )
+        }
+    }
 }
@@ -364,4 +364,54 @@ class TSOutgoingMessageTest: SSKBaseTest {
             XCTAssert(identityManager.shouldSharePhoneNumber(with: otherAci, tx: transaction.asV2Read))
         }
     }
+
+    func testDataMessageIsReusedUntilContentChanges() {
+        write { transaction in
+            let otherAddress = SignalServiceAddress(serviceId: Aci.randomForTesting(), phoneNumber: "+12223334444")
+            let thread = TSContactThread.getOrCreateThread(withContactAddress: otherAddress, transaction: transaction)
+            let messageBuilder = TSOutgoingMessageBuilder.outgoingMessageBuilder(thread: thread, messageBody: "Hello")
+            messageBuilder.timestamp = 100
+            let message = messageBuilder.build(transaction: transaction)
+            message.anyInsert(transaction: transaction)
+
+            let firstDataMessage = message.buildDataMessage(thread, transaction: transaction)!
+            let secondDataMessage = message.buildDataMessage(thread, transaction: transaction)!
+            XCTAssertEqual(firstDataMessage.body, "Hello")
+            XCTAssertEqual(try firstDataMessage.serializedData(), try secondDataMessage.serializedData())
+
+            message.update(withMessageBody: "Goodbye", transaction: transaction)
+
+            let updatedDataMessage = message.buildDataMessage(thread, transaction: transaction)!
+            XCTAssertEqual(updatedDataMessage.body, "Goodbye")
+        }
+    }
+
+    func testColumnUpdatesPersist() {
+        write { transaction in
+            let otherAci = Aci.randomForTesting()
+            let otherAddress = SignalServiceAddress(serviceId: otherAci, phoneNumber: "+12223334444")
+            let thread = TSContactThread.getOrCreateThread(withContactAddress: otherAddress, transaction: transaction)
+            let messageBuilder = TSOutgoingMessageBuilder.outgoingMessageBuilder(thread: thread, messageBody: "Hello")
+            messageBuilder.timestamp = 100
+            messageBuilder.expiresInSeconds = 10
+            let message = messageBuilder.build(transaction: transaction)
+            message.anyInsert(transaction: transaction)
+            message.updateWithSentRecipient(otherAci, wasSentByUD: false, transaction: transaction)
+
+            message.update(withHasSyncedTranscript: true, transaction: transaction)
+            message.update(withExpireStartedAt: 1000, transaction: transaction)
+
+            let fetched = TSInteraction.anyFetch(
+                uniqueId: message.uniqueId,
+                transaction: transaction,
+                ignoreCache: true
+            ) as! TSOutgoingMessage
+            XCTAssertTrue(fetched.hasSyncedTranscript)
+            XCTAssertEqual(fetched.expireStartedAt, 1000)
+            XCTAssertEqual(fetched.expiresAt, 11_000)
+            XCTAssertEqual(fetched.body, "Hello")
+            XCTAssertEqual(fetched.messageState, .sent)
+            XCTAssertEqual(fetched.storedMessageState, .sent)
+        }
+    }
 }
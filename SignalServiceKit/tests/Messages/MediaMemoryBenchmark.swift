@@ -0,0 +1,361 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import AVFoundation
+import UniformTypeIdentifiers
+import XCTest
+import YYImage
+
+@testable import SignalServiceKit
+
+/// Loads a gallery of mixed media through the legacy attachment thumbnail
+/// API and records peak memory, thumbnail decodes and time to first
+/// thumbnail.
+///
+/// The fixtures (a 48 MP HEIC, an animated WebP, a GIF, a 4K video and a
+/// voice note) are generated when the benchmark starts, so they don't
+/// bloat the repository. A thumbnail request that isn't answered from the
+/// cache is counted as a decode.
+///
+/// Set `SIGNAL_BENCHMARKS` to run; see `BenchmarkHarness`.
+class MediaMemoryBenchmark: SSKBaseTest {
+
+    /// The number of cells each fixture fills in the gallery pass.
+    private let galleryCopyCount = 6
+
+    private var fixtureUrls = [URL]()
+
+    override func tearDown() {
+        for url in fixtureUrls {
+            try? OWSFileSystem.deleteFileIfExists(url: url)
+        }
+        super.tearDown()
+    }
+
+    // MARK: - Fixtures
+
+    private struct Fixture {
+        var name: String
+        var contentType: String
+        var attachmentType: TSAttachmentType = .default
+        var isImage: Bool
+        var makeFile: (URL) throws -> Bool
+    }
+
+    private lazy var fixtures: [Fixture] = [
+        Fixture(name: "48 MP HEIC", contentType: MimeType.imageHeic.rawValue, isImage: true) { url in
+            try Self.writeStillImage(
+                to: url,
+                type: .heic,
+                image: Self.renderFrame(size: CGSize(width: 8064, height: 6048), index: 0)
+            )
+        },
+        Fixture(name: "Animated WebP", contentType: MimeType.imageWebp.rawValue, isImage: true) { url in
+            guard let encoder = YYImageEncoder(type: .webP) else {
+                return false
+            }
+            encoder.loopCount = 0
+            for index in 0..<24 {
+                encoder.add(Self.renderFrame(size: CGSize(width: 512, height: 512), index: index), duration: 1 / 12)
+            }
+            guard let data = encoder.encode() else {
+                return false
+            }
+            try data.write(to: url)
+            return true
+        },
+        Fixture(name: "GIF", contentType: MimeType.imageGif.rawValue, isImage: true) { url in
+            let frames = (0..<30).map { Self.renderFrame(size: CGSize(width: 480, height: 270), index: $0) }
+            return try Self.writeAnimatedGif(to: url, frames: frames)
+        },
+        Fixture(name: "4K video", contentType: "video/mp4", isImage: false) { url in
+            try Self.writeVideo(to: url, size: CGSize(width: 3840, height: 2160), frameCount: 30)
+        },
+        Fixture(name: "Voice note", contentType: "audio/aac", attachmentType: .voiceMessage, isImage: false) { url in
+            try Self.writeAudio(to: url, duration: 30)
+        },
+    ]
+
+    private static func renderFrame(size: CGSize, index: Int) -> UIImage {
+        let format = UIGraphicsImageRendererFormat()
+        format.scale = 1
+        format.opaque = true
+        return UIGraphicsImageRenderer(size: size, format: format).image { context in
+            let hue = CGFloat(index % 12) / 12
+            UIColor(hue: hue, saturation: 0.6, brightness: 0.9, alpha: 1).setFill()
+            context.fill(CGRect(origin: .zero, size: size))
+            // Some detail, so that encoders can't collapse the frame.
+            let tileSize = max(size.width, size.height) / 16
+            for row in 0..<Int(size.height / tileSize) + 1 {
+                for column in 0..<Int(size.width / tileSize) + 1 where (row + column + index) % 3 == 0 {
+                    UIColor(hue: 1 - hue, saturation: 0.8, brightness: CGFloat(row % 4 + 1) / 4, alpha: 1).setFill()
+                    context.fill(CGRect(x: CGFloat(column) * tileSize, y: CGFloat(row) * tileSize, width: tileSize, height: tileSize))
+                }
+            }
+        }
+    }
+
+    /// Returns false if this platform can't encode the type (e.g. HEIC on
+    /// some simulators).
+    private static func writeStillImage(to url: URL, type: UTType, image: UIImage) throws -> Bool {
+        guard
+            let cgImage = image.cgImage,
+            let destination = CGImageDestinationCreateWithURL(url as CFURL, type.identifier as CFString, 1, nil)
+        else {
+            return false
+        }
+        CGImageDestinationAddImage(destination, cgImage, [kCGImageDestinationLossyCompressionQuality: 0.8] as CFDictionary)
+        return CGImageDestinationFinalize(destination)
+    }
+
+    private static func writeAnimatedGif(to url: URL, frames: [UIImage]) throws -> Bool {
+        guard let destination = CGImageDestinationCreateWithURL(url as CFURL, UTType.gif.identifier as CFString, frames.count, nil) else {
+            return false
+        }
+        CGImageDestinationSetProperties(destination, [
+            kCGImagePropertyGIFDictionary: [kCGImagePropertyGIFLoopCount: 0],
+        ] as CFDictionary)
+        for frame in frames {
+            guard let cgImage = frame.cgImage else {
+                return false
+            }
+            CGImageDestinationAddImage(destination, cgImage, [
+                kCGImagePropertyGIFDictionary: [kCGImagePropertyGIFDelayTime: 0.1],
+            ] as CFDictionary)
+        }
+        return CGImageDestinationFinalize(destination)
+    }
+
+    private static func writeVideo(to url: URL, size: CGSize, frameCount: Int) throws -> Bool {
+        try? OWSFileSystem.deleteFileIfExists(url: url)
+        let writer = try AVAssetWriter(outputURL: url, fileType: .mp4)
+        let input = AVAssetWriterInput(mediaType: .video, outputSettings: [
+            AVVideoCodecKey: AVVideoCodecType.h264,
+            AVVideoWidthKey: Int(size.width),
+            AVVideoHeightKey: Int(size.height),
+        ])
+        input.expectsMediaDataInRealTime = false
+        let adaptor = AVAssetWriterInputPixelBufferAdaptor(assetWriterInput: input, sourcePixelBufferAttributes: [
+            kCVPixelBufferPixelFormatTypeKey as String: kCVPixelFormatType_32BGRA,
+            kCVPixelBufferWidthKey as String: Int(size.width),
+            kCVPixelBufferHeightKey as String: Int(size.height),
+        ])
+        writer.add(input)
+        guard writer.startWriting() else {
+            return false
+        }
+        writer.startSession(atSourceTime: .zero)
+
+        for index in 0..<frameCount {
+            while !input.isReadyForMoreMediaData {
+                Thread.sleep(forTimeInterval: 0.01)
+            }
+            guard
+                let pixelBufferPool = adaptor.pixelBufferPool,
+                let cgImage = renderFrame(size: size, index: index).cgImage
+            else {
+                return false
+            }
+            var pixelBuffer: CVPixelBuffer?
+            CVPixelBufferPoolCreatePixelBuffer(nil, pixelBufferPool, &pixelBuffer)
+            guard let pixelBuffer else {
+                return false
+            }
+            CVPixelBufferLockBaseAddress(pixelBuffer, [])
+            let context = CGContext(
+                data: CVPixelBufferGetBaseAddress(pixelBuffer),
+                width: Int(size.width),
+                height: Int(size.height),
+                bitsPerComponent: 8,
+                bytesPerRow: CVPixelBufferGetBytesPerRow(pixelBuffer),
+                space: CGColorSpaceCreateDeviceRGB(),
+                bitmapInfo: CGImageAlphaInfo.noneSkipFirst.rawValue | CGBitmapInfo.byteOrder32Little.rawValue
+            )
+            context?.draw(cgImage, in: CGRect(origin: .zero, size: size))
+            CVPixelBufferUnlockBaseAddress(pixelBuffer, [])
+            adaptor.append(pixelBuffer, withPresentationTime: CMTime(value: CMTimeValue(index), timescale: 30))
+        }
+
+        input.markAsFinished()
+        let semaphore = DispatchSemaphore(value: 0)
+        writer.finishWriting { semaphore.signal() }
+        semaphore.wait()
+        return writer.status == .completed
+    }
+
+    private static func writeAudio(to url: URL, duration: TimeInterval) throws -> Bool {
+        let sampleRate: Double = 44_100
+        let file = try AVAudioFile(forWriting: url, settings: [
+            AVFormatIDKey: kAudioFormatMPEG4AAC,
+            AVSampleRateKey: sampleRate,
+            AVNumberOfChannelsKey: 1,
+        ])
+        let frameCount = AVAudioFrameCount(sampleRate * duration)
+        guard
+            let buffer = AVAudioPCMBuffer(pcmFormat: file.processingFormat, frameCapacity: frameCount),
+            let samples = buffer.floatChannelData?[0]
+        else {
+            return false
+        }
+        // A 440 Hz tone whose volume rises and falls, like speech.
+        for index in 0..<Int(frameCount) {
+            let time = Double(index) / sampleRate
+            samples[index] = Float(sin(2 * .pi * 440 * time) * (0.5 + 0.5 * sin(2 * .pi * time)))
+        }
+        buffer.frameLength = frameCount
+        try file.write(from: buffer)
+        return true
+    }
+
+    private func makeAttachmentStream(fixture: Fixture, url: URL) throws -> TSAttachmentStream {
+        let byteCount = try XCTUnwrap(OWSFileSystem.fileSize(of: url)).uint32Value
+        let attachment = TSAttachmentStream(
+            contentType: fixture.contentType,
+            byteCount: byteCount,
+            sourceFilename: url.lastPathComponent,
+            caption: nil,
+            attachmentType: fixture.attachmentType,
+            albumMessageId: nil
+        )
+        try attachment.writeCopyingDataSource(try DataSourcePath(fileUrl: url, shouldDeleteOnDeallocation: false))
+        return attachment
+    }
+
+    // MARK: - Measurements
+
+    private struct ThumbnailLoadResult {
+        var firstThumbnailNanoseconds: UInt64?
+        var requestCount = 0
+        var decodeCount = 0
+        var failureCount = 0
+    }
+
+    /// Requests every thumbnail quality for each attachment at once and waits
+    /// for all of them, as a gallery does when it first appears.
+    private func loadThumbnails(attachments: [TSAttachmentStream]) -> ThumbnailLoadResult {
+        var result = ThumbnailLoadResult()
+        let startTime = clock_gettime_nsec_np(CLOCK_UPTIME_RAW)
+        let recordThumbnail = {
+            if result.firstThumbnailNanoseconds == nil {
+                result.firstThumbnailNanoseconds = clock_gettime_nsec_np(CLOCK_UPTIME_RAW) - startTime
+            }
+        }
+
+        var expectations = [XCTestExpectation]()
+        for attachment in attachments {
+            for quality in [TSAttachmentThumbnailQuality.small, .medium, .large] {
+                result.requestCount += 1
+                let expectation = self.expectation(description: "Thumbnail")
+                let cachedImage = attachment.thumbnailImage(
+                    quality: quality,
+                    success: { _ in
+                        // Invoked on main.
+                        result.decodeCount += 1
+                        recordThumbnail()
+                        expectation.fulfill()
+                    },
+                    failure: {
+                        result.failureCount += 1
+                        expectation.fulfill()
+                    }
+                )
+                if cachedImage != nil {
+                    recordThumbnail()
+                    expectation.fulfill()
+                }
+                expectations.append(expectation)
+            }
+        }
+        wait(for: expectations, timeout: 120)
+        return result
+    }
+
+    private func megabytes(_ byteCount: UInt64) -> String {
+        return String(format: "%.1f MB", Double(byteCount) / 1024 / 1024)
+    }
+
+    private func milliseconds(_ nanoseconds: UInt64?) -> String {
+        guard let nanoseconds else {
+            return "n/a"
+        }
+        return String(format: "%.1f ms", Double(nanoseconds) / Double(NSEC_PER_MSEC))
+    }
+
+    // MARK: - Benchmarks
+
+    func testMediaGallery() throws {
+        try BenchmarkHarness.skipUnlessEnabled()
+
+        var attachments = [TSAttachmentStream]()
+        for fixture in fixtures {
+            let url = OWSFileSystem.temporaryFileUrl(fileExtension: MimeTypeUtil.fileExtensionForMimeType(fixture.contentType))
+            fixtureUrls.append(url)
+            guard try autoreleasepool(invoking: { try fixture.makeFile(url) }) else {
+                print("[Benchmark] \(fixture.name): skipped, couldn't encode fixture on this platform")
+                continue
+            }
+            let attachment = try makeAttachmentStream(fixture: fixture, url: url)
+            attachments.append(attachment)
+
+            let sampler = BenchmarkHarness.PeakFootprintSampler()
+            sampler.start()
+
+            let sizeStartTime = clock_gettime_nsec_np(CLOCK_UPTIME_RAW)
+            let imageSizePixels = attachment.imageSizePixels
+            let sizeNanoseconds = clock_gettime_nsec_np(CLOCK_UPTIME_RAW) - sizeStartTime
+
+            let coldLoad = loadThumbnails(attachments: [attachment])
+            let warmLoad = loadThumbnails(attachments: [attachment])
+
+            var originalImageNanoseconds: UInt64?
+            if fixture.isImage {
+                autoreleasepool {
+                    let startTime = clock_gettime_nsec_np(CLOCK_UPTIME_RAW)
+                    let originalImage = attachment.originalImage
+                    originalImageNanoseconds = clock_gettime_nsec_np(CLOCK_UPTIME_RAW) - startTime
+                    XCTAssertNotNil(originalImage, fixture.name)
+                }
+            }
+
+            let peakFootprintGrowth = sampler.stop()
+            print(
+                "[Benchmark] \(fixture.name): "
+                + "imageSizePixels \(Int(imageSizePixels.width))x\(Int(imageSizePixels.height)) in \(milliseconds(sizeNanoseconds)), "
+                + "first thumbnail \(milliseconds(coldLoad.firstThumbnailNanoseconds)), "
+                + "\(coldLoad.decodeCount) decodes and \(coldLoad.failureCount) failures for \(coldLoad.requestCount) requests, "
+                + "\(warmLoad.decodeCount) decodes when repeated, "
+                + "originalImage \(milliseconds(originalImageNanoseconds)), "
+                + "peak footprint +\(megabytes(peakFootprintGrowth))"
+            )
+        }
+
+        // Fresh copies of every fixture, so that nothing is cached.
+        var galleryAttachments = [TSAttachmentStream]()
+        for attachment in attachments {
+            for _ in 0..<galleryCopyCount {
+                let copy = TSAttachmentStream(
+                    contentType: attachment.contentType,
+                    byteCount: attachment.byteCount,
+                    sourceFilename: attachment.sourceFilename,
+                    caption: nil,
+                    attachmentType: attachment.attachmentType,
+                    albumMessageId: nil
+                )
+                try copy.writeSharingFile(of: attachment)
+                galleryAttachments.append(copy)
+            }
+        }
+        let sampler = BenchmarkHarness.PeakFootprintSampler()
+        sampler.start()
+        let galleryLoad = loadThumbnails(attachments: galleryAttachments)
+        let peakFootprintGrowth = sampler.stop()
+        print(
+            "[Benchmark] Gallery of \(galleryAttachments.count): "
+            + "first thumbnail \(milliseconds(galleryLoad.firstThumbnailNanoseconds)), "
+            + "\(galleryLoad.decodeCount) decodes and \(galleryLoad.failureCount) failures for \(galleryLoad.requestCount) requests, "
+            + "peak footprint +\(megabytes(peakFootprintGrowth))"
+        )
+    }
+}
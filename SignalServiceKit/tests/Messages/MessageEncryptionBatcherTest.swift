@@ -0,0 +1,41 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import XCTest
+
+@testable import SignalServiceKit
+
+class MessageEncryptionBatcherTest: SSKBaseTest {
+
+    private struct TestError: Error {}
+
+    func testConcurrentWritesEachReturnTheirOwnResult() async throws {
+        let batcher = MessageEncryptionBatcher()
+        let results = try await withThrowingTaskGroup(of: Int.self, returning: [Int].self) { taskGroup in
+            for value in 0..<200 {
+                taskGroup.addTask {
+                    try await batcher.write { _ in value }
+                }
+            }
+            return try await taskGroup.reduce(into: []) { $0.append($1) }
+        }
+        XCTAssertEqual(results.sorted(), Array(0..<200))
+    }
+
+    func testThrowingWriteDoesNotAffectOthers() async throws {
+        let batcher = MessageEncryptionBatcher()
+        async let failingWrite: Int = batcher.write { _ in throw TestError() }
+        async let succeedingWrite: Int = batcher.write { _ in 1 }
+
+        do {
+            _ = try await failingWrite
+            XCTFail("Expected an error.")
+        } catch is TestError {
+            // Expected.
+        }
+        let succeedingResult = try await succeedingWrite
+        XCTAssertEqual(succeedingResult, 1)
+    }
+}
@@ -69,4 +69,25 @@ final class OWSDisappearingMessagesJobTest: SSKBaseTest {
             XCTAssertEqual(messageCount, 2)
         }
     }
+
+    func testExpirationBucketEnd() {
+        let bucketInterval = OWSDisappearingMessagesJob.expirationBucketInterval
+        let bucketStart = Date(timeIntervalSince1970: 1_700_000_000)
+        let bucketEnd = bucketStart.addingTimeInterval(bucketInterval)
+
+        XCTAssertEqual(OWSDisappearingMessagesJob.expirationBucketEnd(for: bucketStart), bucketStart)
+        XCTAssertEqual(OWSDisappearingMessagesJob.expirationBucketEnd(for: bucketStart.addingTimeInterval(0.001)), bucketEnd)
+        XCTAssertEqual(OWSDisappearingMessagesJob.expirationBucketEnd(for: bucketEnd.addingTimeInterval(-0.001)), bucketEnd)
+    }
+
+    func testExpirationBucketStart() {
+        let bucketInterval = OWSDisappearingMessagesJob.expirationBucketInterval
+        let bucketStart = Date(timeIntervalSince1970: 1_700_000_000)
+        let bucketEnd = bucketStart.addingTimeInterval(bucketInterval)
+
+        XCTAssertEqual(OWSDisappearingMessagesJob.expirationBucketStart(for: bucketStart), bucketStart)
+        XCTAssertEqual(OWSDisappearingMessagesJob.expirationBucketStart(for: bucketStart.addingTimeInterval(0.001)), bucketStart)
+        XCTAssertEqual(OWSDisappearingMessagesJob.expirationBucketStart(for: bucketEnd.addingTimeInterval(-0.001)), bucketStart)
+        XCTAssertEqual(OWSDisappearingMessagesJob.expirationBucketStart(for: bucketEnd), bucketEnd)
+    }
 }
@@ -0,0 +1,102 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import XCTest
+
+@testable import SignalServiceKit
+
+class OWSThumbnailLoadingQueueTest: SSKBaseTest {
+
+    private func makeLoadedThumbnail() -> OWSLoadedThumbnail {
+        return OWSLoadedThumbnail(image: UIImage(), data: Data())
+    }
+
+    func testConcurrentRequestsShareOneLoad() {
+        let queue = OWSThumbnailLoadingQueue()
+        let workCount = AtomicUInt(0, lock: .sharedGlobal)
+        let releaseWork = DispatchSemaphore(value: 0)
+        let loadedThumbnail = makeLoadedThumbnail()
+
+        let work: OWSThumbnailLoadingQueue.WorkBlock = { success, _ in
+            workCount.increment()
+            releaseWork.wait()
+            success(loadedThumbnail)
+        }
+
+        let expectations = (0..<3).map { expectation(description: "success \($0)") }
+        for expectation in expectations {
+            queue.enqueueLoad(
+                key: "a-200",
+                priority: .visible,
+                token: nil,
+                work: work,
+                success: { result in
+                    XCTAssertIdentical(result, loadedThumbnail)
+                    expectation.fulfill()
+                },
+                failure: { XCTFail("Unexpected failure.") }
+            )
+        }
+        releaseWork.signal()
+
+        wait(for: expectations, timeout: 5)
+        XCTAssertEqual(workCount.get(), 1)
+        XCTAssertEqual(queue.queuedLoadCount, 0)
+    }
+
+    func testCancelledRequestFailsAndOthersSucceed() {
+        let queue = OWSThumbnailLoadingQueue()
+        let releaseWork = DispatchSemaphore(value: 0)
+        let loadedThumbnail = makeLoadedThumbnail()
+
+        let work: OWSThumbnailLoadingQueue.WorkBlock = { success, _ in
+            releaseWork.wait()
+            success(loadedThumbnail)
+        }
+
+        let token = OWSThumbnailLoadingToken()
+        let cancelledExpectation = expectation(description: "cancelled")
+        queue.enqueueLoad(
+            key: "b-200",
+            priority: .visible,
+            token: token,
+            work: work,
+            success: { _ in XCTFail("Cancelled request should not succeed.") },
+            failure: { cancelledExpectation.fulfill() }
+        )
+        let successExpectation = expectation(description: "success")
+        queue.enqueueLoad(
+            key: "b-200",
+            priority: .background,
+            token: nil,
+            work: work,
+            success: { _ in successExpectation.fulfill() },
+            failure: { XCTFail("Unexpected failure.") }
+        )
+
+        token.cancel()
+        releaseWork.signal()
+
+        wait(for: [cancelledExpectation, successExpectation], timeout: 5)
+    }
+
+    func testAlreadyCancelledTokenFailsImmediately() {
+        let queue = OWSThumbnailLoadingQueue()
+        let token = OWSThumbnailLoadingToken()
+        token.cancel()
+
+        var didFail = false
+        queue.enqueueLoad(
+            key: "c-200",
+            priority: .visible,
+            token: token,
+            work: { _, _ in XCTFail("Work should not run.") },
+            success: { _ in XCTFail("Unexpected success.") },
+            failure: { didFail = true }
+        )
+        XCTAssertTrue(didFail)
+        XCTAssertEqual(queue.queuedLoadCount, 0)
+    }
+}
@@ -54,4 +54,22 @@ class ReceiptSenderTest: XCTestCase {
         XCTAssertEqual(receiptSets[1].identifier, aci.serviceIdUppercaseString)
         XCTAssertEqual(receiptSets[1].receiptSet.timestamps, [1234])
     }
+
+    func testFullBatchEndsWait() {
+        var sendingState = ReceiptSender.SendingState()
+        XCTAssertTrue(sendingState.startIfPossible())
+
+        let batchWait = Task<Void, Never> {}
+        sendingState.batchWait = batchWait
+
+        XCTAssertNil(sendingState.didEnqueueReceipt(maxReceiptsPerBatch: 3))
+        XCTAssertNil(sendingState.didEnqueueReceipt(maxReceiptsPerBatch: 3))
+        XCTAssertNotNil(sendingState.didEnqueueReceipt(maxReceiptsPerBatch: 3))
+        XCTAssertTrue(sendingState.mightHavePendingReceipts)
+
+        // Starting the next pass starts a new batch.
+        sendingState.inProgress = false
+        XCTAssertTrue(sendingState.startIfPossible())
+        XCTAssertFalse(sendingState.isBatchFull(maxReceiptsPerBatch: 3))
+    }
 }
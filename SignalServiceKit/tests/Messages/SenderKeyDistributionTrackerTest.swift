@@ -0,0 +1,72 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import LibSignalClient
+import XCTest
+
+@testable import SignalServiceKit
+
+class SenderKeyDistributionTrackerTest: XCTestCase {
+
+    private struct TestError: Error {}
+
+    private func buildKey(serviceId: ServiceId = Aci.randomForTesting()) -> SenderKeyDistributionTracker.Key {
+        return SenderKeyDistributionTracker.Key(
+            threadUniqueId: "thread",
+            serviceId: serviceId,
+            distributionId: UUID()
+        )
+    }
+
+    func testConcurrentDistributionWaitsForFirst() async throws {
+        let tracker = SenderKeyDistributionTracker()
+        let key = buildKey()
+
+        guard case .started(let future) = tracker.beginDistribution(for: key) else {
+            return XCTFail("Expected the first distribution to start.")
+        }
+        guard case .inProgress(let promise) = tracker.beginDistribution(for: key) else {
+            return XCTFail("Expected the second distribution to wait.")
+        }
+
+        tracker.endDistribution(for: key, future: future, result: .success(()))
+        try await promise.awaitable()
+
+        // Once ended, the next distribution starts afresh.
+        guard case .started = tracker.beginDistribution(for: key) else {
+            return XCTFail("Expected a new distribution to start.")
+        }
+    }
+
+    func testFailedDistributionFailsWaiters() async {
+        let tracker = SenderKeyDistributionTracker()
+        let key = buildKey()
+
+        guard case .started(let future) = tracker.beginDistribution(for: key) else {
+            return XCTFail("Expected the first distribution to start.")
+        }
+        guard case .inProgress(let promise) = tracker.beginDistribution(for: key) else {
+            return XCTFail("Expected the second distribution to wait.")
+        }
+
+        tracker.endDistribution(for: key, future: future, result: .failure(TestError()))
+        do {
+            try await promise.awaitable()
+            XCTFail("Expected an error.")
+        } catch {
+            XCTAssert(error is TestError)
+        }
+    }
+
+    func testDistinctKeysDontWait() {
+        let tracker = SenderKeyDistributionTracker()
+        guard
+            case .started = tracker.beginDistribution(for: buildKey()),
+            case .started = tracker.beginDistribution(for: buildKey())
+        else {
+            return XCTFail("Expected both distributions to start.")
+        }
+    }
+}
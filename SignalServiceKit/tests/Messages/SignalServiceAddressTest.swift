@@ -795,6 +795,22 @@ class SignalServiceAddressTest: XCTestCase {
         XCTAssertEqual(addresses.count, iterations)
     }
 
+    func testInternedAddresses() {
+        let aci = Aci.randomForTesting()
+        let phoneNumber = "+16505550100"
+
+        let address1 = cache.internedAddress(for: aci)
+        let address2 = cache.internedAddress(for: aci)
+        XCTAssertTrue(address1 === address2)
+        XCTAssertEqual(address1, makeAddress(serviceId: aci))
+        XCTAssertNotEqual(address1, cache.internedAddress(for: Aci.randomForTesting()))
+
+        // Interned addresses reflect mapping changes.
+        updateMapping(aci: aci, phoneNumber: phoneNumber)
+        XCTAssertEqual(address1.phoneNumber, phoneNumber)
+        XCTAssertEqual(address1, makeAddress(phoneNumber: phoneNumber))
+    }
+
     func testPotentiallyVisible() {
         let aci = Aci.constantForTesting("00000000-0000-4000-A000-000000000000")
         let phoneNumber = E164("+16505550100")
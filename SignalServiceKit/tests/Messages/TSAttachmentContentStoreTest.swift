@@ -0,0 +1,106 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import CryptoKit
+import XCTest
+
+@testable import SignalServiceKit
+
+class TSAttachmentContentStoreTest: SSKBaseTest {
+
+    private func makeFile(contents: Data) throws -> URL {
+        let dirUrl = URL(fileURLWithPath: TSAttachmentStream.attachmentsFolder()).appendingPathComponent(UUID().uuidString)
+        XCTAssertTrue(OWSFileSystem.ensureDirectoryExists(dirUrl.path))
+        let fileUrl = dirUrl.appendingPathComponent("file.bin")
+        try contents.write(to: fileUrl)
+        return fileUrl
+    }
+
+    private func storeEntryNames() -> [String] {
+        return (try? FileManager.default.contentsOfDirectory(atPath: TSAttachmentContentStore.storeDirPath)) ?? []
+    }
+
+    func testIdenticalFilesShareStorageUntilRemoved() throws {
+        let store = TSAttachmentContentStore.shared
+        let contents = Randomness.generateRandomBytes(128 * 1024)
+        let sha256Digest = Data(SHA256.hash(data: contents))
+        let fileUrl1 = try makeFile(contents: contents)
+        let fileUrl2 = try makeFile(contents: contents)
+
+        store.deduplicateFile(at: fileUrl1, sha256Digest: sha256Digest)
+        store.deduplicateFile(at: fileUrl2, sha256Digest: sha256Digest)
+        store.flushForTests()
+
+        // Two attachment files plus the store entry.
+        XCTAssertEqual(TSAttachmentContentStore.linkCount(atPath: fileUrl1.path), 3)
+        XCTAssertEqual(try Data(contentsOf: fileUrl2), contents)
+        XCTAssertFalse(FileManager.default.isWritableFile(atPath: fileUrl2.path))
+
+        XCTAssertEqual(TSAttachmentContentStore.storeSha256Digest(ofFileAtPath: fileUrl1.path), sha256Digest)
+        XCTAssertTrue(OWSFileSystem.deleteFileIfExists(fileUrl1.path))
+        store.didRemoveFile(linkedToEntryWithSha256Digest: sha256Digest)
+        store.flushForTests()
+        XCTAssertEqual(TSAttachmentContentStore.linkCount(atPath: fileUrl2.path), 2)
+        XCTAssertEqual(try Data(contentsOf: fileUrl2), contents)
+
+        XCTAssertEqual(TSAttachmentContentStore.storeSha256Digest(ofFileAtPath: fileUrl2.path), sha256Digest)
+        XCTAssertTrue(OWSFileSystem.deleteFileIfExists(fileUrl2.path))
+        store.didRemoveFile(linkedToEntryWithSha256Digest: sha256Digest)
+        store.flushForTests()
+        XCTAssertTrue(storeEntryNames().isEmpty)
+    }
+
+    func testRemovingOneLinkedAttachmentLeavesTheOtherReadable() throws {
+        let contents = Randomness.generateRandomBytes(128 * 1024)
+        let attachments = try (0..<2).map { _ in
+            let attachment = TSAttachmentStream(
+                contentType: MimeType.applicationOctetStream.rawValue,
+                byteCount: UInt32(contents.count),
+                sourceFilename: nil,
+                caption: nil,
+                attachmentType: .default,
+                albumMessageId: nil
+            )
+            try attachment.writeCopyingDataSource(DataSourceValue(contents, fileExtension: "bin"))
+            return attachment
+        }
+        TSAttachmentContentStore.shared.flushForTests()
+        let filePath0 = try XCTUnwrap(attachments[0].originalFilePath)
+        let filePath1 = try XCTUnwrap(attachments[1].originalFilePath)
+        XCTAssertEqual(TSAttachmentContentStore.linkCount(atPath: filePath1), 3)
+
+        attachments[0].removeFile()
+        TSAttachmentContentStore.shared.flushForTests()
+
+        XCTAssertFalse(FileManager.default.fileExists(atPath: filePath0))
+        XCTAssertEqual(try attachments[1].readMappedDataFromFile(), contents)
+        XCTAssertEqual(storeEntryNames().count, 1)
+
+        attachments[1].removeFile()
+        TSAttachmentContentStore.shared.flushForTests()
+        XCTAssertTrue(storeEntryNames().isEmpty)
+    }
+
+    func testSweepRemovesEntriesOrphanedWithoutNotice() throws {
+        let store = TSAttachmentContentStore.shared
+        let contents = Randomness.generateRandomBytes(128 * 1024)
+        let fileUrl = try makeFile(contents: contents)
+        store.deduplicateFile(at: fileUrl, sha256Digest: Data(SHA256.hash(data: contents)))
+        store.flushForTests()
+        XCTAssertEqual(storeEntryNames().count, 1)
+
+        XCTAssertTrue(OWSFileSystem.deleteFileIfExists(fileUrl.path))
+        store.sweepUnreferencedEntries()
+        XCTAssertTrue(storeEntryNames().isEmpty)
+    }
+
+    func testSmallFilesAreNotDeduplicated() throws {
+        let contents = Randomness.generateRandomBytes(1024)
+        let fileUrl = try makeFile(contents: contents)
+        TSAttachmentContentStore.shared.deduplicateFile(at: fileUrl, sha256Digest: Data(SHA256.hash(data: contents)))
+        TSAttachmentContentStore.shared.flushForTests()
+        XCTAssertEqual(TSAttachmentContentStore.linkCount(atPath: fileUrl.path), 1)
+    }
+}
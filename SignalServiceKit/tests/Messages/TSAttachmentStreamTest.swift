@@ -0,0 +1,51 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import XCTest
+
+@testable import SignalServiceKit
+
+class TSAttachmentStreamTest: SSKBaseTest {
+
+    private func makeImageAttachment(width: CGFloat, height: CGFloat) throws -> TSAttachmentStream {
+        let format = UIGraphicsImageRendererFormat()
+        format.scale = 1
+        let image = UIGraphicsImageRenderer(size: CGSize(width: width, height: height), format: format).image { context in
+            UIColor.blue.setFill()
+            context.fill(CGRect(x: 0, y: 0, width: width, height: height))
+        }
+        let pngData = try XCTUnwrap(image.pngData())
+        let attachment = TSAttachmentStream(
+            contentType: MimeType.imagePng.rawValue,
+            byteCount: UInt32(pngData.count),
+            sourceFilename: nil,
+            caption: nil,
+            attachmentType: .default,
+            albumMessageId: nil
+        )
+        try attachment.writeCopyingDataSource(DataSourceValue(pngData, fileExtension: "png"))
+        return attachment
+    }
+
+    func testOriginalImageWithMaxPixelSizeIsBounded() throws {
+        let attachment = try makeImageAttachment(width: 400, height: 300)
+        defer { attachment.removeFile() }
+
+        let image = try XCTUnwrap(attachment.originalImage(maxPixelSize: 100))
+        let cgImage = try XCTUnwrap(image.cgImage)
+        XCTAssertLessThanOrEqual(max(cgImage.width, cgImage.height), 100)
+        XCTAssertGreaterThan(min(cgImage.width, cgImage.height), 0)
+    }
+
+    func testOriginalImageWithMaxPixelSizeKeepsSmallImages() throws {
+        let attachment = try makeImageAttachment(width: 40, height: 30)
+        defer { attachment.removeFile() }
+
+        let image = try XCTUnwrap(attachment.originalImage(maxPixelSize: 100))
+        let cgImage = try XCTUnwrap(image.cgImage)
+        XCTAssertEqual(cgImage.width, 40)
+        XCTAssertEqual(cgImage.height, 30)
+    }
+}
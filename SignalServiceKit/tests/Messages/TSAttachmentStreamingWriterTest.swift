@@ -0,0 +1,66 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import CryptoKit
+import XCTest
+
+@testable import SignalServiceKit
+
+class TSAttachmentStreamingWriterTest: XCTestCase {
+
+    func testCopiesFile() throws {
+        let plaintext = Randomness.generateRandomBytes(600 * 1024 + 17)
+        let srcUrl = OWSFileSystem.temporaryFileUrl()
+        let dstUrl = OWSFileSystem.temporaryFileUrl()
+        try plaintext.write(to: srcUrl)
+        defer {
+            try? OWSFileSystem.deleteFileIfExists(url: srcUrl)
+            try? OWSFileSystem.deleteFileIfExists(url: dstUrl)
+        }
+
+        let result = try TSAttachmentStreamingWriter.write(copyingFileAt: srcUrl, to: dstUrl)
+
+        XCTAssertEqual(try Data(contentsOf: dstUrl), plaintext)
+        XCTAssertEqual(result.plaintextSha256Digest, Data(SHA256.hash(data: plaintext)))
+        XCTAssertNil(result.sniffedMimeType)
+        XCTAssertEqual(result.imageSizePixels, .zero)
+    }
+
+    func testProbesImageHeader() throws {
+        let image = UIGraphicsImageRenderer(size: CGSize(width: 30, height: 20), format: {
+            let format = UIGraphicsImageRendererFormat()
+            format.scale = 1
+            return format
+        }()).image { context in
+            UIColor.red.setFill()
+            context.fill(CGRect(x: 0, y: 0, width: 30, height: 20))
+        }
+        let pngData = try XCTUnwrap(image.pngData())
+        let srcUrl = OWSFileSystem.temporaryFileUrl(fileExtension: "png")
+        let dstUrl = OWSFileSystem.temporaryFileUrl(fileExtension: "png")
+        try pngData.write(to: srcUrl)
+        defer {
+            try? OWSFileSystem.deleteFileIfExists(url: srcUrl)
+            try? OWSFileSystem.deleteFileIfExists(url: dstUrl)
+        }
+
+        let result = try TSAttachmentStreamingWriter.write(copyingFileAt: srcUrl, to: dstUrl)
+
+        XCTAssertEqual(result.sniffedMimeType, MimeType.imagePng.rawValue)
+        XCTAssertEqual(result.imageSizePixels, CGSize(width: 30, height: 20))
+    }
+
+    func testDataSourceInMemory() throws {
+        let plaintext = Randomness.generateRandomBytes(1024)
+        let dataSource = DataSourceValue(plaintext, fileExtension: "bin")
+        let dstUrl = OWSFileSystem.temporaryFileUrl()
+        defer { try? OWSFileSystem.deleteFileIfExists(url: dstUrl) }
+
+        let result = try TSAttachmentStreamingWriter.write(copying: dataSource, to: dstUrl)
+
+        XCTAssertEqual(try Data(contentsOf: dstUrl), plaintext)
+        XCTAssertEqual(result.plaintextSha256Digest, Data(SHA256.hash(data: plaintext)))
+    }
+}
@@ -0,0 +1,55 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import LibSignalClient
+import XCTest
+
+@testable import SignalServiceKit
+
+class EnvelopeHeaderTest: XCTestCase {
+    func testMatchesFullDecode() throws {
+        let sourceServiceId = Aci.randomForTesting().serviceIdString
+        let serverGuid = UUID().uuidString
+
+        let envelopeBuilder = SSKProtoEnvelope.builder(timestamp: 1_700_000_000_123)
+        envelopeBuilder.setType(.unidentifiedSender)
+        envelopeBuilder.setSourceServiceID(sourceServiceId)
+        envelopeBuilder.setSourceDevice(3)
+        envelopeBuilder.setServerGuid(serverGuid)
+        envelopeBuilder.setServerTimestamp(1_700_000_000_456)
+        envelopeBuilder.setContent(Data(repeating: 0xab, count: 4096))
+        envelopeBuilder.setStory(true)
+        let envelopeData = try envelopeBuilder.buildSerializedData()
+
+        let header = try XCTUnwrap(EnvelopeHeader(envelopeData: envelopeData))
+        let envelope = try SSKProtoEnvelope(serializedData: envelopeData)
+
+        XCTAssertEqual(header.type, envelope.type)
+        XCTAssertEqual(header.timestamp, envelope.timestamp)
+        XCTAssertEqual(header.sourceServiceId, sourceServiceId)
+        XCTAssertEqual(header.sourceDevice, 3)
+        XCTAssertEqual(header.serverGuid, serverGuid)
+    }
+
+    func testMissingFields() throws {
+        let envelopeData = try SSKProtoEnvelope.builder(timestamp: 42).buildSerializedData()
+
+        let header = try XCTUnwrap(EnvelopeHeader(envelopeData: envelopeData))
+
+        XCTAssertEqual(header.timestamp, 42)
+        XCTAssertNil(header.type)
+        XCTAssertNil(header.sourceServiceId)
+        XCTAssertNil(header.sourceDevice)
+        XCTAssertNil(header.serverGuid)
+    }
+
+    func testTruncatedData() throws {
+        let envelopeBuilder = SSKProtoEnvelope.builder(timestamp: 42)
+        envelopeBuilder.setContent(Data(repeating: 0xab, count: 64))
+        let envelopeData = try envelopeBuilder.buildSerializedData()
+
+        XCTAssertNil(EnvelopeHeader(envelopeData: envelopeData.dropLast(1)))
+    }
+}
@@ -0,0 +1,68 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import XCTest
+@testable import SignalServiceKit
+
+class PaymentModelAggregatesTest: XCTestCase {
+
+    private func summary(
+        _ paymentState: TSPaymentState,
+        isUnread: Bool = false,
+        sortDate: TimeInterval,
+        picoMob: UInt64,
+        feePicoMob: UInt64 = 0
+    ) -> PaymentModelSummary {
+        return PaymentModelSummary(
+            paymentState: paymentState,
+            isIncoming: paymentState.isIncoming,
+            isUnread: isUnread,
+            sortDate: Date(timeIntervalSince1970: sortDate),
+            picoMob: picoMob,
+            feePicoMob: feePicoMob
+        )
+    }
+
+    func testTotalsAndUnreadCount() {
+        var contents = PaymentModelAggregateContents()
+        contents.update(uniqueId: "a", summary: summary(.incomingVerified, isUnread: true, sortDate: 1, picoMob: 10))
+        contents.update(uniqueId: "b", summary: summary(.incomingVerified, isUnread: true, sortDate: 2, picoMob: 5))
+        contents.update(uniqueId: "c", summary: summary(.outgoingSending, sortDate: 3, picoMob: 7, feePicoMob: 1))
+
+        XCTAssertEqual(contents.unreadCount, 2)
+        XCTAssertEqual(contents.totalsByState[.incomingVerified], PaymentModelStateTotals(count: 2, picoMob: 15, feePicoMob: 0))
+        XCTAssertEqual(contents.totalsByState[.outgoingSending], PaymentModelStateTotals(count: 1, picoMob: 7, feePicoMob: 1))
+
+        // Updating a payment moves it between states.
+        contents.update(uniqueId: "a", summary: summary(.incomingComplete, sortDate: 1, picoMob: 10))
+        XCTAssertEqual(contents.unreadCount, 1)
+        XCTAssertEqual(contents.totalsByState[.incomingVerified], PaymentModelStateTotals(count: 1, picoMob: 5, feePicoMob: 0))
+        XCTAssertEqual(contents.totalsByState[.incomingComplete], PaymentModelStateTotals(count: 1, picoMob: 10, feePicoMob: 0))
+
+        contents.update(uniqueId: "b", summary: nil)
+        XCTAssertEqual(contents.unreadCount, 0)
+        XCTAssertNil(contents.totalsByState[.incomingVerified])
+    }
+
+    func testLatestSortDateAndMostRecent() {
+        var contents = PaymentModelAggregateContents()
+        XCTAssertNil(contents.latestSortDate())
+
+        contents.update(uniqueId: "a", summary: summary(.incomingComplete, sortDate: 1, picoMob: 1))
+        contents.update(uniqueId: "b", summary: summary(.outgoingComplete, sortDate: 3, picoMob: 1))
+        contents.update(uniqueId: "c", summary: summary(.incomingComplete, sortDate: 2, picoMob: 1))
+        XCTAssertEqual(contents.latestSortDate(), Date(timeIntervalSince1970: 3))
+        XCTAssertEqual(contents.mostRecentUniqueIds(isIncoming: nil, limit: 10), ["b", "c", "a"])
+        XCTAssertEqual(contents.mostRecentUniqueIds(isIncoming: true, limit: 1), ["c"])
+        XCTAssertEqual(contents.mostRecentUniqueIds(isIncoming: false, limit: 10), ["b"])
+
+        contents.update(uniqueId: "b", summary: nil)
+        XCTAssertEqual(contents.latestSortDate(), Date(timeIntervalSince1970: 2))
+        XCTAssertEqual(contents.mostRecentUniqueIds(isIncoming: nil, limit: 10), ["c", "a"])
+
+        contents.update(uniqueId: "d", summary: summary(.incomingComplete, sortDate: 4, picoMob: 1))
+        XCTAssertEqual(contents.latestSortDate(), Date(timeIntervalSince1970: 4))
+    }
+}
@@ -0,0 +1,173 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import GRDB
+import XCTest
+@testable import SignalServiceKit
+
+class FullTextSearchIndexerTest: SSKBaseTest {
+    private var thread: TSContactThread!
+
+    override func setUp() {
+        super.setUp()
+
+        write { tx in
+            (DependenciesBridge.shared.registrationStateChangeManager as! RegistrationStateChangeManagerImpl).registerForTests(
+                localIdentifiers: .forUnitTests,
+                tx: tx.asV2Write
+            )
+            thread = TSContactThread.getOrCreateThread(
+                withContactAddress: SignalServiceAddress(Aci.randomForTesting()),
+                transaction: tx
+            )
+        }
+    }
+
+    private func search(_ searchText: String, isSorted: Bool = true) -> [String] {
+        var snippets = [String]()
+        read { tx in
+            FullTextSearchIndexer.search(for: searchText, maxResults: 100, tx: tx) { _, snippet, _ in
+                snippets.append(snippet)
+            }
+        }
+        return isSorted ? snippets.sorted() : snippets
+    }
+
+    private func pendingCount() -> Int {
+        return SSKEnvironment.shared.databaseStorageRef.read { tx in
+            try! Int.fetchOne(
+                tx.unwrapGrdbRead.database,
+                sql: "SELECT COUNT(*) FROM \(FullTextSearchIndexer.pendingTableName)"
+            )!
+        }
+    }
+
+    private func indexPendingMessages() {
+        write { tx in
+            FullTextSearchIndexer.indexPendingMessages(limit: 1000, tx: tx)
+        }
+    }
+
+    func testPendingMessagesAreSearchable() {
+        let message1 = TSOutgoingMessage(in: thread, messageBody: "This world contains glory and despair.")
+        let message2 = TSOutgoingMessage(in: thread, messageBody: "This world contains hope and despair.")
+        write { tx in
+            message1.anyInsert(transaction: tx)
+            message2.anyInsert(transaction: tx)
+        }
+        XCTAssertEqual(pendingCount(), 2)
+
+        // Before indexing, search matches the pending messages directly.
+        let pendingGlory = search("GLO")
+        XCTAssertEqual(pendingGlory, ["This world contains <match>glory</match> and despair"])
+        XCTAssertEqual(search("despair world").count, 2)
+
+        indexPendingMessages()
+        XCTAssertEqual(pendingCount(), 0)
+        XCTAssertEqual(search("GLO"), pendingGlory)
+        XCTAssertEqual(search("despair world").count, 2)
+
+        // An edit is visible before it's indexed.
+        write { tx in
+            message1.update(withMessageBody: "This world contains glory and defeat.", transaction: tx)
+        }
+        XCTAssertEqual(pendingCount(), 1)
+        XCTAssertEqual(search("despair").count, 1)
+        XCTAssertEqual(search("defeat").count, 1)
+        indexPendingMessages()
+        XCTAssertEqual(search("despair").count, 1)
+        XCTAssertEqual(search("defeat").count, 1)
+
+        // So is a deletion.
+        write { tx in
+            DependenciesBridge.shared.interactionDeleteManager.delete(message1, sideEffects: .default(), tx: tx.asV2Write)
+        }
+        XCTAssertEqual(search("glory").count, 0)
+        indexPendingMessages()
+        XCTAssertEqual(search("glory").count, 0)
+        XCTAssertEqual(search("hope").count, 1)
+    }
+
+    func testPendingMessagesAreMergedByRank() {
+        let messageBodies = [
+            "apple banana cherry",
+            "apple",
+            "apple banana cherry date elderberry fig grape",
+            "banana",
+        ]
+        let messages = messageBodies.map { TSOutgoingMessage(in: thread, messageBody: $0) }
+        write { tx in
+            for message in messages {
+                message.anyInsert(transaction: tx)
+            }
+        }
+        indexPendingMessages()
+        let indexedResults = search("apple", isSorted: false)
+        XCTAssertEqual(indexedResults, [
+            "<match>apple</match>",
+            "<match>apple</match> banana cherry",
+            "<match>apple</match> banana cherry date elderberry fig grape",
+        ])
+
+        // A pending message ranks where it would if it were indexed.
+        write { tx in
+            messages[0].update(withMessageBody: messageBodies[0], transaction: tx)
+        }
+        XCTAssertEqual(pendingCount(), 1)
+        XCTAssertEqual(search("apple", isSorted: false), indexedResults)
+    }
+
+    func testPendingLogIsCapped() {
+        var messages = [TSOutgoingMessage]()
+        write { tx in
+            for index in 0...FullTextSearchIndexer.maxPendingCount {
+                let message = TSOutgoingMessage(in: thread, messageBody: "Message \(index)")
+                message.anyInsert(transaction: tx)
+                messages.append(message)
+            }
+        }
+        XCTAssertEqual(pendingCount(), FullTextSearchIndexer.maxPendingCount)
+        // The message that didn't fit was indexed immediately.
+        XCTAssertEqual(search("\(FullTextSearchIndexer.maxPendingCount)"), ["Message <match>\(FullTextSearchIndexer.maxPendingCount)</match>"])
+        XCTAssertEqual(search("Message").count, 100)
+    }
+
+    private func matchPendingContent(_ content: String, searchText: String) -> String? {
+        return SSKEnvironment.shared.databaseStorageRef.read { tx in
+            let tokenizer = try! tx.unwrapGrdbRead.database.makeTokenizer(.unicode61())
+            return FullTextSearchIndexer.matchPendingContent(
+                FullTextSearchIndexer.normalizeText(content),
+                queryPhrases: FullTextSearchIndexer.queryPhrases(for: searchText, tokenizer: tokenizer).map { $0.tokens },
+                tokenizer: tokenizer
+            )?.snippet
+        }
+    }
+
+    func testMatchPendingContent() {
+        let content = "NOËL and SØRINA met at the café"
+        XCTAssertEqual(
+            matchPendingContent(content, searchText: "noel caf"),
+            "<match>NOËL</match> and SØRINA met at the <match>café</match>"
+        )
+        // Like unicode61, Ø isn't treated as a diacritic.
+        XCTAssertNil(matchPendingContent(content, searchText: "sorina"))
+        XCTAssertNil(matchPendingContent(content, searchText: "noel bar"))
+
+        let longContent = (1...30).map { $0 == 10 ? "needle" : "hay" }.joined(separator: " ")
+        XCTAssertEqual(
+            matchPendingContent(longContent, searchText: "need"),
+            "…hay hay <match>needle</match> " + Array(repeating: "hay", count: 12).joined(separator: " ") + "…"
+        )
+    }
+}
+
+// MARK: -
+
+private extension TSOutgoingMessage {
+    convenience init(in thread: TSThread, messageBody: String) {
+        let builder: TSOutgoingMessageBuilder = .withDefaultValues(thread: thread, messageBody: messageBody)
+        self.init(outgoingMessageWith: builder, recipientAddressStates: [:])
+    }
+}
@@ -4,6 +4,7 @@
 //
 
 import Foundation
+import LibSignalClient
 import XCTest
 @testable import SignalServiceKit
 
@@ -58,6 +59,74 @@ class InteractionFinderTest: SSKBaseTest {
             XCTAssertEqual(4, try! finder1.fetchUniqueIdsForConversationView(rowIdFilter: .newest, limit: 100, tx: transaction).count)
             XCTAssertEqual(2, try! finder2.fetchUniqueIdsForConversationView(rowIdFilter: .newest, limit: 100, tx: transaction).count)
         }
+
+        self.read { transaction in
+            var outgoingMessageIds = [String]()
+            try! finder1.enumerateInteractionsForConversationView(
+                recordTypes: [.outgoingMessage],
+                rowIdFilter: .newest,
+                tx: transaction
+            ) { interaction -> Bool in
+                outgoingMessageIds.append(interaction.uniqueId)
+                return true
+            }
+            XCTAssertEqual(outgoingMessageIds, [outgoingMessage1.uniqueId])
+
+            var projections = [InteractionFinder.InteractionProjection]()
+            try! finder1.enumerateInteractionProjectionsForConversationView(
+                rowIdFilter: .newest,
+                tx: transaction
+            ) { projection -> Bool in
+                projections.append(projection)
+                return true
+            }
+            XCTAssertEqual(projections.map(\.uniqueId), [missedCall, errorMessage2, errorMessage1, outgoingMessage1].map(\.uniqueId))
+            XCTAssertEqual(projections.first?.recordType, .call)
+            XCTAssertEqual(projections.first?.fetchInteraction(tx: transaction)?.uniqueId, missedCall.uniqueId)
+
+            var errorMessageCount = 0
+            try! finder1.enumerateInteractionProjectionsForConversationView(
+                recordTypes: [.errorMessage],
+                rowIdFilter: .newest,
+                tx: transaction
+            ) { _ -> Bool in
+                errorMessageCount += 1
+                return true
+            }
+            XCTAssertEqual(errorMessageCount, 2)
+        }
+    }
+
+    func testPlaceholdersWithTimestamp() {
+        let senderAci = Aci.randomForTesting()
+        let timestamp: UInt64 = 1234
+
+        write { tx in
+            let thread = TSContactThread.getOrCreateThread(
+                withContactAddress: SignalServiceAddress(senderAci),
+                transaction: tx
+            )
+            // An unrelated interaction with the same timestamp.
+            let builder: TSOutgoingMessageBuilder = .withDefaultValues(thread: thread, timestamp: timestamp, messageBody: "hello")
+            TSOutgoingMessage(outgoingMessageWith: builder, recipientAddressStates: [:]).anyInsert(transaction: tx)
+
+            OWSRecoverableDecryptionPlaceholder(
+                failedEnvelopeTimestamp: timestamp,
+                sourceAci: AciObjC(senderAci),
+                untrustedGroupId: nil,
+                transaction: tx
+            )!.anyInsert(transaction: tx)
+        }
+
+        read { tx in
+            let placeholders = try! InteractionFinder.placeholders(withTimestamp: timestamp, transaction: tx)
+            XCTAssertEqual(placeholders.map { $0.sender?.serviceId }, [senderAci])
+            XCTAssertEqual(try! InteractionFinder.placeholders(withTimestamp: timestamp + 1, transaction: tx).count, 0)
+
+            var enumeratedCount = 0
+            InteractionFinder.enumeratePlaceholders(transaction: tx) { _ in enumeratedCount += 1 }
+            XCTAssertEqual(enumeratedCount, 1)
+        }
     }
 
     func testUnreadInArchiveIsIgnored() {
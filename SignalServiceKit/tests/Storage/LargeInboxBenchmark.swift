@@ -0,0 +1,199 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import Foundation
+import GRDB
+import XCTest
+@testable import SignalServiceKit
+
+/// Measures inbox and thread operations against a database the size of a
+/// heavy user's: 10k threads and 5M interactions.
+///
+/// Inserting millions of models would take hours, so one message per
+/// thread is inserted normally and then copied in SQL. The copies only
+/// exist in `model_TSInteraction` (e.g. they aren't in the search index),
+/// which is all that the measured queries read. One thread holds a large
+/// share of the interactions, so per-thread operations are measured on
+/// both a busy thread and a typical one.
+///
+/// Generating the database takes several minutes and a few GB of disk.
+/// Set `SIGNAL_BENCHMARKS` to run; see `BenchmarkHarness`.
+class LargeInboxBenchmark: SSKBaseTest {
+    private let threadCount = 10_000
+    private let interactionCount = 5_000_000
+    private let busyThreadInteractionCount = 500_000
+
+    /// The inbox shows roughly this many rows on first load.
+    private let inboxPageSize = 50
+
+    override func setUp() {
+        super.setUp()
+
+        write { tx in
+            (DependenciesBridge.shared.registrationStateChangeManager as! RegistrationStateChangeManagerImpl).registerForTests(
+                localIdentifiers: .forUnitTests,
+                tx: tx.asV2Write
+            )
+        }
+    }
+
+    // MARK: - Fixtures
+
+    /// Returns the threads, busiest first.
+    private func generateDatabase() throws -> [TSContactThread] {
+        let threads: [TSContactThread] = write { tx in
+            return (0..<threadCount).map { index in
+                let thread = TSContactThread(contactAddress: SignalServiceAddress.randomForTesting())
+                thread.anyInsert(transaction: tx)
+                TSIncomingMessageBuilder.withDefaultValues(
+                    thread: thread,
+                    timestamp: 1_700_000_000_000 + UInt64(index) * 1_000_000,
+                    authorAci: thread.contactAddress.aci,
+                    messageBody: "Are we still on for dinner tomorrow?",
+                    // Every tenth thread is unread.
+                    read: index % 10 != 0
+                ).build().anyInsert(transaction: tx)
+                return thread
+            }
+        }
+
+        let typicalCopyCount = (interactionCount - busyThreadInteractionCount) / (threadCount - 1) - 1
+        try copyMessages(in: threads.prefix(1), copyCount: busyThreadInteractionCount - 1)
+        try copyMessages(in: threads.dropFirst(), copyCount: typicalCopyCount)
+
+        write { tx in
+            try! tx.unwrapGrdbWrite.database.execute(sql: """
+                UPDATE \(ThreadRecord.databaseTableName)
+                SET \(threadColumn: .lastInteractionRowId) = (
+                    SELECT MAX(\(interactionColumn: .id))
+                    FROM \(InteractionRecord.databaseTableName)
+                    WHERE \(interactionColumn: .threadUniqueId) = \(threadColumnFullyQualified: .uniqueId)
+                )
+                """)
+        }
+        // The threads' cached copies are now stale.
+        SSKEnvironment.shared.modelReadCachesRef.evacuateAllCaches()
+
+        return threads
+    }
+
+    /// Copies every interaction in `threads` `copyCount` times, in batches
+    /// of threads so that no single transaction gets too large.
+    private func copyMessages(in threads: ArraySlice<TSContactThread>, copyCount: Int) throws {
+        let batchSize = max(1, 50_000 / max(copyCount, 1))
+        var remainingThreads = threads
+        while !remainingThreads.isEmpty {
+            let batch = remainingThreads.prefix(batchSize)
+            remainingThreads = remainingThreads.dropFirst(batchSize)
+            try write { tx in
+                let database = tx.unwrapGrdbWrite.database
+                let columns = try database.columns(in: InteractionRecord.databaseTableName)
+                    .map(\.name)
+                    .filter { $0 != InteractionRecord.columnName(.id) }
+                let values = columns.map { column -> String in
+                    switch column {
+                    case InteractionRecord.columnName(.uniqueId):
+                        return "\"\(column)\" || '-' || copy.n"
+                    case InteractionRecord.columnName(.timestamp), InteractionRecord.columnName(.receivedAtTimestamp):
+                        return "\"\(column)\" + copy.n"
+                    default:
+                        return "\"\(column)\""
+                    }
+                }
+                let threadUniqueIds = batch.map(\.uniqueId)
+                try database.execute(
+                    sql: """
+                        WITH RECURSIVE copy(n) AS (
+                            SELECT 1 UNION ALL SELECT n + 1 FROM copy WHERE n < ?
+                        )
+                        INSERT INTO \(InteractionRecord.databaseTableName) (\(columns.map { "\"\($0)\"" }.joined(separator: ", ")))
+                        SELECT \(values.joined(separator: ", "))
+                        FROM \(InteractionRecord.databaseTableName), copy
+                        WHERE \(interactionColumn: .threadUniqueId) IN (\(threadUniqueIds.map { _ in "?" }.joined(separator: ", ")))
+                        """,
+                    arguments: StatementArguments([copyCount] + threadUniqueIds)
+                )
+            }
+        }
+    }
+
+    private func deleteThread(_ thread: TSThread) {
+        write { tx in
+            DependenciesBridge.shared.threadSoftDeleteManager
+                .softDelete(threads: [thread], sendDeleteForMeSyncMessage: false, tx: tx.asV2Write)
+        }
+    }
+
+    // MARK: - Benchmarks
+
+    func testLargeInbox() throws {
+        try BenchmarkHarness.skipUnlessEnabled()
+
+        let threads = try generateDatabase()
+        let busyThread = threads[0]
+        let typicalThread = threads[threads.count / 2]
+
+        BenchmarkHarness.measure("Inbox load (\(inboxPageSize) rows)", iterations: 10) {
+            read { tx in
+                let threadUniqueIds = try! ThreadFinder().visibleInboxThreadIds(transaction: tx)
+                // Roughly what each chat list cell's view model loads.
+                for threadUniqueId in threadUniqueIds.prefix(inboxPageSize) {
+                    let thread = TSThread.anyFetch(uniqueId: threadUniqueId, transaction: tx, ignoreCache: true)!
+                    _ = thread.lastInteractionForInbox(transaction: tx)
+                    _ = InteractionFinder(threadUniqueId: threadUniqueId).unreadCount(transaction: tx)
+                }
+            }
+        }
+
+        BenchmarkHarness.measure("Unread count, all threads", iterations: 20) {
+            read { tx in
+                _ = InteractionFinder.unreadCountInAllThreads(transaction: tx)
+            }
+        }
+
+        for (name, thread) in [("busy", busyThread), ("typical", typicalThread)] {
+            BenchmarkHarness.measure("lastInteractionForInbox, \(name) thread", iterations: 100) {
+                read { tx in
+                    _ = thread.lastInteractionForInbox(transaction: tx)
+                }
+            }
+
+            BenchmarkHarness.measure("Unread count, \(name) thread", iterations: 100) {
+                read { tx in
+                    _ = InteractionFinder(threadUniqueId: thread.uniqueId).unreadCount(transaction: tx)
+                }
+            }
+
+            BenchmarkHarness.measure("receivedMessagesForInvalidKey, \(name) thread", iterations: 20) {
+                read { tx in
+                    _ = thread.receivedMessages(forInvalidKey: Randomness.generateRandomBytes(32), tx: tx)
+                }
+            }
+
+            write { tx in
+                let message = TSIncomingMessageBuilder.withDefaultValues(
+                    thread: thread,
+                    authorAci: thread.contactAddress.aci,
+                    messageBody: "One more thing"
+                ).build()
+                message.anyInsert(transaction: tx)
+                BenchmarkHarness.measure("updateWithInsertedMessage, \(name) thread", iterations: 100) {
+                    thread.update(withInsertedMessage: message, transaction: tx)
+                }
+            }
+        }
+
+        // The harness runs each block once to warm up before measuring, so
+        // each measurement deletes one more thread than it has iterations.
+        var typicalThreadsToDelete = Array(threads[1...5])
+        BenchmarkHarness.measure("Thread deletion, typical thread", iterations: typicalThreadsToDelete.count - 1) {
+            deleteThread(typicalThreadsToDelete.removeLast())
+        }
+        var busyThreadsToDelete = [busyThread, threads[6]]
+        BenchmarkHarness.measure("Thread deletion, busy thread", iterations: 1) {
+            deleteThread(busyThreadsToDelete.removeLast())
+        }
+    }
+}
@@ -334,4 +334,23 @@ class ModelReadCacheTest: SSKBaseTest {
             }
         }
     }
+
+    func testStatistics() {
+        let address: OWSUserProfile.Address = .otherUser(SignalServiceAddress.randomForTesting())
+        adapter.storage[address] = OWSUserProfile(address: address)
+        read { [unowned self] transaction in
+            let cache = TestableModelReadCache(mode: .read, adapter: adapter, appReadiness: AppReadinessMock())
+            let cacheKey = adapter.cacheKey(forKey: address)
+            _ = cache.getValue(for: cacheKey, transaction: transaction)
+            XCTAssertEqual(cache.statistics.hitCount, 0)
+            XCTAssertEqual(cache.statistics.missCount, 1)
+
+            cache.didRead(value: adapter.storage[address]!, transaction: transaction)
+            _ = cache.getValue(for: cacheKey, transaction: transaction)
+            _ = cache.getValue(for: cacheKey, transaction: transaction)
+            XCTAssertEqual(cache.statistics.hitCount, 2)
+            XCTAssertEqual(cache.statistics.missCount, 1)
+            XCTAssertEqual(cache.statistics.hitRate, 2.0 / 3.0, accuracy: 0.001)
+        }
+    }
 }
@@ -0,0 +1,223 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import Foundation
+import GRDB
+import XCTest
+@testable import SignalServiceKit
+
+/// Compares `initWithCoder:` with the generated `initWithGrdbId:…`
+/// initializers (via `fromRecord`) for the models that dominate the
+/// database, and measures the full-row re-encode of an update.
+///
+/// Set `SIGNAL_BENCHMARKS` to run; see `BenchmarkHarness`.
+class ModelSerializationBenchmark: SSKBaseTest {
+    private let iterations = 2_000
+
+    private let aliceAci = Aci.constantForTesting("00000000-0000-4000-8000-0000000000a1")
+    private lazy var aliceAddress = SignalServiceAddress(aliceAci)
+
+    override func setUp() {
+        super.setUp()
+
+        write { tx in
+            (DependenciesBridge.shared.registrationStateChangeManager as! RegistrationStateChangeManagerImpl).registerForTests(
+                localIdentifiers: .forUnitTests,
+                tx: tx.asV2Write
+            )
+        }
+    }
+
+    // MARK: - Fixtures
+
+    /// About the length of a typical message, with a mention and a few styles.
+    private static let messageBody = String(repeating: "Are we still on for dinner tomorrow? ", count: 4)
+
+    private func messageBodyRanges() -> MessageBodyRanges {
+        return MessageBodyRanges(
+            mentions: [NSRange(location: 0, length: 1): aliceAci],
+            styles: [
+                .init(.bold, range: NSRange(location: 4, length: 8)),
+                .init(.italic, range: NSRange(location: 20, length: 16)),
+            ]
+        )
+    }
+
+    private func insertContactThread(transaction: SDSAnyWriteTransaction) -> TSContactThread {
+        let thread = TSContactThread(contactAddress: aliceAddress)
+        thread.anyInsert(transaction: transaction)
+        return thread
+    }
+
+    // MARK: - Benchmarks
+
+    func testOutgoingMessage() throws {
+        try BenchmarkHarness.skipUnlessEnabled()
+
+        let message: TSOutgoingMessage = write { tx in
+            let thread = insertContactThread(transaction: tx)
+            let message = TSOutgoingMessageBuilder.withDefaultValues(
+                thread: thread,
+                messageBody: Self.messageBody,
+                bodyRanges: messageBodyRanges(),
+                expiresInSeconds: 7 * UInt32(kDayInterval)
+            ).build(transaction: tx)
+            message.anyInsert(transaction: tx)
+            return message
+        }
+        try benchmark(
+            "TSOutgoingMessage",
+            model: message,
+            recordType: InteractionRecord.self,
+            fromRecord: TSInteraction.fromRecord(_:),
+            update: { message.anyOverwritingUpdate(transaction: $0) }
+        )
+    }
+
+    func testIncomingMessage() throws {
+        try BenchmarkHarness.skipUnlessEnabled()
+
+        let message: TSIncomingMessage = write { tx in
+            let thread = insertContactThread(transaction: tx)
+            let message = TSIncomingMessageBuilder.withDefaultValues(
+                thread: thread,
+                authorAci: aliceAci,
+                messageBody: Self.messageBody,
+                bodyRanges: messageBodyRanges(),
+                serverTimestamp: 1_700_000_000_000,
+                serverDeliveryTimestamp: 1_700_000_000_100,
+                serverGuid: UUID().uuidString,
+                wasReceivedByUD: true
+            ).build()
+            message.anyInsert(transaction: tx)
+            return message
+        }
+        try benchmark(
+            "TSIncomingMessage",
+            model: message,
+            recordType: InteractionRecord.self,
+            fromRecord: TSInteraction.fromRecord(_:),
+            update: { message.anyOverwritingUpdate(transaction: $0) }
+        )
+    }
+
+    func testAttachmentStream() throws {
+        try BenchmarkHarness.skipUnlessEnabled()
+
+        let attachment: TSAttachmentStream = write { tx in
+            let attachment = TSAttachmentStream(
+                contentType: MimeType.imageJpeg.rawValue,
+                byteCount: 1_500_000,
+                sourceFilename: "IMG_0001.jpg",
+                caption: "The view from the top",
+                attachmentType: .default,
+                albumMessageId: UUID().uuidString
+            )
+            attachment.anyInsert(transaction: tx)
+            return attachment
+        }
+        try benchmark(
+            "TSAttachmentStream",
+            model: attachment,
+            recordType: AttachmentRecord.self,
+            fromRecord: TSAttachment.fromRecord(_:),
+            update: { attachment.anyOverwritingUpdate(transaction: $0) }
+        )
+    }
+
+    func testGroupThread() throws {
+        try BenchmarkHarness.skipUnlessEnabled()
+
+        let groupThread: TSGroupThread = try write { tx in
+            let members = (0..<32).map { _ in SignalServiceAddress.randomForTesting() }
+            return try GroupManager.createGroupForTests(members: members, name: "Book Club", transaction: tx)
+        }
+        try benchmark(
+            "TSGroupThread",
+            model: groupThread,
+            recordType: ThreadRecord.self,
+            fromRecord: TSThread.fromRecord(_:),
+            update: { groupThread.anyOverwritingUpdate(transaction: $0) }
+        )
+    }
+
+    func testPaymentModel() throws {
+        try BenchmarkHarness.skipUnlessEnabled()
+
+        let paymentModel: TSPaymentModel = write { tx in
+            let mobileCoin = MobileCoinPayment(
+                recipientPublicAddressData: Randomness.generateRandomBytes(64),
+                transactionData: Randomness.generateRandomBytes(2048),
+                receiptData: Randomness.generateRandomBytes(256),
+                incomingTransactionPublicKeys: nil,
+                spentKeyImages: [Randomness.generateRandomBytes(32), Randomness.generateRandomBytes(32)],
+                outputPublicKeys: [Randomness.generateRandomBytes(32), Randomness.generateRandomBytes(32)],
+                ledgerBlockTimestamp: 1_700_000_000_000,
+                ledgerBlockIndex: 1_000_000,
+                feeAmount: TSPaymentAmount(currency: .mobileCoin, picoMob: 1_000_000_000)
+            )
+            let paymentModel = TSPaymentModel(
+                paymentType: .outgoingPayment,
+                paymentState: .outgoingComplete,
+                paymentAmount: TSPaymentAmount(currency: .mobileCoin, picoMob: 5_000_000_000_000),
+                createdDate: Date(),
+                senderOrRecipientAci: AciObjC(aliceAci),
+                memoMessage: "Dinner",
+                isUnread: false,
+                interactionUniqueId: nil,
+                mobileCoin: mobileCoin
+            )
+            paymentModel.anyInsert(transaction: tx)
+            return paymentModel
+        }
+        try benchmark(
+            "TSPaymentModel",
+            model: paymentModel,
+            recordType: PaymentModelRecord.self,
+            fromRecord: TSPaymentModel.fromRecord(_:),
+            update: { paymentModel.anyOverwritingUpdate(transaction: $0) }
+        )
+    }
+
+    // MARK: -
+
+    private func benchmark<Model: BaseModel, Record: SDSRecord>(
+        _ name: String,
+        model: Model,
+        recordType: Record.Type,
+        fromRecord: (Record) throws -> BaseModel,
+        update: (SDSAnyWriteTransaction) -> Void
+    ) throws {
+        let archive = try NSKeyedArchiver.archivedData(withRootObject: model, requiringSecureCoding: false)
+        BenchmarkHarness.measure("\(name) initWithCoder:", iterations: iterations) { () -> Any? in
+            let unarchiver = try! NSKeyedUnarchiver(forReadingFrom: archive)
+            unarchiver.requiresSecureCoding = false
+            let result = unarchiver.decodeObject(forKey: NSKeyedArchiveRootObjectKey)
+            unarchiver.finishDecoding()
+            owsPrecondition(result is Model)
+            return result
+        }
+
+        let record: Record = try XCTUnwrap(SSKEnvironment.shared.databaseStorageRef.read { tx in
+            try! Record.fetchOne(
+                tx.unwrapGrdbRead.database,
+                sql: "SELECT * FROM \(Record.databaseTableName) WHERE uniqueId = ?",
+                arguments: [model.uniqueId]
+            )
+        })
+        try BenchmarkHarness.measure("\(name) initWithGrdbId:", iterations: iterations) { () -> Any in
+            let result = try fromRecord(record)
+            owsPrecondition(result is Model)
+            return result
+        }
+
+        write { tx in
+            // Every update re-encodes (and rewrites) the entire row.
+            BenchmarkHarness.measure("\(name) update", iterations: iterations) {
+                update(tx)
+            }
+        }
+    }
+}
@@ -53,6 +53,37 @@ class SDSKeyValueStoreTest: SSKBaseTest {
         }
     }
 
+    func test_cachedValues() {
+        let store = SDSKeyValueStore(collection: "cachedTest", isCached: true)
+
+        self.read { transaction in
+            XCTAssertNil(store.getBool("boolA", transaction: transaction))
+        }
+        self.write { transaction in
+            store.setBool(true, key: "boolA", transaction: transaction)
+            XCTAssertEqual(store.getBool("boolA", transaction: transaction), true)
+        }
+        self.read { transaction in
+            XCTAssertEqual(store.getBool("boolA", transaction: transaction), true)
+            XCTAssertEqual(store.getBool("boolA", transaction: transaction), true)
+        }
+        self.write { transaction in
+            store.setBool(false, key: "boolA", transaction: transaction)
+            store.setString("test", key: "stringA", transaction: transaction)
+        }
+        self.read { transaction in
+            XCTAssertEqual(store.getBool("boolA", transaction: transaction), false)
+            XCTAssertEqual(store.getString("stringA", transaction: transaction), "test")
+        }
+        self.write { transaction in
+            store.removeAll(transaction: transaction)
+        }
+        self.read { transaction in
+            XCTAssertNil(store.getBool("boolA", transaction: transaction))
+            XCTAssertNil(store.getString("stringA", transaction: transaction))
+        }
+    }
+
     func test_string() {
         let store = SDSKeyValueStore(collection: "test")
 
@@ -0,0 +1,55 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import Foundation
+import XCTest
+@testable import SignalServiceKit
+
+class SDSParallelDecoderTest: SSKBaseTest {
+    private func insertMessages(count: Int) -> [String] {
+        let thread = TSContactThread(contactAddress: SignalServiceAddress(phoneNumber: "+13213334444"))
+        var uniqueIds = [String]()
+        write { transaction in
+            thread.anyInsert(transaction: transaction)
+            for index in 0..<count {
+                let message = TSOutgoingMessage(in: thread, messageBody: "message \(index)")
+                message.anyInsert(transaction: transaction)
+                uniqueIds.append(message.uniqueId)
+            }
+        }
+        return uniqueIds
+    }
+
+    func testEnumeratesAllInteractionsInOrder() {
+        // Span several pages.
+        let uniqueIds = insertMessages(count: SDSParallelDecoder.defaultPageSize * 2 + 3)
+        read { transaction in
+            var expected = [String]()
+            TSInteraction.anyEnumerate(transaction: transaction) { interaction, _ in
+                expected.append(interaction.uniqueId)
+            }
+            var actual = [String]()
+            TSInteraction.anyEnumerateDecodingInParallel(transaction: transaction) { interaction, _ in
+                actual.append(interaction.uniqueId)
+            }
+            XCTAssertEqual(actual, expected)
+            XCTAssertEqual(Set(actual), Set(uniqueIds))
+        }
+    }
+
+    func testStop() {
+        _ = insertMessages(count: SDSParallelDecoder.defaultPageSize + 1)
+        read { transaction in
+            var count = 0
+            TSInteraction.anyEnumerateDecodingInParallel(transaction: transaction) { _, stop in
+                count += 1
+                if count == 3 {
+                    stop.pointee = true
+                }
+            }
+            XCTAssertEqual(count, 3)
+        }
+    }
+}
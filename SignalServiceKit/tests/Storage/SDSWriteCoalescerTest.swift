@@ -0,0 +1,77 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import Foundation
+import XCTest
+@testable import SignalServiceKit
+
+class SDSWriteCoalescerTest: SSKBaseTest {
+    func testWritesAreCommittedAndCompleted() {
+        let store = SDSKeyValueStore(collection: "SDSWriteCoalescerTest")
+        let coalescer = SDSWriteCoalescer(databaseStorage: SSKEnvironment.shared.databaseStorageRef, maxDelay: 0.01, maxBatchCount: 4)
+
+        // Enough writes for a full batch plus a delayed one.
+        let writeCount = 6
+        var expectations = [XCTestExpectation]()
+        for index in 0..<writeCount {
+            let expectation = self.expectation(description: "write \(index)")
+            expectations.append(expectation)
+            coalescer.enqueue(
+                block: { tx in store.setInt(index, key: "\(index)", transaction: tx) },
+                completion: { expectation.fulfill() }
+            )
+        }
+        wait(for: expectations, timeout: 5)
+
+        read { tx in
+            for index in 0..<writeCount {
+                XCTAssertEqual(store.getInt("\(index)", transaction: tx), index)
+            }
+        }
+    }
+
+    func testWritesRunInOrder() {
+        let store = SDSKeyValueStore(collection: "SDSWriteCoalescerTest")
+        let coalescer = SDSWriteCoalescer(databaseStorage: SSKEnvironment.shared.databaseStorageRef, maxDelay: 0.01)
+
+        let expectation = self.expectation(description: "writes")
+        coalescer.enqueue(block: { tx in store.setString("first", key: "key", transaction: tx) })
+        coalescer.enqueue(
+            block: { tx in store.setString("second", key: "key", transaction: tx) },
+            completion: { expectation.fulfill() }
+        )
+        wait(for: [expectation], timeout: 5)
+
+        read { tx in
+            XCTAssertEqual(store.getString("key", transaction: tx), "second")
+        }
+    }
+
+    func testFailingWriteDoesNotAffectBatchMates() {
+        let store = SDSKeyValueStore(collection: "SDSWriteCoalescerTest")
+        let coalescer = SDSWriteCoalescer(databaseStorage: SSKEnvironment.shared.databaseStorageRef, maxDelay: 0.01)
+
+        let expectation = self.expectation(description: "writes")
+        coalescer.enqueue(block: { tx in store.setString("before", key: "before", transaction: tx) })
+        coalescer.enqueue(block: { tx in
+            do {
+                try tx.unwrapGrdbWrite.database.execute(sql: "INSERT INTO SDSWriteCoalescerTestMissingTable VALUES (1)")
+                XCTFail("Statement unexpectedly succeeded.")
+            } catch {
+                // Expected.
+            }
+        })
+        coalescer.enqueue(
+            block: { tx in store.setString("after", key: "after", transaction: tx) },
+            completion: { expectation.fulfill() }
+        )
+        wait(for: [expectation], timeout: 5)
+
+        read { tx in
+            XCTAssertEqual(store.getString("before", transaction: tx), "before")
+            XCTAssertEqual(store.getString("after", transaction: tx), "after")
+        }
+    }
+}
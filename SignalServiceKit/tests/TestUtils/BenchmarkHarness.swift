@@ -0,0 +1,176 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import Foundation
+import SignalServiceKit
+import XCTest
+
+/// Measures the time and allocations of a block, per iteration.
+///
+/// Benchmarks are skipped unless `SIGNAL_BENCHMARKS` is set in the test
+/// scheme's environment; they're slow, and their numbers only mean
+/// something in a Release build on a device. Each result is printed as a
+/// single `[Benchmark]` line so that runs can be compared.
+///
+/// Allocations are counted as the growth in live malloc blocks across the
+/// measured iterations, with every iteration's result kept alive until the
+/// end. That's the size of the object graph the block builds; temporary
+/// allocations that are freed before the block returns aren't counted.
+enum BenchmarkHarness {
+
+    struct Result {
+        var title: String
+        var iterations: Int
+        var nanosecondsPerOp: Double
+        var allocationsPerOp: Double
+        var bytesPerOp: Double
+
+        var formatted: String {
+            return String(
+                format: "[Benchmark] %@: %.0f ns/op, %.1f allocs/op, %.0f bytes/op (%d iterations)",
+                title,
+                nanosecondsPerOp,
+                allocationsPerOp,
+                bytesPerOp,
+                iterations
+            )
+        }
+    }
+
+    static func skipUnlessEnabled() throws {
+        try XCTSkipUnless(
+            ProcessInfo.processInfo.environment["SIGNAL_BENCHMARKS"] != nil,
+            "Set SIGNAL_BENCHMARKS to run benchmarks."
+        )
+    }
+
+    @discardableResult
+    static func measure<T>(_ title: String, iterations: Int, block: () throws -> T) rethrows -> Result {
+        // Warm up caches, lazy statics, etc.
+        _ = try autoreleasepool { try block() }
+
+        var results = [T]()
+        results.reserveCapacity(iterations)
+
+        let statsBefore = mallocStatistics()
+        let startTime = clock_gettime_nsec_np(CLOCK_UPTIME_RAW)
+        try autoreleasepool {
+            for _ in 0..<iterations {
+                results.append(try block())
+            }
+        }
+        let endTime = clock_gettime_nsec_np(CLOCK_UPTIME_RAW)
+        let statsAfter = mallocStatistics()
+        withExtendedLifetime(results) {}
+
+        let result = Result(
+            title: title,
+            iterations: iterations,
+            nanosecondsPerOp: Double(endTime - startTime) / Double(iterations),
+            allocationsPerOp: (Double(statsAfter.blocks_in_use) - Double(statsBefore.blocks_in_use)) / Double(iterations),
+            bytesPerOp: (Double(statsAfter.size_in_use) - Double(statsBefore.size_in_use)) / Double(iterations)
+        )
+        print(result.formatted)
+        return result
+    }
+
+    /// Times the stages of one iteration separately. Work before `start()`
+    /// (e.g. fetching fixtures) isn't counted; `lap(_:)` ends a stage.
+    struct Stopwatch {
+        fileprivate var stageNames = [String]()
+        fileprivate var stageNanoseconds = [String: UInt64]()
+        private var lapStartTime = clock_gettime_nsec_np(CLOCK_UPTIME_RAW)
+
+        mutating func start() {
+            lapStartTime = clock_gettime_nsec_np(CLOCK_UPTIME_RAW)
+        }
+
+        mutating func lap(_ stage: String) {
+            let now = clock_gettime_nsec_np(CLOCK_UPTIME_RAW)
+            if stageNanoseconds[stage] == nil {
+                stageNames.append(stage)
+            }
+            stageNanoseconds[stage, default: 0] += now - lapStartTime
+            lapStartTime = now
+        }
+    }
+
+    /// Like `measure`, but reports each stage's ns/op instead of the whole
+    /// block's. Allocations aren't counted.
+    static func measureStages(_ title: String, iterations: Int, block: (inout Stopwatch) throws -> Void) rethrows {
+        var warmUpStopwatch = Stopwatch()
+        try autoreleasepool { try block(&warmUpStopwatch) }
+
+        var stopwatch = Stopwatch()
+        for _ in 0..<iterations {
+            try autoreleasepool { try block(&stopwatch) }
+        }
+
+        var totalNanoseconds: UInt64 = 0
+        for stage in stopwatch.stageNames {
+            let nanoseconds = stopwatch.stageNanoseconds[stage] ?? 0
+            totalNanoseconds += nanoseconds
+            print(String(
+                format: "[Benchmark] %@ / %@: %.0f ns/op",
+                title,
+                stage,
+                Double(nanoseconds) / Double(iterations)
+            ))
+        }
+        print(String(
+            format: "[Benchmark] %@: %.0f ns/op (%d iterations)",
+            title,
+            Double(totalNanoseconds) / Double(iterations),
+            iterations
+        ))
+    }
+
+    /// Samples the process's memory footprint in the background to find its
+    /// peak while work is in flight (including work on other threads).
+    final class PeakFootprintSampler {
+        private let queue = DispatchQueue(label: "org.signal.benchmark-footprint-sampler", qos: .userInteractive)
+        private var timer: DispatchSourceTimer?
+
+        // Only accessed on queue.
+        private var baselineFootprint: UInt64 = 0
+        private var peakFootprint: UInt64 = 0
+
+        func start() {
+            queue.sync {
+                baselineFootprint = Self.currentFootprint()
+                peakFootprint = baselineFootprint
+            }
+            let timer = DispatchSource.makeTimerSource(queue: queue)
+            timer.schedule(deadline: .now(), repeating: .milliseconds(2))
+            timer.setEventHandler { [unowned self] in
+                self.peakFootprint = max(self.peakFootprint, Self.currentFootprint())
+            }
+            timer.resume()
+            self.timer = timer
+        }
+
+        /// Returns the growth of the peak footprint over the footprint when
+        /// sampling started, in bytes.
+        func stop() -> UInt64 {
+            timer?.cancel()
+            timer = nil
+            return queue.sync {
+                peakFootprint = max(peakFootprint, Self.currentFootprint())
+                return peakFootprint - baselineFootprint
+            }
+        }
+
+        private static func currentFootprint() -> UInt64 {
+            return LocalDevice.currentMemoryStatus(forceUpdate: true)?.footprint ?? 0
+        }
+    }
+
+    private static func mallocStatistics() -> malloc_statistics_t {
+        var stats = malloc_statistics_t()
+        // A nil zone sums the statistics of every zone.
+        malloc_zone_statistics(nil, &stats)
+        return stats
+    }
+}
@@ -0,0 +1,26 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import XCTest
+@testable import SignalServiceKit
+
+class CacheCoordinatorTest: XCTestCase {
+    func testPurgeOrder() {
+        let coordinator = CacheCoordinator(observesMemoryPressure: false)
+
+        var purged = [String]()
+        coordinator.register(name: "model", priority: .model) { purged.append("model") }
+        coordinator.register(name: "media", priority: .media) { purged.append("media") }
+        coordinator.register(name: "placeholder", priority: .placeholder) { purged.append("placeholder") }
+
+        // A warning leaves the model caches alone.
+        coordinator.purgeCaches(for: .warning)
+        XCTAssertEqual(purged, ["placeholder", "media"])
+
+        purged = []
+        coordinator.purgeCaches(for: .critical)
+        XCTAssertEqual(purged, ["placeholder", "media", "model"])
+    }
+}
@@ -0,0 +1,29 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import XCTest
+@testable import SignalServiceKit
+
+class ContentionProfilerTest: XCTestCase {
+    func testWorstOffenders() {
+        let profiler = ContentionProfiler(isEnabled: true)
+        let now = CACurrentMediaTime()
+        profiler.recordWait(site: "short", startTime: now)
+        profiler.recordWait(site: "long", startTime: now - 0.5)
+        profiler.recordWait(site: "long", startTime: now - 0.25)
+
+        let worstOffenders = profiler.worstOffenders(limit: 1)
+        XCTAssertEqual(worstOffenders.map(\.site), ["long"])
+        XCTAssertEqual(worstOffenders.first?.statistics.waitCount, 2)
+        XCTAssertGreaterThanOrEqual(worstOffenders.first?.statistics.maxWaitTime ?? 0, 0.5)
+        XCTAssertEqual(profiler.worstOffenders(limit: 10).count, 2)
+    }
+
+    func testDisabled() {
+        let profiler = ContentionProfiler(isEnabled: false)
+        profiler.measureWait(site: "site") {}
+        XCTAssertTrue(profiler.worstOffenders(limit: 10).isEmpty)
+    }
+}
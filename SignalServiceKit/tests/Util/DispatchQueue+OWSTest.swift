@@ -65,4 +65,22 @@ class DispatchQueueOWSTests: XCTestCase {
             }
         }
     }
+
+    func testIsCurrentQueue() {
+        let queue = DispatchQueue(label: "org.signal.test.is-current-queue")
+        let targetingQueue = DispatchQueue(label: "org.signal.test.targeting-queue", target: queue)
+        let otherQueue = DispatchQueue(label: "org.signal.test.other-queue")
+
+        XCTAssertTrue(DispatchQueueIsCurrentQueue(.main))
+        XCTAssertFalse(DispatchQueueIsCurrentQueue(queue))
+        queue.sync {
+            XCTAssertTrue(DispatchQueueIsCurrentQueue(queue))
+            XCTAssertFalse(DispatchQueueIsCurrentQueue(otherQueue))
+            XCTAssertFalse(DispatchQueueIsCurrentQueue(.main))
+        }
+        targetingQueue.sync {
+            XCTAssertTrue(DispatchQueueIsCurrentQueue(targetingQueue))
+            XCTAssertTrue(DispatchQueueIsCurrentQueue(queue))
+        }
+    }
 }
@@ -0,0 +1,38 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import XCTest
+@testable import SignalServiceKit
+
+class HotPathLogTest: XCTestCase {
+    override func tearDown() {
+        HotPathLog.setIsEnabled(false)
+        super.tearDown()
+    }
+
+    func testDecodedText() {
+        HotPathLog.setIsEnabled(true)
+        HotPathLog.record(.sends, "Test event on main thread", 1234, 5)
+
+        let expectation = expectation(description: "Recorded on another thread")
+        Thread.detachNewThread {
+            HotPathLog.record(.thumbnails, "Test event on another thread", 42)
+            expectation.fulfill()
+        }
+        wait(for: [expectation], timeout: 1)
+
+        let text = HotPathLog.decodedText()
+        XCTAssertTrue(text.contains("[Sends]"))
+        XCTAssertTrue(text.contains("Test event on main thread: 1234, 5"))
+        XCTAssertTrue(text.contains("[Thumbnails]"))
+        XCTAssertTrue(text.contains("Test event on another thread: 42, 0"))
+    }
+
+    func testDisabled() {
+        HotPathLog.setIsEnabled(false)
+        HotPathLog.record(.sends, "Test event while disabled")
+        XCTAssertFalse(HotPathLog.decodedText().contains("Test event while disabled"))
+    }
+}
@@ -0,0 +1,61 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import XCTest
+@testable import SignalServiceKit
+
+class MainThreadSchedulerTest: XCTestCase {
+    func testUserVisibleBlocksRunFirst() {
+        let scheduler = MainThreadScheduler(sliceBudget: 10)
+        let order = AtomicArray<String>(lock: .init())
+        let expectation = expectation(description: "All blocks ran")
+        expectation.expectedFulfillmentCount = 4
+
+        // Keep the main thread busy so that every block is queued before the
+        // first slice runs.
+        let queued = DispatchSemaphore(value: 0)
+        DispatchQueue.main.async {
+            queued.wait()
+        }
+        DispatchQueue.global().async {
+            for name in ["background1", "visible1", "background2", "visible2"] {
+                let priority: MainThreadWorkPriority = name.hasPrefix("visible") ? .userVisible : .background
+                scheduler.schedule(priority: priority) {
+                    XCTAssertTrue(Thread.isMainThread)
+                    order.append(name)
+                    expectation.fulfill()
+                }
+            }
+            queued.signal()
+        }
+
+        wait(for: [expectation], timeout: 5)
+        XCTAssertEqual(order.get(), ["visible1", "visible2", "background1", "background2"])
+    }
+
+    func testRunsImmediatelyOnMainThread() {
+        let scheduler = MainThreadScheduler(sliceBudget: 0)
+        var didRun = false
+        scheduler.schedule(priority: .background) {
+            didRun = true
+        }
+        XCTAssertTrue(didRun)
+    }
+
+    func testSlicesRunEveryBlock() {
+        // With no budget, each slice runs a single block.
+        let scheduler = MainThreadScheduler(sliceBudget: 0)
+        let expectation = expectation(description: "All blocks ran")
+        expectation.expectedFulfillmentCount = 10
+        DispatchQueue.global().async {
+            for _ in 0..<10 {
+                scheduler.schedule(priority: .userVisible) {
+                    expectation.fulfill()
+                }
+            }
+        }
+        wait(for: [expectation], timeout: 5)
+    }
+}
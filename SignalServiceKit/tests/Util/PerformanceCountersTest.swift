@@ -0,0 +1,62 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import XCTest
+@testable import SignalServiceKit
+
+class PerformanceCountersTest: XCTestCase {
+    func testDecryptionRate() {
+        var now: TimeInterval = 1000
+        let counters = PerformanceCounters(now: { now })
+
+        for _ in 0..<30 {
+            counters.recordDecryption()
+        }
+        now += 1
+        for _ in 0..<90 {
+            counters.recordDecryption()
+        }
+
+        var snapshot = counters.snapshot()
+        XCTAssertEqual(snapshot.decryptionCount, 120)
+        XCTAssertEqual(snapshot.decryptionsPerSecond, 2)
+        XCTAssertEqual(snapshot.peakDecryptionsPerSecond, 90)
+
+        // Older seconds fall out of the window.
+        now += 60
+        snapshot = counters.snapshot()
+        XCTAssertEqual(snapshot.decryptionCount, 120)
+        XCTAssertEqual(snapshot.decryptionsPerSecond, 0)
+        XCTAssertEqual(snapshot.peakDecryptionsPerSecond, 0)
+    }
+
+    func testGaugesAndHistogram() {
+        let counters = PerformanceCounters(now: { 0 })
+
+        counters.sendDidStart()
+        counters.sendDidStart()
+        counters.sendDidFinish()
+        counters.setThumbnailQueueDepth(12)
+        counters.setThumbnailQueueDepth(3)
+        counters.recordThumbnailCacheLookup(isHit: true)
+        counters.recordThumbnailCacheLookup(isHit: true)
+        counters.recordThumbnailCacheLookup(isHit: true)
+        counters.recordThumbnailCacheLookup(isHit: false)
+        counters.recordWriteTransaction(duration: 0.0005)
+        counters.recordWriteTransaction(duration: 0.010)
+        counters.recordWriteTransaction(duration: 2)
+
+        let snapshot = counters.snapshot()
+        XCTAssertEqual(snapshot.sendsInFlight, 1)
+        XCTAssertEqual(snapshot.peakSendsInFlight, 2)
+        XCTAssertEqual(snapshot.thumbnailQueueDepth, 3)
+        XCTAssertEqual(snapshot.peakThumbnailQueueDepth, 12)
+        XCTAssertEqual(snapshot.thumbnailCacheHitRate, 0.75)
+        XCTAssertEqual(snapshot.writeTransactionCount, 3)
+        XCTAssertEqual(snapshot.writeTransactionMaxDuration, 2)
+        XCTAssertEqual(snapshot.writeDurationBuckets, [1, 0, 1, 0, 0, 0, 1])
+        XCTAssertTrue(counters.report().contains("hit rate 75.0%"))
+    }
+}
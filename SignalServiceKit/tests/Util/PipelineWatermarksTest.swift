@@ -0,0 +1,23 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+import XCTest
+@testable import SignalServiceKit
+
+class PipelineWatermarksTest: XCTestCase {
+    func testSample() {
+        let watermarks = PipelineWatermarks(reportFilePath: { OWSFileSystem.temporaryFilePath(fileExtension: "txt") }, writeDelay: 60)
+        XCTAssertNil(watermarks.watermark(for: .protoBuild))
+
+        watermarks.sample(.protoBuild)
+        watermarks.sample(.protoBuild)
+
+        let watermark = watermarks.watermark(for: .protoBuild)
+        XCTAssertEqual(watermark?.sampleCount, 2)
+        XCTAssertGreaterThan(watermark?.peakStackUsage ?? 0, 0)
+        XCTAssertNil(watermarks.watermark(for: .messageDecode))
+        XCTAssertTrue(watermarks.report().hasPrefix("ProtoBuild: 2 samples"))
+    }
+}
@@ -362,4 +362,20 @@ final class StringTest: XCTestCase {
     func testTrimToUtf8Count() {
         XCTAssertEqual("🥹🥷🥹🥷🥹".trimToUtf8ByteCount(9), "🥹🥷")
     }
+
+    func testTrimToUtf8CountAscii() {
+        let longAscii = String(repeating: "abcdefgh", count: 4)
+        XCTAssertEqual(longAscii.trimToUtf8ByteCount(32), longAscii)
+        XCTAssertEqual(longAscii.trimToUtf8ByteCount(19), String(longAscii.prefix(19)))
+        XCTAssertEqual(longAscii.trimToUtf8ByteCount(0), "")
+        XCTAssertEqual((longAscii as NSString).trimToUtf8ByteCount(19), String(longAscii.prefix(19)))
+
+        // "\r\n" is a single character.
+        XCTAssertEqual("abc\r\ndef".trimToUtf8ByteCount(4), "abc")
+        XCTAssertEqual("abc\r\ndef".trimToUtf8ByteCount(5), "abc\r\n")
+
+        // A combining accent past the limit extends the last ASCII character.
+        XCTAssertEqual("abcde\u{301}f".trimToUtf8ByteCount(5), "abcd")
+        XCTAssertEqual("abcdefgh🥹".trimToUtf8ByteCount(10), "abcdefgh")
+    }
 }
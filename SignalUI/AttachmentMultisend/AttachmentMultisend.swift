@@ -547,6 +547,7 @@ public class AttachmentMultisend {
     ///
     /// For private story threads, we create a single StoryMessage per attachment across all of them.
     /// Then theres one OutgoingStoryMessage per thread, all pointing to that same StoryMessage.
+    /// The threads' recipients are resolved once, and shared by every attachment.
     private class func preparePrivateStoryMessages(
         privateStoryThreads: [TSPrivateStoryThread],
         builders: [StoryMessageBuilder],
@@ -555,18 +556,15 @@ public class AttachmentMultisend {
         if privateStoryThreads.isEmpty {
             return []
         }
+        let fanOutPlan = try PrivateStoryFanOutPlan(threads: privateStoryThreads, tx: tx)
         return try builders
             .flatMap { builder in
-                let storyMessage = try createAndInsertStoryMessage(
-                    builder: builder,
-                    privateStoryThreads: privateStoryThreads,
-                    tx: tx
-                )
-                return OutgoingStoryMessage.createDedupedOutgoingMessages(
-                    for: storyMessage,
-                    sendingTo: privateStoryThreads,
+                let storyMessage = try builder.build(
+                    groupId: nil,
+                    manifest: .outgoing(recipientStates: fanOutPlan.recipientStates),
                     tx: tx
                 )
+                return fanOutPlan.outgoingMessages(for: storyMessage)
             }
             .map { outgoingStoryMessage in
                 return try UnpreparedOutgoingMessage.forOutgoingStoryMessage(
@@ -576,38 +574,6 @@ public class AttachmentMultisend {
             }
     }
 
-    private class func createAndInsertStoryMessage(
-        builder: StoryMessageBuilder,
-        privateStoryThreads: [TSPrivateStoryThread],
-        tx: SDSAnyWriteTransaction
-    ) throws -> StoryMessage {
-        var recipientStates = [ServiceId: StoryRecipientState]()
-        for thread in privateStoryThreads {
-            guard let threadUuid = UUID(uuidString: thread.uniqueId) else {
-                throw OWSAssertionError("Invalid uniqueId for thread \(thread.uniqueId)")
-            }
-            for recipientAddress in thread.recipientAddresses(with: tx) {
-                guard let recipient = recipientAddress.serviceId else {
-                    continue
-                }
-                let existingState = recipientStates[recipient] ?? .init(allowsReplies: false, contexts: [])
-                let newState = StoryRecipientState(
-                    allowsReplies: existingState.allowsReplies || thread.allowsReplies,
-                    contexts: existingState.contexts + [threadUuid]
-                )
-                recipientStates[recipient] = newState
-            }
-        }
-
-        let storyManifest = StoryManifest.outgoing(recipientStates: recipientStates)
-
-        return try builder.build(
-            groupId: nil,
-            manifest: storyManifest,
-            tx: tx
-        )
-    }
-
     // MARK: Generic story construction
 
     private struct StoryMessageBuilder {
@@ -44,6 +44,10 @@ public class LinkPreviewFetcherImpl: LinkPreviewFetcher {
         self.groupsV2 = groupsV2
         self.linkPreviewSettingStore = linkPreviewSettingStore
         self.tsAccountManager = tsAccountManager
+
+        CacheCoordinator.shared.register(name: "Link previews", priority: .media) { [weak self] in
+            self?.previewCache.clear()
+        }
     }
 
     public func fetchLinkPreview(for url: URL) async throws -> OWSLinkPreviewDraft {
@@ -70,6 +74,22 @@ public class LinkPreviewFetcherImpl: LinkPreviewFetcher {
     }
 
     private func fetchLinkPreview(forGenericUrl url: URL) async throws -> OWSLinkPreviewDraft? {
+        let cacheKey = Self.previewCacheKey(for: url)
+        if
+            let cachedPreview = previewCache.get(key: cacheKey),
+            -cachedPreview.fetchDate.timeIntervalSinceNow < Self.previewCacheTtl
+        {
+            return cachedPreview.linkPreviewDraft(for: url)
+        }
+
+        guard let linkPreviewDraft = try await self.fetchUncachedLinkPreview(forGenericUrl: url) else {
+            return nil
+        }
+        previewCache.set(key: cacheKey, value: CachedPreview(draft: linkPreviewDraft, fetchDate: Date()))
+        return linkPreviewDraft
+    }
+
+    private func fetchUncachedLinkPreview(forGenericUrl url: URL) async throws -> OWSLinkPreviewDraft? {
         let (respondingUrl, rawHtml) = try await self.fetchStringResource(from: url)
 
         let content = HTMLMetadata.construct(parsing: rawHtml)
@@ -164,6 +184,47 @@ public class LinkPreviewFetcherImpl: LinkPreviewFetcher {
 
     private static let maxFetchedContentSize = 2 * 1024 * 1024
 
+    // MARK: - Cache
+
+    /// A fetched generic link preview, with its thumbnail already downsampled
+    /// and encoded.
+    private struct CachedPreview {
+        let draft: OWSLinkPreviewDraft
+        let fetchDate: Date
+
+        func linkPreviewDraft(for url: URL) -> OWSLinkPreviewDraft {
+            // The draft must use the url as the user typed it; it has to
+            // appear verbatim in the message body.
+            return OWSLinkPreviewDraft(
+                url: url,
+                title: draft.title,
+                imageData: draft.imageData,
+                imageMimeType: draft.imageMimeType,
+                previewDescription: draft.previewDescription,
+                date: draft.date
+            )
+        }
+    }
+
+    /// Popular links tend to be shared to several chats in a row, so generic
+    /// previews are kept for a while rather than refetching the page and the
+    /// image (and re-encoding the image) for each message.
+    private let previewCache = LRUCache<String, CachedPreview>(maxSize: 32, shouldEvacuateInBackground: true)
+
+    private static let previewCacheTtl = 10 * kMinuteInterval
+
+    /// Links that only differ by scheme or host case, or by fragment, share
+    /// a preview.
+    static func previewCacheKey(for url: URL) -> String {
+        guard var components = URLComponents(url: url, resolvingAgainstBaseURL: false) else {
+            return url.absoluteString
+        }
+        components.scheme = components.scheme?.lowercased()
+        components.host = components.host?.lowercased()
+        components.fragment = nil
+        return components.string ?? url.absoluteString
+    }
+
     // MARK: - Preview Thumbnails
 
     private struct PreviewThumbnail {
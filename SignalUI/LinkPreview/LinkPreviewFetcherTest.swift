@@ -30,6 +30,17 @@ class LinkPreviewFetcherTest: XCTestCase {
         )
     }
 
+    func testPreviewCacheKey() {
+        XCTAssertEqual(
+            LinkPreviewFetcherImpl.previewCacheKey(for: URL(string: "HTTPS://Signal.ORG/blog/?a=B#Top")!),
+            "https://signal.org/blog/?a=B"
+        )
+        XCTAssertNotEqual(
+            LinkPreviewFetcherImpl.previewCacheKey(for: URL(string: "https://signal.org/Blog")!),
+            LinkPreviewFetcherImpl.previewCacheKey(for: URL(string: "https://signal.org/blog")!)
+        )
+    }
+
     func testLinkDownloadAndParsing() async throws {
         try XCTSkipUnless(shouldRunNetworkTests)
 
@@ -741,8 +741,11 @@ private class PaymentProcessingOperation: OWSOperation, @unchecked Sendable {
                                                                      transaction: transaction) else {
                         throw OWSAssertionError("Missing TSPaymentModel.")
                     }
-                    paymentModel.update(mcLedgerBlockIndex: 111, transaction: transaction)
-                    paymentModel.update(paymentState: .outgoingVerified, transaction: transaction)
+                    paymentModel.update(mcLedgerBlockIndex: 111,
+                                        mcLedgerBlockTimestamp: 0,
+                                        paymentAmount: nil,
+                                        paymentState: .outgoingVerified,
+                                        transaction: transaction)
                 }
             }
         }
@@ -761,32 +764,22 @@ private class PaymentProcessingOperation: OWSOperation, @unchecked Sendable {
                 }
 
                 return mobileCoinAPI.getOutgoingTransactionStatus(transaction: transaction)
-            }.map { (transactionStatus: MCOutgoingTransactionStatus) in
-                try SSKEnvironment.shared.databaseStorageRef.write { transaction in
-                    switch transactionStatus.transactionStatus {
-                    case .unknown:
-                        throw PaymentsError.verificationStatusUnknown
-                    case .accepted(let block):
-                        if !paymentModel.hasMCLedgerBlockIndex {
-                            paymentModel.update(mcLedgerBlockIndex: block.index, transaction: transaction)
-                        }
-                        if let ledgerBlockDate = block.timestamp,
-                           !paymentModel.hasMCLedgerBlockTimestamp {
-                            paymentModel.update(mcLedgerBlockTimestamp: ledgerBlockDate.ows_millisecondsSince1970,
-                                                transaction: transaction)
-                        }
-                        try paymentModel.updatePaymentModelState(fromState: .outgoingUnverified,
-                                                                 toState: .outgoingVerified,
-                                                                 transaction: transaction)
-
-                        // If we've verified a payment, our balance may have changed.
-                        SUIEnvironment.shared.paymentsImplRef.updateCurrentPaymentBalance()
-                    case .failed:
-                        Self.markAsFailed(paymentModel: paymentModel,
-                                          paymentFailure: .validationFailed,
-                                          paymentState: .outgoingFailed,
-                                          transaction: transaction)
-                    }
+            }.then(on: DispatchQueue.global()) { (transactionStatus: MCOutgoingTransactionStatus) -> Promise<Void> in
+                switch transactionStatus.transactionStatus {
+                case .unknown:
+                    throw PaymentsError.verificationStatusUnknown
+                case .accepted(let block):
+                    return Self.applyLedgerBlockUpdatePromise(PaymentLedgerBlockUpdate(
+                        paymentModel: paymentModel,
+                        ledgerBlockIndex: block.index,
+                        ledgerBlockTimestamp: block.timestamp?.ows_millisecondsSince1970 ?? 0,
+                        fromState: .outgoingUnverified,
+                        toState: .outgoingVerified
+                    ))
+                case .failed:
+                    return Self.markAsFailedPromise(paymentModel: paymentModel,
+                                                    paymentFailure: .validationFailed,
+                                                    paymentState: .outgoingFailed)
                 }
             }
         }
@@ -892,38 +885,57 @@ private class PaymentProcessingOperation: OWSOperation, @unchecked Sendable {
             }
 
             return mobileCoinAPI.getIncomingReceiptStatus(receipt: receipt)
-        }.map { (receiptStatus: MCIncomingReceiptStatus) in
-            try SSKEnvironment.shared.databaseStorageRef.write { transaction in
-                switch receiptStatus.receiptStatus {
-                case .unknown:
-                    throw PaymentsError.verificationStatusUnknown
-                case .received(let block):
-                    paymentModel.update(mcLedgerBlockIndex: block.index,
-                                        transaction: transaction)
-                    if let ledgerBlockDate = block.timestamp {
-                        paymentModel.update(mcLedgerBlockTimestamp: ledgerBlockDate.ows_millisecondsSince1970,
-                                            transaction: transaction)
-                    } else {
-                        Logger.warn("Missing ledgerBlockDate.")
-                    }
-                    paymentModel.update(withPaymentAmount: receiptStatus.paymentAmount,
-                                        transaction: transaction)
-                    try paymentModel.updatePaymentModelState(fromState: .incomingUnverified,
-                                                             toState: .incomingVerified,
-                                                             transaction: transaction)
-
-                    // If we've verified a payment, our balance may have changed.
-                    SUIEnvironment.shared.paymentsImplRef.updateCurrentPaymentBalance()
-                case .failed:
-                    Self.markAsFailed(paymentModel: paymentModel,
-                                      paymentFailure: .validationFailed,
-                                      paymentState: .incomingFailed,
-                                      transaction: transaction)
+        }.then(on: DispatchQueue.global()) { (receiptStatus: MCIncomingReceiptStatus) -> Promise<Void> in
+            switch receiptStatus.receiptStatus {
+            case .unknown:
+                throw PaymentsError.verificationStatusUnknown
+            case .received(let block):
+                if block.timestamp == nil {
+                    Logger.warn("Missing ledgerBlockDate.")
                 }
+                return Self.applyLedgerBlockUpdatePromise(PaymentLedgerBlockUpdate(
+                    paymentModel: paymentModel,
+                    ledgerBlockIndex: block.index,
+                    ledgerBlockTimestamp: block.timestamp?.ows_millisecondsSince1970 ?? 0,
+                    paymentAmount: receiptStatus.paymentAmount,
+                    fromState: .incomingUnverified,
+                    toState: .incomingVerified
+                ))
+            case .failed:
+                return Self.markAsFailedPromise(paymentModel: paymentModel,
+                                                paymentFailure: .validationFailed,
+                                                paymentState: .incomingFailed)
             }
         }
     }
 
+    /// Verifications finish independently of one another; their ledger
+    /// blocks are committed together in coalesced write transactions.
+    private static func applyLedgerBlockUpdatePromise(_ update: PaymentLedgerBlockUpdate) -> Promise<Void> {
+        let (promise, future) = Promise<Void>.pending()
+        var updateError: Error?
+        SSKEnvironment.shared.databaseStorageRef.asyncCoalescedWrite(
+            block: { transaction in
+                do {
+                    try update.paymentModel.applyLedgerBlockUpdate(update, transaction: transaction)
+                } catch {
+                    updateError = error
+                }
+            },
+            completionQueue: .global(),
+            completion: {
+                if let updateError {
+                    future.reject(updateError)
+                    return
+                }
+                // If we've verified a payment, our balance may have changed.
+                SUIEnvironment.shared.paymentsImplRef.updateCurrentPaymentBalance()
+                future.resolve(())
+            }
+        )
+        return promise
+    }
+
     class func handleIndeterminatePayment(paymentModel: TSPaymentModel) {
         owsFailDebug("Indeterminate payment: \(paymentModel.descriptionForLogs)")
 
@@ -220,7 +220,10 @@ public class PaymentsReconciliation {
                               databaseState: databaseState,
                               transaction: transaction)
 
-                try cleanUpDatabase(transaction: transaction)
+                // Reconciliation didn't write anything (it would have thrown),
+                // so the models in databaseState are exactly those in the
+                // database; don't fetch and decode them all again.
+                try cleanUpDatabase(paymentModels: databaseState.paymentModels, transaction: transaction)
             }
             SSKEnvironment.shared.databaseStorageRef.write { transaction in
                 reconciliationDidSucceed(transaction: transaction,
@@ -238,7 +241,12 @@ public class PaymentsReconciliation {
                                       databaseState: databaseState,
                                       transaction: transaction)
 
-                        try cleanUpDatabase(transaction: transaction)
+                        // Inserting payment models may have culled others, so
+                        // re-fetch them.
+                        try cleanUpDatabase(
+                            paymentModels: TSPaymentModel.anyFetchAll(transaction: transaction),
+                            transaction: transaction
+                        )
 
                         reconciliationDidSucceed(transaction: transaction,
                                                  transactionHistory: transactionHistory)
@@ -642,11 +650,12 @@ public class PaymentsReconciliation {
         return timestampUpperBound - 1
     }
 
-    private static func cleanUpDatabase(transaction: SDSAnyReadTransaction) throws {
-        try cleanUpDatabaseMobileCoin(transaction: transaction)
+    private static func cleanUpDatabase(paymentModels: [TSPaymentModel], transaction: SDSAnyReadTransaction) throws {
+        try cleanUpDatabaseMobileCoin(paymentModels: paymentModels, transaction: transaction)
     }
 
-    private static func cleanUpDatabaseMobileCoin(transaction: SDSAnyReadTransaction) throws {
+    private static func cleanUpDatabaseMobileCoin(paymentModels allPaymentModels: [TSPaymentModel],
+                                                  transaction: SDSAnyReadTransaction) throws {
 
         var unidentifiedPaymentModelsToCull = [String: TSPaymentModel]()
 
@@ -683,7 +692,6 @@ public class PaymentsReconciliation {
         let spentKeyImagesMap = MultiMap<Data, TSPaymentModel>()
         let outputPublicKeys = MultiMap<Data, TSPaymentModel>()
 
-        let allPaymentModels = TSPaymentModel.anyFetchAll(transaction: transaction)
         for paymentModel in allPaymentModels {
             owsAssertDebug(paymentModel.isFailed == (paymentModel.mobileCoin == nil))
             guard !paymentModel.isFailed,
@@ -970,6 +978,15 @@ internal class PaymentsDatabaseState {
 
     var allPaymentState = [PaymentState]()
 
+    var paymentModels: [TSPaymentModel] {
+        allPaymentState.compactMap {
+            guard case .model(let paymentModel) = $0 else {
+                return nil
+            }
+            return paymentModel
+        }
+    }
+
     // A map of "received TXO public key" to TSPaymentModel or ArchivedPayment
     // representing an (incoming) transactions.
     var incomingAnyMap = MultiMap<Data, PaymentState>()
@@ -167,7 +167,11 @@ public class ChatListInfo {
             VoiceMessageInterruptedDraftStore.hasDraft(for: thread, transaction: transaction)
         }
         func loadLastMessageText() -> HydratedMessageBody? {
-            if let previewable = lastMessageForInbox as? OWSPreviewText {
+            if let errorMessage = lastMessageForInbox as? TSErrorMessage {
+                return HydratedMessageBody.fromPlaintextWithoutRanges(
+                    PreviewTextCache.shared.errorMessagePreviewText(errorMessage, transaction: transaction).filterStringForDisplay()
+                )
+            } else if let previewable = lastMessageForInbox as? OWSPreviewText {
                 return HydratedMessageBody.fromPlaintextWithoutRanges(
                     previewable.previewText(transaction: transaction).filterStringForDisplay()
                 )
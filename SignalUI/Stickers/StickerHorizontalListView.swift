@@ -47,7 +47,7 @@ public class StickerHorizontalListViewItemSticker: StickerHorizontalListViewItem
 
         guard !view.hasStickerView else { return view }
 
-        guard let stickerView = StickerView.stickerView(forInstalledStickerInfo: stickerInfo) else {
+        guard let stickerView = StickerView.stickerView(forInstalledStickerInfo: stickerInfo, isThumbnail: true) else {
             view.showPlaceholder()
             return view
         }
@@ -0,0 +1,203 @@
+//
+// Copyright 2024 Signal Messenger, LLC
+// SPDX-License-Identifier: AGPL-3.0-only
+//
+
+public import SignalServiceKit
+import YYImage
+
+/// Decoded sticker images for the sticker keyboard and suggestions.
+///
+/// Decoding a sticker (usually a 512px WebP) when its cell first appears
+/// makes the first scroll through a pack stutter. Images are kept in a
+/// bounded memory cache; static stickers are also downsampled and written
+/// to a persistent raster cache, which is much cheaper to load than the
+/// original. Animated stickers are cached as parsed `YYImage`s, whose
+/// frames are still decoded as they play.
+///
+/// Images that aren't in memory are loaded on a utility queue, never on
+/// the caller's thread. When a pack is installed, its cover and first page
+/// of stickers are decoded ahead of time; when it's uninstalled, its rasters
+/// are deleted.
+public final class StickerImageCache {
+
+    public static let shared = StickerImageCache()
+
+    /// The keyboard shows up to four stickers per row on the widest phones.
+    private static let rasterPixelSize: CGFloat = 256
+
+    /// The number of stickers that fit on the first page of the keyboard.
+    private static let prefetchCount = 16
+
+    private let cache = LRUCache<String, UIImage>(
+        maxSize: 256,
+        totalCostLimit: 32 * 1024 * 1024,
+        shouldEvacuateInBackground: true
+    )
+
+    private let rasterDirectoryUrl = URL(fileURLWithPath: OWSFileSystem.cachesDirectoryPath())
+        .appendingPathComponent("StickerRasters", isDirectory: true)
+
+    private let prefetchQueue = DispatchQueue(label: "org.signal.sticker-image-cache", qos: .utility)
+
+    private init() {
+        NotificationCenter.default.addObserver(
+            self,
+            selector: #selector(stickerPackDidInstall),
+            name: StickerManager.stickerPackDidInstall,
+            object: nil
+        )
+        NotificationCenter.default.addObserver(
+            self,
+            selector: #selector(stickerPackDidUninstall),
+            name: StickerManager.stickerPackDidUninstall,
+            object: nil
+        )
+        CacheCoordinator.shared.register(name: "Sticker images", priority: .media, purge: cache.clear)
+    }
+
+    /// Returns the sticker's image for display at keyboard-cell sizes if
+    /// it's in memory. Otherwise, returns nil and loads it in the background;
+    /// `completion` is then invoked on the main thread with the image, or
+    /// with nil if it can't be loaded.
+    public func thumbnailImage(
+        stickerInfo: StickerInfo,
+        stickerMetadata: any StickerMetadata,
+        completion: @escaping (UIImage?) -> Void
+    ) -> UIImage? {
+        let key = stickerInfo.asKey()
+        if let image = cache.get(key: key) {
+            return image
+        }
+        prefetchQueue.async {
+            let image = autoreleasepool {
+                self.loadImage(key: key, stickerMetadata: stickerMetadata)
+            }
+            DispatchQueue.main.async {
+                completion(image)
+            }
+        }
+        return nil
+    }
+
+    private func loadImage(key: String, stickerMetadata: any StickerMetadata) -> UIImage? {
+        if let image = cache.get(key: key) {
+            return image
+        }
+        if let image = loadRaster(key: key) {
+            cache.set(key: key, value: image, cost: Self.cost(of: image))
+            return image
+        }
+        guard stickerMetadata.isValidImage() else {
+            owsFailDebug("Invalid sticker")
+            return nil
+        }
+        guard
+            let stickerData = try? stickerMetadata.readStickerData(),
+            let stickerImage = YYImage(data: stickerData)
+        else {
+            Logger.warn("Sticker could not be loaded.")
+            return nil
+        }
+        guard stickerImage.animatedImageFrameCount() <= 1 else {
+            cache.set(key: key, value: stickerImage, cost: stickerData.count)
+            return stickerImage
+        }
+        let image = downsample(stickerImage)
+        cache.set(key: key, value: image, cost: Self.cost(of: image))
+        saveRaster(image, key: key)
+        return image
+    }
+
+    // MARK: - Prefetch
+
+    @objc
+    private func stickerPackDidInstall(_ notification: Notification) {
+        guard let stickerPack = notification.object as? StickerPack else {
+            owsFailDebug("Missing sticker pack.")
+            return
+        }
+        prefetchQueue.async {
+            let stickerInfos = [stickerPack.coverInfo] + stickerPack.stickerInfos.prefix(Self.prefetchCount)
+            for stickerInfo in stickerInfos {
+                autoreleasepool {
+                    let key = stickerInfo.asKey()
+                    guard
+                        self.cache.get(key: key) == nil,
+                        let stickerMetadata = StickerManager.installedStickerMetadataWithSneakyTransaction(stickerInfo: stickerInfo)
+                    else {
+                        return
+                    }
+                    _ = self.loadImage(key: key, stickerMetadata: stickerMetadata)
+                }
+            }
+        }
+    }
+
+    @objc
+    private func stickerPackDidUninstall(_ notification: Notification) {
+        guard let stickerPack = notification.object as? StickerPack else {
+            owsFailDebug("Missing sticker pack.")
+            return
+        }
+        prefetchQueue.async {
+            for stickerInfo in [stickerPack.coverInfo] + stickerPack.stickerInfos {
+                let key = stickerInfo.asKey()
+                self.cache.remove(key: key)
+                do {
+                    try OWSFileSystem.deleteFileIfExists(url: self.rasterUrl(key: key))
+                } catch {
+                    Logger.warn("Couldn't delete sticker raster: \(error)")
+                }
+            }
+        }
+    }
+
+    // MARK: - Rasters
+
+    private func downsample(_ image: UIImage) -> UIImage {
+        let pixelSize = max(image.size.width * image.scale, image.size.height * image.scale)
+        let scale = min(1, Self.rasterPixelSize / max(pixelSize, 1))
+        let size = CGSize(width: image.size.width * image.scale * scale, height: image.size.height * image.scale * scale)
+        let format = UIGraphicsImageRendererFormat()
+        format.scale = 1
+        format.opaque = false
+        // Drawing decodes the image once, here, rather than on the main thread.
+        return UIGraphicsImageRenderer(size: size, format: format).image { _ in
+            image.draw(in: CGRect(origin: .zero, size: size))
+        }
+    }
+
+    private func rasterUrl(key: String) -> URL {
+        return rasterDirectoryUrl.appendingPathComponent(key).appendingPathExtension("png")
+    }
+
+    private func loadRaster(key: String) -> UIImage? {
+        guard
+            let data = try? Data(contentsOf: rasterUrl(key: key)),
+            let image = UIImage(data: data, scale: 1)
+        else {
+            return nil
+        }
+        return image.preparingForDisplay() ?? image
+    }
+
+    private func saveRaster(_ image: UIImage, key: String) {
+        prefetchQueue.async {
+            guard let data = image.pngData() else {
+                owsFailDebug("Couldn't encode sticker raster.")
+                return
+            }
+            do {
+                try FileManager.default.createDirectory(at: self.rasterDirectoryUrl, withIntermediateDirectories: true)
+                try data.write(to: self.rasterUrl(key: key), options: .atomic)
+            } catch {
+                Logger.warn("Couldn't write sticker raster: \(error)")
+            }
+        }
+    }
+
+    private static func cost(of image: UIImage) -> Int {
+        return Int(image.size.width * image.scale * image.size.height * image.scale) * 4
+    }
+}
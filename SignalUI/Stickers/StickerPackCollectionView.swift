@@ -249,12 +249,12 @@ public class StickerPackCollectionView: UICollectionView {
         stickerView.autoPinEdge(toSuperviewEdge: .trailing, withInset: hMargin, relation: .greaterThanOrEqual)
     }
 
-    private func imageView(forStickerInfo stickerInfo: StickerInfo) -> UIView? {
+    private func imageView(forStickerInfo stickerInfo: StickerInfo, isThumbnail: Bool = false) -> UIView? {
         guard let stickerPackDataSource = stickerPackDataSource else {
             owsFailDebug("Missing stickerPackDataSource.")
             return nil
         }
-        return StickerView.stickerView(forStickerInfo: stickerInfo, dataSource: stickerPackDataSource)
+        return StickerView.stickerView(forStickerInfo: stickerInfo, dataSource: stickerPackDataSource, isThumbnail: isThumbnail)
     }
 
     private let reusableStickerViewCache = StickerViewCache(maxSize: 32)
@@ -268,7 +268,7 @@ public class StickerPackCollectionView: UICollectionView {
 
         guard !view.hasStickerView else { return view }
 
-        guard let imageView = imageView(forStickerInfo: stickerInfo) else {
+        guard let imageView = imageView(forStickerInfo: stickerInfo, isThumbnail: true) else {
             view.showPlaceholder(color: placeholderColor)
             return view
         }
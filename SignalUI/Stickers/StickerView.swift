@@ -12,31 +12,57 @@ public class StickerView {
     // Never instantiate this class.
     private init() {}
 
+    /// - Parameter isThumbnail: If true, the sticker is displayed at
+    ///   keyboard-cell sizes and its image may come from (and is added to)
+    ///   `StickerImageCache`.
     public static func stickerView(forStickerInfo stickerInfo: StickerInfo,
                                    dataSource: StickerPackDataSource,
-                                   size: CGFloat? = nil) -> UIView? {
+                                   size: CGFloat? = nil,
+                                   isThumbnail: Bool = false) -> UIView? {
         guard let stickerMetadata = dataSource.metadata(forSticker: stickerInfo) else {
             Logger.warn("Missing sticker metadata.")
             return nil
         }
-        return stickerView(stickerInfo: stickerInfo, stickerMetadata: stickerMetadata, size: size)
+        return stickerView(stickerInfo: stickerInfo, stickerMetadata: stickerMetadata, size: size, isThumbnail: isThumbnail)
     }
 
     public static func stickerView(forInstalledStickerInfo stickerInfo: StickerInfo,
-                                   size: CGFloat? = nil) -> UIView? {
+                                   size: CGFloat? = nil,
+                                   isThumbnail: Bool = false) -> UIView? {
         let metadata = StickerManager.installedStickerMetadataWithSneakyTransaction(stickerInfo: stickerInfo)
         guard let stickerMetadata = metadata else {
             Logger.warn("Missing sticker metadata.")
             return nil
         }
-        return stickerView(stickerInfo: stickerInfo, stickerMetadata: stickerMetadata, size: size)
+        return stickerView(stickerInfo: stickerInfo, stickerMetadata: stickerMetadata, size: size, isThumbnail: isThumbnail)
     }
 
     private static func stickerView(
         stickerInfo: StickerInfo,
         stickerMetadata: any StickerMetadata,
-        size: CGFloat? = nil
+        size: CGFloat? = nil,
+        isThumbnail: Bool = false
     ) -> UIView? {
+        if isThumbnail {
+            let stickerView = YYAnimatedImageView()
+            stickerView.alwaysInfiniteLoop = true
+            stickerView.contentMode = .scaleAspectFit
+            // Stays empty until the image is loaded in the background.
+            stickerView.image = StickerImageCache.shared.thumbnailImage(
+                stickerInfo: stickerInfo,
+                stickerMetadata: stickerMetadata
+            ) { [weak stickerView] stickerImage in
+                guard let stickerImage else {
+                    Logger.warn("Could not load sticker for display.")
+                    return
+                }
+                stickerView?.image = stickerImage
+            }
+            if let size = size {
+                stickerView.autoSetDimensions(to: CGSize(square: size))
+            }
+            return stickerView
+        }
         guard
             let stickerView = self.stickerView(
                 stickerInfo: stickerInfo,
@@ -148,6 +148,7 @@ public struct ReportSpamUIUtils {
                 try InteractionFinder(
                     threadUniqueId: thread.uniqueId
                 ).enumerateInteractionsForConversationView(
+                    recordTypes: [.incomingMessage],
                     rowIdFilter: .newest,
                     tx: tx
                 ) { interaction -> Bool in